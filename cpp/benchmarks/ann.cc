@@ -0,0 +1,153 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+/// Recall and latency of IVF-PQ approximate nearest neighbor search, against the brute-force
+/// scan of all the vectors at every SIMD level supported by the CPU.
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "lance/encodings/kernels.h"
+#include "lance/index/ivf_pq.h"
+#include "lance/index/kmeans.h"
+
+using lance::encodings::kernels::SimdLevel;
+using lance::index::IvfPqIndex;
+
+namespace kernels = lance::encodings::kernels;
+
+namespace {
+
+constexpr int64_t kNumVectors = 100000;
+constexpr int32_t kDimension = 64;
+constexpr int32_t kNumQueries = 100;
+constexpr int32_t kTopK = 10;
+
+/// Generate vectors around random centers, like the embeddings of a few topics.
+std::vector<float> MakeVectors(int64_t num_vectors, int32_t num_clusters, uint32_t seed) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> center_dist(-1, 1);
+  std::vector<float> centers(num_clusters * kDimension);
+  std::generate(centers.begin(), centers.end(), [&] { return center_dist(gen); });
+  gen.seed(seed);
+  std::normal_distribution<float> noise(0, 0.2);
+  std::uniform_int_distribution<int32_t> cluster_dist(0, num_clusters - 1);
+  std::vector<float> vectors(num_vectors * kDimension);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto center = centers.data() + cluster_dist(gen) * kDimension;
+    for (int32_t j = 0; j < kDimension; j++) {
+      vectors[i * kDimension + j] = center[j] + noise(gen);
+    }
+  }
+  return vectors;
+}
+
+std::vector<int64_t> BruteForce(const std::vector<float>& vectors, const float* query) {
+  std::vector<std::tuple<float, int64_t>> distances(kNumVectors);
+  for (int64_t i = 0; i < kNumVectors; i++) {
+    distances[i] = {lance::index::L2Distance(query, vectors.data() + i * kDimension, kDimension),
+                    i};
+  }
+  std::partial_sort(distances.begin(), distances.begin() + kTopK, distances.end());
+  std::vector<int64_t> row_ids;
+  for (int32_t i = 0; i < kTopK; i++) {
+    row_ids.emplace_back(std::get<1>(distances[i]));
+  }
+  return row_ids;
+}
+
+/// Search `k * refine_factor` candidates in the index, and re-rank them by exact distances.
+std::vector<int64_t> Search(const IvfPqIndex& index,
+                            const std::vector<float>& vectors,
+                            const float* query,
+                            int32_t nprobe,
+                            int32_t refine_factor) {
+  auto neighbors = index.Search(query, kTopK * refine_factor, nprobe).ValueOrDie();
+  if (refine_factor > 1) {
+    for (auto& neighbor : neighbors) {
+      neighbor.distance = lance::index::L2Distance(
+          query, vectors.data() + neighbor.row_id * kDimension, kDimension);
+    }
+    std::sort(neighbors.begin(), neighbors.end(), [](auto& lhs, auto& rhs) {
+      return lhs.distance < rhs.distance;
+    });
+    neighbors.resize(std::min<std::size_t>(neighbors.size(), kTopK));
+  }
+  std::vector<int64_t> row_ids;
+  for (auto& neighbor : neighbors) {
+    row_ids.emplace_back(neighbor.row_id);
+  }
+  return row_ids;
+}
+
+}  // namespace
+
+TEST_CASE("IVF-PQ recall and latency") {
+  auto vectors = MakeVectors(kNumVectors, 1000, 1);
+  auto queries = MakeVectors(kNumQueries, 1000, 2);
+  std::vector<int64_t> row_ids(kNumVectors);
+  std::iota(row_ids.begin(), row_ids.end(), 0);
+
+  lance::arrow::IvfPqIndexOptions options;
+  options.num_partitions = 256;
+  options.num_sub_vectors = 16;
+  options.max_iterations = 20;
+  auto index =
+      IvfPqIndex::Build(vectors.data(), row_ids.data(), kNumVectors, kDimension, options)
+          .ValueOrDie();
+
+  std::vector<std::vector<int64_t>> expected;
+  for (int32_t q = 0; q < kNumQueries; q++) {
+    expected.emplace_back(BruteForce(vectors, queries.data() + q * kDimension));
+  }
+
+  auto max_level = kernels::DetectSimdLevel();
+  for (auto level :
+       {SimdLevel::kScalar, SimdLevel::kSSE4_2, SimdLevel::kAVX2, SimdLevel::kAVX512}) {
+    if (level <= max_level) {
+      kernels::SetSimdLevel(level);
+      BENCHMARK(fmt::format("Brute force ({})", kernels::ToString(level))) {
+        return BruteForce(vectors, queries.data());
+      };
+    }
+  }
+  kernels::SetSimdLevel(max_level);
+
+  for (auto [nprobe, refine_factor] : std::vector<std::tuple<int32_t, int32_t>>{
+           {1, 1}, {8, 1}, {32, 1}, {8, 10}, {32, 10}}) {
+    int64_t num_found = 0;
+    for (int32_t q = 0; q < kNumQueries; q++) {
+      for (auto row_id :
+           Search(*index, vectors, queries.data() + q * kDimension, nprobe, refine_factor)) {
+        num_found += std::count(expected[q].begin(), expected[q].end(), row_id);
+      }
+    }
+    auto name = fmt::format("IVF-PQ nprobe={} refine_factor={}", nprobe, refine_factor);
+    fmt::print("{}: recall@{}={:.3f}\n",
+               name,
+               kTopK,
+               static_cast<double>(num_found) / (kNumQueries * kTopK));
+    BENCHMARK(std::string(name)) {
+      return Search(*index, vectors, queries.data(), nprobe, refine_factor);
+    };
+  }
+}
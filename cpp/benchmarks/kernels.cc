@@ -0,0 +1,151 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+/// Micro benchmarks of the decoding kernels.
+///
+/// Each kernel runs at every SIMD level supported by the CPU, and the results are checked
+/// against the scalar reference before being timed.
+
+#include <arrow/util/bit_util.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lance/encodings/kernels.h"
+
+using lance::encodings::kernels::SimdLevel;
+
+namespace kernels = lance::encodings::kernels;
+
+namespace {
+
+constexpr int64_t kNumValues = 1024 * 1024;
+
+std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels;
+  auto max_level = kernels::DetectSimdLevel();
+  for (auto level :
+       {SimdLevel::kScalar, SimdLevel::kSSE4_2, SimdLevel::kAVX2, SimdLevel::kAVX512}) {
+    if (level <= max_level) {
+      levels.emplace_back(level);
+    }
+  }
+  return levels;
+}
+
+/// Run `fn` with the scalar reference, then check and benchmark it at every SIMD level.
+///
+/// \param fn runs the kernel and returns its output.
+template <typename Fn>
+void VerifyAndBenchmark(const std::string& name, Fn&& fn) {
+  kernels::SetSimdLevel(SimdLevel::kScalar);
+  auto expected = fn();
+  for (auto level : SupportedLevels()) {
+    kernels::SetSimdLevel(level);
+    INFO(name << " at " << kernels::ToString(level));
+    CHECK(fn() == expected);
+    BENCHMARK(fmt::format("{} ({})", name, kernels::ToString(level))) { return fn(); };
+  }
+  kernels::SetSimdLevel(kernels::DetectSimdLevel());
+}
+
+std::vector<int32_t> RandomIndices(int64_t length, int32_t max) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int32_t> dist(0, max - 1);
+  std::vector<int32_t> indices(length);
+  std::generate(indices.begin(), indices.end(), [&]() { return dist(gen); });
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+std::vector<uint8_t> RandomBitmap(int64_t num_bits, double density) {
+  std::mt19937 gen(42);
+  std::bernoulli_distribution dist(density);
+  std::vector<uint8_t> bitmap(::arrow::bit_util::BytesForBits(num_bits));
+  for (int64_t i = 0; i < num_bits; i++) {
+    ::arrow::bit_util::SetBitTo(bitmap.data(), i, dist(gen));
+  }
+  return bitmap;
+}
+
+}  // namespace
+
+TEST_CASE("Gather") {
+  auto indices = RandomIndices(kNumValues / 4, kNumValues);
+  for (int32_t byte_width : {4, 8}) {
+    std::vector<uint8_t> values(kNumValues * byte_width);
+    std::iota(values.begin(), values.end(), 0);
+    VerifyAndBenchmark(fmt::format("Gather {} bytes", byte_width), [&]() {
+      std::vector<uint8_t> out(indices.size() * byte_width);
+      kernels::Gather(values.data(), byte_width, indices.data(), indices.size(), 0, out.data());
+      return out;
+    });
+  }
+}
+
+TEST_CASE("Rebase offsets") {
+  std::vector<int32_t> offsets32(kNumValues);
+  std::vector<int64_t> offsets64(kNumValues);
+  for (int64_t i = 0; i < kNumValues; i++) {
+    offsets32[i] = static_cast<int32_t>(1000 + i * 10);
+    offsets64[i] = 4096 + i * 10;
+  }
+  VerifyAndBenchmark("Rebase int32 offsets", [&]() {
+    std::vector<int32_t> out(kNumValues);
+    kernels::RebaseOffsets(offsets32.data(), kNumValues, 1000, out.data());
+    return out;
+  });
+  VerifyAndBenchmark("Rebase int64 positions", [&]() {
+    std::vector<int32_t> out(kNumValues);
+    kernels::RebaseOffsets(offsets64.data(), kNumValues, int64_t{4096}, out.data());
+    return out;
+  });
+}
+
+TEST_CASE("Gather bits") {
+  auto bitmap = RandomBitmap(kNumValues, 0.5);
+  auto indices = RandomIndices(kNumValues / 4, kNumValues);
+  VerifyAndBenchmark("Gather bits", [&]() {
+    std::vector<uint8_t> out(::arrow::bit_util::BytesForBits(indices.size()));
+    kernels::GatherBits(
+        bitmap.data(), bitmap.size(), indices.data(), indices.size(), 0, out.data());
+    return out;
+  });
+}
+
+TEST_CASE("Bitmap to indices") {
+  for (double density : {0.01, 0.5, 0.99}) {
+    auto bitmap = RandomBitmap(kNumValues, density);
+    VerifyAndBenchmark(fmt::format("Bitmap to indices (density={})", density), [&]() {
+      std::vector<int32_t> out(kNumValues);
+      out.resize(kernels::BitmapToIndices(bitmap.data(), 0, kNumValues, out.data()));
+      return out;
+    });
+  }
+}
+
+TEST_CASE("Unpack bits") {
+  auto bitmap = RandomBitmap(kNumValues, 0.5);
+  VerifyAndBenchmark("Unpack bits", [&]() {
+    std::vector<uint8_t> out(kNumValues);
+    kernels::UnpackBits(bitmap.data(), 0, kNumValues, out.data());
+    return out;
+  });
+}
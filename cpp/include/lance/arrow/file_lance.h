@@ -16,7 +16,9 @@
 
 #include <arrow/dataset/file_base.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 namespace lance::arrow {
 
@@ -51,15 +53,80 @@ class LanceFileFormat : public ::arrow::dataset::FileFormat {
   std::shared_ptr<::arrow::dataset::FileWriteOptions> DefaultWriteOptions() override;
 };
 
+/// How the writer chooses the encoding of each page of a column.
+enum class EncodingPolicy {
+  /// All pages use the encoding of the column.
+  kFixed,
+  /// Pick the encoding that makes the page smallest.
+  kSmallest,
+  /// Pick a smaller encoding only if the saved space outweighs its slower decoding.
+  kBalanced,
+};
+
 class FileWriteOptions : public ::arrow::dataset::FileWriteOptions {
  public:
   FileWriteOptions();
 
   ~FileWriteOptions() override = default;
 
+  /// The primary key column. Integer, string / binary and fixed size binary columns, and the
+  /// dictionary columns of them, are indexed to read the rows by key; the other columns are only
+  /// recorded as the primary key. The write fails with `Status::Invalid` if the column does not
+  /// exist.
   std::string primary_key;
 
   int32_t chunk_size = 1024;
+
+  /// Columns to write with run-length encoding.
+  ///
+  /// Suitable for sorted or clustered columns, i.e., partition keys, where consecutive rows
+  /// share the same value. Boolean, numeric, temporal and string / binary columns are supported;
+  /// the other columns keep their default encodings.
+  std::vector<std::string> rle_columns;
+
+  /// String / binary columns to compress with FSST, i.e., file paths or captions that share
+  /// common substrings.
+  std::vector<std::string> fsst_columns;
+
+  /// Float / double columns to write with byte-stream-split encoding, i.e., bounding boxes or
+  /// scores, so that their pages compress better.
+  std::vector<std::string> byte_stream_split_columns;
+
+  /// String / binary columns of large values, i.e., image or mask bytes, to store out of the
+  /// pages. The pages only keep the file position and the length of each value, so that the
+  /// values can be fetched lazily.
+  std::vector<std::string> blob_columns;
+
+  /// Struct columns whose children are all fixed-width, i.e., bounding boxes, to store as one
+  /// page of interleaved rows, so that a point lookup reads all the children in one I/O.
+  ///
+  /// The write fails with `Status::Invalid` if a column does not exist or can not be packed.
+  std::vector<std::string> packed_struct_columns;
+
+  /// Encoding selection for the pages of primitive and string / binary columns that are not
+  /// listed in any of the columns options above.
+  ///
+  /// With a policy other than `kFixed`, the writer encodes a sample of each page with each
+  /// candidate encoding (i.e., plain, RLE and FSST) and records the choice in the file.
+  EncodingPolicy encoding_policy = EncodingPolicy::kFixed;
+
+  /// Columns to write a Bloom filter for each page, with the target false positive rate of the
+  /// filters, i.e., `{{"uuid", 0.01}}`. The filters let equality and `is_in` filters skip the
+  /// batches that do not have the values.
+  ///
+  /// Only fixed-width and string / binary columns are supported; the write fails with
+  /// `Status::Invalid` for the other columns, or the columns that do not exist.
+  std::map<std::string, double> bloom_filter_columns;
+
+  /// Low-cardinality columns, i.e., `split` or `label`, to write a bitmap index for, which maps
+  /// each distinct value to its rows. Filters of `==`, `is_in`, `and` and `or` over the indexed
+  /// columns read only the matched rows.
+  ///
+  /// Only integer and string / binary columns, and the dictionary columns of them, are
+  /// supported; the write fails with `Status::Invalid` for the other columns, or the columns that
+  /// do not exist. A column is not indexed if it has more than
+  /// `lance::format::BitmapIndex::kMaxNumValues` distinct values.
+  std::vector<std::string> bitmap_index_columns;
 };
 
 }  // namespace lance::arrow
@@ -0,0 +1,63 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/dataset/type_fwd.h>
+#include <arrow/status.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace lance::arrow {
+
+/// Parameters of an IVF-PQ index.
+struct IvfPqIndexOptions {
+  /// Number of IVF partitions, i.e., the k-means clusters of the vectors.
+  int32_t num_partitions = 256;
+
+  /// Number of sub-vectors of product quantization. It must divide the dimension of the
+  /// vectors. Each sub-vector is encoded into one byte.
+  int32_t num_sub_vectors = 16;
+
+  /// Maximum number of k-means iterations.
+  int32_t max_iterations = 50;
+
+  /// Number of training vectors per cluster. k-means is trained over a random sample of at
+  /// most `num_partitions * sample_rate` vectors.
+  int32_t sample_rate = 256;
+
+  /// The seed of the random samples.
+  uint32_t seed = 42;
+};
+
+/// Build an IVF-PQ index over a vector column of a dataset, for approximate nearest neighbor
+/// search with `ScannerBuilder::NearestNeighbors()`.
+///
+/// The index is stored as lance files in the `uri` directory. It refers to the rows by their
+/// positions in the fragments of the dataset, so it must be built again once the fragments
+/// change.
+///
+/// \param dataset a dataset of lance files.
+/// \param column a `fixed_size_list<float>` or `list<float>` column. Null vectors are not
+///               indexed.
+/// \param uri the directory to write the index to.
+/// \param options the parameters of the index.
+::arrow::Status BuildIvfPqIndex(const std::shared_ptr<::arrow::dataset::Dataset>& dataset,
+                                const std::string& column,
+                                const std::string& uri,
+                                const IvfPqIndexOptions& options = {});
+
+}  // namespace lance::arrow
@@ -26,6 +26,47 @@
 
 namespace lance::arrow {
 
+/// Distance metrics of the nearest neighbor search. Smaller distances are nearer.
+enum class DistanceMetric {
+  /// Squared L2 distance.
+  kL2,
+  /// `1 - cos(query, vector)`.
+  kCosine,
+  /// Negative dot product.
+  kDot,
+};
+
+/// Nearest neighbor query over a vector column.
+struct NearestNeighborQuery {
+  /// A `fixed_size_list<float>` or `list<float>` column.
+  std::string column;
+
+  /// The query vector.
+  std::vector<float> query;
+
+  /// Search several query vectors in one scan, instead of `query`. The neighbors of all the
+  /// queries are returned, query by query, with the position of their query in an extra
+  /// `query_id` column.
+  std::vector<std::vector<float>> queries;
+
+  /// The distance metric. The IVF-PQ index only supports L2.
+  DistanceMetric metric = DistanceMetric::kL2;
+
+  /// Number of neighbors to return.
+  int32_t k = 10;
+
+  /// The directory of an IVF-PQ index of the column, built by `BuildIvfPqIndex()`.
+  /// Search by scanning all the vectors if it is empty.
+  std::string index_uri;
+
+  /// Number of IVF partitions to scan.
+  int32_t nprobe = 1;
+
+  /// If set, search `k * refine_factor` candidates in the index, and re-rank them by their
+  /// exact distances.
+  std::optional<int32_t> refine_factor = std::nullopt;
+};
+
 /// \brief Lance Scanner Builder
 ///
 /// The main difference between ScannerBuilder and `::arrow::ScannerBuilder` is that
@@ -52,14 +93,26 @@ class ScannerBuilder final {
   /// Set limit to the dataset
   void Limit(int64_t limit, int64_t offset = 0);
 
+  /// Only scan the nearest neighbors of a query vector.
+  ///
+  /// The neighbors are returned in the order of their distances, with the distances in an extra
+  /// `score` column. The filter and the limit apply to the neighbors. Only the vector column is
+  /// scanned to search the neighbors; the projected and the filter columns are read for the
+  /// neighbors only.
+  void NearestNeighbors(const NearestNeighborQuery& query);
+
   ::arrow::Result<std::shared_ptr<::arrow::dataset::Scanner>> Finish() const;
 
  private:
+  /// Search the nearest neighbors, and scan them in memory.
+  ::arrow::Result<std::shared_ptr<::arrow::dataset::Scanner>> FinishNearestNeighbors() const;
+
   std::shared_ptr<::arrow::dataset::Dataset> dataset_;
   std::optional<std::vector<std::string>> columns_ = std::nullopt;
   ::arrow::compute::Expression filter_ = ::arrow::compute::literal(true);
   std::optional<int64_t> limit_ = std::nullopt;
   int64_t offset_ = 0;
+  std::optional<NearestNeighborQuery> nearest_neighbors_ = std::nullopt;
 };
 
 }  // namespace lance::arrow
\ No newline at end of file
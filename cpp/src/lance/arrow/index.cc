@@ -0,0 +1,46 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/arrow/index.h"
+
+#include <arrow/dataset/dataset.h>
+#include <arrow/filesystem/api.h>
+#include <fmt/format.h>
+
+#include "lance/index/ivf_pq.h"
+#include "lance/index/nearest_neighbors.h"
+
+namespace lance::arrow {
+
+::arrow::Status BuildIvfPqIndex(const std::shared_ptr<::arrow::dataset::Dataset>& dataset,
+                                const std::string& column,
+                                const std::string& uri,
+                                const IvfPqIndexOptions& options) {
+  ARROW_ASSIGN_OR_RAISE(auto readers, lance::index::OpenFragments(dataset));
+  ARROW_ASSIGN_OR_RAISE(auto vectors, lance::index::ReadVectors(readers, column));
+  if (vectors.row_ids.empty()) {
+    return ::arrow::Status::Invalid(fmt::format("Column {} has no vectors to index", column));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto index,
+                        lance::index::IvfPqIndex::Build(vectors.values.data(),
+                                                        vectors.row_ids.data(),
+                                                        vectors.row_ids.size(),
+                                                        vectors.dimension,
+                                                        options));
+  std::string path;
+  ARROW_ASSIGN_OR_RAISE(auto fs, ::arrow::fs::FileSystemFromUriOrPath(uri, &path));
+  return index->Write(fs, path);
+}
+
+}  // namespace lance::arrow
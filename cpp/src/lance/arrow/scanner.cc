@@ -16,15 +16,34 @@
 
 #include <arrow/dataset/dataset.h>
 #include <arrow/dataset/scanner.h>
+#include <arrow/filesystem/api.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "lance/arrow/file_lance.h"
 #include "lance/arrow/file_lance_ext.h"
+#include "lance/arrow/stl.h"
 #include "lance/format/schema.h"
+#include "lance/index/ivf_pq.h"
+#include "lance/index/nearest_neighbors.h"
+#include "lance/io/reader.h"
 
 namespace lance::arrow {
 
+namespace {
+
+/// The column of the distances of the nearest neighbors.
+constexpr char kScoreColumn[] = "score";
+
+/// The column of the positions of the queries, when searching multiple queries.
+constexpr char kQueryIdColumn[] = "query_id";
+
+}  // namespace
+
 ScannerBuilder::ScannerBuilder(std::shared_ptr<::arrow::dataset::Dataset> dataset)
     : dataset_(dataset) {}
 
@@ -37,10 +56,17 @@ void ScannerBuilder::Limit(int64_t limit, int64_t offset) {
   offset_ = offset;
 }
 
+void ScannerBuilder::NearestNeighbors(const NearestNeighborQuery& query) {
+  nearest_neighbors_ = query;
+}
+
 ::arrow::Result<std::shared_ptr<::arrow::dataset::Scanner>> ScannerBuilder::Finish() const {
   if (offset_ < 0) {
     return ::arrow::Status::Invalid("Offset is negative");
   }
+  if (nearest_neighbors_.has_value()) {
+    return FinishNearestNeighbors();
+  }
 
   auto builder = ::arrow::dataset::ScannerBuilder(dataset_);
   ARROW_RETURN_NOT_OK(builder.Filter(filter_));
@@ -93,4 +119,138 @@ void ScannerBuilder::Limit(int64_t limit, int64_t offset) {
   return scanner;
 }
 
+::arrow::Result<std::shared_ptr<::arrow::dataset::Scanner>>
+ScannerBuilder::FinishNearestNeighbors() const {
+  const auto& query = nearest_neighbors_.value();
+  if (query.k <= 0 || query.nprobe <= 0 || query.refine_factor.value_or(1) <= 0) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Invalid nearest neighbor query: k={}, nprobe={}, refine_factor={}",
+                    query.k,
+                    query.nprobe,
+                    query.refine_factor.value_or(1)));
+  }
+  for (auto name : {kQueryIdColumn, kScoreColumn}) {
+    if (dataset_->schema()->GetFieldIndex(name) >= 0) {
+      return ::arrow::Status::Invalid(fmt::format("Dataset already has a column named {}", name));
+    }
+  }
+  auto queries = query.queries.empty() ? std::vector<std::vector<float>>{query.query}
+                                        : query.queries;
+
+  ARROW_ASSIGN_OR_RAISE(auto readers, lance::index::OpenFragments(dataset_));
+  std::vector<std::vector<lance::index::Neighbor>> neighbors;
+  if (query.index_uri.empty()) {
+    ARROW_ASSIGN_OR_RAISE(
+        neighbors,
+        lance::index::SearchExact(readers, query.column, queries, query.k, query.metric));
+  } else {
+    if (query.metric != DistanceMetric::kL2) {
+      return ::arrow::Status::NotImplemented("IVF-PQ index only supports L2 distance");
+    }
+    std::string path;
+    ARROW_ASSIGN_OR_RAISE(auto fs, ::arrow::fs::FileSystemFromUriOrPath(query.index_uri, &path));
+    ARROW_ASSIGN_OR_RAISE(auto index, lance::index::IvfPqIndex::Open(fs, path));
+    for (auto& query_vector : queries) {
+      if (index->dimension() != static_cast<int32_t>(query_vector.size())) {
+        return ::arrow::Status::Invalid(fmt::format("Query vector has dimension {}, expected {}",
+                                                    query_vector.size(),
+                                                    index->dimension()));
+      }
+      auto num_candidates = query.k * query.refine_factor.value_or(1);
+      ARROW_ASSIGN_OR_RAISE(auto candidates,
+                            index->Search(query_vector.data(), num_candidates, query.nprobe));
+      if (query.refine_factor.has_value()) {
+        ARROW_ASSIGN_OR_RAISE(
+            candidates,
+            lance::index::Refine(readers, query.column, query_vector, candidates, query.k));
+      }
+      neighbors.emplace_back(std::move(candidates));
+    }
+  }
+
+  std::vector<int64_t> row_ids;
+  std::vector<int32_t> query_ids;
+  std::vector<float> scores;
+  for (std::size_t i = 0; i < neighbors.size(); i++) {
+    for (auto& neighbor : neighbors[i]) {
+      row_ids.emplace_back(neighbor.row_id);
+      query_ids.emplace_back(static_cast<int32_t>(i));
+      scores.emplace_back(neighbor.distance);
+    }
+  }
+  // Only read the projected columns and the filter columns of the neighbors.
+  std::optional<std::vector<std::string>> take_columns = columns_;
+  if (take_columns.has_value()) {
+    for (auto& ref : ::arrow::compute::FieldsInExpression(filter_)) {
+      if (ref.name() == nullptr) {
+        // Read all the columns for the nested references.
+        take_columns.reset();
+        break;
+      }
+      take_columns->emplace_back(*ref.name());
+    }
+  }
+  if (take_columns.has_value()) {
+    // The extra columns are added after the take.
+    std::erase_if(take_columns.value(), [](auto& name) {
+      return name == kQueryIdColumn || name == kScoreColumn;
+    });
+    // The batches are read in the column order of the dataset.
+    auto column_index = [&](const std::string& name) {
+      return dataset_->schema()->GetFieldIndex(name.substr(0, name.find('.')));
+    };
+    std::stable_sort(take_columns->begin(), take_columns->end(), [&](auto& lhs, auto& rhs) {
+      return column_index(lhs) < column_index(rhs);
+    });
+  }
+  auto schema = std::make_shared<lance::format::Schema>(dataset_->schema());
+  if (!readers.empty()) {
+    ARROW_ASSIGN_OR_RAISE(schema, readers[0]->schema().Project(*dataset_->schema()));
+  }
+  if (take_columns.has_value()) {
+    ARROW_ASSIGN_OR_RAISE(schema, schema->Project(take_columns.value()));
+  }
+  std::shared_ptr<::arrow::Table> table;
+  if (readers.empty()) {
+    ARROW_ASSIGN_OR_RAISE(table, ::arrow::Table::MakeEmpty(schema->ToArrow()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(table, lance::index::TakeRows(readers, *schema, row_ids));
+  }
+  std::vector<std::string> extra_columns;
+  if (!query.queries.empty()) {
+    ARROW_ASSIGN_OR_RAISE(auto query_id_arr, ToArray(query_ids));
+    ARROW_ASSIGN_OR_RAISE(
+        table,
+        table->AddColumn(table->num_columns(),
+                         ::arrow::field(kQueryIdColumn, ::arrow::int32()),
+                         std::make_shared<::arrow::ChunkedArray>(query_id_arr)));
+    extra_columns.emplace_back(kQueryIdColumn);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto score_arr, ToArray(scores));
+  ARROW_ASSIGN_OR_RAISE(
+      table,
+      table->AddColumn(table->num_columns(),
+                       ::arrow::field(kScoreColumn, ::arrow::float32()),
+                       std::make_shared<::arrow::ChunkedArray>(score_arr)));
+  extra_columns.emplace_back(kScoreColumn);
+
+  // Filter the neighbors in memory, keeping their order.
+  auto builder = ScannerBuilder(std::make_shared<::arrow::dataset::InMemoryDataset>(table));
+  builder.Filter(filter_);
+  ARROW_ASSIGN_OR_RAISE(auto scanner, builder.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto result, scanner->ToTable());
+  if (limit_.has_value() || offset_ > 0) {
+    result = result->Slice(offset_, limit_.value_or(result->num_rows()));
+  }
+
+  // Project the output columns after the filter, which may refer to the other columns.
+  builder = ScannerBuilder(std::make_shared<::arrow::dataset::InMemoryDataset>(result));
+  if (columns_.has_value()) {
+    auto columns = columns_.value();
+    columns.insert(columns.end(), extra_columns.begin(), extra_columns.end());
+    builder.Project(columns);
+  }
+  return builder.Finish();
+}
+
 }  // namespace lance::arrow
@@ -14,18 +14,33 @@
 
 #include "lance/arrow/scanner.h"
 
+#include <arrow/array/concatenate.h>
 #include <arrow/builder.h>
 #include <arrow/dataset/dataset.h>
+#include <arrow/dataset/discovery.h>
 #include <arrow/dataset/scanner.h>
+#include <arrow/filesystem/localfs.h>
 #include <arrow/table.h>
 #include <arrow/type.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <filesystem>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
 
+#include "lance/arrow/file_lance.h"
+#include "lance/arrow/index.h"
+#include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
+#include "lance/arrow/writer.h"
 
 auto nested_schema = ::arrow::schema({::arrow::field("pk", ::arrow::int32()),
                                       ::arrow::field("objects",
@@ -78,4 +93,229 @@ TEST_CASE("Build Scanner with nested struct") {
   CHECK(scanner->options()->batch_readahead == 1);
 
   fmt::print("Scanner Options: {}\n", scanner->options()->filter.ToString());
-}
\ No newline at end of file
+}
+
+namespace {
+
+/// Scan the nearest neighbors, and return the values of the "id" column.
+std::vector<int32_t> ScanNeighbors(const std::shared_ptr<::arrow::dataset::Dataset>& dataset,
+                                   const lance::arrow::NearestNeighborQuery& query,
+                                   std::shared_ptr<::arrow::Table>* result = nullptr) {
+  auto builder = lance::arrow::ScannerBuilder(dataset);
+  builder.NearestNeighbors(query);
+  builder.Project({"id"});
+  auto table = builder.Finish().ValueOrDie()->ToTable().ValueOrDie();
+  auto ids = std::static_pointer_cast<::arrow::Int32Array>(
+      ::arrow::Concatenate(table->GetColumnByName("id")->chunks()).ValueOrDie());
+  if (result != nullptr) {
+    *result = table;
+  }
+  return {ids->raw_values(), ids->raw_values() + ids->length()};
+}
+
+constexpr int32_t kDimension = 8;
+
+std::vector<float> RandomVectors(int64_t num_vectors) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> vectors(num_vectors * kDimension);
+  std::generate(vectors.begin(), vectors.end(), [&] { return dist(gen); });
+  return vectors;
+}
+
+/// Write the vectors into two lance files of three batches each, with an "id" column, and the
+/// vectors as a `fixed_size_list<float>` column "vec" and a `list<float>` column "list_vec".
+std::shared_ptr<::arrow::dataset::Dataset> MakeVectorDataset(const std::filesystem::path& dir,
+                                                             const std::vector<float>& vectors) {
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "data");
+  auto schema = ::arrow::schema(
+      {::arrow::field("id", ::arrow::int32()),
+       ::arrow::field("vec", ::arrow::fixed_size_list(::arrow::float32(), kDimension)),
+       ::arrow::field("list_vec", ::arrow::list(::arrow::float32()))});
+  auto num_rows = static_cast<int32_t>(vectors.size() / kDimension / 2);
+  for (int32_t file = 0; file < 2; file++) {
+    std::vector<int32_t> ids(num_rows);
+    std::iota(ids.begin(), ids.end(), file * num_rows);
+    auto values = lance::arrow::ToArray(std::vector<float>(
+                                            vectors.begin() + file * num_rows * kDimension,
+                                            vectors.begin() + (file + 1) * num_rows * kDimension))
+                      .ValueOrDie();
+    auto vec_arr = ::arrow::FixedSizeListArray::FromArrays(values, kDimension).ValueOrDie();
+    std::vector<int32_t> offsets(num_rows + 1);
+    std::generate(offsets.begin(), offsets.end(), [i = 0]() mutable { return kDimension * i++; });
+    auto list_arr =
+        ::arrow::ListArray::FromArrays(*lance::arrow::ToArray(offsets).ValueOrDie(), *values)
+            .ValueOrDie();
+    auto table = ::arrow::Table::Make(
+        schema, {lance::arrow::ToArray(ids).ValueOrDie(), vec_arr, list_arr});
+    auto third = num_rows / 3;
+    table = ::arrow::ConcatenateTables(
+                {table->Slice(0, third), table->Slice(third, third), table->Slice(2 * third)})
+                .ValueOrDie();
+    auto path = dir / "data" / (std::to_string(file) + ".lance");
+    auto sink = ::arrow::fs::LocalFileSystem().OpenOutputStream(path.string()).ValueOrDie();
+    CHECK(lance::arrow::WriteTable(*table, sink, "id").ok());
+    CHECK(sink->Close().ok());
+  }
+  return ::arrow::dataset::FileSystemDatasetFactory::Make(
+             "file://" + (dir / "data").string(),
+             std::shared_ptr<::arrow::dataset::FileFormat>(new lance::arrow::LanceFileFormat()),
+             ::arrow::dataset::FileSystemFactoryOptions())
+      .ValueOrDie()
+      ->Finish()
+      .ValueOrDie();
+}
+
+}  // namespace
+
+TEST_CASE("Scan nearest neighbors") {
+  auto dir = std::filesystem::temp_directory_path() / "scanner_test_nearest_neighbors";
+  auto vectors = RandomVectors(600);
+  auto dataset = MakeVectorDataset(dir, vectors);
+
+  lance::arrow::NearestNeighborQuery query;
+  query.column = "vec";
+  query.k = 5;
+  query.query = std::vector<float>(vectors.begin() + 423 * kDimension,
+                                   vectors.begin() + 424 * kDimension);
+
+  // Exact search.
+  std::shared_ptr<::arrow::Table> table;
+  auto expected = ScanNeighbors(dataset, query, &table);
+  CHECK(expected.size() == 5);
+  CHECK(expected[0] == 423);
+  CHECK(table->schema()->Equals(*::arrow::schema(
+      {::arrow::field("id", ::arrow::int32()), ::arrow::field("score", ::arrow::float32())})));
+  auto scores = std::static_pointer_cast<::arrow::FloatArray>(
+      ::arrow::Concatenate(table->GetColumnByName("score")->chunks()).ValueOrDie());
+  CHECK(scores->Value(0) == 0);
+  CHECK(std::is_sorted(scores->raw_values(), scores->raw_values() + scores->length()));
+
+  // Search with the index, and re-rank the candidates.
+  auto index_uri = (dir / "index").string();
+  lance::arrow::IvfPqIndexOptions options;
+  options.num_partitions = 4;
+  options.num_sub_vectors = 4;
+  CHECK(lance::arrow::BuildIvfPqIndex(dataset, "vec", index_uri, options).ok());
+  query.index_uri = index_uri;
+  query.nprobe = 4;
+  auto approximate = ScanNeighbors(dataset, query);
+  CHECK(approximate.size() == 5);
+  query.refine_factor = 20;
+  CHECK(ScanNeighbors(dataset, query) == expected);
+
+  // Filter and limit the neighbors.
+  auto builder = lance::arrow::ScannerBuilder(dataset);
+  builder.NearestNeighbors(query);
+  builder.Filter(::arrow::compute::not_equal(::arrow::compute::field_ref("id"),
+                                             ::arrow::compute::literal(expected[1])));
+  builder.Limit(2, 1);
+  table = builder.Finish().ValueOrDie()->ToTable().ValueOrDie();
+  auto ids = std::static_pointer_cast<::arrow::Int32Array>(
+      ::arrow::Concatenate(table->GetColumnByName("id")->chunks()).ValueOrDie());
+  CHECK(table->num_columns() == 4);
+  CHECK(ids->length() == 2);
+  CHECK(ids->Value(0) == expected[2]);
+  CHECK(ids->Value(1) == expected[3]);
+
+  // Filter by a column that is not projected, and by the scores.
+  builder = lance::arrow::ScannerBuilder(dataset);
+  builder.NearestNeighbors(query);
+  builder.Project({"vec"});
+  builder.Filter(::arrow::compute::and_(
+      ::arrow::compute::not_equal(::arrow::compute::field_ref("id"),
+                                  ::arrow::compute::literal(expected[1])),
+      ::arrow::compute::greater(::arrow::compute::field_ref("score"),
+                                ::arrow::compute::literal(0.0f))));
+  table = builder.Finish().ValueOrDie()->ToTable().ValueOrDie();
+  CHECK(table->schema()->field_names() == std::vector<std::string>({"vec", "score"}));
+  CHECK(table->num_rows() == 3);
+
+  // Invalid queries.
+  query.query.resize(kDimension + 1);
+  builder = lance::arrow::ScannerBuilder(dataset);
+  builder.NearestNeighbors(query);
+  CHECK(!builder.Finish().ok());
+  query.index_uri = "";
+  builder.NearestNeighbors(query);
+  CHECK(!builder.Finish().ok());
+  query.column = "id";
+  query.query.resize(kDimension);
+  builder.NearestNeighbors(query);
+  CHECK(!builder.Finish().ok());
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Scan nearest neighbors of multiple queries by each metric") {
+  auto dir = std::filesystem::temp_directory_path() / "scanner_test_nearest_neighbors_metrics";
+  auto vectors = RandomVectors(600);
+  auto dataset = MakeVectorDataset(dir, vectors);
+
+  const int32_t kTopK = 5;
+  std::vector<int32_t> query_rows{10, 450, 599};
+  lance::arrow::NearestNeighborQuery query;
+  query.k = kTopK;
+  for (auto row : query_rows) {
+    query.queries.emplace_back(vectors.begin() + row * kDimension,
+                               vectors.begin() + (row + 1) * kDimension);
+  }
+
+  for (auto metric : {lance::arrow::DistanceMetric::kL2,
+                      lance::arrow::DistanceMetric::kCosine,
+                      lance::arrow::DistanceMetric::kDot}) {
+    // Brute force, in double precision.
+    std::vector<int32_t> expected;
+    for (auto& query_vector : query.queries) {
+      std::vector<std::tuple<double, int32_t>> distances;
+      for (int32_t row = 0; row < 600; row++) {
+        double l2 = 0, dot = 0, norm = 0, query_norm = 0;
+        for (int32_t j = 0; j < kDimension; j++) {
+          double value = vectors[row * kDimension + j];
+          l2 += (query_vector[j] - value) * (query_vector[j] - value);
+          dot += query_vector[j] * value;
+          norm += value * value;
+          query_norm += query_vector[j] * query_vector[j];
+        }
+        if (metric == lance::arrow::DistanceMetric::kL2) {
+          distances.emplace_back(l2, row);
+        } else if (metric == lance::arrow::DistanceMetric::kCosine) {
+          distances.emplace_back(1 - dot / std::sqrt(norm * query_norm), row);
+        } else {
+          distances.emplace_back(-dot, row);
+        }
+      }
+      std::sort(distances.begin(), distances.end());
+      for (int32_t i = 0; i < kTopK; i++) {
+        expected.emplace_back(std::get<1>(distances[i]));
+      }
+    }
+
+    query.metric = metric;
+    for (auto column : {"vec", "list_vec"}) {
+      INFO("Metric " << static_cast<int>(metric) << " column " << column);
+      query.column = column;
+      std::shared_ptr<::arrow::Table> table;
+      CHECK(ScanNeighbors(dataset, query, &table) == expected);
+      auto expected_schema = ::arrow::schema({::arrow::field("id", ::arrow::int32()),
+                                              ::arrow::field("query_id", ::arrow::int32()),
+                                              ::arrow::field("score", ::arrow::float32())});
+      CHECK(table->schema()->Equals(*expected_schema));
+      auto query_ids = std::static_pointer_cast<::arrow::Int32Array>(
+          ::arrow::Concatenate(table->GetColumnByName("query_id")->chunks()).ValueOrDie());
+      for (int64_t i = 0; i < query_ids->length(); i++) {
+        CHECK(query_ids->Value(i) == i / kTopK);
+      }
+    }
+  }
+
+  // The index only supports L2.
+  query.column = "vec";
+  query.index_uri = (dir / "index").string();
+  auto builder = lance::arrow::ScannerBuilder(dataset);
+  builder.NearestNeighbors(query);
+  CHECK(!builder.Finish().ok());
+
+  std::filesystem::remove_all(dir);
+}
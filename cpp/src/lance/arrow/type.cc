@@ -18,6 +18,7 @@
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
 #include <arrow/util/string.h>
+#include <arrow/util/value_parsing.h>
 #include <fmt/format.h>
 
 #include <memory>
@@ -26,10 +27,95 @@
 
 namespace lance::arrow {
 
+namespace {
+
+std::string ToString(::arrow::TimeUnit::type unit) {
+  switch (unit) {
+    case ::arrow::TimeUnit::SECOND:
+      return "s";
+    case ::arrow::TimeUnit::MILLI:
+      return "ms";
+    case ::arrow::TimeUnit::MICRO:
+      return "us";
+    case ::arrow::TimeUnit::NANO:
+      return "ns";
+  }
+  return "";
+}
+
+::arrow::Result<::arrow::TimeUnit::type> ParseTimeUnit(::arrow::util::string_view unit) {
+  if (unit == "s") {
+    return ::arrow::TimeUnit::SECOND;
+  } else if (unit == "ms") {
+    return ::arrow::TimeUnit::MILLI;
+  } else if (unit == "us") {
+    return ::arrow::TimeUnit::MICRO;
+  } else if (unit == "ns") {
+    return ::arrow::TimeUnit::NANO;
+  }
+  return ::arrow::Status::Invalid(fmt::format("Invalid time unit: {}", unit.to_string()));
+}
+
+/// Parse "decimal128:precision:scale" / "decimal256:precision:scale".
+::arrow::Result<std::shared_ptr<::arrow::DataType>> ParseDecimalType(
+    ::arrow::util::string_view logical_type) {
+  auto components = ::arrow::internal::SplitString(logical_type, ':');
+  int32_t precision, scale;
+  if (components.size() != 3 ||
+      !::arrow::internal::ParseValue<::arrow::Int32Type>(
+          components[1].data(), components[1].size(), &precision) ||
+      !::arrow::internal::ParseValue<::arrow::Int32Type>(
+          components[2].data(), components[2].size(), &scale)) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Invalid decimal type string: {}", logical_type.to_string()));
+  }
+  if (components[0] == "decimal128") {
+    return ::arrow::Decimal128Type::Make(precision, scale);
+  }
+  return ::arrow::Decimal256Type::Make(precision, scale);
+}
+
+}  // namespace
+
 ::arrow::Result<std::string> ToLogicalType(std::shared_ptr<::arrow::DataType> dtype) {
-  if (is_list(dtype)) {
+  if (dtype->id() == ::arrow::Type::LIST) {
     auto list_type = std::reinterpret_pointer_cast<::arrow::ListType>(dtype);
     return is_struct(list_type->value_type()) ? "list.struct" : "list";
+  } else if (dtype->id() == ::arrow::Type::LARGE_LIST) {
+    auto list_type = std::reinterpret_pointer_cast<::arrow::LargeListType>(dtype);
+    return is_struct(list_type->value_type()) ? "large_list.struct" : "large_list";
+  } else if (is_map(dtype)) {
+    auto map_type = std::static_pointer_cast<::arrow::MapType>(dtype);
+    return map_type->keys_sorted() ? "map:sorted" : "map";
+  } else if (is_fixed_size_list(dtype)) {
+    auto list_type = std::reinterpret_pointer_cast<::arrow::FixedSizeListType>(dtype);
+    ARROW_ASSIGN_OR_RAISE(auto value_type, ToLogicalType(list_type->value_type()));
+    return fmt::format("fixed_size_list:{}:{}", value_type, list_type->list_size());
+  } else if (dtype->id() == ::arrow::Type::FIXED_SIZE_BINARY) {
+    auto binary_type = std::static_pointer_cast<::arrow::FixedSizeBinaryType>(dtype);
+    return fmt::format("fixed_size_binary:{}", binary_type->byte_width());
+  } else if (::arrow::is_decimal(dtype->id())) {
+    auto decimal_type = std::static_pointer_cast<::arrow::DecimalType>(dtype);
+    return fmt::format("{}:{}:{}",
+                       dtype->id() == ::arrow::Type::DECIMAL128 ? "decimal128" : "decimal256",
+                       decimal_type->precision(),
+                       decimal_type->scale());
+  } else if (dtype->id() == ::arrow::Type::DATE32) {
+    return "date32:day";
+  } else if (dtype->id() == ::arrow::Type::DATE64) {
+    return "date64:ms";
+  } else if (dtype->id() == ::arrow::Type::TIME32 || dtype->id() == ::arrow::Type::TIME64) {
+    auto time_type = std::static_pointer_cast<::arrow::TimeType>(dtype);
+    return fmt::format("{}:{}", dtype->name(), ToString(time_type->unit()));
+  } else if (dtype->id() == ::arrow::Type::DURATION) {
+    auto duration_type = std::static_pointer_cast<::arrow::DurationType>(dtype);
+    return fmt::format("duration:{}", ToString(duration_type->unit()));
+  } else if (dtype->id() == ::arrow::Type::TIMESTAMP) {
+    auto ts_type = std::static_pointer_cast<::arrow::TimestampType>(dtype);
+    if (ts_type->timezone().empty()) {
+      return fmt::format("timestamp:{}", ToString(ts_type->unit()));
+    }
+    return fmt::format("timestamp:{}:{}", ToString(ts_type->unit()), ts_type->timezone());
   } else if (is_struct(dtype)) {
     return "struct";
   } else if (::arrow::is_dictionary(dtype->id())) {
@@ -51,7 +137,7 @@ namespace lance::arrow {
   } else if (logical_type == "int8") {
     return ::arrow::int8();
   } else if (logical_type == "uint8") {
-    return ::arrow::utf8();
+    return ::arrow::uint8();
   } else if (logical_type == "int16") {
     return ::arrow::int16();
   } else if (logical_type == "uint16") {
@@ -72,6 +158,59 @@ namespace lance::arrow {
     return ::arrow::utf8();
   } else if (logical_type == "binary") {
     return ::arrow::binary();
+  } else if (logical_type == "large_string") {
+    return ::arrow::large_utf8();
+  } else if (logical_type == "large_binary") {
+    return ::arrow::large_binary();
+  } else if (logical_type.starts_with("fixed_size_list:")) {
+    auto components = ::arrow::internal::SplitString(logical_type, ':');
+    if (components.size() != 3) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Invalid fixed size list type string: {}", logical_type.to_string()));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto value_type, FromLogicalType(components[1]));
+    int32_t list_size;
+    if (!::arrow::internal::ParseValue<::arrow::Int32Type>(
+            components[2].data(), components[2].size(), &list_size)) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Invalid fixed size list type string: {}", logical_type.to_string()));
+    }
+    return ::arrow::fixed_size_list(value_type, list_size);
+  } else if (logical_type.starts_with("fixed_size_binary:")) {
+    auto components = ::arrow::internal::SplitString(logical_type, ':');
+    int32_t byte_width;
+    if (components.size() != 2 ||
+        !::arrow::internal::ParseValue<::arrow::Int32Type>(
+            components[1].data(), components[1].size(), &byte_width)) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Invalid fixed size binary type string: {}", logical_type.to_string()));
+    }
+    return ::arrow::fixed_size_binary(byte_width);
+  } else if (logical_type.starts_with("decimal128:") || logical_type.starts_with("decimal256:")) {
+    return ParseDecimalType(logical_type);
+  } else if (logical_type == "date32:day") {
+    return ::arrow::date32();
+  } else if (logical_type == "date64:ms") {
+    return ::arrow::date64();
+  } else if (logical_type.starts_with("time32:")) {
+    ARROW_ASSIGN_OR_RAISE(auto unit, ParseTimeUnit(logical_type.substr(7)));
+    return ::arrow::time32(unit);
+  } else if (logical_type.starts_with("time64:")) {
+    ARROW_ASSIGN_OR_RAISE(auto unit, ParseTimeUnit(logical_type.substr(7)));
+    return ::arrow::time64(unit);
+  } else if (logical_type.starts_with("duration:")) {
+    ARROW_ASSIGN_OR_RAISE(auto unit, ParseTimeUnit(logical_type.substr(9)));
+    return ::arrow::duration(unit);
+  } else if (logical_type.starts_with("timestamp:")) {
+    // "timestamp:unit[:timezone]". The timezone, i.e., "+08:00", may contain ':' itself.
+    auto spec = logical_type.substr(10);
+    auto pos = spec.find(':');
+    ARROW_ASSIGN_OR_RAISE(auto unit, ParseTimeUnit(spec.substr(0, pos)));
+    if (pos == ::arrow::util::string_view::npos) {
+      return ::arrow::timestamp(unit);
+    }
+    auto timezone = spec.substr(pos + 1);
+    return ::arrow::timestamp(unit, std::string(timezone.data(), timezone.size()));
   } else if (logical_type.starts_with("dict")) {
     auto components = ::arrow::internal::SplitString(logical_type, ':');
     if (components.size() != 4) {
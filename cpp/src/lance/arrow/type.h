@@ -54,6 +54,11 @@ inline auto is_list(const std::shared_ptr<::arrow::DataType>& dtype) {
   return dtype->id() == ::arrow::Type::LIST || dtype->id() == ::arrow::Type::LARGE_LIST;
 }
 
+/// Returns True if the data type is a fixed size list.
+inline bool is_fixed_size_list(const std::shared_ptr<::arrow::DataType>& dtype) {
+  return dtype->id() == ::arrow::Type::FIXED_SIZE_LIST;
+}
+
 /// Returns True if the data type is a struct.
 inline bool is_struct(const std::shared_ptr<::arrow::DataType>& dtype) {
   return dtype->id() == ::arrow::Type::STRUCT;
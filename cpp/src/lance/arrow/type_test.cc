@@ -18,6 +18,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using std::string;
@@ -37,4 +38,55 @@ TEST_CASE("Parse dictionary type") {
 
   actual = lance::arrow::FromLogicalType(logical_type).ValueOrDie();
   CHECK(dict_type->Equals(actual));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Parse fixed size list type") {
+  auto list_type = arrow::fixed_size_list(arrow::float32(), 512);
+  auto logical_type = lance::arrow::ToLogicalType(list_type).ValueOrDie();
+  CHECK(logical_type == "fixed_size_list:float:512");
+
+  auto actual = lance::arrow::FromLogicalType(logical_type).ValueOrDie();
+  CHECK(list_type->Equals(actual));
+
+  CHECK(!lance::arrow::FromLogicalType("fixed_size_list:float").ok());
+}
+
+TEST_CASE("Parse fixed size binary type") {
+  auto binary_type = arrow::fixed_size_binary(32);
+  auto logical_type = lance::arrow::ToLogicalType(binary_type).ValueOrDie();
+  CHECK(logical_type == "fixed_size_binary:32");
+
+  auto actual = lance::arrow::FromLogicalType(logical_type).ValueOrDie();
+  CHECK(binary_type->Equals(actual));
+
+  CHECK(!lance::arrow::FromLogicalType("fixed_size_binary:abc").ok());
+}
+
+TEST_CASE("Parse temporal and decimal types") {
+  auto decimal_type = arrow::decimal128(38, 10);
+  for (auto& [type, expected] :
+       vector<std::tuple<std::shared_ptr<arrow::DataType>, string>>{
+           {arrow::uint8(), "uint8"},
+           {arrow::date32(), "date32:day"},
+           {arrow::date64(), "date64:ms"},
+           {arrow::time32(arrow::TimeUnit::MILLI), "time32:ms"},
+           {arrow::time64(arrow::TimeUnit::NANO), "time64:ns"},
+           {arrow::duration(arrow::TimeUnit::SECOND), "duration:s"},
+           {arrow::timestamp(arrow::TimeUnit::MICRO), "timestamp:us"},
+           {arrow::timestamp(arrow::TimeUnit::MILLI, "+08:00"), "timestamp:ms:+08:00"},
+           {arrow::timestamp(arrow::TimeUnit::NANO, "America/New_York"),
+            "timestamp:ns:America/New_York"},
+           {decimal_type, "decimal128:38:10"},
+           {arrow::decimal256(76, 2), "decimal256:76:2"},
+       }) {
+    auto logical_type = lance::arrow::ToLogicalType(type).ValueOrDie();
+    CHECK(logical_type == expected);
+
+    auto actual = lance::arrow::FromLogicalType(logical_type).ValueOrDie();
+    INFO("Expected: " << type->ToString() << " Actual: " << actual->ToString());
+    CHECK(type->Equals(actual));
+  }
+
+  CHECK(!lance::arrow::FromLogicalType("timestamp:minute").ok());
+  CHECK(!lance::arrow::FromLogicalType("decimal128:38").ok());
+}
@@ -14,9 +14,14 @@
 
 #include "lance/arrow/utils.h"
 
+#include <arrow/array/util.h>
+#include <arrow/buffer.h>
 #include <arrow/result.h>
+#include <arrow/scalar.h>
+#include <arrow/type_traits.h>
 #include <fmt/format.h>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -103,4 +108,47 @@ namespace lance::arrow {
   return ::arrow::StructArray::Make(arrays, names);
 }
 
-}  // namespace lance::arrow
\ No newline at end of file
+std::optional<int> ByteWidth(const ::arrow::DataType& type) {
+  auto fixed_width = dynamic_cast<const ::arrow::FixedWidthType*>(&type);
+  if (fixed_width == nullptr || type.id() == ::arrow::Type::DICTIONARY ||
+      fixed_width->bit_width() % 8 != 0) {
+    return std::nullopt;
+  }
+  return fixed_width->bit_width() / 8;
+}
+
+::arrow::Result<std::string> ScalarToBytes(const ::arrow::Scalar& scalar) {
+  if (!scalar.is_valid) {
+    return ::arrow::Status::Invalid("ScalarToBytes: scalar is null");
+  }
+  if (::arrow::is_base_binary_like(scalar.type->id())) {
+    return static_cast<const ::arrow::BaseBinaryScalar&>(scalar).value->ToString();
+  }
+  auto byte_width = ByteWidth(*scalar.type);
+  if (!byte_width.has_value()) {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("ScalarToBytes: unsupported type {}", scalar.type->ToString()));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto arr, ::arrow::MakeArrayFromScalar(scalar, 1));
+  auto& data = arr->data();
+  return std::string(
+      reinterpret_cast<const char*>(data->buffers[1]->data() + data->offset * *byte_width),
+      *byte_width);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> ScalarFromBytes(
+    const std::shared_ptr<::arrow::DataType>& type, const std::string& bytes) {
+  auto buf = ::arrow::Buffer::FromString(bytes);
+  if (::arrow::is_base_binary_like(type->id())) {
+    return ::arrow::MakeScalar(type, buf);
+  }
+  auto byte_width = ByteWidth(*type);
+  if (!byte_width.has_value() || static_cast<int64_t>(bytes.size()) != *byte_width) {
+    return ::arrow::Status::Invalid(fmt::format(
+        "ScalarFromBytes: can not read {} bytes as {}", bytes.size(), type->ToString()));
+  }
+  auto arr = ::arrow::MakeArray(::arrow::ArrayData::Make(type, 1, {nullptr, buf}, 0));
+  return arr->GetScalar(0);
+}
+
+}  // namespace lance::arrow
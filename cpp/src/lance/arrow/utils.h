@@ -19,6 +19,8 @@
 #include <arrow/result.h>
 
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace lance::arrow {
 
@@ -33,4 +35,17 @@ namespace lance::arrow {
     const std::shared_ptr<::arrow::StructArray>& rhs,
     ::arrow::MemoryPool* pool = ::arrow::default_memory_pool());
 
+/// Returns the byte width of a byte-aligned fixed-width type, or `std::nullopt` otherwise.
+std::optional<int> ByteWidth(const ::arrow::DataType& type);
+
+/// Serialize a scalar to the bytes of its plain encoding.
+///
+/// \param scalar a valid scalar of a byte-aligned fixed-width type, or a string / binary type.
+/// \return the little-endian bytes of a fixed-width value, or the bytes of a binary value.
+::arrow::Result<std::string> ScalarToBytes(const ::arrow::Scalar& scalar);
+
+/// Deserialize a scalar from the bytes of its plain encoding. The inverse of `ScalarToBytes()`.
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> ScalarFromBytes(
+    const std::shared_ptr<::arrow::DataType>& type, const std::string& bytes);
+
 }  // namespace lance::arrow
@@ -15,10 +15,14 @@
 #include "lance/arrow/utils.h"
 
 #include <arrow/builder.h>
+#include <arrow/scalar.h>
 #include <arrow/type.h>
 #include <fmt/format.h>
 
 #include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
@@ -92,4 +96,39 @@ TEST_CASE("Merge nested structs") {
 
   INFO("Actual data: " << points->ToString() << " Expected: " << expected_arr->ToString());
   CHECK(points->Equals(expected_arr));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Serialize scalars to bytes") {
+  for (auto& scalar : std::vector<std::shared_ptr<::arrow::Scalar>>{
+           std::make_shared<::arrow::Int32Scalar>(-42),
+           std::make_shared<::arrow::DoubleScalar>(3.25),
+           std::make_shared<::arrow::UInt8Scalar>(200),
+           std::make_shared<::arrow::TimestampScalar>(1'660'000'000'000,
+                                                      ::arrow::timestamp(::arrow::TimeUnit::MILLI)),
+           std::make_shared<::arrow::Decimal128Scalar>(::arrow::Decimal128(-12345),
+                                                       ::arrow::decimal128(10, 2)),
+           std::make_shared<::arrow::StringScalar>("lance"),
+           std::make_shared<::arrow::LargeBinaryScalar>(::arrow::Buffer::FromString("\x01\x02")),
+       }) {
+    INFO("Scalar: " << scalar->ToString());
+    auto bytes = lance::arrow::ScalarToBytes(*scalar).ValueOrDie();
+    auto actual = lance::arrow::ScalarFromBytes(scalar->type, bytes).ValueOrDie();
+    CHECK(actual->Equals(*scalar));
+  }
+  CHECK(lance::arrow::ScalarToBytes(::arrow::Int32Scalar(7)).ValueOrDie() ==
+        std::string("\x07\x00\x00\x00", 4));
+
+  CHECK(!lance::arrow::ScalarToBytes(::arrow::BooleanScalar(true)).ok());
+  CHECK(!lance::arrow::ScalarToBytes(*::arrow::MakeNullScalar(::arrow::int32())).ok());
+  CHECK(!lance::arrow::ScalarFromBytes(::arrow::int64(), "abc").ok());
+}
+
+TEST_CASE("Byte width of fixed-width types") {
+  CHECK(lance::arrow::ByteWidth(*::arrow::int16()) == 2);
+  CHECK(lance::arrow::ByteWidth(*::arrow::float64()) == 8);
+  CHECK(lance::arrow::ByteWidth(*::arrow::fixed_size_binary(12)) == 12);
+  CHECK(!lance::arrow::ByteWidth(*::arrow::boolean()).has_value());
+  CHECK(!lance::arrow::ByteWidth(*::arrow::utf8()).has_value());
+  auto dict_type = ::arrow::dictionary(::arrow::int8(), ::arrow::utf8());
+  CHECK(!lance::arrow::ByteWidth(*dict_type).has_value());
+}
@@ -15,17 +15,22 @@
 #include "lance/arrow/writer.h"
 
 #include <arrow/builder.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/api.h>
 #include <arrow/table.h>
 #include <arrow/type.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
 #include <catch2/catch_test_macros.hpp>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <vector>
 
 #include "lance/arrow/reader.h"
+#include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
 #include "lance/io/reader.h"
 
@@ -172,4 +177,119 @@ TEST_CASE("Write dictionary type") {
 
   auto actual_table = reader->ReadTable().ValueOrDie();
   CHECK(table->Equals(*actual_table));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Write dictionaries that change across batches") {
+  auto make_chunk = [](const std::shared_ptr<::arrow::DataType>& type,
+                       const std::shared_ptr<::arrow::Array>& dict,
+                       const std::vector<int8_t>& indices) {
+    ::arrow::Int8Builder builder;
+    CHECK(builder.AppendValues(indices).ok());
+    return ::arrow::DictionaryArray::FromArrays(type, builder.Finish().ValueOrDie(), dict)
+        .ValueOrDie();
+  };
+
+  auto check_round_trip = [](const std::shared_ptr<::arrow::DataType>& type,
+                             const ::arrow::ArrayVector& chunks,
+                             const std::shared_ptr<::arrow::Array>& expected_dict) {
+    auto schema = arrow::schema({arrow::field("label", type)});
+    auto table =
+        arrow::Table::Make(schema, {std::make_shared<::arrow::ChunkedArray>(chunks)});
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    CHECK(lance::arrow::WriteTable(*table, sink, "label").ok());
+
+    auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+    auto reader = FileReader::Make(infile).ValueOrDie();
+    CHECK(reader->num_batches() == 2);
+    auto actual = reader->ReadTable().ValueOrDie()->column(0);
+    // All batches share the file-level dictionary.
+    for (auto& chunk : actual->chunks()) {
+      auto dict_arr = std::static_pointer_cast<::arrow::DictionaryArray>(chunk);
+      INFO("Dictionary: " << dict_arr->dictionary()->ToString());
+      CHECK(dict_arr->dictionary()->Equals(expected_dict));
+    }
+    auto value_type = std::static_pointer_cast<::arrow::DictionaryType>(type)->value_type();
+    auto expected_values = ::arrow::compute::Cast(table->column(0), value_type).ValueOrDie();
+    auto actual_values = ::arrow::compute::Cast(actual, value_type).ValueOrDie();
+    CHECK(actual_values.chunked_array()->Equals(expected_values.chunked_array()));
+  };
+
+  SECTION("String dictionary") {
+    auto type = ::arrow::dictionary(arrow::int8(), arrow::utf8());
+    auto dict1 = lance::arrow::ToArray({"cat", "dog"}).ValueOrDie();
+    auto dict2 = lance::arrow::ToArray({"person", "cat", "bird"}).ValueOrDie();
+    check_round_trip(type,
+                     {make_chunk(type, dict1, {0, 1, 0}), make_chunk(type, dict2, {2, 0, 1, 1})},
+                     lance::arrow::ToArray({"cat", "dog", "person", "bird"}).ValueOrDie());
+  }
+
+  SECTION("Int64 dictionary") {
+    auto type = ::arrow::dictionary(arrow::int8(), arrow::int64());
+    auto dict1 = lance::arrow::ToArray<int64_t>({10, 20}).ValueOrDie();
+    auto dict2 = lance::arrow::ToArray<int64_t>({30, 10}).ValueOrDie();
+    check_round_trip(type,
+                     {make_chunk(type, dict1, {1, 1, 0}), make_chunk(type, dict2, {0, 1})},
+                     lance::arrow::ToArray<int64_t>({10, 20, 30}).ValueOrDie());
+  }
+}
+
+TEST_CASE("Dictionary overflows the index type") {
+  auto type = ::arrow::dictionary(arrow::int8(), arrow::int32());
+  ::arrow::ArrayVector chunks;
+  for (int32_t batch = 0; batch < 2; batch++) {
+    std::vector<int32_t> values(100);
+    std::iota(values.begin(), values.end(), batch * 100);
+    ::arrow::Int8Builder builder;
+    for (int8_t i = 0; i < 100; i++) {
+      CHECK(builder.Append(i).ok());
+    }
+    auto dict = lance::arrow::ToArray(values).ValueOrDie();
+    chunks.emplace_back(
+        ::arrow::DictionaryArray::FromArrays(type, builder.Finish().ValueOrDie(), dict)
+            .ValueOrDie());
+  }
+  auto schema = arrow::schema({arrow::field("label", type)});
+  auto table = arrow::Table::Make(schema, {std::make_shared<::arrow::ChunkedArray>(chunks)});
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto status = lance::arrow::WriteTable(*table, sink, "label");
+  INFO("Status: " << status);
+  CHECK(status.IsCapacityError());
+}
+
+TEST_CASE("Large list values overflow the page") {
+  // The values buffer is never read, because the writer checks the offsets first.
+  int64_t num_values = int64_t{std::numeric_limits<int32_t>::max()} + 1;
+  auto offsets = ::arrow::Buffer::FromVector(std::vector<int64_t>{0, num_values});
+  auto values = std::make_shared<::arrow::UInt8Array>(
+      num_values, ::arrow::AllocateBuffer(1).ValueOrDie());
+  auto type = ::arrow::large_list(::arrow::uint8());
+  auto arr = std::make_shared<::arrow::LargeListArray>(type, 1, offsets, values);
+  auto schema = arrow::schema({arrow::field("frames", type)});
+  auto table = arrow::Table::Make(schema, {arr});
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto status = lance::arrow::WriteTable(*table, sink, "");
+  INFO("Status: " << status);
+  CHECK(status.IsCapacityError());
+}
+
+TEST_CASE("Write with a primary key that can not be indexed") {
+  ::arrow::TimestampBuilder builder(::arrow::timestamp(::arrow::TimeUnit::MICRO),
+                                    ::arrow::default_memory_pool());
+  CHECK(builder.AppendValues({1000, 3000, 2000}).ok());
+  auto schema = arrow::schema({arrow::field("ts", builder.type())});
+  auto table = arrow::Table::Make(schema, {builder.Finish().ValueOrDie()});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "ts").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = FileReader::Make(infile).ValueOrDie();
+  CHECK(reader->primary_key() == "ts");
+  CHECK(table->Equals(*reader->ReadTable().ValueOrDie()));
+
+  // The primary key is recorded, without an index.
+  auto lance_reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(lance_reader->Open().ok());
+  CHECK(lance_reader->metadata().primary_key_index_position() == 0);
+  CHECK(lance_reader->primary_key_index() == nullptr);
+}
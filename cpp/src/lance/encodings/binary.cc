@@ -16,12 +16,16 @@
 
 #include <arrow/array.h>
 #include <arrow/array/array_binary.h>
+#include <arrow/buffer.h>
 #include <arrow/result.h>
 #include <arrow/status.h>
 
+#include <limits>
 #include <memory>
 #include <vector>
 
+#include "lance/encodings/kernels.h"
+
 using arrow::Result;
 using arrow::Status;
 using std::shared_ptr;
@@ -33,15 +37,22 @@ VarBinaryEncoder::VarBinaryEncoder(std::shared_ptr<::arrow::io::OutputStream> ou
     : Encoder(out) {}
 
 Result<int64_t> VarBinaryEncoder::Write(const std::shared_ptr<::arrow::Array> data) {
+  if (::arrow::is_large_binary_like(data->type_id())) {
+    return WriteValues(*std::static_pointer_cast<::arrow::LargeBinaryArray>(data));
+  }
+  return WriteValues(*std::static_pointer_cast<::arrow::BinaryArray>(data));
+}
+
+template <typename ArrayType>
+Result<int64_t> VarBinaryEncoder::WriteValues(const ArrayType& arr) {
   ARROW_ASSIGN_OR_RAISE(auto start_offset, out_->Tell());
-  auto arr = std::static_pointer_cast<::arrow::BinaryArray>(data);
-  ARROW_RETURN_NOT_OK(out_->Write(arr->value_data()));
+  ARROW_RETURN_NOT_OK(out_->Write(arr.value_data()));
 
   ARROW_ASSIGN_OR_RAISE(auto offsets_position, out_->Tell());
   offsetBuilder_.Reset();
-  assert(arr->length() > 0);
-  for (int64_t i = 0; i < arr->length(); ++i) {
-    ARROW_RETURN_NOT_OK(offsetBuilder_.Append(start_offset + arr->value_offset(i)));
+  assert(arr.length() > 0);
+  for (int64_t i = 0; i < arr.length(); ++i) {
+    ARROW_RETURN_NOT_OK(offsetBuilder_.Append(start_offset + arr.value_offset(i)));
   }
   ARROW_RETURN_NOT_OK(offsetBuilder_.Append(offsets_position));
   ARROW_RETURN_NOT_OK(offsetBuilder_.Finish(&offsetsArr));
@@ -49,4 +60,35 @@ Result<int64_t> VarBinaryEncoder::Write(const std::shared_ptr<::arrow::Array> da
   return offsets_position;
 }
 
+VarBinary32Encoder::VarBinary32Encoder(std::shared_ptr<::arrow::io::OutputStream> out) noexcept
+    : Encoder(out) {}
+
+Result<int64_t> VarBinary32Encoder::Write(const std::shared_ptr<::arrow::Array> data) {
+  auto arr = std::static_pointer_cast<::arrow::BinaryArray>(data);
+  if (arr->total_values_length() > std::numeric_limits<int32_t>::max()) {
+    return Status::CapacityError("VarBinary32Encoder: page values exceed 2GB");
+  }
+  ARROW_ASSIGN_OR_RAISE(auto offsets_position, out_->Tell());
+  if (arr->length() == 0) {
+    int32_t zero = 0;
+    ARROW_RETURN_NOT_OK(out_->Write(&zero, sizeof(zero)));
+    return offsets_position;
+  }
+  auto start_offset = arr->value_offset(0);
+  auto num_offsets = arr->length() + 1;
+  if (start_offset == 0) {
+    ARROW_RETURN_NOT_OK(out_->Write(arr->raw_value_offsets(), num_offsets * sizeof(int32_t)));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(auto offsets, ::arrow::AllocateBuffer(num_offsets * sizeof(int32_t)));
+    kernels::RebaseOffsets(arr->raw_value_offsets(),
+                           num_offsets,
+                           start_offset,
+                           reinterpret_cast<int32_t*>(offsets->mutable_data()));
+    ARROW_RETURN_NOT_OK(out_->Write(offsets->data(), offsets->size()));
+  }
+  ARROW_RETURN_NOT_OK(
+      out_->Write(arr->value_data()->data() + start_offset, arr->total_values_length()));
+  return offsets_position;
+}
+
 }  // namespace lance::encodings
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "lance/encodings/encoder.h"
+#include "lance/encodings/kernels.h"
 #include "lance/format/format.h"
 
 namespace lance::encodings {
@@ -58,11 +59,43 @@ class VarBinaryEncoder : public Encoder {
   std::string ToString() const override { return "Encoder(type=VarBinary)"; }
 
  private:
+  /// Write a binary or large binary array.
+  template <typename ArrayType>
+  ::arrow::Result<int64_t> WriteValues(const ArrayType& arr);
+
   ::arrow::TypeTraits<OffsetType>::BuilderType offsetBuilder_;
   std::shared_ptr<::arrow::TypeTraits<OffsetType>::ArrayType> offsetsArr;
 };
 
+/// Var-length Binary Encoding with page-relative int32 offsets, for pages smaller than 2GB.
+///
+/// Layout:
+///
+/// |offset0|offset1|...|offsetN|
+/// |value1|value2|...|valueN|
+///
+/// The offsets are int32 values relative to the first value (`offset0 = 0`), so that they can
+/// be used as the offsets of an arrow array without conversion. It returns the position of the
+/// offsets.
+class VarBinary32Encoder : public Encoder {
+ public:
+  explicit VarBinary32Encoder(std::shared_ptr<::arrow::io::OutputStream> out) noexcept;
+
+  virtual ~VarBinary32Encoder() = default;
+
+  /// Write an Array, and returns the position of the offsets.
+  ///
+  /// Returns `Status::CapacityError` if the values of the page are larger than 2GB.
+  ::arrow::Result<int64_t> Write(const std::shared_ptr<::arrow::Array> arr) override;
+
+  /// Debug string.
+  std::string ToString() const override { return "Encoder(type=VarBinary32)"; }
+};
+
 /// Decode for Var-length binary encoding.
+///
+/// The int64 file positions are rebased into the offsets of `T`, int32 for string / binary and
+/// int64 for large_string / large_binary.
 template <ArrowType T>
 class VarBinaryDecoder : public Decoder {
  public:
@@ -125,18 +158,15 @@ template <ArrowType T>
       *length + 1, *offsets_buf);
   auto start_offset = positions->Value(0);
 
-  ::arrow::Int32Builder builder;
-  for (int64_t i = 0; i < positions->length(); ++i) {
-    ARROW_RETURN_NOT_OK(builder.Append(static_cast<int32_t>(positions->Value(i) - start_offset)));
-  }
-  auto value_offsets_buf = builder.Finish();
-  if (!value_offsets_buf.ok()) {
-    return value_offsets_buf.status();
-  }
-  auto value_offsets = std::static_pointer_cast<::arrow::Int32Array>(*value_offsets_buf);
+  using ValueOffsetCType = typename T::offset_type;
+  ARROW_ASSIGN_OR_RAISE(auto value_offsets,
+                        ::arrow::AllocateBuffer((*length + 1) * sizeof(ValueOffsetCType)));
+  auto src = positions->raw_values();
+  auto dst = reinterpret_cast<ValueOffsetCType*>(value_offsets->mutable_data());
+  kernels::RebaseOffsets(src, *length + 1, start_offset, dst);
   auto read_length = positions->Value(positions->length() - 1) - start_offset;
   ARROW_ASSIGN_OR_RAISE(auto data_buf, infile_->ReadAt(start_offset, read_length));
-  return std::make_shared<ArrayType>(*length, value_offsets->values(), data_buf);
+  return std::make_shared<ArrayType>(*length, std::move(value_offsets), data_buf);
 }
 
 template <ArrowType T>
@@ -155,4 +185,91 @@ template <ArrowType T>
   return builder.Finish();
 }
 
+/// Decoder for var-length binary encoding with page-relative int32 offsets.
+template <ArrowType T>
+class VarBinary32Decoder : public Decoder {
+ public:
+  using Decoder::Decoder;
+
+  virtual ~VarBinary32Decoder() = default;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  /// Read the values in `[start, start + length)`.
+  ///
+  /// The offsets read from the file are used as is if `start == 0`, or rebased once otherwise.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+ private:
+  using ArrayType = typename ::arrow::TypeTraits<T>::ArrayType;
+
+  /// File position of the first value.
+  int64_t values_position() const {
+    return position_ + (static_cast<int64_t>(length_) + 1) * sizeof(int32_t);
+  }
+};
+
+template <ArrowType T>
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> VarBinary32Decoder<T>::GetScalar(
+    int64_t idx) const {
+  int32_t offsets[2];
+  ARROW_RETURN_NOT_OK(infile_->ReadAt(position_ + idx * sizeof(int32_t), sizeof(offsets), offsets));
+  ARROW_ASSIGN_OR_RAISE(auto buf,
+                        infile_->ReadAt(values_position() + offsets[0], offsets[1] - offsets[0]));
+  return std::make_shared<typename ::arrow::TypeTraits<T>::ScalarType>(buf);
+}
+
+template <ArrowType T>
+::arrow::Result<std::shared_ptr<::arrow::Array>> VarBinary32Decoder<T>::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  if (!length.has_value()) {
+    length = length_ - start;
+  }
+  if (start + *length > length_) {
+    return ::arrow::Status::IndexError(fmt::format(
+        "VarBinary32Decoder::ToArray: out of range: start={} length={} page_length={}\n",
+        start,
+        *length,
+        length_));
+  }
+  ARROW_ASSIGN_OR_RAISE(std::shared_ptr<::arrow::Buffer> offsets_buf,
+                        infile_->ReadAt(position_ + start * sizeof(int32_t),
+                                        (*length + 1) * sizeof(int32_t)));
+  auto offsets = reinterpret_cast<const int32_t*>(offsets_buf->data());
+  auto start_offset = offsets[0];
+  ARROW_ASSIGN_OR_RAISE(
+      auto data_buf,
+      infile_->ReadAt(values_position() + start_offset, offsets[*length] - start_offset));
+  if (start_offset != 0) {
+    ARROW_ASSIGN_OR_RAISE(auto rebased, ::arrow::AllocateBuffer(offsets_buf->size()));
+    auto dst = reinterpret_cast<int32_t*>(rebased->mutable_data());
+    kernels::RebaseOffsets(offsets, *length + 1, start_offset, dst);
+    offsets_buf = std::move(rebased);
+  }
+  return std::make_shared<ArrayType>(*length, offsets_buf, data_buf);
+}
+
+template <ArrowType T>
+::arrow::Result<std::shared_ptr<::arrow::Array>> VarBinary32Decoder<T>::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  if (indices->length() == 0) {
+    return ::arrow::Status::Invalid("VarBinary32Decoder::Take: Indices array is not valid");
+  }
+  // Read the range covering all the indices with two I/Os, like PlainDecoder::Take.
+  int32_t start = indices->Value(0);
+  int32_t length = indices->Value(indices->length() - 1) - start + 1;
+  ARROW_ASSIGN_OR_RAISE(auto range, ToArray(start, length));
+  auto values = std::static_pointer_cast<ArrayType>(range);
+  typename ::arrow::TypeTraits<T>::BuilderType builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(indices->length()));
+  for (int64_t i = 0; i < indices->length(); i++) {
+    ARROW_RETURN_NOT_OK(builder.Append(values->GetView(indices->Value(i) - start)));
+  }
+  return builder.Finish();
+}
+
 }  // namespace lance::encodings
\ No newline at end of file
@@ -101,4 +101,38 @@ TEST_CASE("Take") {
   auto actual = decoder.Take(indices).ValueOrDie();
   auto expected = lance::arrow::ToArray({"5", "10", "20"}).ValueOrDie();
   CHECK(expected->Equals(actual));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Write binary with int32 offsets") {
+  std::vector<std::string> words;
+  for (int i = 0; i < 100; i++) {
+    words.emplace_back(fmt::format("word-{}", i));
+  }
+  auto arr = lance::arrow::ToArray(words).ValueOrDie();
+  // Sliced array, to check that the offsets are rebased to the first value.
+  auto sliced = std::static_pointer_cast<StringArray>(arr->Slice(10, 80));
+
+  auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  lance::encodings::VarBinary32Encoder encoder(out);
+  auto offset = encoder.Write(sliced).ValueOrDie();
+  // 4 bytes per offset.
+  CHECK(out->Tell().ValueOrDie() - offset ==
+        static_cast<int64_t>(81 * sizeof(int32_t) + sliced->total_values_length()));
+  auto infile = make_shared<arrow::io::BufferReader>(out->Finish().ValueOrDie());
+
+  lance::encodings::VarBinary32Decoder<::arrow::StringType> decoder(infile, ::arrow::utf8());
+  decoder.Reset(offset, 80);
+  auto actual = decoder.ToArray().ValueOrDie();
+  CHECK(sliced->Equals(actual));
+  CHECK(actual->ValidateFull().ok());
+
+  auto slice = decoder.ToArray(25, 10).ValueOrDie();
+  CHECK(sliced->Slice(25, 10)->Equals(slice));
+  CHECK(slice->ValidateFull().ok());
+
+  CHECK(decoder.GetScalar(5).ValueOrDie()->Equals(::arrow::StringScalar("word-15")));
+
+  auto indices = lance::arrow::ToArray({5, 10, 79}).ValueOrDie();
+  auto expected = lance::arrow::ToArray({"word-15", "word-20", "word-89"}).ValueOrDie();
+  CHECK(expected->Equals(decoder.Take(indices).ValueOrDie()));
+}
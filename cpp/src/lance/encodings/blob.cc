@@ -0,0 +1,216 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/blob.h"
+
+#include <arrow/scalar.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace lance::encodings {
+
+namespace {
+
+/// Size of the descriptor of one blob: `position:int64` and `length:int64`.
+constexpr int64_t kDescriptorSize = 2 * sizeof(int64_t);
+
+/// Read blobs with one I/O if the gap between them is not larger than this.
+constexpr int64_t kBlobCoalesceGap = 8 * 1024;
+
+/// Do not coalesce blobs into one I/O larger than this.
+constexpr int64_t kBlobCoalesceMaxSize = 64 * 1024 * 1024;
+
+}  // namespace
+
+BlobHandle::BlobHandle(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                       int64_t position,
+                       int64_t length) noexcept
+    : infile_(std::move(infile)), position_(position), length_(length) {}
+
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> BlobHandle::Read() const {
+  return infile_->ReadAt(position_, length_);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> BlobHandle::ReadRange(int64_t offset,
+                                                                        int64_t length) const {
+  if (offset < 0 || length < 0 || offset + length > length_) {
+    return ::arrow::Status::IndexError(fmt::format(
+        "BlobHandle::ReadRange: out of range: offset={}, length={}, blob_length={}",
+        offset,
+        length,
+        length_));
+  }
+  return infile_->ReadAt(position_ + offset, length);
+}
+
+::arrow::Result<std::vector<std::shared_ptr<::arrow::Buffer>>> ReadBlobs(
+    const std::vector<std::optional<BlobHandle>>& blobs) {
+  std::vector<std::shared_ptr<::arrow::Buffer>> buffers(blobs.size());
+  std::vector<size_t> order;
+  for (size_t i = 0; i < blobs.size(); i++) {
+    if (blobs[i].has_value()) {
+      order.emplace_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&blobs](auto a, auto b) {
+    return std::make_tuple(blobs[a]->file().get(), blobs[a]->position()) <
+           std::make_tuple(blobs[b]->file().get(), blobs[b]->position());
+  });
+  // Coalesce the sorted blobs into ranges, and slice the blobs out of each range.
+  size_t begin = 0;
+  while (begin < order.size()) {
+    auto& first = *blobs[order[begin]];
+    auto range_start = first.position();
+    auto range_end = first.position() + first.length();
+    size_t end = begin + 1;
+    for (; end < order.size(); end++) {
+      auto& blob = *blobs[order[end]];
+      auto blob_end = std::max(range_end, blob.position() + blob.length());
+      if (blob.file() != first.file() || blob.position() - range_end > kBlobCoalesceGap ||
+          blob_end - range_start > kBlobCoalesceMaxSize) {
+        break;
+      }
+      range_end = blob_end;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto range, first.file()->ReadAt(range_start, range_end - range_start));
+    for (auto i = begin; i < end; i++) {
+      auto& blob = *blobs[order[i]];
+      buffers[order[i]] = ::arrow::SliceBuffer(range, blob.position() - range_start, blob.length());
+    }
+    begin = end;
+  }
+  return buffers;
+}
+
+BlobEncoder::BlobEncoder(std::shared_ptr<::arrow::io::OutputStream> out) : Encoder(out) {}
+
+::arrow::Result<int64_t> BlobEncoder::Write(std::shared_ptr<::arrow::Array> data) {
+  if (data->type_id() != ::arrow::Type::STRING && data->type_id() != ::arrow::Type::BINARY) {
+    return ::arrow::Status::Invalid(
+        fmt::format("BlobEncoder:: does not support data type {}", data->type()->ToString()));
+  }
+  auto arr = std::static_pointer_cast<::arrow::BinaryArray>(data);
+  ARROW_ASSIGN_OR_RAISE(auto blobs_position, out_->Tell());
+  auto start_offset = arr->length() > 0 ? arr->value_offset(0) : 0;
+  if (arr->length() > 0) {
+    ARROW_RETURN_NOT_OK(
+        out_->Write(arr->value_data()->data() + start_offset, arr->total_values_length()));
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto descriptors, ::arrow::AllocateBuffer(arr->length() * kDescriptorSize));
+  auto values = reinterpret_cast<int64_t*>(descriptors->mutable_data());
+  for (int64_t i = 0; i < arr->length(); i++) {
+    values[2 * i] = blobs_position + arr->value_offset(i) - start_offset;
+    values[2 * i + 1] = arr->value_length(i);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto position, out_->Tell());
+  ARROW_RETURN_NOT_OK(out_->Write(descriptors->data(), descriptors->size()));
+  return position;
+}
+
+BlobDecoder::BlobDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                         std::shared_ptr<::arrow::DataType> type)
+    : Decoder(infile, type) {}
+
+::arrow::Result<std::vector<BlobHandle>> BlobDecoder::GetBlobs(int32_t start,
+                                                               int32_t length) const {
+  if (start < 0 || length < 0 || start + length > length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("BlobDecoder::GetBlobs: out of range: start={}, length={}, page_length={}",
+                    start,
+                    length,
+                    length_));
+  }
+  std::vector<BlobHandle> blobs;
+  if (length == 0) {
+    return blobs;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto buf,
+                        infile_->ReadAt(position_ + start * kDescriptorSize,
+                                        length * kDescriptorSize));
+  auto descriptors = reinterpret_cast<const int64_t*>(buf->data());
+  blobs.reserve(length);
+  for (int32_t i = 0; i < length; i++) {
+    blobs.emplace_back(infile_, descriptors[2 * i], descriptors[2 * i + 1]);
+  }
+  return blobs;
+}
+
+::arrow::Result<std::vector<BlobHandle>> BlobDecoder::GetBlobs(
+    const std::shared_ptr<::arrow::Int32Array>& indices) const {
+  if (indices->length() == 0) {
+    return std::vector<BlobHandle>{};
+  }
+  // The descriptors are small, read the range that covers all the indices.
+  auto start = indices->Value(0);
+  auto length = indices->Value(indices->length() - 1) - start + 1;
+  ARROW_ASSIGN_OR_RAISE(auto range, GetBlobs(start, length));
+  std::vector<BlobHandle> blobs;
+  blobs.reserve(indices->length());
+  for (int64_t i = 0; i < indices->length(); i++) {
+    blobs.emplace_back(range[indices->Value(i) - start]);
+  }
+  return blobs;
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> BlobDecoder::Materialize(
+    const std::vector<BlobHandle>& blobs) const {
+  int64_t total_length = std::accumulate(
+      blobs.begin(), blobs.end(), int64_t{0}, [](auto acc, auto& b) { return acc + b.length(); });
+  if (total_length > std::numeric_limits<int32_t>::max()) {
+    return ::arrow::Status::CapacityError(
+        "BlobDecoder: the blobs exceed 2GB, use GetBlobs() to read them lazily");
+  }
+  ARROW_ASSIGN_OR_RAISE(
+      auto buffers, ReadBlobs(std::vector<std::optional<BlobHandle>>(blobs.begin(), blobs.end())));
+  ARROW_ASSIGN_OR_RAISE(auto offsets,
+                        ::arrow::AllocateBuffer((blobs.size() + 1) * sizeof(int32_t)));
+  ARROW_ASSIGN_OR_RAISE(auto data, ::arrow::AllocateBuffer(total_length));
+  auto offset_values = reinterpret_cast<int32_t*>(offsets->mutable_data());
+  int32_t offset = 0;
+  for (size_t i = 0; i < buffers.size(); i++) {
+    offset_values[i] = offset;
+    if (buffers[i]->size() > 0) {
+      std::memcpy(data->mutable_data() + offset, buffers[i]->data(), buffers[i]->size());
+    }
+    offset += static_cast<int32_t>(buffers[i]->size());
+  }
+  offset_values[buffers.size()] = offset;
+  return ::arrow::MakeArray(::arrow::ArrayData::Make(
+      type_, blobs.size(), {nullptr, std::move(offsets), std::move(data)}));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> BlobDecoder::GetScalar(int64_t idx) const {
+  ARROW_ASSIGN_OR_RAISE(auto blobs, GetBlobs(idx, 1));
+  ARROW_ASSIGN_OR_RAISE(auto buf, blobs[0].Read());
+  return ::arrow::MakeScalar(type_, std::move(buf));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> BlobDecoder::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  ARROW_ASSIGN_OR_RAISE(auto blobs, GetBlobs(start, length.value_or(length_ - start)));
+  return Materialize(blobs);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> BlobDecoder::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  ARROW_ASSIGN_OR_RAISE(auto blobs, GetBlobs(indices));
+  return Materialize(blobs);
+}
+
+}  // namespace lance::encodings
@@ -0,0 +1,120 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/io/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lance/encodings/encoder.h"
+
+namespace lance::encodings {
+
+/// A lazy reference to one blob value in a file. The bytes are only read on request.
+class BlobHandle {
+ public:
+  BlobHandle(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+             int64_t position,
+             int64_t length) noexcept;
+
+  /// File position of the blob.
+  int64_t position() const { return position_; }
+
+  /// Size of the blob in bytes.
+  int64_t length() const { return length_; }
+
+  /// Read the whole blob.
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>> Read() const;
+
+  /// Read `length` bytes starting from `offset` within the blob.
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>> ReadRange(int64_t offset,
+                                                              int64_t length) const;
+
+  const std::shared_ptr<::arrow::io::RandomAccessFile>& file() const { return infile_; }
+
+ private:
+  std::shared_ptr<::arrow::io::RandomAccessFile> infile_;
+  int64_t position_;
+  int64_t length_;
+};
+
+/// Read the bytes of many blobs.
+///
+/// Blobs of the same file that are close to each other are fetched in one I/O.
+///
+/// \param blobs the blobs to read. `std::nullopt` stands for a null value.
+/// \return one buffer per blob, or `nullptr` for a null value.
+::arrow::Result<std::vector<std::shared_ptr<::arrow::Buffer>>> ReadBlobs(
+    const std::vector<std::optional<BlobHandle>>& blobs);
+
+/// Blob Encoder, for large binary values, i.e., images or masks.
+///
+/// Layout:
+///
+/// |blob1|blob2|...|blobN|
+/// |position1:int64|length1:int64|...|positionN:int64|lengthN:int64|
+///
+/// The page only contains the descriptors of the blobs, which are stored in their own file
+/// region ahead of the page. It returns the position of the descriptors.
+class BlobEncoder : public Encoder {
+ public:
+  explicit BlobEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
+
+  virtual ~BlobEncoder() = default;
+
+  ::arrow::Result<int64_t> Write(std::shared_ptr<::arrow::Array> arr) override;
+
+  std::string ToString() const override { return "Encoder(type=Blob)"; }
+};
+
+/// Blob Decoder.
+///
+/// `ToArray()`, `Take()` and `GetScalar()` read the bytes of the blobs. Use `GetBlobs()` to
+/// only read the descriptors.
+class BlobDecoder : public Decoder {
+ public:
+  BlobDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+              std::shared_ptr<::arrow::DataType> type);
+
+  ~BlobDecoder() override = default;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+  /// Get the handles of the blobs in `[start, start + length)`, without reading the blobs.
+  ::arrow::Result<std::vector<BlobHandle>> GetBlobs(int32_t start, int32_t length) const;
+
+  /// Get the handles of the blobs at the (sorted) indices, without reading the blobs.
+  ::arrow::Result<std::vector<BlobHandle>> GetBlobs(
+      const std::shared_ptr<::arrow::Int32Array>& indices) const;
+
+ private:
+  /// Read the blobs and make a binary array.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Materialize(
+      const std::vector<BlobHandle>& blobs) const;
+};
+
+}  // namespace lance::encodings
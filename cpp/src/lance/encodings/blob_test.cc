@@ -0,0 +1,90 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/blob.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <arrow/scalar.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+
+using lance::encodings::BlobDecoder;
+using lance::encodings::BlobEncoder;
+using lance::encodings::BlobHandle;
+
+TEST_CASE("Blob encoding") {
+  std::vector<std::string> values;
+  for (int i = 0; i < 20; i++) {
+    values.emplace_back(std::string(1000 + i, static_cast<char>('a' + i)));
+  }
+  auto arr = lance::arrow::ToArray(values).ValueOrDie();
+  auto sliced = arr->Slice(5);
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  BlobEncoder encoder(sink);
+  auto offset = encoder.Write(sliced).ValueOrDie();
+  // The page only contains the descriptors.
+  CHECK(sink->Tell().ValueOrDie() - offset == 15 * 16);
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  BlobDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, sliced->length());
+
+  CHECK(sliced->Equals(decoder.ToArray().ValueOrDie()));
+  CHECK(sliced->Slice(3, 4)->Equals(decoder.ToArray(3, 4).ValueOrDie()));
+  CHECK(decoder.GetScalar(2).ValueOrDie()->Equals(sliced->GetScalar(2).ValueOrDie()));
+  auto indices = lance::arrow::ToArray({1, 4, 14}).ValueOrDie();
+  auto expected =
+      lance::arrow::ToArray({values[6], values[9], values[19]}).ValueOrDie();
+  CHECK(expected->Equals(decoder.Take(indices).ValueOrDie()));
+
+  auto blobs = decoder.GetBlobs(indices).ValueOrDie();
+  CHECK(blobs.size() == 3);
+  CHECK(blobs[0].length() == 1006);
+  CHECK(blobs[1].Read().ValueOrDie()->ToString() == values[9]);
+  CHECK(blobs[2].ReadRange(10, 5).ValueOrDie()->ToString() == std::string(5, 'a' + 19));
+  CHECK(!blobs[2].ReadRange(1000, 100).ok());
+}
+
+TEST_CASE("Read many blobs") {
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(sink->Write(std::string(100, 'x')).ok());
+  CHECK(sink->Write(std::string(100, 'y')).ok());
+  CHECK(sink->Write(std::string(100000, 'z')).ok());
+  CHECK(sink->Write(std::string(10, 'w')).ok());
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+
+  // Out of order, with nulls, and ranges far away from each other.
+  std::vector<std::optional<BlobHandle>> blobs = {BlobHandle(infile, 100200, 10),
+                                                  std::nullopt,
+                                                  BlobHandle(infile, 100, 50),
+                                                  BlobHandle(infile, 0, 100),
+                                                  BlobHandle(infile, 150, 0)};
+  auto buffers = lance::encodings::ReadBlobs(blobs).ValueOrDie();
+  CHECK(buffers.size() == 5);
+  CHECK(buffers[0]->ToString() == std::string(10, 'w'));
+  CHECK(buffers[1] == nullptr);
+  CHECK(buffers[2]->ToString() == std::string(50, 'y'));
+  CHECK(buffers[3]->ToString() == std::string(100, 'x'));
+  CHECK(buffers[4]->size() == 0);
+}
@@ -0,0 +1,249 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/byte_stream_split.h"
+
+#include <arrow/buffer.h>
+#include <arrow/scalar.h>
+#include <arrow/type_traits.h>
+#include <fmt/format.h>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lance::encodings {
+
+namespace {
+
+#if defined(__SSE2__)
+
+/// Number of values processed by one SIMD block, i.e., the bytes in one SSE register.
+constexpr int64_t kBlockSize = 16;
+
+/// Perfect shuffle of the bytes in `W` registers: interleave the first half with the second
+/// half. It rotates the bits of the byte index left by one.
+template <int W>
+inline void PerfectShuffle(__m128i* v) {
+  __m128i tmp[W];
+  for (int j = 0; j < W / 2; j++) {
+    tmp[2 * j] = _mm_unpacklo_epi8(v[j], v[j + W / 2]);
+    tmp[2 * j + 1] = _mm_unpackhi_epi8(v[j], v[j + W / 2]);
+  }
+  std::memcpy(v, tmp, sizeof(tmp));
+}
+
+/// Split `kBlockSize` values starting from the i-th value.
+///
+/// The byte index `value << log2(W) | byte` becomes `byte << 4 | value`, a left rotation by
+/// 4 bits, i.e., 4 perfect shuffles.
+template <int W>
+inline void SplitBlock(const uint8_t* values, int64_t num_values, int64_t i, uint8_t* out) {
+  __m128i v[W];
+  for (int k = 0; k < W; k++) {
+    v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i * W + k * kBlockSize));
+  }
+  for (int round = 0; round < 4; round++) {
+    PerfectShuffle<W>(v);
+  }
+  for (int k = 0; k < W; k++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k * num_values + i), v[k]);
+  }
+}
+
+/// Merge `kBlockSize` values starting from the i-th value. The inverse of `SplitBlock()`, a
+/// left rotation by log2(W) bits.
+template <int W>
+inline void MergeBlock(const uint8_t* streams, int64_t stride, int64_t i, uint8_t* out) {
+  constexpr int kRounds = W == 4 ? 2 : 3;
+  __m128i v[W];
+  for (int k = 0; k < W; k++) {
+    v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(streams + k * stride + i));
+  }
+  for (int round = 0; round < kRounds; round++) {
+    PerfectShuffle<W>(v);
+  }
+  for (int k = 0; k < W; k++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * W + k * kBlockSize), v[k]);
+  }
+}
+
+#endif  // __SSE2__
+
+}  // namespace
+
+void ByteStreamSplit(const uint8_t* values, int64_t num_values, int byte_width, uint8_t* out) {
+  int64_t i = 0;
+#if defined(__SSE2__)
+  auto num_blocks = num_values / kBlockSize;
+  if (byte_width == 4) {
+    for (; i < num_blocks * kBlockSize; i += kBlockSize) {
+      SplitBlock<4>(values, num_values, i, out);
+    }
+  } else if (byte_width == 8) {
+    for (; i < num_blocks * kBlockSize; i += kBlockSize) {
+      SplitBlock<8>(values, num_values, i, out);
+    }
+  }
+#endif
+  for (; i < num_values; i++) {
+    for (int k = 0; k < byte_width; k++) {
+      out[k * num_values + i] = values[i * byte_width + k];
+    }
+  }
+}
+
+void ByteStreamMerge(
+    const uint8_t* streams, int64_t stride, int64_t num_values, int byte_width, uint8_t* out) {
+  int64_t i = 0;
+#if defined(__SSE2__)
+  auto num_blocks = num_values / kBlockSize;
+  if (byte_width == 4) {
+    for (; i < num_blocks * kBlockSize; i += kBlockSize) {
+      MergeBlock<4>(streams, stride, i, out);
+    }
+  } else if (byte_width == 8) {
+    for (; i < num_blocks * kBlockSize; i += kBlockSize) {
+      MergeBlock<8>(streams, stride, i, out);
+    }
+  }
+#endif
+  for (; i < num_values; i++) {
+    for (int k = 0; k < byte_width; k++) {
+      out[i * byte_width + k] = streams[k * stride + i];
+    }
+  }
+}
+
+ByteStreamSplitEncoder::ByteStreamSplitEncoder(std::shared_ptr<::arrow::io::OutputStream> out)
+    : Encoder(out) {}
+
+::arrow::Result<int64_t> ByteStreamSplitEncoder::Write(std::shared_ptr<::arrow::Array> arr) {
+  auto type_id = arr->type_id();
+  if (type_id != ::arrow::Type::FLOAT && type_id != ::arrow::Type::DOUBLE) {
+    return ::arrow::Status::Invalid(fmt::format(
+        "ByteStreamSplitEncoder:: does not support data type {}", arr->type()->ToString()));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto position, out_->Tell());
+  auto byte_width = ::arrow::bit_width(type_id) / 8;
+  ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(arr->length() * byte_width));
+  ByteStreamSplit(arr->data()->buffers[1]->data() + arr->offset() * byte_width,
+                  arr->length(),
+                  byte_width,
+                  buf->mutable_data());
+  ARROW_RETURN_NOT_OK(out_->Write(buf->data(), buf->size()));
+  return position;
+}
+
+ByteStreamSplitDecoder::ByteStreamSplitDecoder(
+    std::shared_ptr<::arrow::io::RandomAccessFile> infile, std::shared_ptr<::arrow::DataType> type)
+    : Decoder(infile, type) {}
+
+::arrow::Status ByteStreamSplitDecoder::Init() {
+  if (type_->id() != ::arrow::Type::FLOAT && type_->id() != ::arrow::Type::DOUBLE) {
+    return ::arrow::Status::Invalid(
+        fmt::format("ByteStreamSplitDecoder: unsupported type: {}", type_->ToString()));
+  }
+  byte_width_ = ::arrow::bit_width(type_->id()) / 8;
+  return ::arrow::Status::OK();
+}
+
+::arrow::Result<std::tuple<std::shared_ptr<::arrow::Buffer>, int64_t>>
+ByteStreamSplitDecoder::ReadStreams(int32_t start, int32_t length) const {
+  // The span from the first byte of the first stream to the last byte of the last stream.
+  int64_t span = static_cast<int64_t>(byte_width_ - 1) * length_ + length;
+  if (span <= 2 * static_cast<int64_t>(byte_width_) * length) {
+    // The range covers a large part of the page, read it in one I/O.
+    ARROW_ASSIGN_OR_RAISE(auto buf, infile_->ReadAt(position_ + start, span));
+    return std::make_tuple(buf, static_cast<int64_t>(length_));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(length * byte_width_));
+  for (int k = 0; k < byte_width_; k++) {
+    ARROW_RETURN_NOT_OK(infile_->ReadAt(position_ + static_cast<int64_t>(k) * length_ + start,
+                                        length,
+                                        buf->mutable_data() + k * length));
+  }
+  return std::make_tuple(std::shared_ptr<::arrow::Buffer>(std::move(buf)),
+                         static_cast<int64_t>(length));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> ByteStreamSplitDecoder::GetScalar(
+    int64_t idx) const {
+  if (idx < 0 || idx >= length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("ByteStreamSplitDecoder::GetScalar: index {} out of range", idx));
+  }
+  uint8_t bytes[sizeof(double)];
+  for (int k = 0; k < byte_width_; k++) {
+    ARROW_RETURN_NOT_OK(
+        infile_->ReadAt(position_ + static_cast<int64_t>(k) * length_ + idx, 1, bytes + k));
+  }
+  if (type_->id() == ::arrow::Type::FLOAT) {
+    float value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return std::make_shared<::arrow::FloatScalar>(value);
+  }
+  double value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return std::make_shared<::arrow::DoubleScalar>(value);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> ByteStreamSplitDecoder::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  if (!length.has_value()) {
+    length = length_ - start;
+  }
+  if (start + length.value() > length_ || start > length_) {
+    return ::arrow::Status::IndexError(fmt::format(
+        "ByteStreamSplitDecoder::ToArray: out of range: start={}, length={}, page_length={}\n",
+        start,
+        length.value(),
+        length_));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto streams, ReadStreams(start, length.value()));
+  auto& [buf, stride] = streams;
+  ARROW_ASSIGN_OR_RAISE(auto values, ::arrow::AllocateBuffer(length.value() * byte_width_));
+  ByteStreamMerge(buf->data(), stride, length.value(), byte_width_, values->mutable_data());
+  return ::arrow::MakeArray(
+      ::arrow::ArrayData::Make(type_, length.value(), {nullptr, std::move(values)}));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> ByteStreamSplitDecoder::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  if (indices->length() == 0) {
+    return ::arrow::Status::Invalid("ByteStreamSplitDecoder::Take: Indices array is not valid");
+  }
+  int32_t start = indices->Value(0);
+  int32_t length = indices->Value(indices->length() - 1) - start + 1;
+  if (start < 0 || start + length > length_) {
+    return ::arrow::Status::Invalid("ByteStreamSplitDecoder::Take: Indices array is not valid");
+  }
+  ARROW_ASSIGN_OR_RAISE(auto streams, ReadStreams(start, length));
+  auto& [buf, stride] = streams;
+  // Gather the bytes of the selected values directly from the streams.
+  ARROW_ASSIGN_OR_RAISE(auto values, ::arrow::AllocateBuffer(indices->length() * byte_width_));
+  auto out = values->mutable_data();
+  for (int64_t i = 0; i < indices->length(); i++) {
+    auto idx = indices->Value(i) - start;
+    for (int k = 0; k < byte_width_; k++) {
+      out[i * byte_width_ + k] = buf->data()[k * stride + idx];
+    }
+  }
+  return ::arrow::MakeArray(
+      ::arrow::ArrayData::Make(type_, indices->length(), {nullptr, std::move(values)}));
+}
+
+}  // namespace lance::encodings
@@ -0,0 +1,89 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/io/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "lance/encodings/encoder.h"
+
+namespace lance::encodings {
+
+/// Scatter the bytes of `num_values` values of `byte_width` bytes into `byte_width` streams.
+///
+/// The k-th byte of the i-th value is written to `out[k * num_values + i]`.
+void ByteStreamSplit(const uint8_t* values, int64_t num_values, int byte_width, uint8_t* out);
+
+/// Gather `num_values` values of `byte_width` bytes from `byte_width` streams, each of
+/// `stride` bytes, starting at `streams`. The inverse of `ByteStreamSplit()`.
+void ByteStreamMerge(
+    const uint8_t* streams, int64_t stride, int64_t num_values, int byte_width, uint8_t* out);
+
+/// Byte-stream-split Encoder for float and double values.
+///
+/// Layout:
+///
+/// |byte0 of value1|...|byte0 of valueN|byte1 of value1|...|byte1 of valueN|...
+///
+/// The same bytes of all values (i.e., sign and exponent) are grouped together, so that
+/// the page compresses much better with a general-purpose codec. The page has the same
+/// size as a plain page.
+class ByteStreamSplitEncoder : public Encoder {
+ public:
+  explicit ByteStreamSplitEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
+
+  virtual ~ByteStreamSplitEncoder() = default;
+
+  ::arrow::Result<int64_t> Write(std::shared_ptr<::arrow::Array> arr) override;
+
+  std::string ToString() const override { return "Encoder(type=ByteStreamSplit)"; }
+};
+
+/// Byte-stream-split Decoder.
+class ByteStreamSplitDecoder : public Decoder {
+ public:
+  ByteStreamSplitDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                         std::shared_ptr<::arrow::DataType> type);
+
+  ~ByteStreamSplitDecoder() override = default;
+
+  ::arrow::Status Init() override;
+
+  /// Gather the bytes of one value from each stream.
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+ private:
+  /// Read the rows `[start, start + length)` of every stream.
+  ///
+  /// \return a buffer of `byte_width` streams of `stride` bytes each, and the stride.
+  ::arrow::Result<std::tuple<std::shared_ptr<::arrow::Buffer>, int64_t>> ReadStreams(
+      int32_t start, int32_t length) const;
+
+  int byte_width_ = 0;
+};
+
+}  // namespace lance::encodings
@@ -0,0 +1,104 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/byte_stream_split.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <arrow/scalar.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+
+using lance::encodings::ByteStreamSplitDecoder;
+using lance::encodings::ByteStreamSplitEncoder;
+
+TEST_CASE("Byte stream split kernels") {
+  // Cover both the SIMD blocks and the scalar tail.
+  for (int byte_width : {4, 8}) {
+    for (int64_t num_values : {0, 1, 15, 16, 17, 100, 1000}) {
+      std::vector<uint8_t> values(num_values * byte_width);
+      for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<uint8_t>(i * 31 + i / 7);
+      }
+      std::vector<uint8_t> streams(values.size());
+      lance::encodings::ByteStreamSplit(values.data(), num_values, byte_width, streams.data());
+      for (int64_t i = 0; i < num_values; i++) {
+        for (int k = 0; k < byte_width; k++) {
+          CHECK(streams[k * num_values + i] == values[i * byte_width + k]);
+        }
+      }
+      std::vector<uint8_t> merged(values.size());
+      lance::encodings::ByteStreamMerge(
+          streams.data(), num_values, num_values, byte_width, merged.data());
+      CHECK(merged == values);
+    }
+  }
+}
+
+template <typename T>
+void TestByteStreamSplit(const std::vector<T>& values) {
+  auto arr = lance::arrow::ToArray(values).ValueOrDie();
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  ByteStreamSplitEncoder encoder(sink);
+  // Write a sliced array to check the offset is respected.
+  auto sliced = arr->Slice(3);
+  auto offset = encoder.Write(sliced).ValueOrDie();
+  CHECK(sink->Tell().ValueOrDie() - offset ==
+        static_cast<int64_t>(sliced->length() * sizeof(T)));
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  ByteStreamSplitDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, sliced->length());
+
+  CHECK(sliced->Equals(decoder.ToArray().ValueOrDie()));
+  CHECK(sliced->Slice(10, 50)->Equals(decoder.ToArray(10, 50).ValueOrDie()));
+  CHECK(sliced->Slice(200, 3)->Equals(decoder.ToArray(200, 3).ValueOrDie()));
+  for (int64_t i : {0, 17, 500}) {
+    CHECK(decoder.GetScalar(i).ValueOrDie()->Equals(sliced->GetScalar(i).ValueOrDie()));
+  }
+  CHECK(!decoder.GetScalar(sliced->length()).ok());
+
+  auto indices = lance::arrow::ToArray({1, 2, 30, 400}).ValueOrDie();
+  auto expected = lance::arrow::ToArray(
+                      std::vector<T>({values[4], values[5], values[33], values[403]}))
+                      .ValueOrDie();
+  CHECK(expected->Equals(decoder.Take(indices).ValueOrDie()));
+}
+
+TEST_CASE("Byte stream split float and double") {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(0, 640);
+  std::vector<float> floats;
+  std::vector<double> doubles;
+  for (int i = 0; i < 1000; i++) {
+    floats.emplace_back(static_cast<float>(dist(gen)));
+    doubles.emplace_back(dist(gen));
+  }
+  TestByteStreamSplit(floats);
+  TestByteStreamSplit(doubles);
+}
+
+TEST_CASE("Byte stream split does not support integers") {
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  ByteStreamSplitEncoder encoder(sink);
+  CHECK(!encoder.Write(lance::arrow::ToArray({1, 2, 3}).ValueOrDie()).ok());
+}
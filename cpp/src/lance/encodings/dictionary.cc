@@ -15,6 +15,8 @@
 #include "lance/encodings/dictionary.h"
 
 #include <arrow/array.h>
+#include <arrow/array/util.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <arrow/result.h>
 #include <arrow/scalar.h>
@@ -22,8 +24,10 @@
 #include <fmt/format.h>
 
 #include <memory>
+#include <numeric>
 
 #include "lance/encodings/binary.h"
+#include "lance/encodings/kernels.h"
 #include "lance/encodings/plain.h"
 
 namespace lance::encodings {
@@ -40,7 +44,7 @@ DictionaryEncoder::DictionaryEncoder(std::shared_ptr<::arrow::io::OutputStream>
 ::arrow::Result<int64_t> DictionaryEncoder::WriteValueArray(std::shared_ptr<::arrow::Array> arr) {
   if (::arrow::is_primitive(arr->type_id())) {
     return PlainEncoder(out_).Write(arr);
-  } else if (arr->type_id() == ::arrow::Type::STRING) {
+  } else if (arr->type_id() == ::arrow::Type::STRING || arr->type_id() == ::arrow::Type::BINARY) {
     return VarBinaryEncoder(out_).Write(arr);
   }
   return ::arrow::Status::Invalid(
@@ -84,4 +88,73 @@ void DictionaryDecoder::Reset(int64_t position, int32_t length) {
   return ::arrow::DictionaryArray::FromArrays(index_arr, dict_);
 }
 
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> DictionaryDecoder::Filter(
+    const std::string& function, const ::arrow::Datum& literal) const {
+  ARROW_ASSIGN_OR_RAISE(
+      auto codes,
+      ResolveCodes(static_cast<const ::arrow::DictionaryType&>(*type_), dict_, literal));
+  return FilterCodes(function, codes);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> DictionaryDecoder::FilterCodes(
+    const std::string& function, const std::shared_ptr<::arrow::Array>& codes) const {
+  if (function != "equal" && function != "not_equal" && function != "is_in") {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("Dictionary encoding does not support filter: {}", function));
+  }
+  std::shared_ptr<::arrow::Buffer> buf;
+  if (codes->length() == 0) {
+    // None of the literal values is in the dictionary: no row is equal to them.
+    auto num_rows = function == "not_equal" ? length_ : 0;
+    ARROW_ASSIGN_OR_RAISE(buf, ::arrow::AllocateBuffer(num_rows * sizeof(int32_t)));
+    auto indices = reinterpret_cast<int32_t*>(buf->mutable_data());
+    std::iota(indices, indices + num_rows, 0);
+    return std::make_shared<::arrow::Int32Array>(num_rows, buf);
+  }
+  if (function != "is_in" && codes->length() > 1) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Dictionary filter {} expects one code, got {}", function, codes->length()));
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto index_arr, plain_decoder_->ToArray());
+  ::arrow::Datum mask;
+  if (function == "is_in") {
+    ARROW_ASSIGN_OR_RAISE(mask,
+                          ::arrow::compute::IsIn(index_arr,
+                                                 ::arrow::compute::SetLookupOptions(codes)));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(auto code, codes->GetScalar(0));
+    ARROW_ASSIGN_OR_RAISE(mask, ::arrow::compute::CallFunction(function, {index_arr, code}));
+  }
+  auto bools = std::static_pointer_cast<::arrow::BooleanArray>(mask.make_array());
+  ARROW_ASSIGN_OR_RAISE(buf, ::arrow::AllocateBuffer(bools->length() * sizeof(int32_t)));
+  auto count = kernels::BitmapToIndices(bools->values()->data(),
+                                        bools->offset(),
+                                        bools->length(),
+                                        reinterpret_cast<int32_t*>(buf->mutable_data()));
+  return std::make_shared<::arrow::Int32Array>(count, buf);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> DictionaryDecoder::ResolveCodes(
+    const ::arrow::DictionaryType& type,
+    const std::shared_ptr<::arrow::Array>& dict,
+    const ::arrow::Datum& literal) {
+  std::shared_ptr<::arrow::Array> values;
+  if (literal.is_scalar()) {
+    ARROW_ASSIGN_OR_RAISE(values, ::arrow::MakeArrayFromScalar(*literal.scalar(), 1));
+  } else if (literal.is_array()) {
+    values = literal.make_array();
+  } else {
+    return ::arrow::Status::Invalid(
+        fmt::format("Dictionary filter expects a scalar or an array: {}", literal.ToString()));
+  }
+  // Position of each value in the dictionary, or null if it is absent.
+  ARROW_ASSIGN_OR_RAISE(
+      auto positions,
+      ::arrow::compute::IndexIn(values, ::arrow::compute::SetLookupOptions(dict)));
+  ARROW_ASSIGN_OR_RAISE(auto codes, ::arrow::compute::DropNull(positions));
+  ARROW_ASSIGN_OR_RAISE(auto casted, ::arrow::compute::Cast(codes, type.index_type()));
+  return casted.make_array();
+}
+
 }  // namespace lance::encodings
@@ -36,7 +36,8 @@ class DictionaryEncoder : public Encoder {
 
   /// Write value array.
   ///
-  /// It should be only called once per dataset / file.
+  /// Primitive values are written with plain encoding, and string / binary values with
+  /// var-binary encoding. It should be only called once per dataset / file.
   ::arrow::Result<int64_t> WriteValueArray(std::shared_ptr<::arrow::Array> arr);
 
   std::string ToString() const override;
@@ -75,6 +76,31 @@ class DictionaryDecoder : public Decoder {
   ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
       std::shared_ptr<::arrow::Int32Array> indices) const override;
 
+  /// Evaluate `value == literal`, `value != literal` or `is_in(value, literal)` over the codes
+  /// of the page, with the literal resolved against the dictionary.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      const std::string& function, const ::arrow::Datum& literal) const override;
+
+  /// Evaluate a predicate over the codes of the page, without decoding the values.
+  ///
+  /// \param function "equal", "not_equal" or "is_in".
+  /// \param codes the codes of the literal, from `ResolveCodes()`.
+  /// \return the sorted indices of the rows that satisfy the predicate.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> FilterCodes(
+      const std::string& function, const std::shared_ptr<::arrow::Array>& codes) const;
+
+  /// Resolve the values of a literal to their codes in a dictionary.
+  ///
+  /// \param type the dictionary type.
+  /// \param dict the dictionary values.
+  /// \param literal a scalar or an array of the value type of the dictionary.
+  /// \return the codes of the index type of the dictionary. The values that are not in the
+  ///         dictionary are dropped.
+  static ::arrow::Result<std::shared_ptr<::arrow::Array>> ResolveCodes(
+      const ::arrow::DictionaryType& type,
+      const std::shared_ptr<::arrow::Array>& dict,
+      const ::arrow::Datum& literal);
+
  private:
   std::shared_ptr<::arrow::Array> dict_;
   std::unique_ptr<PlainDecoder> plain_decoder_;
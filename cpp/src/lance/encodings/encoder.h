@@ -20,6 +20,11 @@
 #include <concepts>
 #include <memory>
 #include <optional>
+#include <string>
+
+namespace arrow {
+class Datum;
+}  // namespace arrow
 
 namespace arrow::io {
 class RandomAccessFile;
@@ -89,6 +94,19 @@ class Decoder {
   virtual ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
       std::shared_ptr<::arrow::Int32Array> indices) const = 0;
 
+  /// Evaluate a predicate `value <function> literal` over the encoded page, without decoding
+  /// all the values.
+  ///
+  /// \param function the name of an arrow compute function, i.e., "equal", "less".
+  /// \param literal the right hand side of the predicate.
+  /// \return the sorted indices of the rows that satisfy the predicate, or
+  ///         `Status::NotImplemented` if the encoding can not evaluate this predicate.
+  virtual ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      [[maybe_unused]] const std::string& function,
+      [[maybe_unused]] const ::arrow::Datum& literal) const {
+    return ::arrow::Status::NotImplemented("Filter is not supported by this encoding");
+  }
+
  protected:
   std::shared_ptr<::arrow::io::RandomAccessFile> infile_;
   std::shared_ptr<::arrow::DataType> type_;
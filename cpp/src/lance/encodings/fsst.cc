@@ -0,0 +1,406 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/fsst.h"
+
+#include <arrow/array/util.h>
+#include <arrow/buffer.h>
+#include <arrow/builder.h>
+#include <arrow/result.h>
+#include <arrow/scalar.h>
+#include <arrow/status.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "lance/encodings/binary.h"
+#include "lance/io/endian.h"
+
+namespace lance::encodings {
+
+namespace {
+
+/// Number of bytes sampled from a page to build the symbol table.
+constexpr int64_t kSampleSize = 16 * 1024;
+
+/// Number of rounds to refine the symbol table.
+constexpr int kNumGenerations = 5;
+
+std::string_view ToStringView(const uint64_t& symbol, int64_t length) {
+  return std::string_view(reinterpret_cast<const char*>(&symbol), length);
+}
+
+}  // namespace
+
+void SymbolTable::AddSymbol(std::string_view symbol) {
+  assert(num_symbols_ < kMaxSymbols);
+  assert(!symbol.empty() && symbol.size() <= kMaxSymbolLength);
+  uint64_t value = 0;
+  std::memcpy(&value, symbol.data(), symbol.size());
+  symbols_[num_symbols_] = value;
+  lengths_[num_symbols_] = symbol.size();
+  num_symbols_++;
+}
+
+void SymbolTable::BuildIndex() {
+  for (auto& codes : index_) {
+    codes.clear();
+  }
+  for (int code = 0; code < num_symbols_; code++) {
+    index_[symbols_[code] & 0xFF].emplace_back(code);
+  }
+  for (auto& codes : index_) {
+    std::stable_sort(codes.begin(), codes.end(), [this](uint8_t a, uint8_t b) {
+      return lengths_[a] > lengths_[b];
+    });
+  }
+}
+
+int SymbolTable::FindSymbol(const uint8_t* data, int64_t size) const {
+  for (auto code : index_[data[0]]) {
+    if (lengths_[code] <= size && std::memcmp(&symbols_[code], data, lengths_[code]) == 0) {
+      return code;
+    }
+  }
+  return -1;
+}
+
+SymbolTable SymbolTable::Build(const ::arrow::BinaryArray& arr) {
+  // Evenly sample the values, up to kSampleSize bytes.
+  std::vector<std::string_view> sample;
+  auto step = std::max<int64_t>(1, arr.total_values_length() / kSampleSize);
+  for (int64_t i = 0; i < arr.length(); i += step) {
+    if (arr.IsValid(i)) {
+      sample.emplace_back(arr.GetView(i));
+    }
+  }
+
+  SymbolTable table;
+  for (int generation = 0; generation < kNumGenerations; generation++) {
+    // Count the symbols used to compress the sample with the current table, and the
+    // concatenations of adjacent symbols, as the candidates for the next table.
+    std::unordered_map<std::string_view, int64_t> counts;
+    std::unordered_map<std::string, int64_t> concatenation_counts;
+    for (auto value : sample) {
+      auto data = reinterpret_cast<const uint8_t*>(value.data());
+      int64_t pos = 0;
+      std::string_view prev;
+      while (pos < static_cast<int64_t>(value.size())) {
+        auto code = table.FindSymbol(data + pos, value.size() - pos);
+        auto length = code < 0 ? 1 : table.lengths_[code];
+        auto current = value.substr(pos, length);
+        counts[current]++;
+        if (!prev.empty() && prev.size() + current.size() <= kMaxSymbolLength) {
+          concatenation_counts[std::string(prev) + std::string(current)]++;
+        }
+        prev = current;
+        pos += length;
+      }
+    }
+    for (auto& [symbol, count] : concatenation_counts) {
+      counts[symbol] += count;
+    }
+
+    // Keep the candidates that save the most bytes.
+    std::vector<std::tuple<int64_t, std::string_view>> candidates;
+    for (auto& [symbol, count] : counts) {
+      candidates.emplace_back(count * symbol.size(), symbol);
+    }
+    auto num_symbols = std::min<size_t>(kMaxSymbols, candidates.size());
+    std::partial_sort(candidates.begin(),
+                      candidates.begin() + num_symbols,
+                      candidates.end(),
+                      [](auto& a, auto& b) {
+                        // Break ties by the symbol, to build the same table on every run.
+                        auto& [gain_a, symbol_a] = a;
+                        auto& [gain_b, symbol_b] = b;
+                        return gain_a > gain_b || (gain_a == gain_b && symbol_a < symbol_b);
+                      });
+    SymbolTable next;
+    for (size_t i = 0; i < num_symbols; i++) {
+      next.AddSymbol(std::get<1>(candidates[i]));
+    }
+    next.BuildIndex();
+    table = std::move(next);
+  }
+  return table;
+}
+
+int64_t SymbolTable::SerializedSize(int num_symbols) {
+  return 1 + num_symbols * (1 + kMaxSymbolLength);
+}
+
+std::string SymbolTable::Serialize() const {
+  std::string out;
+  out.reserve(SerializedSize(num_symbols_));
+  out.push_back(static_cast<char>(num_symbols_));
+  for (int code = 0; code < num_symbols_; code++) {
+    out.push_back(static_cast<char>(lengths_[code]));
+    out.append(ToStringView(symbols_[code], kMaxSymbolLength));
+  }
+  return out;
+}
+
+::arrow::Result<SymbolTable> SymbolTable::Parse(const uint8_t* data, int64_t size) {
+  if (size < 1 || size < SerializedSize(data[0])) {
+    return ::arrow::Status::Invalid("FSST: symbol table is truncated");
+  }
+  SymbolTable table;
+  auto num_symbols = data[0];
+  if (num_symbols > kMaxSymbols) {
+    return ::arrow::Status::Invalid(fmt::format("FSST: invalid number of symbols {}", num_symbols));
+  }
+  for (int code = 0; code < num_symbols; code++) {
+    auto entry = data + 1 + code * (1 + kMaxSymbolLength);
+    auto length = entry[0];
+    if (length == 0 || length > kMaxSymbolLength) {
+      return ::arrow::Status::Invalid(fmt::format("FSST: invalid symbol length {}", length));
+    }
+    table.AddSymbol(std::string_view(reinterpret_cast<const char*>(entry + 1), length));
+  }
+  table.BuildIndex();
+  return table;
+}
+
+void SymbolTable::Compress(std::string_view value, std::string* out) const {
+  auto data = reinterpret_cast<const uint8_t*>(value.data());
+  int64_t size = value.size();
+  int64_t pos = 0;
+  while (pos < size) {
+    auto code = FindSymbol(data + pos, size - pos);
+    if (code < 0) {
+      out->push_back(static_cast<char>(kEscape));
+      out->push_back(static_cast<char>(data[pos]));
+      pos++;
+    } else {
+      out->push_back(static_cast<char>(code));
+      pos += lengths_[code];
+    }
+  }
+}
+
+int64_t SymbolTable::DecompressedSize(std::string_view codes) const {
+  auto data = reinterpret_cast<const uint8_t*>(codes.data());
+  int64_t size = 0;
+  for (size_t i = 0; i < codes.size(); i++) {
+    if (data[i] == kEscape) {
+      size++;
+      i++;
+    } else {
+      size += lengths_[data[i]];
+    }
+  }
+  return size;
+}
+
+int64_t SymbolTable::Decompress(std::string_view codes, uint8_t* out) const {
+  auto data = reinterpret_cast<const uint8_t*>(codes.data());
+  auto start = out;
+  for (size_t i = 0; i < codes.size(); i++) {
+    auto code = data[i];
+    if (code == kEscape) {
+      *out++ = data[++i];
+    } else {
+      std::memcpy(out, &symbols_[code], kMaxSymbolLength);
+      out += lengths_[code];
+    }
+  }
+  return out - start;
+}
+
+bool SymbolTable::StartsWith(std::string_view codes, std::string_view prefix) const {
+  auto data = reinterpret_cast<const uint8_t*>(codes.data());
+  size_t matched = 0;
+  for (size_t i = 0; i < codes.size() && matched < prefix.size(); i++) {
+    const void* symbol;
+    size_t length;
+    if (data[i] == kEscape) {
+      symbol = &data[++i];
+      length = 1;
+    } else {
+      symbol = &symbols_[data[i]];
+      length = lengths_[data[i]];
+    }
+    auto n = std::min(length, prefix.size() - matched);
+    if (std::memcmp(symbol, prefix.data() + matched, n) != 0) {
+      return false;
+    }
+    matched += n;
+  }
+  return matched == prefix.size();
+}
+
+FSSTEncoder::FSSTEncoder(std::shared_ptr<::arrow::io::OutputStream> out) : Encoder(out) {}
+
+::arrow::Result<int64_t> FSSTEncoder::Write(std::shared_ptr<::arrow::Array> arr) {
+  if (!::arrow::is_binary_like(arr->type_id())) {
+    return ::arrow::Status::Invalid(
+        fmt::format("FSSTEncoder: does not support data type {}", arr->type()->ToString()));
+  }
+  auto binary_arr = std::static_pointer_cast<::arrow::BinaryArray>(arr);
+  auto table = SymbolTable::Build(*binary_arr);
+
+  ::arrow::BinaryBuilder builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(arr->length()));
+  std::string codes;
+  for (int64_t i = 0; i < arr->length(); i++) {
+    codes.clear();
+    if (binary_arr->IsValid(i)) {
+      table.Compress(binary_arr->GetView(i), &codes);
+    }
+    ARROW_RETURN_NOT_OK(builder.Append(codes));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto compressed, builder.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto values_position, VarBinaryEncoder(out_).Write(compressed));
+
+  ARROW_ASSIGN_OR_RAISE(auto header_position, out_->Tell());
+  ARROW_RETURN_NOT_OK(lance::io::WriteInt<int64_t>(out_, values_position));
+  ARROW_RETURN_NOT_OK(out_->Write(table.Serialize()));
+  return header_position;
+}
+
+FSSTDecoder::FSSTDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                         std::shared_ptr<::arrow::DataType> type)
+    : Decoder(infile, type) {}
+
+::arrow::Status FSSTDecoder::Init() {
+  values_decoder_ =
+      std::make_unique<VarBinaryDecoder<::arrow::BinaryType>>(infile_, ::arrow::binary());
+  return values_decoder_->Init();
+}
+
+void FSSTDecoder::Reset(int64_t position, int32_t length) {
+  Decoder::Reset(position, length);
+  symbol_table_.reset();
+}
+
+::arrow::Status FSSTDecoder::LoadHeader() const {
+  if (symbol_table_.has_value()) {
+    return ::arrow::Status::OK();
+  }
+  // Read the largest possible header in one I/O.
+  auto header_size = sizeof(int64_t) + SymbolTable::SerializedSize(SymbolTable::kMaxSymbols);
+  ARROW_ASSIGN_OR_RAISE(auto header, infile_->ReadAt(position_, header_size));
+  if (header->size() < static_cast<int64_t>(sizeof(int64_t))) {
+    return ::arrow::Status::IOError(
+        fmt::format("FSSTDecoder: failed to read header at {}", position_));
+  }
+  auto values_position = lance::io::ReadInt<int64_t>(header->data());
+  ARROW_ASSIGN_OR_RAISE(
+      auto table,
+      SymbolTable::Parse(header->data() + sizeof(int64_t), header->size() - sizeof(int64_t)));
+  values_decoder_->Reset(values_position, length_);
+  symbol_table_ = std::move(table);
+  return ::arrow::Status::OK();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FSSTDecoder::Decompress(
+    const std::shared_ptr<::arrow::Array>& compressed) const {
+  auto arr = std::static_pointer_cast<::arrow::BinaryArray>(compressed);
+  auto& table = symbol_table_.value();
+  int64_t total_size = 0;
+  for (int64_t i = 0; i < arr->length(); i++) {
+    total_size += table.DecompressedSize(arr->GetView(i));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto offsets,
+                        ::arrow::AllocateBuffer((arr->length() + 1) * sizeof(int32_t)));
+  ARROW_ASSIGN_OR_RAISE(auto data,
+                        ::arrow::AllocateBuffer(total_size + SymbolTable::kMaxSymbolLength));
+  auto raw_offsets = reinterpret_cast<int32_t*>(offsets->mutable_data());
+  int64_t pos = 0;
+  for (int64_t i = 0; i < arr->length(); i++) {
+    raw_offsets[i] = pos;
+    pos += table.Decompress(arr->GetView(i), data->mutable_data() + pos);
+  }
+  raw_offsets[arr->length()] = pos;
+  std::shared_ptr<::arrow::Buffer> values = std::move(data);
+  return ::arrow::MakeArray(::arrow::ArrayData::Make(
+      type_,
+      arr->length(),
+      {nullptr, std::move(offsets), ::arrow::SliceBuffer(values, 0, total_size)}));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> FSSTDecoder::GetScalar(int64_t idx) const {
+  ARROW_RETURN_NOT_OK(LoadHeader());
+  ARROW_ASSIGN_OR_RAISE(auto scalar, values_decoder_->GetScalar(idx));
+  auto codes = std::static_pointer_cast<::arrow::BinaryScalar>(scalar)->view();
+  auto& table = symbol_table_.value();
+  auto size = table.DecompressedSize(codes);
+  ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(size + SymbolTable::kMaxSymbolLength));
+  table.Decompress(codes, buf->mutable_data());
+  std::shared_ptr<::arrow::Buffer> value = ::arrow::SliceBuffer(std::move(buf), 0, size);
+  if (type_->id() == ::arrow::Type::STRING) {
+    return std::make_shared<::arrow::StringScalar>(value);
+  }
+  return std::make_shared<::arrow::BinaryScalar>(value);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FSSTDecoder::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  ARROW_RETURN_NOT_OK(LoadHeader());
+  ARROW_ASSIGN_OR_RAISE(auto compressed, values_decoder_->ToArray(start, length));
+  return Decompress(compressed);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FSSTDecoder::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  ARROW_RETURN_NOT_OK(LoadHeader());
+  ARROW_ASSIGN_OR_RAISE(auto compressed, values_decoder_->Take(indices));
+  return Decompress(compressed);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> FSSTDecoder::Filter(
+    const std::string& function, const ::arrow::Datum& literal) const {
+  if (!literal.is_scalar() || !literal.scalar()->is_valid ||
+      !::arrow::is_binary_like(literal.scalar()->type->id())) {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("FSSTDecoder::Filter: unsupported literal {}", literal.ToString()));
+  }
+  auto value = std::static_pointer_cast<::arrow::BaseBinaryScalar>(literal.scalar())->view();
+  ARROW_RETURN_NOT_OK(LoadHeader());
+  auto& table = symbol_table_.value();
+  ARROW_ASSIGN_OR_RAISE(auto compressed_arr, values_decoder_->ToArray());
+  auto compressed = std::static_pointer_cast<::arrow::BinaryArray>(compressed_arr);
+
+  ::arrow::Int32Builder builder;
+  if (function == "equal" || function == "not_equal") {
+    // Compression is deterministic, so equal values have equal codes.
+    std::string codes;
+    table.Compress(value, &codes);
+    bool expected = function == "equal";
+    for (int64_t i = 0; i < compressed->length(); i++) {
+      if ((compressed->GetView(i) == codes) == expected) {
+        ARROW_RETURN_NOT_OK(builder.Append(i));
+      }
+    }
+  } else if (function == "starts_with") {
+    for (int64_t i = 0; i < compressed->length(); i++) {
+      if (table.StartsWith(compressed->GetView(i), value)) {
+        ARROW_RETURN_NOT_OK(builder.Append(i));
+      }
+    }
+  } else {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("FSSTDecoder::Filter: unsupported function {}", function));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto indices, builder.Finish());
+  return std::static_pointer_cast<::arrow::Int32Array>(indices);
+}
+
+}  // namespace lance::encodings
@@ -0,0 +1,163 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/datum.h>
+#include <arrow/io/api.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lance/encodings/encoder.h"
+
+namespace lance::encodings {
+
+/// A static symbol table of the FSST (Fast Static Symbol Table) string compression.
+///
+/// Each symbol is 1 to 8 bytes, and is encoded as a one-byte code. Bytes that are not covered
+/// by any symbol are written as `kEscape` followed by the literal byte.
+///
+/// Reference: "FSST: Fast Random Access String Compression", VLDB 2020.
+class SymbolTable {
+ public:
+  static constexpr int kMaxSymbols = 255;
+  static constexpr int kMaxSymbolLength = 8;
+  static constexpr uint8_t kEscape = 255;
+
+  SymbolTable() = default;
+
+  /// Build a symbol table from a sample of the values.
+  static SymbolTable Build(const ::arrow::BinaryArray& arr);
+
+  /// Parse a symbol table from the serialized form.
+  static ::arrow::Result<SymbolTable> Parse(const uint8_t* data, int64_t size);
+
+  /// Serialize the symbol table: `num_symbols:uint8`, followed by `length:uint8` and
+  /// `symbol:uint64` (little-endian, zero-padded) of each symbol.
+  std::string Serialize() const;
+
+  /// The size in bytes of a serialized symbol table with `num_symbols` symbols.
+  static int64_t SerializedSize(int num_symbols);
+
+  /// Compress a value, and append the codes to `out`.
+  void Compress(std::string_view value, std::string* out) const;
+
+  /// The size of a value after decompression.
+  int64_t DecompressedSize(std::string_view codes) const;
+
+  /// Decompress codes into `out`.
+  ///
+  /// `out` must have `DecompressedSize(codes) + kMaxSymbolLength` bytes available, since each
+  /// symbol is copied as a whole 8-byte word.
+  ///
+  /// \return the number of bytes decompressed.
+  int64_t Decompress(std::string_view codes, uint8_t* out) const;
+
+  /// Returns true if the decompressed value of the codes starts with the prefix.
+  ///
+  /// Only decompresses as many symbols as needed to compare with the prefix.
+  bool StartsWith(std::string_view codes, std::string_view prefix) const;
+
+  int num_symbols() const { return num_symbols_; }
+
+ private:
+  /// Add a symbol to the table.
+  void AddSymbol(std::string_view symbol);
+
+  /// Find the code of the longest symbol that matches the beginning of the data.
+  ///
+  /// \return the code of the symbol, or -1 if no symbol matches.
+  int FindSymbol(const uint8_t* data, int64_t size) const;
+
+  /// Build the lookup index of symbols, by the first byte of the symbols.
+  void BuildIndex();
+
+  int num_symbols_ = 0;
+  std::array<uint64_t, kMaxSymbols> symbols_{};
+  std::array<uint8_t, kMaxSymbols> lengths_{};
+
+  /// Codes of the symbols that start with each byte, longest first.
+  std::array<std::vector<uint8_t>, 256> index_;
+};
+
+/// FSST Encoder for string and binary values.
+///
+/// Layout:
+///
+/// |compressed value1|...|compressed valueN|
+/// |offset1|...|offsetN+1|
+/// |values_position:int64|symbol table|
+///
+/// The compressed values are written with var-binary encoding. It returns the position of the
+/// header, i.e., `values_position`.
+class FSSTEncoder : public Encoder {
+ public:
+  explicit FSSTEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
+
+  virtual ~FSSTEncoder() = default;
+
+  ::arrow::Result<int64_t> Write(std::shared_ptr<::arrow::Array> arr) override;
+
+  std::string ToString() const override { return "Encoder(type=FSST)"; }
+};
+
+/// FSST Decoder.
+///
+/// Each value is compressed independently, so `GetScalar` and `Take` only decompress the
+/// requested values.
+class FSSTDecoder : public Decoder {
+ public:
+  FSSTDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+              std::shared_ptr<::arrow::DataType> type);
+
+  ~FSSTDecoder() override = default;
+
+  ::arrow::Status Init() override;
+
+  void Reset(int64_t position, int32_t length) override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+  /// Evaluate "equal", "not_equal" and "starts_with" predicates on the compressed values.
+  ///
+  /// Equality compares the compressed values with the compressed literal, and prefix matching
+  /// only decompresses the first symbols of each value.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      const std::string& function, const ::arrow::Datum& literal) const override;
+
+ private:
+  /// Read the header of the page, if it has not been loaded yet.
+  ::arrow::Status LoadHeader() const;
+
+  /// Decompress an array of compressed values.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Decompress(
+      const std::shared_ptr<::arrow::Array>& compressed) const;
+
+  std::unique_ptr<Decoder> values_decoder_;
+  mutable std::optional<SymbolTable> symbol_table_;
+};
+
+}  // namespace lance::encodings
@@ -0,0 +1,137 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/fsst.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <arrow/scalar.h>
+#include <fmt/format.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+#include "lance/encodings/binary.h"
+
+using lance::encodings::FSSTDecoder;
+using lance::encodings::FSSTEncoder;
+
+namespace {
+
+std::shared_ptr<::arrow::StringArray> MakePaths(int num_values) {
+  ::arrow::StringBuilder builder;
+  for (int i = 0; i < num_values; i++) {
+    CHECK(builder
+              .Append(fmt::format(
+                  "s3://bucket/datasets/coco/2017/train/images/{:012d}.jpg", i * 37 % 100000))
+              .ok());
+  }
+  return std::static_pointer_cast<::arrow::StringArray>(builder.Finish().ValueOrDie());
+}
+
+}  // namespace
+
+TEST_CASE("FSST round trip") {
+  auto arr = MakePaths(1000);
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  FSSTEncoder encoder(sink);
+  auto offset = encoder.Write(arr).ValueOrDie();
+  auto compressed_size = sink->Tell().ValueOrDie();
+  INFO("Raw size: " << arr->total_values_length() << " compressed size: " << compressed_size);
+  CHECK(compressed_size * 2 < arr->total_values_length());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  FSSTDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, arr->length());
+
+  auto actual = decoder.ToArray().ValueOrDie();
+  CHECK(arr->Equals(actual));
+  CHECK(arr->Slice(100, 50)->Equals(decoder.ToArray(100, 50).ValueOrDie()));
+
+  for (int i : {0, 1, 500, 999}) {
+    CHECK(decoder.GetScalar(i).ValueOrDie()->Equals(arr->GetScalar(i).ValueOrDie()));
+  }
+
+  auto indices = lance::arrow::ToArray({3, 7, 100, 998}).ValueOrDie();
+  auto expected =
+      lance::arrow::ToArray({arr->GetString(3), arr->GetString(7), arr->GetString(100),
+                             arr->GetString(998)})
+          .ValueOrDie();
+  CHECK(expected->Equals(decoder.Take(indices).ValueOrDie()));
+}
+
+TEST_CASE("FSST with empty values and bytes without symbols") {
+  ::arrow::BinaryBuilder builder;
+  CHECK(builder.Append("").ok());
+  CHECK(builder.Append(std::string("\x00\xff\x01", 3)).ok());
+  CHECK(builder.Append("abcabcabc").ok());
+  CHECK(builder.AppendNull().ok());
+  auto arr = builder.Finish().ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  FSSTEncoder encoder(sink);
+  auto offset = encoder.Write(arr).ValueOrDie();
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  FSSTDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, arr->length());
+
+  auto actual = std::static_pointer_cast<::arrow::BinaryArray>(decoder.ToArray().ValueOrDie());
+  for (int i = 0; i < 3; i++) {
+    CHECK(actual->GetView(i) == std::static_pointer_cast<::arrow::BinaryArray>(arr)->GetView(i));
+  }
+  // The validity is stored separately.
+  CHECK(actual->GetView(3).empty());
+}
+
+TEST_CASE("FSST filters on compressed values") {
+  std::vector<std::string> captions = {"a cat sitting on a couch",
+                                       "a dog sitting on a couch",
+                                       "a cat sitting on a chair",
+                                       "a cat",
+                                       "a cat sitting on a couch"};
+  auto arr = lance::arrow::ToArray(captions).ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  FSSTEncoder encoder(sink);
+  auto offset = encoder.Write(arr).ValueOrDie();
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  FSSTDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, arr->length());
+
+  auto indices =
+      decoder.Filter("equal", ::arrow::Datum(std::string("a cat sitting on a couch"))).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 4}).ValueOrDie()));
+
+  indices = decoder.Filter("not_equal", ::arrow::Datum(std::string("a cat"))).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 1, 2, 4}).ValueOrDie()));
+
+  indices = decoder.Filter("starts_with", ::arrow::Datum(std::string("a cat"))).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 2, 3, 4}).ValueOrDie()));
+
+  indices = decoder.Filter("starts_with", ::arrow::Datum(std::string("a cat sitting on a c")))
+                .ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 2, 4}).ValueOrDie()));
+
+  CHECK(!decoder.Filter("less", ::arrow::Datum(std::string("a"))).ok());
+}
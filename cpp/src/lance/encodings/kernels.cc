@@ -0,0 +1,1222 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/kernels.h"
+
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LANCE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace lance::encodings::kernels {
+
+namespace {
+
+/// The SIMD level in use, or -1 if it has not been detected yet.
+std::atomic<int> simd_level{-1};
+
+/// Positions of the set bits of every byte value, i.e., `{0, 2, 3, ...}` for `0b00001101`.
+struct ByteIndexTable {
+  constexpr ByteIndexTable() : indices() {
+    for (int b = 0; b < 256; b++) {
+      int n = 0;
+      for (int j = 0; j < 8; j++) {
+        if ((b >> j) & 1) {
+          indices[b][n++] = j;
+        }
+      }
+    }
+  }
+
+  uint8_t indices[256][8];
+};
+
+constexpr ByteIndexTable kByteIndexTable;
+
+/// Salts of the 8 words of a Bloom filter block, as in the Parquet split block Bloom filter.
+constexpr uint32_t kBloomSalt[8] = {0x47b6137bU,
+                                    0x44974d91U,
+                                    0x8824ad5bU,
+                                    0xa2b7289dU,
+                                    0x705495c7U,
+                                    0x2df1424bU,
+                                    0x9efc4947U,
+                                    0x5c6bfb31U};
+
+/// The block of a hash, from its upper 32 bits.
+inline int64_t BloomBlockIndex(uint64_t hash, int64_t num_blocks) {
+  return static_cast<int64_t>(((hash >> 32) * static_cast<uint64_t>(num_blocks)) >> 32);
+}
+
+/// Portable implementations, which are the reference of the SIMD implementations.
+namespace scalar {
+
+template <int kByteWidth>
+void GatherFixed(const uint8_t* values,
+                 const int32_t* indices,
+                 int64_t length,
+                 int32_t base,
+                 uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    std::memcpy(out + i * kByteWidth,
+                values + static_cast<int64_t>(indices[i] - base) * kByteWidth,
+                kByteWidth);
+  }
+}
+
+void Gather(const uint8_t* values,
+            int32_t byte_width,
+            const int32_t* indices,
+            int64_t length,
+            int32_t base,
+            uint8_t* out) {
+  switch (byte_width) {
+    case 1:
+      return GatherFixed<1>(values, indices, length, base, out);
+    case 2:
+      return GatherFixed<2>(values, indices, length, base, out);
+    case 4:
+      return GatherFixed<4>(values, indices, length, base, out);
+    case 8:
+      return GatherFixed<8>(values, indices, length, base, out);
+    default:
+      for (int64_t i = 0; i < length; i++) {
+        std::memcpy(out + i * byte_width,
+                    values + static_cast<int64_t>(indices[i] - base) * byte_width,
+                    byte_width);
+      }
+  }
+}
+
+template <typename T, typename OutT>
+void RebaseOffsets(const T* offsets, int64_t length, T base, OutT* out) {
+  for (int64_t i = 0; i < length; i++) {
+    out[i] = static_cast<OutT>(offsets[i] - base);
+  }
+}
+
+/// Gather 8 bits into one byte.
+uint8_t GatherByte(const uint8_t* bitmap, const int32_t* indices, int32_t base) {
+  uint8_t byte = 0;
+  for (int j = 0; j < 8; j++) {
+    byte |= static_cast<uint8_t>(::arrow::bit_util::GetBit(bitmap, indices[j] - base)) << j;
+  }
+  return byte;
+}
+
+void GatherBits(const uint8_t* bitmap,
+                [[maybe_unused]] int64_t num_bytes,
+                const int32_t* indices,
+                int64_t length,
+                int32_t base,
+                uint8_t* out) {
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    out[i / 8] = GatherByte(bitmap, indices + i, base);
+  }
+  for (; i < length; i++) {
+    ::arrow::bit_util::SetBitTo(out, i, ::arrow::bit_util::GetBit(bitmap, indices[i] - base));
+  }
+}
+
+/// Append the set bits in `[begin, end)` to `out`, starting at `out[count]`.
+int64_t BitmapToIndices(const uint8_t* bitmap,
+                        int64_t offset,
+                        int64_t begin,
+                        int64_t end,
+                        int32_t* out,
+                        int64_t count) {
+  for (int64_t i = begin; i < end; i++) {
+    // Branch-free: always write, but only advance on set bits.
+    out[count] = static_cast<int32_t>(i);
+    count += ::arrow::bit_util::GetBit(bitmap, offset + i);
+  }
+  return count;
+}
+
+int64_t BitmapToIndices(const uint8_t* bitmap, int64_t offset, int64_t length, int32_t* out) {
+  return BitmapToIndices(bitmap, offset, 0, length, out, 0);
+}
+
+void UnpackBits(const uint8_t* bitmap, int64_t offset, int64_t length, uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    out[i] = ::arrow::bit_util::GetBit(bitmap, offset + i);
+  }
+}
+
+void EqualFixedSize(const uint8_t* values,
+                    int32_t byte_width,
+                    int64_t length,
+                    const uint8_t* key,
+                    uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    ::arrow::bit_util::SetBitTo(
+        out, i, std::memcmp(values + i * byte_width, key, byte_width) == 0);
+  }
+}
+
+void GatherStrided(const uint8_t* values,
+                   int64_t stride,
+                   int32_t byte_width,
+                   int64_t length,
+                   uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    std::memcpy(out + i * byte_width, values + i * stride, byte_width);
+  }
+}
+
+void BloomFilterInsert(uint32_t* blocks,
+                       int64_t num_blocks,
+                       const uint64_t* hashes,
+                       int64_t length) {
+  for (int64_t i = 0; i < length; i++) {
+    auto block = blocks + BloomBlockIndex(hashes[i], num_blocks) * 8;
+    auto key = static_cast<uint32_t>(hashes[i]);
+    for (int w = 0; w < 8; w++) {
+      block[w] |= 1U << ((key * kBloomSalt[w]) >> 27);
+    }
+  }
+}
+
+void BloomFilterCheck(const uint32_t* blocks,
+                      int64_t num_blocks,
+                      const uint64_t* hashes,
+                      int64_t length,
+                      uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    auto block = blocks + BloomBlockIndex(hashes[i], num_blocks) * 8;
+    auto key = static_cast<uint32_t>(hashes[i]);
+    uint8_t found = 1;
+    for (int w = 0; w < 8; w++) {
+      found &= (block[w] >> ((key * kBloomSalt[w]) >> 27)) & 1;
+    }
+    out[i] = found;
+  }
+}
+
+void L2Distances(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out) {
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    float sum = 0;
+    for (int32_t j = 0; j < dimension; j++) {
+      auto diff = query[j] - vector[j];
+      sum += diff * diff;
+    }
+    out[i] = sum;
+  }
+}
+
+void DotProducts(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out) {
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    float sum = 0;
+    for (int32_t j = 0; j < dimension; j++) {
+      sum += query[j] * vector[j];
+    }
+    out[i] = sum;
+  }
+}
+
+void SquaredNorms(const float* vectors, int32_t dimension, int64_t num_vectors, float* out) {
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    DotProducts(vector, vector, dimension, 1, out + i);
+  }
+}
+
+}  // namespace scalar
+
+#if defined(LANCE_KERNELS_X86)
+
+#define LANCE_TARGET_SSE4_2 __attribute__((target("sse4.2,popcnt")))
+#define LANCE_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define LANCE_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+
+/// The number of rows to process one bit at a time until `offset + i` is byte aligned.
+int64_t UnalignedHead(int64_t offset, int64_t length) {
+  return std::min(length, (8 - offset % 8) % 8);
+}
+
+namespace sse4_2 {
+
+LANCE_TARGET_SSE4_2 void RebaseOffsets(const int32_t* offsets,
+                                       int64_t length,
+                                       int32_t base,
+                                       int32_t* out) {
+  auto vbase = _mm_set1_epi32(base);
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_sub_epi32(v, vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_SSE4_2 void RebaseOffsets(const int64_t* offsets,
+                                       int64_t length,
+                                       int64_t base,
+                                       int32_t* out) {
+  auto vbase = _mm_set1_epi64x(base);
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    auto lo = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i)), vbase);
+    auto hi =
+        _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i + 2)), vbase);
+    // Keep the low 32 bits of each 64-bit lane.
+    auto packed = _mm_shuffle_ps(
+        _mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_castps_si128(packed));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_SSE4_2 void RebaseOffsets(const int64_t* offsets,
+                                       int64_t length,
+                                       int64_t base,
+                                       int64_t* out) {
+  auto vbase = _mm_set1_epi64x(base);
+  int64_t i = 0;
+  for (; i + 2 <= length; i += 2) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_sub_epi64(v, vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_SSE4_2 int64_t BitmapToIndices(const uint8_t* bitmap,
+                                            int64_t offset,
+                                            int64_t length,
+                                            int32_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  int64_t count = scalar::BitmapToIndices(bitmap, offset, 0, i, out, 0);
+  auto bytes = bitmap + (offset + i) / 8;
+  // `count <= i`, so writing 8 indices at `out + count` stays within `out[0, length)`.
+  for (; i + 8 <= length; i += 8, bytes++) {
+    auto byte = *bytes;
+    if (byte == 0) {
+      continue;
+    }
+    auto positions = _mm_loadl_epi64(
+        reinterpret_cast<const __m128i*>(kByteIndexTable.indices[byte]));
+    auto vbase = _mm_set1_epi32(static_cast<int32_t>(i));
+    auto lo = _mm_add_epi32(_mm_cvtepu8_epi32(positions), vbase);
+    auto hi = _mm_add_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(positions, 4)), vbase);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count + 4), hi);
+    count += __builtin_popcount(byte);
+  }
+  return scalar::BitmapToIndices(bitmap, offset, i, length, out, count);
+}
+
+LANCE_TARGET_SSE4_2 void UnpackBits(const uint8_t* bitmap,
+                                    int64_t offset,
+                                    int64_t length,
+                                    uint8_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  scalar::UnpackBits(bitmap, offset, i, out);
+  auto bytes = bitmap + (offset + i) / 8;
+  // Broadcast byte 0 to lanes [0, 8) and byte 1 to lanes [8, 16), then test one bit per lane.
+  auto shuffle = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+  auto bit_mask = _mm_set1_epi64x(static_cast<int64_t>(0x8040201008040201ULL));
+  auto one = _mm_set1_epi8(1);
+  for (; i + 16 <= length; i += 16, bytes += 2) {
+    uint16_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    auto v = _mm_shuffle_epi8(_mm_cvtsi32_si128(word), shuffle);
+    v = _mm_cmpeq_epi8(_mm_and_si128(v, bit_mask), bit_mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(v, one));
+  }
+  scalar::UnpackBits(bitmap, offset + i, length - i, out + i);
+}
+
+/// Compare one value of `byte_width >= 16` bytes, with the last vector overlapping the
+/// previous one when the width is not a multiple of 16.
+LANCE_TARGET_SSE4_2 inline bool Equal16(const uint8_t* value,
+                                        const uint8_t* key,
+                                        int32_t byte_width) {
+  auto eq = _mm_set1_epi8(-1);
+  for (int32_t j = 0; j < byte_width; j += 16) {
+    auto k = std::min(j, byte_width - 16);
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(value + k));
+    auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + k));
+    eq = _mm_and_si128(eq, _mm_cmpeq_epi8(v, w));
+  }
+  return _mm_movemask_epi8(eq) == 0xFFFF;
+}
+
+LANCE_TARGET_SSE4_2 void EqualFixedSize(const uint8_t* values,
+                                        int32_t byte_width,
+                                        int64_t length,
+                                        const uint8_t* key,
+                                        uint8_t* out) {
+  if (byte_width < 16) {
+    return scalar::EqualFixedSize(values, byte_width, length, key, out);
+  }
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint8_t byte = 0;
+    for (int j = 0; j < 8; j++) {
+      byte |= static_cast<uint8_t>(Equal16(values + (i + j) * byte_width, key, byte_width)) << j;
+    }
+    out[i / 8] = byte;
+  }
+  for (; i < length; i++) {
+    ::arrow::bit_util::SetBitTo(out, i, Equal16(values + i * byte_width, key, byte_width));
+  }
+}
+
+}  // namespace sse4_2
+
+namespace avx2 {
+
+LANCE_TARGET_AVX2 void Gather(const uint8_t* values,
+                              int32_t byte_width,
+                              const int32_t* indices,
+                              int64_t length,
+                              int32_t base,
+                              uint8_t* out) {
+  int64_t i = 0;
+  if (byte_width == 4) {
+    auto src = reinterpret_cast<const int*>(values);
+    auto vbase = _mm256_set1_epi32(base);
+    for (; i + 8 <= length; i += 8) {
+      auto idx = _mm256_sub_epi32(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)), vbase);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4),
+                          _mm256_i32gather_epi32(src, idx, 4));
+    }
+  } else if (byte_width == 8) {
+    auto src = reinterpret_cast<const long long*>(values);  // NOLINT
+    auto vbase = _mm_set1_epi32(base);
+    for (; i + 4 <= length; i += 4) {
+      auto idx =
+          _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), vbase);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8),
+                          _mm256_i32gather_epi64(src, idx, 8));
+    }
+  }
+  scalar::Gather(values, byte_width, indices + i, length - i, base, out + i * byte_width);
+}
+
+LANCE_TARGET_AVX2 void RebaseOffsets(const int32_t* offsets,
+                                     int64_t length,
+                                     int32_t base,
+                                     int32_t* out) {
+  auto vbase = _mm256_set1_epi32(base);
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_sub_epi32(v, vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX2 void RebaseOffsets(const int64_t* offsets,
+                                     int64_t length,
+                                     int64_t base,
+                                     int32_t* out) {
+  auto vbase = _mm256_set1_epi64x(base);
+  // Move the low 32 bits of the four 64-bit lanes into the low 128 bits.
+  auto low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    auto v = _mm256_sub_epi64(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i)), vbase);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(v, low_halves)));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX2 void RebaseOffsets(const int64_t* offsets,
+                                     int64_t length,
+                                     int64_t base,
+                                     int64_t* out) {
+  auto vbase = _mm256_set1_epi64x(base);
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_sub_epi64(v, vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX2 void GatherBits(const uint8_t* bitmap,
+                                  int64_t num_bytes,
+                                  const int32_t* indices,
+                                  int64_t length,
+                                  int32_t base,
+                                  uint8_t* out) {
+  auto words = reinterpret_cast<const int*>(bitmap);
+  // Only gather the 32-bit words that are entirely inside of the bitmap.
+  auto num_words = static_cast<int32_t>(
+      std::min<int64_t>(num_bytes / 4, std::numeric_limits<int32_t>::max()));
+  auto vbase = _mm256_set1_epi32(base);
+  auto vnum_words = _mm256_set1_epi32(num_words);
+  auto bit_mask = _mm256_set1_epi32(31);
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    auto pos = _mm256_sub_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)), vbase);
+    auto word_idx = _mm256_srli_epi32(pos, 5);
+    if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vnum_words, word_idx))) !=
+        0xFF) {
+      out[i / 8] = scalar::GatherByte(bitmap, indices + i, base);
+      continue;
+    }
+    auto w = _mm256_i32gather_epi32(words, word_idx, 4);
+    auto bits = _mm256_srlv_epi32(w, _mm256_and_si256(pos, bit_mask));
+    out[i / 8] = static_cast<uint8_t>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(bits, 31))));
+  }
+  for (; i < length; i++) {
+    ::arrow::bit_util::SetBitTo(out, i, ::arrow::bit_util::GetBit(bitmap, indices[i] - base));
+  }
+}
+
+LANCE_TARGET_AVX2 int64_t BitmapToIndices(const uint8_t* bitmap,
+                                          int64_t offset,
+                                          int64_t length,
+                                          int32_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  int64_t count = scalar::BitmapToIndices(bitmap, offset, 0, i, out, 0);
+  auto bytes = bitmap + (offset + i) / 8;
+  // `count <= i`, so writing 8 indices at `out + count` stays within `out[0, length)`.
+  for (; i + 8 <= length; i += 8, bytes++) {
+    auto byte = *bytes;
+    if (byte == 0) {
+      continue;
+    }
+    auto positions = _mm_loadl_epi64(
+        reinterpret_cast<const __m128i*>(kByteIndexTable.indices[byte]));
+    auto v = _mm256_add_epi32(_mm256_cvtepu8_epi32(positions),
+                              _mm256_set1_epi32(static_cast<int32_t>(i)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), v);
+    count += __builtin_popcount(byte);
+  }
+  return scalar::BitmapToIndices(bitmap, offset, i, length, out, count);
+}
+
+LANCE_TARGET_AVX2 void UnpackBits(const uint8_t* bitmap,
+                                  int64_t offset,
+                                  int64_t length,
+                                  uint8_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  scalar::UnpackBits(bitmap, offset, i, out);
+  auto bytes = bitmap + (offset + i) / 8;
+  // The 4 bytes are broadcast to both 128-bit lanes, and the in-lane shuffle picks bytes
+  // 0, 1 for the low lane and bytes 2, 3 for the high lane.
+  auto shuffle = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                  2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  auto bit_mask = _mm256_set1_epi64x(static_cast<int64_t>(0x8040201008040201ULL));
+  auto one = _mm256_set1_epi8(1);
+  for (; i + 32 <= length; i += 32, bytes += 4) {
+    int32_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    auto v = _mm256_shuffle_epi8(_mm256_set1_epi32(word), shuffle);
+    v = _mm256_cmpeq_epi8(_mm256_and_si256(v, bit_mask), bit_mask);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(v, one));
+  }
+  scalar::UnpackBits(bitmap, offset + i, length - i, out + i);
+}
+
+/// Compare one value of `byte_width >= 32` bytes, see `sse4_2::Equal16`.
+LANCE_TARGET_AVX2 inline bool Equal32(const uint8_t* value,
+                                      const uint8_t* key,
+                                      int32_t byte_width) {
+  auto eq = _mm256_set1_epi8(-1);
+  for (int32_t j = 0; j < byte_width; j += 32) {
+    auto k = std::min(j, byte_width - 32);
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value + k));
+    auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + k));
+    eq = _mm256_and_si256(eq, _mm256_cmpeq_epi8(v, w));
+  }
+  return _mm256_movemask_epi8(eq) == -1;
+}
+
+LANCE_TARGET_AVX2 void EqualFixedSize(const uint8_t* values,
+                                      int32_t byte_width,
+                                      int64_t length,
+                                      const uint8_t* key,
+                                      uint8_t* out) {
+  if (byte_width < 32) {
+    return sse4_2::EqualFixedSize(values, byte_width, length, key, out);
+  }
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint8_t byte = 0;
+    for (int j = 0; j < 8; j++) {
+      byte |= static_cast<uint8_t>(Equal32(values + (i + j) * byte_width, key, byte_width)) << j;
+    }
+    out[i / 8] = byte;
+  }
+  for (; i < length; i++) {
+    ::arrow::bit_util::SetBitTo(out, i, Equal32(values + i * byte_width, key, byte_width));
+  }
+}
+
+LANCE_TARGET_AVX2 void GatherStrided(const uint8_t* values,
+                                     int64_t stride,
+                                     int32_t byte_width,
+                                     int64_t length,
+                                     uint8_t* out) {
+  int64_t i = 0;
+  // The lanes are addressed relative to the first value of each vector, so that the int32
+  // byte offsets of the lanes do not overflow.
+  if (byte_width == 4 && stride <= std::numeric_limits<int32_t>::max() / 8) {
+    auto s = static_cast<int32_t>(stride);
+    auto vindex = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    for (; i + 8 <= length; i += 8) {
+      auto src = reinterpret_cast<const int*>(values + i * stride);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4),
+                          _mm256_i32gather_epi32(src, vindex, 1));
+    }
+  } else if (byte_width == 8 && stride <= std::numeric_limits<int32_t>::max() / 4) {
+    auto s = static_cast<int32_t>(stride);
+    auto vindex = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+    for (; i + 4 <= length; i += 4) {
+      auto src = reinterpret_cast<const long long*>(values + i * stride);  // NOLINT
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8),
+                          _mm256_i32gather_epi64(src, vindex, 1));
+    }
+  }
+  scalar::GatherStrided(values + i * stride, stride, byte_width, length - i, out + i * byte_width);
+}
+
+/// The bits of a key in each word of a Bloom filter block.
+LANCE_TARGET_AVX2 inline __m256i BloomMask(uint32_t key) {
+  auto salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kBloomSalt));
+  auto bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salt), 27);
+  return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+}
+
+LANCE_TARGET_AVX2 void BloomFilterInsert(uint32_t* blocks,
+                                         int64_t num_blocks,
+                                         const uint64_t* hashes,
+                                         int64_t length) {
+  for (int64_t i = 0; i < length; i++) {
+    auto block =
+        reinterpret_cast<__m256i*>(blocks + BloomBlockIndex(hashes[i], num_blocks) * 8);
+    auto mask = BloomMask(static_cast<uint32_t>(hashes[i]));
+    _mm256_storeu_si256(block, _mm256_or_si256(_mm256_loadu_si256(block), mask));
+  }
+}
+
+LANCE_TARGET_AVX2 void BloomFilterCheck(const uint32_t* blocks,
+                                        int64_t num_blocks,
+                                        const uint64_t* hashes,
+                                        int64_t length,
+                                        uint8_t* out) {
+  for (int64_t i = 0; i < length; i++) {
+    auto block =
+        reinterpret_cast<const __m256i*>(blocks + BloomBlockIndex(hashes[i], num_blocks) * 8);
+    auto mask = BloomMask(static_cast<uint32_t>(hashes[i]));
+    // All the bits of the mask are set in the block.
+    out[i] = static_cast<uint8_t>(_mm256_testc_si256(_mm256_loadu_si256(block), mask));
+  }
+}
+
+/// The sum of the 8 floats of a register.
+LANCE_TARGET_AVX2 inline float HorizontalSum(__m256 v) {
+  auto sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  return _mm_cvtss_f32(sum);
+}
+
+/// The mask of the first `n` (< 8) lanes, to load the tail of a vector.
+LANCE_TARGET_AVX2 inline __m256i TailMask(int32_t n) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+LANCE_TARGET_AVX2 void L2Distances(const float* query,
+                                   const float* vectors,
+                                   int32_t dimension,
+                                   int64_t num_vectors,
+                                   float* out) {
+  auto tail = dimension % 8;
+  auto mask = TailMask(tail);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    auto acc = _mm256_setzero_ps();
+    int32_t j = 0;
+    for (; j + 8 <= dimension; j += 8) {
+      auto diff = _mm256_sub_ps(_mm256_loadu_ps(query + j), _mm256_loadu_ps(vector + j));
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(diff, diff));
+    }
+    if (tail > 0) {
+      // The masked lanes are loaded as zeros, and add nothing.
+      auto diff =
+          _mm256_sub_ps(_mm256_maskload_ps(query + j, mask), _mm256_maskload_ps(vector + j, mask));
+      acc = _mm256_add_ps(acc, _mm256_mul_ps(diff, diff));
+    }
+    out[i] = HorizontalSum(acc);
+  }
+}
+
+LANCE_TARGET_AVX2 void DotProducts(const float* query,
+                                   const float* vectors,
+                                   int32_t dimension,
+                                   int64_t num_vectors,
+                                   float* out) {
+  auto tail = dimension % 8;
+  auto mask = TailMask(tail);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    auto acc = _mm256_setzero_ps();
+    int32_t j = 0;
+    for (; j + 8 <= dimension; j += 8) {
+      acc = _mm256_add_ps(acc,
+                          _mm256_mul_ps(_mm256_loadu_ps(query + j), _mm256_loadu_ps(vector + j)));
+    }
+    if (tail > 0) {
+      acc = _mm256_add_ps(
+          acc,
+          _mm256_mul_ps(_mm256_maskload_ps(query + j, mask), _mm256_maskload_ps(vector + j, mask)));
+    }
+    out[i] = HorizontalSum(acc);
+  }
+}
+
+LANCE_TARGET_AVX2 void SquaredNorms(const float* vectors,
+                                    int32_t dimension,
+                                    int64_t num_vectors,
+                                    float* out) {
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    DotProducts(vector, vector, dimension, 1, out + i);
+  }
+}
+
+}  // namespace avx2
+
+namespace avx512 {
+
+LANCE_TARGET_AVX512 void Gather(const uint8_t* values,
+                                int32_t byte_width,
+                                const int32_t* indices,
+                                int64_t length,
+                                int32_t base,
+                                uint8_t* out) {
+  int64_t i = 0;
+  if (byte_width == 4) {
+    auto vbase = _mm512_set1_epi32(base);
+    for (; i + 16 <= length; i += 16) {
+      auto idx = _mm512_sub_epi32(_mm512_loadu_si512(indices + i), vbase);
+      _mm512_storeu_si512(out + i * 4, _mm512_i32gather_epi32(idx, values, 4));
+    }
+  } else if (byte_width == 8) {
+    auto vbase = _mm256_set1_epi32(base);
+    for (; i + 8 <= length; i += 8) {
+      auto idx = _mm256_sub_epi32(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)), vbase);
+      _mm512_storeu_si512(out + i * 8, _mm512_i32gather_epi64(idx, values, 8));
+    }
+  }
+  scalar::Gather(values, byte_width, indices + i, length - i, base, out + i * byte_width);
+}
+
+LANCE_TARGET_AVX512 void RebaseOffsets(const int32_t* offsets,
+                                       int64_t length,
+                                       int32_t base,
+                                       int32_t* out) {
+  auto vbase = _mm512_set1_epi32(base);
+  int64_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    _mm512_storeu_si512(out + i, _mm512_sub_epi32(_mm512_loadu_si512(offsets + i), vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX512 void RebaseOffsets(const int64_t* offsets,
+                                       int64_t length,
+                                       int64_t base,
+                                       int32_t* out) {
+  auto vbase = _mm512_set1_epi64(base);
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    auto v = _mm512_sub_epi64(_mm512_loadu_si512(offsets + i), vbase);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi64_epi32(v));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX512 void RebaseOffsets(const int64_t* offsets,
+                                       int64_t length,
+                                       int64_t base,
+                                       int64_t* out) {
+  auto vbase = _mm512_set1_epi64(base);
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    auto v = _mm512_loadu_si512(offsets + i);
+    _mm512_storeu_si512(out + i, _mm512_sub_epi64(v, vbase));
+  }
+  scalar::RebaseOffsets(offsets + i, length - i, base, out + i);
+}
+
+LANCE_TARGET_AVX512 void GatherBits(const uint8_t* bitmap,
+                                    int64_t num_bytes,
+                                    const int32_t* indices,
+                                    int64_t length,
+                                    int32_t base,
+                                    uint8_t* out) {
+  // Only gather the 32-bit words that are entirely inside of the bitmap.
+  auto num_words = static_cast<int32_t>(
+      std::min<int64_t>(num_bytes / 4, std::numeric_limits<int32_t>::max()));
+  auto vbase = _mm512_set1_epi32(base);
+  auto vnum_words = _mm512_set1_epi32(num_words);
+  auto bit_mask = _mm512_set1_epi32(31);
+  auto one = _mm512_set1_epi32(1);
+  int64_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    auto pos = _mm512_sub_epi32(_mm512_loadu_si512(indices + i), vbase);
+    auto word_idx = _mm512_srli_epi32(pos, 5);
+    uint16_t bits;
+    if (_mm512_cmplt_epi32_mask(word_idx, vnum_words) != 0xFFFF) {
+      bits = scalar::GatherByte(bitmap, indices + i, base) |
+             (scalar::GatherByte(bitmap, indices + i + 8, base) << 8);
+    } else {
+      auto w = _mm512_i32gather_epi32(word_idx, bitmap, 4);
+      bits = _mm512_test_epi32_mask(w, _mm512_sllv_epi32(one, _mm512_and_si512(pos, bit_mask)));
+    }
+    std::memcpy(out + i / 8, &bits, sizeof(bits));
+  }
+  scalar::GatherBits(bitmap, num_bytes, indices + i, length - i, base, out + i / 8);
+}
+
+LANCE_TARGET_AVX512 int64_t BitmapToIndices(const uint8_t* bitmap,
+                                            int64_t offset,
+                                            int64_t length,
+                                            int32_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  int64_t count = scalar::BitmapToIndices(bitmap, offset, 0, i, out, 0);
+  auto bytes = bitmap + (offset + i) / 8;
+  auto iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  for (; i + 16 <= length; i += 16, bytes += 2) {
+    uint16_t mask;
+    std::memcpy(&mask, bytes, sizeof(mask));
+    if (mask == 0) {
+      continue;
+    }
+    auto v = _mm512_add_epi32(iota, _mm512_set1_epi32(static_cast<int32_t>(i)));
+    _mm512_mask_compressstoreu_epi32(out + count, mask, v);
+    count += __builtin_popcount(mask);
+  }
+  return scalar::BitmapToIndices(bitmap, offset, i, length, out, count);
+}
+
+LANCE_TARGET_AVX512 void UnpackBits(const uint8_t* bitmap,
+                                    int64_t offset,
+                                    int64_t length,
+                                    uint8_t* out) {
+  int64_t i = UnalignedHead(offset, length);
+  scalar::UnpackBits(bitmap, offset, i, out);
+  auto bytes = bitmap + (offset + i) / 8;
+  auto one = _mm512_set1_epi8(1);
+  for (; i + 64 <= length; i += 64, bytes += 8) {
+    uint64_t mask;
+    std::memcpy(&mask, bytes, sizeof(mask));
+    _mm512_storeu_si512(out + i, _mm512_maskz_mov_epi8(mask, one));
+  }
+  scalar::UnpackBits(bitmap, offset + i, length - i, out + i);
+}
+
+LANCE_TARGET_AVX512 void GatherStrided(const uint8_t* values,
+                                       int64_t stride,
+                                       int32_t byte_width,
+                                       int64_t length,
+                                       uint8_t* out) {
+  int64_t i = 0;
+  if (byte_width == 4 && stride <= std::numeric_limits<int32_t>::max() / 16) {
+    auto vindex = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(static_cast<int32_t>(stride)));
+    for (; i + 16 <= length; i += 16) {
+      _mm512_storeu_si512(out + i * 4, _mm512_i32gather_epi32(vindex, values + i * stride, 1));
+    }
+  } else if (byte_width == 8 && stride <= std::numeric_limits<int32_t>::max() / 8) {
+    auto vindex = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                     _mm256_set1_epi32(static_cast<int32_t>(stride)));
+    for (; i + 8 <= length; i += 8) {
+      _mm512_storeu_si512(out + i * 8, _mm512_i32gather_epi64(vindex, values + i * stride, 1));
+    }
+  }
+  scalar::GatherStrided(values + i * stride, stride, byte_width, length - i, out + i * byte_width);
+}
+
+LANCE_TARGET_AVX512 void L2Distances(const float* query,
+                                     const float* vectors,
+                                     int32_t dimension,
+                                     int64_t num_vectors,
+                                     float* out) {
+  auto tail = dimension % 16;
+  auto mask = static_cast<__mmask16>((1U << tail) - 1);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    auto acc = _mm512_setzero_ps();
+    int32_t j = 0;
+    for (; j + 16 <= dimension; j += 16) {
+      auto diff = _mm512_sub_ps(_mm512_loadu_ps(query + j), _mm512_loadu_ps(vector + j));
+      acc = _mm512_fmadd_ps(diff, diff, acc);
+    }
+    if (tail > 0) {
+      auto diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, query + j),
+                                _mm512_maskz_loadu_ps(mask, vector + j));
+      acc = _mm512_fmadd_ps(diff, diff, acc);
+    }
+    out[i] = _mm512_reduce_add_ps(acc);
+  }
+}
+
+LANCE_TARGET_AVX512 void DotProducts(const float* query,
+                                     const float* vectors,
+                                     int32_t dimension,
+                                     int64_t num_vectors,
+                                     float* out) {
+  auto tail = dimension % 16;
+  auto mask = static_cast<__mmask16>((1U << tail) - 1);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    auto acc = _mm512_setzero_ps();
+    int32_t j = 0;
+    for (; j + 16 <= dimension; j += 16) {
+      acc = _mm512_fmadd_ps(_mm512_loadu_ps(query + j), _mm512_loadu_ps(vector + j), acc);
+    }
+    if (tail > 0) {
+      acc = _mm512_fmadd_ps(
+          _mm512_maskz_loadu_ps(mask, query + j), _mm512_maskz_loadu_ps(mask, vector + j), acc);
+    }
+    out[i] = _mm512_reduce_add_ps(acc);
+  }
+}
+
+LANCE_TARGET_AVX512 void SquaredNorms(const float* vectors,
+                                      int32_t dimension,
+                                      int64_t num_vectors,
+                                      float* out) {
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    DotProducts(vector, vector, dimension, 1, out + i);
+  }
+}
+
+}  // namespace avx512
+
+#endif  // LANCE_KERNELS_X86
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#if defined(LANCE_KERNELS_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return SimdLevel::kAVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+    return SimdLevel::kSSE4_2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+SimdLevel GetSimdLevel() {
+  auto level = simd_level.load(std::memory_order_relaxed);
+  if (level < 0) {
+    level = static_cast<int>(DetectSimdLevel());
+    simd_level.store(level, std::memory_order_relaxed);
+  }
+  return static_cast<SimdLevel>(level);
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) {
+  auto effective = std::min(level, DetectSimdLevel());
+  simd_level.store(static_cast<int>(effective), std::memory_order_relaxed);
+  return effective;
+}
+
+std::string ToString(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return "scalar";
+    case SimdLevel::kSSE4_2:
+      return "sse4.2";
+    case SimdLevel::kAVX2:
+      return "avx2";
+    case SimdLevel::kAVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+void Gather(const uint8_t* values,
+            int32_t byte_width,
+            const int32_t* indices,
+            int64_t length,
+            int32_t base,
+            uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::Gather(values, byte_width, indices, length, base, out);
+    case SimdLevel::kAVX2:
+      return avx2::Gather(values, byte_width, indices, length, base, out);
+    default:
+      break;
+  }
+#endif
+  scalar::Gather(values, byte_width, indices, length, base, out);
+}
+
+void RebaseOffsets(const int32_t* offsets, int64_t length, int32_t base, int32_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kAVX2:
+      return avx2::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::RebaseOffsets(offsets, length, base, out);
+    default:
+      break;
+  }
+#endif
+  scalar::RebaseOffsets(offsets, length, base, out);
+}
+
+void RebaseOffsets(const int64_t* offsets, int64_t length, int64_t base, int32_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kAVX2:
+      return avx2::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::RebaseOffsets(offsets, length, base, out);
+    default:
+      break;
+  }
+#endif
+  scalar::RebaseOffsets(offsets, length, base, out);
+}
+
+void RebaseOffsets(const int64_t* offsets, int64_t length, int64_t base, int64_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kAVX2:
+      return avx2::RebaseOffsets(offsets, length, base, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::RebaseOffsets(offsets, length, base, out);
+    default:
+      break;
+  }
+#endif
+  scalar::RebaseOffsets(offsets, length, base, out);
+}
+
+void GatherBits(const uint8_t* bitmap,
+                int64_t num_bytes,
+                const int32_t* indices,
+                int64_t length,
+                int32_t base,
+                uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::GatherBits(bitmap, num_bytes, indices, length, base, out);
+    case SimdLevel::kAVX2:
+      return avx2::GatherBits(bitmap, num_bytes, indices, length, base, out);
+    default:
+      break;
+  }
+#endif
+  scalar::GatherBits(bitmap, num_bytes, indices, length, base, out);
+}
+
+int64_t BitmapToIndices(const uint8_t* bitmap, int64_t offset, int64_t length, int32_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::BitmapToIndices(bitmap, offset, length, out);
+    case SimdLevel::kAVX2:
+      return avx2::BitmapToIndices(bitmap, offset, length, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::BitmapToIndices(bitmap, offset, length, out);
+    default:
+      break;
+  }
+#endif
+  return scalar::BitmapToIndices(bitmap, offset, length, out);
+}
+
+void UnpackBits(const uint8_t* bitmap, int64_t offset, int64_t length, uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::UnpackBits(bitmap, offset, length, out);
+    case SimdLevel::kAVX2:
+      return avx2::UnpackBits(bitmap, offset, length, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::UnpackBits(bitmap, offset, length, out);
+    default:
+      break;
+  }
+#endif
+  scalar::UnpackBits(bitmap, offset, length, out);
+}
+
+void EqualFixedSize(const uint8_t* values,
+                    int32_t byte_width,
+                    int64_t length,
+                    const uint8_t* key,
+                    uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    // Keys are at most a few vectors wide, so AVX-512 does not pay off over AVX2.
+    case SimdLevel::kAVX512:
+    case SimdLevel::kAVX2:
+      return avx2::EqualFixedSize(values, byte_width, length, key, out);
+    case SimdLevel::kSSE4_2:
+      return sse4_2::EqualFixedSize(values, byte_width, length, key, out);
+    default:
+      break;
+  }
+#endif
+  scalar::EqualFixedSize(values, byte_width, length, key, out);
+}
+
+void GatherStrided(const uint8_t* values,
+                   int64_t stride,
+                   int32_t byte_width,
+                   int64_t length,
+                   uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::GatherStrided(values, stride, byte_width, length, out);
+    case SimdLevel::kAVX2:
+      return avx2::GatherStrided(values, stride, byte_width, length, out);
+    default:
+      // SSE4.2 has no gather instructions.
+      break;
+  }
+#endif
+  scalar::GatherStrided(values, stride, byte_width, length, out);
+}
+
+void BloomFilterInsert(uint32_t* blocks,
+                       int64_t num_blocks,
+                       const uint64_t* hashes,
+                       int64_t length) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      // A block is exactly one AVX2 register.
+    case SimdLevel::kAVX2:
+      return avx2::BloomFilterInsert(blocks, num_blocks, hashes, length);
+    default:
+      // SSE4.2 has no variable shifts.
+      break;
+  }
+#endif
+  scalar::BloomFilterInsert(blocks, num_blocks, hashes, length);
+}
+
+void BloomFilterCheck(const uint32_t* blocks,
+                      int64_t num_blocks,
+                      const uint64_t* hashes,
+                      int64_t length,
+                      uint8_t* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+    case SimdLevel::kAVX2:
+      return avx2::BloomFilterCheck(blocks, num_blocks, hashes, length, out);
+    default:
+      break;
+  }
+#endif
+  scalar::BloomFilterCheck(blocks, num_blocks, hashes, length, out);
+}
+
+void L2Distances(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::L2Distances(query, vectors, dimension, num_vectors, out);
+    case SimdLevel::kAVX2:
+      return avx2::L2Distances(query, vectors, dimension, num_vectors, out);
+    default:
+      break;
+  }
+#endif
+  scalar::L2Distances(query, vectors, dimension, num_vectors, out);
+}
+
+void DotProducts(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::DotProducts(query, vectors, dimension, num_vectors, out);
+    case SimdLevel::kAVX2:
+      return avx2::DotProducts(query, vectors, dimension, num_vectors, out);
+    default:
+      break;
+  }
+#endif
+  scalar::DotProducts(query, vectors, dimension, num_vectors, out);
+}
+
+void SquaredNorms(const float* vectors, int32_t dimension, int64_t num_vectors, float* out) {
+#if defined(LANCE_KERNELS_X86)
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAVX512:
+      return avx512::SquaredNorms(vectors, dimension, num_vectors, out);
+    case SimdLevel::kAVX2:
+      return avx2::SquaredNorms(vectors, dimension, num_vectors, out);
+    default:
+      break;
+  }
+#endif
+  scalar::SquaredNorms(vectors, dimension, num_vectors, out);
+}
+
+}  // namespace lance::encodings::kernels
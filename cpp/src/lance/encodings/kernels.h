@@ -0,0 +1,185 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/// Low-level kernels shared by the decoders.
+///
+/// Each kernel has a portable scalar implementation, which is also the reference, and
+/// SSE4.2 / AVX2 / AVX-512 implementations on x86. The SIMD implementations are compiled with
+/// function-level target attributes, so the library does not require `-march` flags, and the
+/// best one supported by the CPU is selected at runtime.
+namespace lance::encodings::kernels {
+
+enum class SimdLevel {
+  kScalar = 0,
+  kSSE4_2 = 1,
+  kAVX2 = 2,
+  kAVX512 = 3,
+};
+
+/// The highest SIMD level supported by the CPU.
+SimdLevel DetectSimdLevel();
+
+/// The SIMD level used by the kernels, `DetectSimdLevel()` by default.
+SimdLevel GetSimdLevel();
+
+/// Override the SIMD level used by the kernels, i.e., to compare against the scalar
+/// reference in tests and benchmarks.
+///
+/// \param level the requested level, capped to what the CPU supports.
+/// \return the level in effect.
+SimdLevel SetSimdLevel(SimdLevel level);
+
+std::string ToString(SimdLevel level);
+
+/// Gather fixed-width values: `out[i] = values[indices[i] - base]`.
+///
+/// \param values the values, `byte_width` bytes each.
+/// \param byte_width the width of one value. 4 and 8 bytes are vectorized, other widths are
+///                   copied value by value.
+/// \param indices the indices to gather, each in `[base, base + num_values)`.
+/// \param length the number of indices.
+/// \param base the index of the first value in `values`.
+/// \param out the output buffer, with at least `length * byte_width` bytes.
+void Gather(const uint8_t* values,
+            int32_t byte_width,
+            const int32_t* indices,
+            int64_t length,
+            int32_t base,
+            uint8_t* out);
+
+/// Rebase offsets to start from `base`: `out[i] = offsets[i] - base`.
+///
+/// `out` may be the same buffer as `offsets`.
+void RebaseOffsets(const int32_t* offsets, int64_t length, int32_t base, int32_t* out);
+
+/// Rebase 64-bit file positions into 32-bit offsets: `out[i] = offsets[i] - base`.
+///
+/// The caller guarantees that the rebased offsets fit in int32.
+void RebaseOffsets(const int64_t* offsets, int64_t length, int64_t base, int32_t* out);
+
+/// Rebase 64-bit offsets, i.e., of large binary arrays: `out[i] = offsets[i] - base`.
+///
+/// `out` may be the same buffer as `offsets`.
+void RebaseOffsets(const int64_t* offsets, int64_t length, int64_t base, int64_t* out);
+
+/// Gather bits: set bit `i` of `out` to the bit `indices[i] - base` of `bitmap`.
+///
+/// \param bitmap the source bitmap.
+/// \param num_bytes the size of `bitmap` in bytes. Vectorized loads never read past it.
+/// \param indices the bits to gather.
+/// \param length the number of indices.
+/// \param base the bit index of the first bit in `bitmap`.
+/// \param out the output bitmap; bits `[0, length)` are overwritten.
+void GatherBits(const uint8_t* bitmap,
+                int64_t num_bytes,
+                const int32_t* indices,
+                int64_t length,
+                int32_t base,
+                uint8_t* out);
+
+/// Collect the positions of the set bits in `[offset, offset + length)` of a bitmap.
+///
+/// \param out the output indices, relative to `offset`, with room for `length` values.
+/// \return the number of indices written to `out`.
+int64_t BitmapToIndices(const uint8_t* bitmap, int64_t offset, int64_t length, int32_t* out);
+
+/// Unpack the bits in `[offset, offset + length)` of a bitmap into one byte (0 or 1) per bit.
+void UnpackBits(const uint8_t* bitmap, int64_t offset, int64_t length, uint8_t* out);
+
+/// Compare fixed-width values with a key: set bit `i` of `out` iff `values[i] == key`.
+///
+/// Values of 16 bytes or more are compared in 16 / 32 byte vectors.
+///
+/// \param values the values, `byte_width` bytes each.
+/// \param length the number of values.
+/// \param key the key, `byte_width` bytes.
+/// \param out the output bitmap; bits `[0, length)` are overwritten.
+void EqualFixedSize(const uint8_t* values,
+                    int32_t byte_width,
+                    int64_t length,
+                    const uint8_t* key,
+                    uint8_t* out);
+
+/// Gather values at a fixed stride: `out[i] = values[i * stride, i * stride + byte_width)`.
+///
+/// I.e., extract one field out of rows of interleaved fields. 4 and 8 byte values are
+/// vectorized with AVX2 / AVX-512 gathers.
+///
+/// \param values the first value.
+/// \param stride the distance in bytes between two consecutive values.
+/// \param byte_width the width of one value.
+/// \param length the number of values.
+/// \param out the output buffer, with at least `length * byte_width` bytes.
+void GatherStrided(const uint8_t* values,
+                   int64_t stride,
+                   int32_t byte_width,
+                   int64_t length,
+                   uint8_t* out);
+
+/// Insert hashes into a split block Bloom filter.
+///
+/// A block has 8 uint32 words. The upper 32 bits of a hash select the block, and the lower
+/// 32 bits, multiplied by a different salt for each word, set one bit in every word.
+///
+/// \param blocks the blocks of the filter, `8 * num_blocks` words.
+/// \param num_blocks the number of blocks, smaller than 2^32.
+/// \param hashes the 64-bit hashes of the values.
+/// \param length the number of hashes.
+void BloomFilterInsert(uint32_t* blocks,
+                       int64_t num_blocks,
+                       const uint64_t* hashes,
+                       int64_t length);
+
+/// Probe a split block Bloom filter: `out[i]` is 1 if `hashes[i]` may have been inserted, or
+/// 0 if it was definitely not.
+///
+/// \see BloomFilterInsert
+void BloomFilterCheck(const uint32_t* blocks,
+                      int64_t num_blocks,
+                      const uint64_t* hashes,
+                      int64_t length,
+                      uint8_t* out);
+
+/// Squared L2 distances between a query and vectors:
+/// `out[i] = sum((query[j] - vectors[i * dimension + j])^2)`.
+///
+/// \param query the query vector, `dimension` floats.
+/// \param vectors `num_vectors` vectors, stored row by row.
+/// \param dimension the dimension of the vectors.
+/// \param num_vectors the number of vectors.
+/// \param out the distances, `num_vectors` floats.
+void L2Distances(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out);
+
+/// Dot products of a query and vectors: `out[i] = sum(query[j] * vectors[i * dimension + j])`.
+///
+/// \see L2Distances
+void DotProducts(const float* query,
+                 const float* vectors,
+                 int32_t dimension,
+                 int64_t num_vectors,
+                 float* out);
+
+/// Squared L2 norms of vectors: `out[i] = sum(vectors[i * dimension + j]^2)`.
+void SquaredNorms(const float* vectors, int32_t dimension, int64_t num_vectors, float* out);
+
+}  // namespace lance::encodings::kernels
@@ -0,0 +1,290 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/kernels.h"
+
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using lance::encodings::kernels::SimdLevel;
+
+namespace kernels = lance::encodings::kernels;
+
+namespace {
+
+/// Run the test body once for every SIMD level the CPU supports.
+template <typename Fn>
+void ForEachSimdLevel(Fn&& fn) {
+  auto max_level = kernels::DetectSimdLevel();
+  for (auto level :
+       {SimdLevel::kScalar, SimdLevel::kSSE4_2, SimdLevel::kAVX2, SimdLevel::kAVX512}) {
+    if (level > max_level) {
+      break;
+    }
+    INFO("SIMD level: " << kernels::ToString(level));
+    CHECK(kernels::SetSimdLevel(level) == level);
+    fn();
+  }
+  kernels::SetSimdLevel(max_level);
+}
+
+std::vector<uint8_t> RandomBitmap(int64_t num_bits, double density) {
+  std::mt19937 gen(42);
+  std::bernoulli_distribution dist(density);
+  std::vector<uint8_t> bitmap(::arrow::bit_util::BytesForBits(num_bits));
+  for (int64_t i = 0; i < num_bits; i++) {
+    ::arrow::bit_util::SetBitTo(bitmap.data(), i, dist(gen));
+  }
+  return bitmap;
+}
+
+}  // namespace
+
+TEST_CASE("Gather fixed-width values") {
+  std::mt19937 gen(7);
+  for (int32_t byte_width : {1, 2, 4, 8, 12}) {
+    const int32_t num_values = 1000;
+    const int32_t base = 100;
+    std::vector<uint8_t> values(num_values * byte_width);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<uint8_t>(i * 13 + i / 5);
+    }
+    for (int64_t length : {0, 1, 7, 8, 17, 333}) {
+      std::uniform_int_distribution<int32_t> dist(base, base + num_values - 1);
+      std::vector<int32_t> indices(length);
+      for (auto& idx : indices) {
+        idx = dist(gen);
+      }
+      std::vector<uint8_t> expected(length * byte_width);
+      for (int64_t i = 0; i < length; i++) {
+        std::memcpy(expected.data() + i * byte_width,
+                    values.data() + (indices[i] - base) * byte_width,
+                    byte_width);
+      }
+      ForEachSimdLevel([&]() {
+        std::vector<uint8_t> out(length * byte_width);
+        kernels::Gather(values.data(), byte_width, indices.data(), length, base, out.data());
+        CHECK(out == expected);
+      });
+    }
+  }
+}
+
+TEST_CASE("Rebase offsets") {
+  for (int64_t length : {0, 1, 3, 4, 9, 16, 1001}) {
+    std::vector<int32_t> offsets32(length);
+    std::vector<int64_t> offsets64(length);
+    std::vector<int32_t> expected(length);
+    std::vector<int64_t> expected64(length);
+    for (int64_t i = 0; i < length; i++) {
+      offsets32[i] = static_cast<int32_t>(500 + i * 7);
+      offsets64[i] = (int64_t{1} << 40) + i * 7;
+      expected[i] = static_cast<int32_t>(i * 7);
+      expected64[i] = i * 7;
+    }
+    ForEachSimdLevel([&]() {
+      std::vector<int32_t> out(length);
+      kernels::RebaseOffsets(offsets32.data(), length, 500, out.data());
+      CHECK(out == expected);
+      kernels::RebaseOffsets(offsets64.data(), length, int64_t{1} << 40, out.data());
+      CHECK(out == expected);
+      std::vector<int64_t> out64(length);
+      kernels::RebaseOffsets(offsets64.data(), length, int64_t{1} << 40, out64.data());
+      CHECK(out64 == expected64);
+      // In place.
+      auto in_place = offsets32;
+      kernels::RebaseOffsets(in_place.data(), length, 500, in_place.data());
+      CHECK(in_place == expected);
+    });
+  }
+}
+
+TEST_CASE("Gather bits") {
+  std::mt19937 gen(11);
+  // The bitmap size is not a multiple of 4 bytes, to cover the words at the end of it.
+  const int64_t num_bits = 1003;
+  auto bitmap = RandomBitmap(num_bits, 0.5);
+  const int32_t base = 16;
+  for (int64_t length : {0, 1, 8, 15, 16, 33, 500}) {
+    std::uniform_int_distribution<int32_t> dist(base, base + num_bits - 1);
+    std::vector<int32_t> indices(length);
+    for (auto& idx : indices) {
+      idx = dist(gen);
+    }
+    if (length > 0) {
+      indices[0] = base + num_bits - 1;
+    }
+    ForEachSimdLevel([&]() {
+      std::vector<uint8_t> out(::arrow::bit_util::BytesForBits(length), 0xFF);
+      kernels::GatherBits(
+          bitmap.data(), bitmap.size(), indices.data(), length, base, out.data());
+      for (int64_t i = 0; i < length; i++) {
+        INFO("i=" << i << " index=" << indices[i]);
+        CHECK(::arrow::bit_util::GetBit(out.data(), i) ==
+              ::arrow::bit_util::GetBit(bitmap.data(), indices[i] - base));
+      }
+    });
+  }
+}
+
+TEST_CASE("Bitmap to indices") {
+  for (double density : {0.0, 0.05, 0.5, 1.0}) {
+    auto bitmap = RandomBitmap(2000, density);
+    for (int64_t offset : {0, 3, 8, 13}) {
+      for (int64_t length : {0, 5, 16, 100, 1900}) {
+        std::vector<int32_t> expected;
+        for (int64_t i = 0; i < length; i++) {
+          if (::arrow::bit_util::GetBit(bitmap.data(), offset + i)) {
+            expected.emplace_back(i);
+          }
+        }
+        ForEachSimdLevel([&]() {
+          std::vector<int32_t> out(length);
+          auto count = kernels::BitmapToIndices(bitmap.data(), offset, length, out.data());
+          out.resize(count);
+          CHECK(out == expected);
+        });
+      }
+    }
+  }
+}
+
+TEST_CASE("Unpack bits") {
+  auto bitmap = RandomBitmap(2000, 0.3);
+  for (int64_t offset : {0, 1, 8, 61}) {
+    for (int64_t length : {0, 7, 16, 32, 64, 100, 1900}) {
+      std::vector<uint8_t> expected(length);
+      for (int64_t i = 0; i < length; i++) {
+        expected[i] = ::arrow::bit_util::GetBit(bitmap.data(), offset + i);
+      }
+      ForEachSimdLevel([&]() {
+        std::vector<uint8_t> out(length);
+        kernels::UnpackBits(bitmap.data(), offset, length, out.data());
+        CHECK(out == expected);
+      });
+    }
+  }
+}
+
+TEST_CASE("Equal fixed size values") {
+  for (int32_t byte_width : {4, 16, 20, 32, 40, 72}) {
+    const int64_t length = 301;
+    std::vector<uint8_t> values(length * byte_width);
+    for (int64_t i = 0; i < length; i++) {
+      // Rows only differ in their last byte, to catch comparisons that stop early.
+      values[(i + 1) * byte_width - 1] = static_cast<uint8_t>(i % 5);
+    }
+    std::vector<uint8_t> key(byte_width);
+    key[byte_width - 1] = 3;
+    ForEachSimdLevel([&]() {
+      std::vector<uint8_t> out(::arrow::bit_util::BytesForBits(length), 0xFF);
+      kernels::EqualFixedSize(values.data(), byte_width, length, key.data(), out.data());
+      for (int64_t i = 0; i < length; i++) {
+        INFO("byte_width=" << byte_width << " i=" << i);
+        CHECK(::arrow::bit_util::GetBit(out.data(), i) == (i % 5 == 3));
+      }
+    });
+  }
+}
+
+TEST_CASE("Gather strided values") {
+  for (int32_t byte_width : {1, 2, 4, 8}) {
+    for (int64_t stride : {byte_width, byte_width + 3, 28}) {
+      for (int64_t length : {0, 1, 7, 8, 17, 333}) {
+        std::vector<uint8_t> rows(length * stride + byte_width);
+        for (size_t i = 0; i < rows.size(); i++) {
+          rows[i] = static_cast<uint8_t>(i * 7 + i / 3);
+        }
+        std::vector<uint8_t> expected(length * byte_width);
+        for (int64_t i = 0; i < length; i++) {
+          std::memcpy(expected.data() + i * byte_width, rows.data() + i * stride, byte_width);
+        }
+        ForEachSimdLevel([&]() {
+          INFO("byte_width=" << byte_width << " stride=" << stride << " length=" << length);
+          std::vector<uint8_t> out(length * byte_width);
+          kernels::GatherStrided(rows.data(), stride, byte_width, length, out.data());
+          CHECK(out == expected);
+        });
+      }
+    }
+  }
+}
+
+TEST_CASE("Bloom filter insert and check") {
+  for (int64_t num_blocks : {1, 3, 64}) {
+    for (int64_t length : {0, 1, 7, 100}) {
+      std::vector<uint64_t> hashes(length);
+      for (int64_t i = 0; i < length; i++) {
+        hashes[i] = (i + 1) * 0x9E3779B97F4A7C15ULL;
+      }
+      std::vector<uint32_t> expected(num_blocks * 8);
+      kernels::SetSimdLevel(SimdLevel::kScalar);
+      kernels::BloomFilterInsert(expected.data(), num_blocks, hashes.data(), length);
+      ForEachSimdLevel([&]() {
+        INFO("num_blocks=" << num_blocks << " length=" << length);
+        std::vector<uint32_t> blocks(num_blocks * 8);
+        kernels::BloomFilterInsert(blocks.data(), num_blocks, hashes.data(), length);
+        CHECK(blocks == expected);
+        std::vector<uint8_t> found(length);
+        kernels::BloomFilterCheck(blocks.data(), num_blocks, hashes.data(), length, found.data());
+        CHECK(std::all_of(found.begin(), found.end(), [](auto f) { return f == 1; }));
+      });
+    }
+  }
+}
+
+TEST_CASE("Vector distances") {
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  for (int32_t dimension : {1, 3, 8, 15, 16, 17, 128}) {
+    const int64_t num_vectors = 20;
+    std::vector<float> query(dimension);
+    std::vector<float> vectors(num_vectors * dimension);
+    std::generate(query.begin(), query.end(), [&] { return dist(gen); });
+    std::generate(vectors.begin(), vectors.end(), [&] { return dist(gen); });
+    std::vector<double> l2(num_vectors);
+    std::vector<double> dot(num_vectors);
+    std::vector<double> norms(num_vectors);
+    for (int64_t i = 0; i < num_vectors; i++) {
+      for (int32_t j = 0; j < dimension; j++) {
+        double value = vectors[i * dimension + j];
+        l2[i] += (query[j] - value) * (query[j] - value);
+        dot[i] += query[j] * value;
+        norms[i] += value * value;
+      }
+    }
+    ForEachSimdLevel([&]() {
+      INFO("dimension=" << dimension);
+      std::vector<float> out(num_vectors);
+      kernels::L2Distances(query.data(), vectors.data(), dimension, num_vectors, out.data());
+      for (int64_t i = 0; i < num_vectors; i++) {
+        CHECK(std::abs(out[i] - l2[i]) < 1e-4);
+      }
+      kernels::DotProducts(query.data(), vectors.data(), dimension, num_vectors, out.data());
+      for (int64_t i = 0; i < num_vectors; i++) {
+        CHECK(std::abs(out[i] - dot[i]) < 1e-4);
+      }
+      kernels::SquaredNorms(vectors.data(), dimension, num_vectors, out.data());
+      for (int64_t i = 0; i < num_vectors; i++) {
+        CHECK(std::abs(out[i] - norms[i]) < 1e-4);
+      }
+    });
+  }
+}
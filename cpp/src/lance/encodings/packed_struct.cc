@@ -0,0 +1,155 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/packed_struct.h"
+
+#include <arrow/array/util.h>
+#include <arrow/buffer.h>
+#include <arrow/type.h>
+#include <fmt/format.h>
+
+#include <cstring>
+
+#include "lance/encodings/kernels.h"
+
+namespace lance::encodings {
+
+::arrow::Result<std::vector<int32_t>> PackedStructLayout(const ::arrow::DataType& type) {
+  if (type.id() != ::arrow::Type::STRUCT) {
+    return ::arrow::Status::Invalid(
+        fmt::format("PackedStruct: {} is not a struct type", type.ToString()));
+  }
+  std::vector<int32_t> layout;
+  int32_t row_width = 0;
+  for (auto& child : type.fields()) {
+    auto& child_type = child->type();
+    auto fixed_width = dynamic_cast<const ::arrow::FixedWidthType*>(child_type.get());
+    if (fixed_width == nullptr || child_type->id() == ::arrow::Type::BOOL ||
+        child_type->id() == ::arrow::Type::DICTIONARY || fixed_width->bit_width() % 8 != 0) {
+      return ::arrow::Status::Invalid(fmt::format(
+          "PackedStruct: field {} must be a byte-aligned fixed-width type, got {}",
+          child->name(),
+          child_type->ToString()));
+    }
+    layout.emplace_back(row_width);
+    row_width += fixed_width->bit_width() / 8;
+  }
+  if (row_width == 0) {
+    return ::arrow::Status::Invalid("PackedStruct: struct has no fields");
+  }
+  layout.emplace_back(row_width);
+  return layout;
+}
+
+PackedStructEncoder::PackedStructEncoder(std::shared_ptr<::arrow::io::OutputStream> out)
+    : Encoder(out) {}
+
+::arrow::Result<int64_t> PackedStructEncoder::Write(std::shared_ptr<::arrow::Array> arr) {
+  ARROW_ASSIGN_OR_RAISE(auto layout, PackedStructLayout(*arr->type()));
+  auto row_width = layout.back();
+  auto struct_arr = std::static_pointer_cast<::arrow::StructArray>(arr);
+
+  ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(arr->length() * row_width));
+  auto out = buf->mutable_data();
+  for (int k = 0; k < struct_arr->num_fields(); k++) {
+    auto child = struct_arr->field(k);
+    auto width = layout[k + 1] - layout[k];
+    auto values = child->data()->buffers[1]->data() + child->offset() * width;
+    for (int64_t i = 0; i < arr->length(); i++) {
+      std::memcpy(out + i * row_width + layout[k], values + i * width, width);
+    }
+  }
+  ARROW_ASSIGN_OR_RAISE(auto position, out_->Tell());
+  ARROW_RETURN_NOT_OK(out_->Write(buf->data(), buf->size()));
+  return position;
+}
+
+PackedStructDecoder::PackedStructDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                                         std::shared_ptr<::arrow::DataType> type)
+    : Decoder(infile, type) {}
+
+::arrow::Status PackedStructDecoder::Init() {
+  ARROW_ASSIGN_OR_RAISE(offsets_, PackedStructLayout(*type_));
+  row_width_ = offsets_.back();
+  offsets_.pop_back();
+  return ::arrow::Status::OK();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> PackedStructDecoder::Unpack(
+    const uint8_t* rows, int64_t length) const {
+  std::vector<std::shared_ptr<::arrow::Array>> children;
+  for (std::size_t k = 0; k < offsets_.size(); k++) {
+    auto width = (k + 1 < offsets_.size() ? offsets_[k + 1] : row_width_) - offsets_[k];
+    ARROW_ASSIGN_OR_RAISE(auto values, ::arrow::AllocateBuffer(length * width));
+    kernels::GatherStrided(rows + offsets_[k], row_width_, width, length, values->mutable_data());
+    children.emplace_back(::arrow::MakeArray(::arrow::ArrayData::Make(
+        type_->field(k)->type(), length, {nullptr, std::move(values)}, 0)));
+  }
+  return std::make_shared<::arrow::StructArray>(type_, length, children);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> PackedStructDecoder::GetScalar(
+    int64_t idx) const {
+  if (idx < 0 || idx >= length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("PackedStructDecoder::GetScalar: index {} out of range", idx));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto row, infile_->ReadAt(position_ + idx * row_width_, row_width_));
+  ARROW_ASSIGN_OR_RAISE(auto arr, Unpack(row->data(), 1));
+  return arr->GetScalar(0);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> PackedStructDecoder::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  if (!length.has_value()) {
+    length = length_ - start;
+  }
+  if (start + length.value() > length_ || start > length_) {
+    return ::arrow::Status::IndexError(fmt::format(
+        "PackedStructDecoder::ToArray: out of range: start={}, length={}, page_length={}\n",
+        start,
+        length.value(),
+        length_));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto rows,
+                        infile_->ReadAt(position_ + static_cast<int64_t>(start) * row_width_,
+                                        static_cast<int64_t>(length.value()) * row_width_));
+  return Unpack(rows->data(), length.value());
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> PackedStructDecoder::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  if (indices->length() == 0) {
+    return ::arrow::Status::Invalid("PackedStructDecoder::Take: Indices array is not valid");
+  }
+  int32_t start = indices->Value(0);
+  int32_t length = indices->Value(indices->length() - 1) - start + 1;
+  if (start < 0 || start + length > length_) {
+    return ::arrow::Status::Invalid("PackedStructDecoder::Take: Indices array is not valid");
+  }
+  ARROW_ASSIGN_OR_RAISE(auto rows,
+                        infile_->ReadAt(position_ + static_cast<int64_t>(start) * row_width_,
+                                        static_cast<int64_t>(length) * row_width_));
+  // Gather the selected rows, then split them into the children.
+  ARROW_ASSIGN_OR_RAISE(auto selected, ::arrow::AllocateBuffer(indices->length() * row_width_));
+  kernels::Gather(rows->data(),
+                  row_width_,
+                  indices->raw_values(),
+                  indices->length(),
+                  start,
+                  selected->mutable_data());
+  return Unpack(selected->data(), indices->length());
+}
+
+}  // namespace lance::encodings
@@ -0,0 +1,86 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/io/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lance/encodings/encoder.h"
+
+namespace lance::encodings {
+
+/// Compute the row layout of a packed struct.
+///
+/// \param type a struct type, whose children are all byte-aligned fixed-width types.
+/// \return the byte offset of each child within a row, followed by the width of the row.
+::arrow::Result<std::vector<int32_t>> PackedStructLayout(const ::arrow::DataType& type);
+
+/// Packed struct Encoder.
+///
+/// Layout:
+///
+/// |child0 of row0|child1 of row0|...|child0 of row1|child1 of row1|...
+///
+/// The fixed-width children of a struct are interleaved row by row in one page, so that
+/// reading all the children of one row takes a single I/O. The validity bitmaps of the struct
+/// and its children are stored separately, as for the other encodings.
+class PackedStructEncoder : public Encoder {
+ public:
+  explicit PackedStructEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
+
+  virtual ~PackedStructEncoder() = default;
+
+  ::arrow::Result<int64_t> Write(std::shared_ptr<::arrow::Array> arr) override;
+
+  std::string ToString() const override { return "Encoder(type=PackedStruct)"; }
+};
+
+/// Packed struct Decoder.
+class PackedStructDecoder : public Decoder {
+ public:
+  PackedStructDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                      std::shared_ptr<::arrow::DataType> type);
+
+  ~PackedStructDecoder() override = default;
+
+  ::arrow::Status Init() override;
+
+  /// Read one row in a single I/O.
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+ private:
+  /// Split `length` consecutive rows into one array per child.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Unpack(const uint8_t* rows,
+                                                           int64_t length) const;
+
+  /// Byte offset of each child within a row.
+  std::vector<int32_t> offsets_;
+  /// Width of one row in bytes.
+  int32_t row_width_ = 0;
+};
+
+}  // namespace lance::encodings
@@ -0,0 +1,97 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/packed_struct.h"
+
+#include <arrow/array.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/api.h>
+#include <arrow/scalar.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+
+using lance::encodings::PackedStructDecoder;
+using lance::encodings::PackedStructEncoder;
+
+TEST_CASE("Packed struct layout") {
+  auto layout = lance::encodings::PackedStructLayout(
+                    *arrow::struct_({arrow::field("x", arrow::float32()),
+                                     arrow::field("id", arrow::int64()),
+                                     arrow::field("tag", arrow::uint8()),
+                                     arrow::field("hash", arrow::fixed_size_binary(16))}))
+                    .ValueOrDie();
+  CHECK(layout == std::vector<int32_t>({0, 4, 12, 13, 29}));
+
+  for (auto& type : {arrow::struct_({arrow::field("name", arrow::utf8())}),
+                     arrow::struct_({arrow::field("flag", arrow::boolean())}),
+                     arrow::struct_({}),
+                     arrow::int32()}) {
+    INFO("Type: " << type->ToString());
+    CHECK(!lance::encodings::PackedStructLayout(*type).ok());
+  }
+}
+
+TEST_CASE("Write and read packed struct") {
+  std::vector<float> xs;
+  std::vector<int64_t> ids;
+  std::vector<uint8_t> tags;
+  for (int i = 0; i < 1000; i++) {
+    xs.emplace_back(static_cast<float>(i) / 3);
+    ids.emplace_back(static_cast<int64_t>(i) * 1000000007);
+    tags.emplace_back(static_cast<uint8_t>(i % 7));
+  }
+  auto arr = arrow::StructArray::Make({lance::arrow::ToArray(xs).ValueOrDie(),
+                                       lance::arrow::ToArray(ids).ValueOrDie(),
+                                       lance::arrow::ToArray(tags).ValueOrDie()},
+                                      std::vector<std::string>{"x", "id", "tag"})
+                 .ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  PackedStructEncoder encoder(sink);
+  // Write a sliced array to check the offset is respected.
+  auto sliced = arr->Slice(5);
+  auto offset = encoder.Write(sliced).ValueOrDie();
+  CHECK(sink->Tell().ValueOrDie() - offset == sliced->length() * 13);
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  PackedStructDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, sliced->length());
+
+  CHECK(sliced->Equals(decoder.ToArray().ValueOrDie()));
+  CHECK(sliced->Slice(10, 50)->Equals(decoder.ToArray(10, 50).ValueOrDie()));
+  CHECK(!decoder.ToArray(990, 10).ok());
+  for (int64_t i : {0, 17, 994}) {
+    CHECK(decoder.GetScalar(i).ValueOrDie()->Equals(*sliced->GetScalar(i).ValueOrDie()));
+  }
+  CHECK(!decoder.GetScalar(sliced->length()).ok());
+
+  auto indices = lance::arrow::ToArray({1, 2, 30, 400, 994}).ValueOrDie();
+  auto expected = arrow::compute::Take(sliced, indices).ValueOrDie().make_array();
+  CHECK(expected->Equals(decoder.Take(indices).ValueOrDie()));
+}
+
+TEST_CASE("Packed struct does not support variable-length children") {
+  auto names = lance::arrow::ToArray(std::vector<std::string>{"a", "b", "c"}).ValueOrDie();
+  auto arr = arrow::StructArray::Make({lance::arrow::ToArray({1, 2, 3}).ValueOrDie(), names},
+                                      std::vector<std::string>{"id", "name"})
+                 .ValueOrDie();
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  PackedStructEncoder encoder(sink);
+  CHECK(!encoder.Write(arr).ok());
+}
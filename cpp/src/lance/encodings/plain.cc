@@ -14,16 +14,21 @@
 
 #include "lance/encodings/plain.h"
 
-#include <arrow/builder.h>
+#include <arrow/datum.h>
 #include <arrow/io/api.h>
 #include <arrow/scalar.h>
 #include <arrow/status.h>
 #include <arrow/type.h>
+#include <arrow/util/bit_util.h>
+#include <arrow/util/bitmap_ops.h>
 #include <fmt/format.h>
 
 #include <memory>
+#include <numeric>
+#include <vector>
 
 #include "lance/encodings/encoder.h"
+#include "lance/encodings/kernels.h"
 
 using ::arrow::Result;
 using ::arrow::Status;
@@ -38,45 +43,67 @@ PlainEncoder::PlainEncoder(std::shared_ptr<::arrow::io::OutputStream> out) : Enc
   ARROW_ASSIGN_OR_RAISE(auto value_offset, out_->Tell());
   // TODO: support more types.
   switch (data_type->id()) {
-    case ::arrow::Type::INT8:
-      ARROW_RETURN_NOT_OK(out_->Write(std::static_pointer_cast<::arrow::Int8Array>(arr)->values()));
+    case ::arrow::Type::BOOL: {
+      // Bit-packed values, re-aligned to start at the first bit of the page.
+      auto bool_arr = std::static_pointer_cast<::arrow::BooleanArray>(arr);
+      auto num_bytes = ::arrow::bit_util::BytesForBits(arr->length());
+      if (arr->offset() % 8 == 0) {
+        ARROW_RETURN_NOT_OK(
+            out_->Write(bool_arr->values()->data() + arr->offset() / 8, num_bytes));
+      } else {
+        ARROW_ASSIGN_OR_RAISE(auto bitmap,
+                              ::arrow::internal::CopyBitmap(::arrow::default_memory_pool(),
+                                                            bool_arr->values()->data(),
+                                                            arr->offset(),
+                                                            arr->length()));
+        ARROW_RETURN_NOT_OK(out_->Write(bitmap->data(), num_bytes));
+      }
       break;
+    }
+    case ::arrow::Type::INT8:
     case ::arrow::Type::UINT8:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::static_pointer_cast<::arrow::UInt8Array>(arr)->values()));
-      break;
     case ::arrow::Type::INT16:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::static_pointer_cast<::arrow::Int16Array>(arr)->values()));
-      break;
     case ::arrow::Type::UINT16:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::static_pointer_cast<::arrow::UInt16Array>(arr)->values()));
-      break;
     case ::arrow::Type::INT32:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::reinterpret_pointer_cast<::arrow::Int32Array>(arr)->values()));
-      break;
     case ::arrow::Type::UINT32:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::static_pointer_cast<::arrow::UInt32Array>(arr)->values()));
-      break;
     case ::arrow::Type::INT64:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::reinterpret_pointer_cast<::arrow::Int64Array>(arr)->values()));
-      break;
     case ::arrow::Type::UINT64:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::static_pointer_cast<::arrow::UInt64Array>(arr)->values()));
-      break;
     case ::arrow::Type::FLOAT:
-      ARROW_RETURN_NOT_OK(
-          out_->Write(std::reinterpret_pointer_cast<::arrow::FloatArray>(arr)->values()));
-      break;
     case ::arrow::Type::DOUBLE:
+    case ::arrow::Type::DATE32:
+    case ::arrow::Type::DATE64:
+    case ::arrow::Type::TIME32:
+    case ::arrow::Type::TIME64:
+    case ::arrow::Type::TIMESTAMP:
+    case ::arrow::Type::DURATION: {
+      // Only write the values within the (possibly sliced) array.
+      auto byte_width = static_cast<const ::arrow::FixedWidthType&>(*data_type).bit_width() / 8;
+      ARROW_RETURN_NOT_OK(out_->Write(arr->data()->buffers[1]->data() + arr->offset() * byte_width,
+                                      arr->length() * byte_width));
+      break;
+    }
+    case ::arrow::Type::FIXED_SIZE_BINARY:
+    case ::arrow::Type::DECIMAL128:
+    case ::arrow::Type::DECIMAL256: {
+      // Values are stored back to back, without offsets.
+      auto binary_arr = std::static_pointer_cast<::arrow::FixedSizeBinaryArray>(arr);
       ARROW_RETURN_NOT_OK(
-          out_->Write(std::reinterpret_pointer_cast<::arrow::DoubleArray>(arr)->values()));
+          out_->Write(binary_arr->GetValue(0), arr->length() * binary_arr->byte_width()));
       break;
+    }
+    case ::arrow::Type::FIXED_SIZE_LIST: {
+      // The values of all the rows are stored contiguously, without offsets.
+      auto list_arr = std::static_pointer_cast<::arrow::FixedSizeListArray>(arr);
+      auto value_type = list_arr->value_type();
+      if (!::arrow::is_primitive(value_type->id())) {
+        return Status::Invalid(
+            fmt::format("PlainEncoder:: does not support data type {}", data_type->ToString()));
+      }
+      auto list_size = list_arr->list_type()->list_size();
+      auto values = list_arr->values()->Slice(list_arr->value_offset(0), arr->length() * list_size);
+      ARROW_RETURN_NOT_OK(Write(values).status());
+      break;
+    }
     default:
       return Status::Invalid(
           fmt::format("PlainEncoder:: does not support data type {}", data_type->ToString()));
@@ -86,6 +113,11 @@ PlainEncoder::PlainEncoder(std::shared_ptr<::arrow::io::OutputStream> out) : Enc
 
 namespace {
 
+/// Decoder for fixed width values.
+///
+/// `T` is the physical type of the values. Logical types that share the same physical layout,
+/// i.e., timestamps over int64, reuse it and only differ by `type_`, which the decoded buffers
+/// are wrapped with, without copying or casting them.
 template <ArrowType T>
 class PlainDecoderImpl : public Decoder {
  public:
@@ -95,7 +127,7 @@ class PlainDecoderImpl : public Decoder {
   ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override {
     CType value;
     ARROW_RETURN_NOT_OK(infile_->ReadAt(position_ + idx * sizeof(value), sizeof(value), &value));
-    return std::make_shared<typename ::arrow::TypeTraits<T>::ScalarType>(value);
+    return ::arrow::MakeScalar(type_, value);
   }
 
   ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
@@ -110,10 +142,10 @@ class PlainDecoderImpl : public Decoder {
                       length.value(),
                       length_));
     }
-    auto bytes = std::max(1, ::arrow::bit_width(type_->id()) / 8);
+    auto bytes = static_cast<int64_t>(sizeof(CType));
     ARROW_ASSIGN_OR_RAISE(auto buf,
                           infile_->ReadAt(position_ + start * bytes, length.value() * bytes));
-    return std::make_shared<ArrayType>(length.value(), buf);
+    return MakeArray(length.value(), std::move(buf));
   }
 
   ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
@@ -128,21 +160,263 @@ class PlainDecoderImpl : public Decoder {
     // We can optimize this later if the indices are sparse and making small I/Os can bring
     // benefits.
     ARROW_ASSIGN_OR_RAISE(auto raw_value_arr, ToArray(start, length));
-    auto values = std::static_pointer_cast<ArrayType>(raw_value_arr);
-    BuilderType builder;
-    ARROW_RETURN_NOT_OK(builder.Reserve(indices->length()));
-    for (int64_t i = 0; i < indices->length(); i++) {
-      auto index = indices->Value(i);
-      ARROW_RETURN_NOT_OK(builder.Append(values->Value(index - start)));
-    }
-    return builder.Finish();
+    ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(indices->length() * sizeof(CType)));
+    kernels::Gather(raw_value_arr->data()->buffers[1]->data(),
+                    sizeof(CType),
+                    indices->raw_values(),
+                    indices->length(),
+                    start,
+                    buf->mutable_data());
+    return MakeArray(indices->length(), std::move(buf));
   }
 
  private:
   using CType = typename ::arrow::TypeTraits<T>::CType;
-  using ScalarType = typename ::arrow::TypeTraits<T>::ScalarType;
-  using ArrayType = typename ::arrow::TypeTraits<T>::ArrayType;
-  using BuilderType = typename ::arrow::TypeTraits<T>::BuilderType;
+
+  std::shared_ptr<::arrow::Array> MakeArray(int64_t length,
+                                            std::shared_ptr<::arrow::Buffer> values) const {
+    return ::arrow::MakeArray(
+        ::arrow::ArrayData::Make(type_, length, {nullptr, std::move(values)}, 0));
+  }
+};
+
+/// Decoder for bit-packed boolean values.
+class BooleanDecoderImpl : public Decoder {
+ public:
+  using Decoder::Decoder;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override {
+    uint8_t byte;
+    ARROW_RETURN_NOT_OK(infile_->ReadAt(position_ + idx / 8, 1, &byte));
+    return std::make_shared<::arrow::BooleanScalar>(::arrow::bit_util::GetBit(&byte, idx % 8));
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start, std::optional<int32_t> length) const override {
+    if (!length.has_value()) {
+      length = length_ - start;
+    }
+    if (start + length.value() > length_ || start > length_) {
+      return ::arrow::Status::IndexError(
+          fmt::format("PlainDecoder::ToArray: out of range: start={}, length={}, page_length={}\n",
+                      start,
+                      length.value(),
+                      length_));
+    }
+    // Only read the bytes covering the range, and keep the sub-byte start as the array offset.
+    auto first_byte = start / 8;
+    auto num_bytes = ::arrow::bit_util::BytesForBits(start + length.value()) - first_byte;
+    ARROW_ASSIGN_OR_RAISE(auto buf, infile_->ReadAt(position_ + first_byte, num_bytes));
+    return std::make_shared<::arrow::BooleanArray>(length.value(), buf, nullptr, 0, start % 8);
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override {
+    if (indices->length() == 0) {
+      return ::arrow::Status::Invalid("PlainDecoder::Take: Indices array is not valid");
+    }
+    int32_t start = indices->Value(0);
+    int32_t length = indices->Value(indices->length() - 1) - start + 1;
+    if (start < 0 || start + length > length_) {
+      return ::arrow::Status::Invalid("PlainDecoder::Take: Indices array is not valid");
+    }
+    auto first_byte = start / 8;
+    auto num_bytes = ::arrow::bit_util::BytesForBits(start + length) - first_byte;
+    ARROW_ASSIGN_OR_RAISE(auto buf, infile_->ReadAt(position_ + first_byte, num_bytes));
+    ARROW_ASSIGN_OR_RAISE(auto values, ::arrow::AllocateEmptyBitmap(indices->length()));
+    kernels::GatherBits(buf->data(),
+                        buf->size(),
+                        indices->raw_values(),
+                        indices->length(),
+                        first_byte * 8,
+                        values->mutable_data());
+    return std::make_shared<::arrow::BooleanArray>(indices->length(), values);
+  }
+};
+
+/// Decoder for fixed size binary values, i.e., hashes and UUIDs, and decimals.
+///
+/// Row `i` is at `i * byte_width`, so random access reads exactly one value.
+class FixedSizeBinaryDecoderImpl : public Decoder {
+ public:
+  FixedSizeBinaryDecoderImpl(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                             std::shared_ptr<::arrow::DataType> type)
+      : Decoder(infile, type),
+        byte_width_(std::static_pointer_cast<::arrow::FixedSizeBinaryType>(type)->byte_width()) {}
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override {
+    if (idx < 0 || idx >= length_) {
+      return ::arrow::Status::IndexError(fmt::format(
+          "PlainDecoder::GetScalar: out of range: idx={}, page_length={}", idx, length_));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto row, ToArray(idx, 1));
+    return row->GetScalar(0);
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start, std::optional<int32_t> length) const override {
+    if (!length.has_value()) {
+      length = length_ - start;
+    }
+    if (start + length.value() > length_ || start > length_) {
+      return ::arrow::Status::IndexError(
+          fmt::format("PlainDecoder::ToArray: out of range: start={}, length={}, page_length={}\n",
+                      start,
+                      length.value(),
+                      length_));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto buf,
+                          infile_->ReadAt(position_ + int64_t{start} * byte_width_,
+                                          int64_t{length.value()} * byte_width_));
+    return MakeArray(length.value(), std::move(buf));
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override {
+    if (indices->length() == 0) {
+      return ::arrow::Status::Invalid("PlainDecoder::Take: Indices array is not valid");
+    }
+    int32_t start = indices->Value(0);
+    int32_t length = indices->Value(indices->length() - 1) - start + 1;
+    ARROW_ASSIGN_OR_RAISE(auto rows, ToArray(start, length));
+    ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(indices->length() * byte_width_));
+    kernels::Gather(rows->data()->buffers[1]->data(),
+                    byte_width_,
+                    indices->raw_values(),
+                    indices->length(),
+                    start,
+                    buf->mutable_data());
+    return MakeArray(indices->length(), std::move(buf));
+  }
+
+  /// Scan the page for a key with `equal` / `not_equal`, i.e., to look up a hash.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      const std::string& function, const ::arrow::Datum& literal) const override {
+    if (type_->id() != ::arrow::Type::FIXED_SIZE_BINARY ||
+        (function != "equal" && function != "not_equal") || !literal.is_scalar() ||
+        !literal.scalar()->is_valid) {
+      return ::arrow::Status::NotImplemented(
+          fmt::format("PlainDecoder::Filter: unsupported predicate {}", function));
+    }
+    std::shared_ptr<::arrow::Buffer> key;
+    auto& scalar = literal.scalar();
+    if (scalar->type->id() == ::arrow::Type::FIXED_SIZE_BINARY ||
+        ::arrow::is_base_binary_like(scalar->type->id())) {
+      key = std::static_pointer_cast<::arrow::BaseBinaryScalar>(scalar)->value;
+    } else {
+      return ::arrow::Status::NotImplemented(fmt::format(
+          "PlainDecoder::Filter: can not compare with {}", scalar->type->ToString()));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto bitmap, ::arrow::AllocateEmptyBitmap(length_));
+    if (key->size() == byte_width_) {
+      ARROW_ASSIGN_OR_RAISE(auto values,
+                            infile_->ReadAt(position_, int64_t{length_} * byte_width_));
+      kernels::EqualFixedSize(
+          values->data(), byte_width_, length_, key->data(), bitmap->mutable_data());
+    }
+    if (function == "not_equal") {
+      ::arrow::internal::InvertBitmap(bitmap->data(), 0, length_, bitmap->mutable_data(), 0);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto indices, ::arrow::AllocateBuffer(length_ * sizeof(int32_t)));
+    auto count = kernels::BitmapToIndices(
+        bitmap->data(), 0, length_, reinterpret_cast<int32_t*>(indices->mutable_data()));
+    return std::make_shared<::arrow::Int32Array>(count, std::move(indices));
+  }
+
+ private:
+  std::shared_ptr<::arrow::Array> MakeArray(int64_t length,
+                                            std::shared_ptr<::arrow::Buffer> values) const {
+    return ::arrow::MakeArray(
+        ::arrow::ArrayData::Make(type_, length, {nullptr, std::move(values)}, 0));
+  }
+
+  int32_t byte_width_;
+};
+
+/// Decoder for fixed size lists of primitive values, i.e., embeddings.
+///
+/// The values of the rows are stored contiguously, so the row `i` starts at value
+/// `i * list_size`.
+class FixedSizeListDecoderImpl : public Decoder {
+ public:
+  FixedSizeListDecoderImpl(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                           std::shared_ptr<::arrow::DataType> type)
+      : Decoder(infile, type),
+        list_type_(std::static_pointer_cast<::arrow::FixedSizeListType>(type)),
+        values_decoder_(infile, list_type_->value_type()) {}
+
+  ::arrow::Status Init() override { return values_decoder_.Init(); }
+
+  void Reset(int64_t position, int32_t length) override {
+    Decoder::Reset(position, length);
+    values_decoder_.Reset(position, length * list_type_->list_size());
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override {
+    auto list_size = list_type_->list_size();
+    ARROW_ASSIGN_OR_RAISE(auto values, values_decoder_.ToArray(idx * list_size, list_size));
+    return std::make_shared<::arrow::FixedSizeListScalar>(values, type_);
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start, std::optional<int32_t> length) const override {
+    if (!length.has_value()) {
+      length = length_ - start;
+    }
+    auto list_size = list_type_->list_size();
+    ARROW_ASSIGN_OR_RAISE(auto values,
+                          values_decoder_.ToArray(start * list_size, length.value() * list_size));
+    return std::make_shared<::arrow::FixedSizeListArray>(type_, length.value(), values);
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override {
+    if (indices->length() == 0) {
+      return ::arrow::Status::Invalid("PlainDecoder::Take: Indices array is not valid");
+    }
+    int32_t start = indices->Value(0);
+    int32_t length = indices->Value(indices->length() - 1) - start + 1;
+    ARROW_ASSIGN_OR_RAISE(auto rows, ToArray(start, length));
+    auto values = std::static_pointer_cast<::arrow::FixedSizeListArray>(rows)->values();
+    auto value_type = list_type_->value_type();
+    auto list_size = list_type_->list_size();
+    auto& values_buf = values->data()->buffers[1];
+    if (value_type->id() == ::arrow::Type::BOOL) {
+      // Gather the bits of the values of each selected row.
+      auto num_values = indices->length() * list_size;
+      std::vector<int32_t> value_indices(num_values);
+      for (int64_t i = 0; i < indices->length(); i++) {
+        auto first = static_cast<int32_t>(values->offset()) +
+                     (indices->Value(i) - start) * list_size;
+        std::iota(value_indices.begin() + i * list_size,
+                  value_indices.begin() + (i + 1) * list_size,
+                  first);
+      }
+      ARROW_ASSIGN_OR_RAISE(auto bitmap, ::arrow::AllocateEmptyBitmap(num_values));
+      kernels::GatherBits(values_buf->data(),
+                          values_buf->size(),
+                          value_indices.data(),
+                          num_values,
+                          0,
+                          bitmap->mutable_data());
+      auto taken = std::make_shared<::arrow::BooleanArray>(num_values, std::move(bitmap));
+      return std::make_shared<::arrow::FixedSizeListArray>(type_, indices->length(), taken);
+    }
+    // Strided gather: copy one row (`list_size` values) at a time.
+    int32_t byte_width = ::arrow::bit_width(value_type->id()) / 8;
+    int32_t row_bytes = list_size * byte_width;
+    auto src = values_buf->data() + values->offset() * byte_width;
+    ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(indices->length() * row_bytes));
+    kernels::Gather(
+        src, row_bytes, indices->raw_values(), indices->length(), start, buf->mutable_data());
+    auto taken = ::arrow::MakeArray(::arrow::ArrayData::Make(
+        value_type, indices->length() * list_size, {nullptr, std::move(buf)}));
+    return std::make_shared<::arrow::FixedSizeListArray>(type_, indices->length(), taken);
+  }
+
+ private:
+  std::shared_ptr<::arrow::FixedSizeListType> list_type_;
+  PlainDecoder values_decoder_;
 };
 
 }  // namespace
@@ -156,7 +430,7 @@ PlainDecoder::~PlainDecoder() {}
 ::arrow::Status PlainDecoder::Init() {
   switch (type_->id()) {
     case ::arrow::Type::BOOL:
-      impl_.reset(new PlainDecoderImpl<::arrow::BooleanType>(infile_, type_));
+      impl_.reset(new BooleanDecoderImpl(infile_, type_));
       break;
     case ::arrow::Type::INT8:
       impl_.reset(new PlainDecoderImpl<::arrow::Int8Type>(infile_, type_));
@@ -188,10 +462,28 @@ PlainDecoder::~PlainDecoder() {}
     case ::arrow::Type::DOUBLE:
       impl_.reset(new PlainDecoderImpl<::arrow::DoubleType>(infile_, type_));
       break;
+    case ::arrow::Type::DATE32:
+    case ::arrow::Type::TIME32:
+      impl_.reset(new PlainDecoderImpl<::arrow::Int32Type>(infile_, type_));
+      break;
+    case ::arrow::Type::DATE64:
+    case ::arrow::Type::TIME64:
+    case ::arrow::Type::TIMESTAMP:
+    case ::arrow::Type::DURATION:
+      impl_.reset(new PlainDecoderImpl<::arrow::Int64Type>(infile_, type_));
+      break;
+    case ::arrow::Type::FIXED_SIZE_BINARY:
+    case ::arrow::Type::DECIMAL128:
+    case ::arrow::Type::DECIMAL256:
+      impl_.reset(new FixedSizeBinaryDecoderImpl(infile_, type_));
+      break;
+    case ::arrow::Type::FIXED_SIZE_LIST:
+      impl_.reset(new FixedSizeListDecoderImpl(infile_, type_));
+      break;
     default:
       return ::arrow::Status::Invalid(fmt::format("Unsupported type: {}", type_->ToString()));
   }
-  return ::arrow::Status::OK();
+  return impl_->Init();
 }
 
 void PlainDecoder::Reset(int64_t position, int32_t length) {
@@ -213,4 +505,9 @@ void PlainDecoder::Reset(int64_t position, int32_t length) {
   return impl_->Take(indices);
 }
 
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> PlainDecoder::Filter(
+    const std::string& function, const ::arrow::Datum& literal) const {
+  return impl_->Filter(function, literal);
+}
+
 }  // namespace lance::encodings
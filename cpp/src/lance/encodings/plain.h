@@ -20,6 +20,7 @@
 #include <fmt/format.h>
 
 #include <memory>
+#include <string>
 
 #include "lance/encodings/encoder.h"
 
@@ -28,6 +29,9 @@ namespace lance::encodings {
 /// Plain Encoder.
 ///
 /// Encoding fixed sized values in an plain array.
+///
+/// Boolean values are bit-packed, with the first value at the lowest bit of the first byte.
+/// Fixed size binary values are stored back to back.
 class PlainEncoder : public Encoder {
  public:
   explicit PlainEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
@@ -61,6 +65,11 @@ class PlainDecoder : public Decoder {
   ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
       std::shared_ptr<::arrow::Int32Array> indices) const override;
 
+  /// Evaluate `equal` / `not_equal` over fixed size binary values, without decoding the page
+  /// into an array.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      const std::string& function, const ::arrow::Datum& literal) const override;
+
  private:
   std::unique_ptr<Decoder> impl_;
 };
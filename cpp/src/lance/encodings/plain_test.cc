@@ -16,7 +16,9 @@
 
 #include <arrow/array.h>
 #include <arrow/builder.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
+#include <fmt/format.h>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -66,3 +68,163 @@ TEST_CASE("Test take plain values") {
   INFO("Indices " << indices->ToString() << " Actual " << actual->ToString());
   CHECK(actual->Equals(indices));
 }
+
+TEST_CASE("Write and read bit-packed boolean array") {
+  arrow::BooleanBuilder builder;
+  for (int i = 0; i < 37; i++) {
+    CHECK(builder.Append(i % 3 == 0 || i % 7 == 0).ok());
+  }
+  auto arr = builder.Finish().ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  lance::encodings::PlainEncoder encoder(sink);
+  // Write a slice that does not start at a byte boundary.
+  auto offset = encoder.Write(arr->Slice(3)).ValueOrDie();
+  auto expected = arr->Slice(3);
+  CHECK(sink->Tell().ValueOrDie() - offset == 5);
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  lance::encodings::PlainDecoder decoder(infile, arrow::boolean());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, expected->length());
+
+  CHECK(expected->Equals(decoder.ToArray().ValueOrDie()));
+  for (int start = 0; start + 9 <= expected->length(); start += 5) {
+    auto actual = decoder.ToArray(start, 9).ValueOrDie();
+    INFO("Start " << start << " actual " << actual->ToString());
+    CHECK(expected->Slice(start, 9)->Equals(actual));
+  }
+  for (int i = 0; i < expected->length(); i++) {
+    CHECK(expected->GetScalar(i).ValueOrDie()->Equals(decoder.GetScalar(i).ValueOrDie()));
+  }
+
+  auto indices = lance::arrow::ToArray({1, 2, 9, 17, 30}).ValueOrDie();
+  auto actual = decoder.Take(indices).ValueOrDie();
+  auto expected_take = arrow::compute::Take(expected, indices).ValueOrDie().make_array();
+  INFO("Expected " << expected_take->ToString() << " Actual " << actual->ToString());
+  CHECK(expected_take->Equals(actual));
+}
+
+TEST_CASE("Write and read fixed size list array") {
+  const int kDimension = 4;
+  std::vector<float> values;
+  for (int i = 0; i < 10 * kDimension; i++) {
+    values.emplace_back(i);
+  }
+  auto values_arr = lance::arrow::ToArray(values).ValueOrDie();
+  auto arr = arrow::FixedSizeListArray::FromArrays(values_arr, kDimension).ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  lance::encodings::PlainEncoder encoder(sink);
+  // Write a slice, only the values of the sliced rows are written.
+  auto expected = arr->Slice(2);
+  auto offset = encoder.Write(expected).ValueOrDie();
+  CHECK(sink->Tell().ValueOrDie() - offset == 8 * kDimension * sizeof(float));
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  lance::encodings::PlainDecoder decoder(infile, arr->type());
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, expected->length());
+
+  auto actual = decoder.ToArray().ValueOrDie();
+  INFO("Expected " << expected->ToString() << " Actual " << actual->ToString());
+  CHECK(expected->Equals(actual));
+  CHECK(expected->Slice(3, 2)->Equals(decoder.ToArray(3, 2).ValueOrDie()));
+  CHECK(decoder.GetScalar(5).ValueOrDie()->Equals(expected->GetScalar(5).ValueOrDie()));
+
+  auto indices = lance::arrow::ToArray({1, 4, 5, 7}).ValueOrDie();
+  auto expected_take = arrow::compute::Take(expected, indices).ValueOrDie().make_array();
+  auto actual_take = decoder.Take(indices).ValueOrDie();
+  INFO("Expected " << expected_take->ToString() << " Actual " << actual_take->ToString());
+  CHECK(expected_take->Equals(actual_take));
+}
+
+TEST_CASE("Write and read fixed size binary array") {
+  const int kByteWidth = 16;
+  auto type = arrow::fixed_size_binary(kByteWidth);
+  arrow::FixedSizeBinaryBuilder builder(type);
+  for (int i = 0; i < 100; i++) {
+    auto key = fmt::format("uuid-{:011d}", i % 40);
+    CHECK(builder.Append(key).ok());
+  }
+  auto arr = builder.Finish().ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  lance::encodings::PlainEncoder encoder(sink);
+  auto expected = arr->Slice(10);
+  auto offset = encoder.Write(expected).ValueOrDie();
+  CHECK(sink->Tell().ValueOrDie() - offset == 90 * kByteWidth);
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  lance::encodings::PlainDecoder decoder(infile, type);
+  CHECK(decoder.Init().ok());
+  decoder.Reset(offset, expected->length());
+
+  CHECK(expected->Equals(decoder.ToArray().ValueOrDie()));
+  CHECK(expected->Slice(5, 20)->Equals(decoder.ToArray(5, 20).ValueOrDie()));
+  CHECK(decoder.GetScalar(33).ValueOrDie()->Equals(expected->GetScalar(33).ValueOrDie()));
+  CHECK(!decoder.GetScalar(90).ok());
+
+  auto indices = lance::arrow::ToArray({1, 4, 5, 77}).ValueOrDie();
+  auto expected_take = arrow::compute::Take(expected, indices).ValueOrDie().make_array();
+  CHECK(expected_take->Equals(decoder.Take(indices).ValueOrDie()));
+
+  // Rows 10 + {20, 60} hold "uuid-00000000030".
+  auto key = std::make_shared<arrow::FixedSizeBinaryScalar>(
+      arrow::Buffer::FromString("uuid-00000000030"), type);
+  auto matched = decoder.Filter("equal", key).ValueOrDie();
+  CHECK(matched->Equals(lance::arrow::ToArray({20, 60}).ValueOrDie()));
+  auto not_matched = decoder.Filter("not_equal", key).ValueOrDie();
+  CHECK(not_matched->length() == 88);
+  // Keys of a different width never match.
+  auto short_key = std::make_shared<arrow::BinaryScalar>(arrow::Buffer::FromString("uuid"));
+  CHECK(decoder.Filter("equal", short_key).ValueOrDie()->length() == 0);
+  CHECK(!decoder.Filter("less", key).ok());
+}
+
+TEST_CASE("Write and read temporal and decimal arrays") {
+  for (auto& type : std::vector<std::shared_ptr<arrow::DataType>>{
+           arrow::timestamp(arrow::TimeUnit::MICRO, "UTC"),
+           arrow::date32(),
+           arrow::time64(arrow::TimeUnit::NANO),
+           arrow::duration(arrow::TimeUnit::MILLI),
+           arrow::decimal128(24, 4),
+           arrow::decimal256(50, 4),
+       }) {
+    INFO("Type: " << type->ToString());
+    std::vector<int64_t> values;
+    for (int i = 0; i < 50; i++) {
+      values.emplace_back(1000 + i * 37);
+    }
+    std::shared_ptr<arrow::Array> arr = lance::arrow::ToArray(values).ValueOrDie();
+    if (arrow::is_decimal(type->id())) {
+      arr = arrow::compute::Cast(*arr, type).ValueOrDie();
+    } else {
+      // View the physical values as the logical type.
+      if (type->id() == arrow::Type::DATE32) {
+        arr = arrow::compute::Cast(*arr, arrow::int32()).ValueOrDie();
+      }
+      arr = arr->View(type).ValueOrDie();
+    }
+
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    lance::encodings::PlainEncoder encoder(sink);
+    auto expected = arr->Slice(3);
+    auto offset = encoder.Write(expected).ValueOrDie();
+
+    auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+    lance::encodings::PlainDecoder decoder(infile, type);
+    CHECK(decoder.Init().ok());
+    decoder.Reset(offset, expected->length());
+
+    auto actual = decoder.ToArray().ValueOrDie();
+    CHECK(actual->type()->Equals(type));
+    CHECK(expected->Equals(actual));
+    CHECK(expected->Slice(5, 20)->Equals(decoder.ToArray(5, 20).ValueOrDie()));
+    CHECK(decoder.GetScalar(33).ValueOrDie()->Equals(expected->GetScalar(33).ValueOrDie()));
+
+    auto indices = lance::arrow::ToArray({1, 4, 5, 40}).ValueOrDie();
+    auto expected_take = arrow::compute::Take(expected, indices).ValueOrDie().make_array();
+    CHECK(expected_take->Equals(decoder.Take(indices).ValueOrDie()));
+  }
+}
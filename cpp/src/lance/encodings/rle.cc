@@ -0,0 +1,383 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/encodings/rle.h"
+
+#include <arrow/array/util.h>
+#include <arrow/buffer.h>
+#include <arrow/compute/api.h>
+#include <arrow/result.h>
+#include <arrow/scalar.h>
+#include <arrow/status.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+#include "lance/encodings/binary.h"
+#include "lance/encodings/kernels.h"
+#include "lance/encodings/plain.h"
+#include "lance/io/endian.h"
+
+namespace lance::encodings {
+
+namespace {
+
+/// Size of the run header: `num_runs:int32` and `values_position:int64`.
+constexpr int64_t kRunHeaderSize = sizeof(int32_t) + sizeof(int64_t);
+
+/// Whether two values are the same. Floating-point values are compared by their bits, so that
+/// -0.0 and 0.0 are in different runs, and a run of NaNs keeps its payload.
+template <typename T>
+bool SameValue(const T& a, const T& b) {
+  if constexpr (std::is_same_v<T, float>) {
+    return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b);
+  } else if constexpr (std::is_same_v<T, double>) {
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+  } else {
+    return a == b;
+  }
+}
+
+template <typename ArrayType>
+std::vector<int32_t> GetRunEnds(const ArrayType& arr) {
+  std::vector<int32_t> run_ends;
+  for (int64_t i = 1; i < arr.length(); i++) {
+    if (!SameValue(arr.GetView(i), arr.GetView(i - 1))) {
+      run_ends.emplace_back(i);
+    }
+  }
+  if (arr.length() > 0) {
+    run_ends.emplace_back(arr.length());
+  }
+  return run_ends;
+}
+
+std::vector<int32_t> GetRunEnds(const ::arrow::BooleanArray& arr) {
+  // Compare unpacked bytes instead of extracting two bits per row.
+  std::vector<uint8_t> values(arr.length());
+  kernels::UnpackBits(arr.values()->data(), arr.offset(), arr.length(), values.data());
+  std::vector<int32_t> run_ends;
+  for (int64_t i = 1; i < arr.length(); i++) {
+    if (values[i] != values[i - 1]) {
+      run_ends.emplace_back(i);
+    }
+  }
+  if (arr.length() > 0) {
+    run_ends.emplace_back(arr.length());
+  }
+  return run_ends;
+}
+
+/// The unsigned integer type of the same width as a temporal type, or nullptr for the other
+/// types.
+std::shared_ptr<::arrow::DataType> GetPhysicalType(const ::arrow::DataType& type) {
+  switch (type.id()) {
+    case ::arrow::Type::DATE32:
+    case ::arrow::Type::TIME32:
+    case ::arrow::Type::INTERVAL_MONTHS:
+      return ::arrow::uint32();
+    case ::arrow::Type::DATE64:
+    case ::arrow::Type::TIME64:
+    case ::arrow::Type::TIMESTAMP:
+    case ::arrow::Type::DURATION:
+      return ::arrow::uint64();
+    default:
+      return nullptr;
+  }
+}
+
+/// View an array as another type of the same layout.
+std::shared_ptr<::arrow::Array> ViewAs(const std::shared_ptr<::arrow::Array>& arr,
+                                       const std::shared_ptr<::arrow::DataType>& type) {
+  auto data = arr->data()->Copy();
+  data->type = type;
+  return ::arrow::MakeArray(data);
+}
+
+::arrow::Result<std::vector<int32_t>> GetRunEnds(const std::shared_ptr<::arrow::Array>& arr) {
+  switch (arr->type_id()) {
+    case ::arrow::Type::BOOL:
+      return GetRunEnds(static_cast<const ::arrow::BooleanArray&>(*arr));
+    case ::arrow::Type::INT8:
+      return GetRunEnds(static_cast<const ::arrow::Int8Array&>(*arr));
+    case ::arrow::Type::UINT8:
+      return GetRunEnds(static_cast<const ::arrow::UInt8Array&>(*arr));
+    case ::arrow::Type::INT16:
+      return GetRunEnds(static_cast<const ::arrow::Int16Array&>(*arr));
+    case ::arrow::Type::UINT16:
+      return GetRunEnds(static_cast<const ::arrow::UInt16Array&>(*arr));
+    case ::arrow::Type::INT32:
+      return GetRunEnds(static_cast<const ::arrow::Int32Array&>(*arr));
+    case ::arrow::Type::UINT32:
+      return GetRunEnds(static_cast<const ::arrow::UInt32Array&>(*arr));
+    case ::arrow::Type::INT64:
+      return GetRunEnds(static_cast<const ::arrow::Int64Array&>(*arr));
+    case ::arrow::Type::UINT64:
+      return GetRunEnds(static_cast<const ::arrow::UInt64Array&>(*arr));
+    case ::arrow::Type::FLOAT:
+      return GetRunEnds(static_cast<const ::arrow::FloatArray&>(*arr));
+    case ::arrow::Type::DOUBLE:
+      return GetRunEnds(static_cast<const ::arrow::DoubleArray&>(*arr));
+    case ::arrow::Type::STRING:
+      return GetRunEnds(static_cast<const ::arrow::StringArray&>(*arr));
+    case ::arrow::Type::BINARY:
+      return GetRunEnds(static_cast<const ::arrow::BinaryArray&>(*arr));
+    default:
+      return ::arrow::Status::Invalid(
+          fmt::format("RLEEncoder: does not support data type {}", arr->type()->ToString()));
+  }
+}
+
+}  // namespace
+
+RLEEncoder::RLEEncoder(std::shared_ptr<::arrow::io::OutputStream> out) : Encoder(out) {}
+
+bool RLEEncoder::Supports(const std::shared_ptr<::arrow::DataType>& type) {
+  switch (type->id()) {
+    case ::arrow::Type::BOOL:
+    case ::arrow::Type::INT8:
+    case ::arrow::Type::UINT8:
+    case ::arrow::Type::INT16:
+    case ::arrow::Type::UINT16:
+    case ::arrow::Type::INT32:
+    case ::arrow::Type::UINT32:
+    case ::arrow::Type::INT64:
+    case ::arrow::Type::UINT64:
+    case ::arrow::Type::FLOAT:
+    case ::arrow::Type::DOUBLE:
+    case ::arrow::Type::STRING:
+    case ::arrow::Type::BINARY:
+      return true;
+    default:
+      return GetPhysicalType(*type) != nullptr;
+  }
+}
+
+::arrow::Result<int64_t> RLEEncoder::Write(std::shared_ptr<::arrow::Array> arr) {
+  auto type = arr->type();
+  if (auto physical_type = GetPhysicalType(*type)) {
+    arr = ViewAs(arr, physical_type);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto run_ends, GetRunEnds(arr));
+  int32_t num_runs = run_ends.size();
+
+  ARROW_ASSIGN_OR_RAISE(auto values_position, out_->Tell());
+  if (num_runs > 0) {
+    // The first row of each run carries the value of the run.
+    std::vector<int32_t> run_starts(num_runs, 0);
+    std::copy(run_ends.begin(), run_ends.end() - 1, run_starts.begin() + 1);
+    ARROW_ASSIGN_OR_RAISE(auto run_starts_arr, lance::arrow::ToArray(run_starts));
+    ARROW_ASSIGN_OR_RAISE(auto values_datum, ::arrow::compute::Take(arr, run_starts_arr));
+    auto values = ViewAs(values_datum.make_array(), type);
+    if (::arrow::is_binary_like(arr->type_id())) {
+      ARROW_ASSIGN_OR_RAISE(values_position, VarBinaryEncoder(out_).Write(values));
+    } else {
+      ARROW_ASSIGN_OR_RAISE(values_position, PlainEncoder(out_).Write(values));
+    }
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto header_position, out_->Tell());
+  ARROW_RETURN_NOT_OK(lance::io::WriteInt<int32_t>(out_, num_runs));
+  ARROW_RETURN_NOT_OK(lance::io::WriteInt<int64_t>(out_, values_position));
+  if (num_runs > 0) {
+    ARROW_ASSIGN_OR_RAISE(auto run_ends_arr, lance::arrow::ToArray(run_ends));
+    ARROW_RETURN_NOT_OK(out_->Write(run_ends_arr->values()));
+  }
+  return header_position;
+}
+
+RLEDecoder::RLEDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+                       std::shared_ptr<::arrow::DataType> type)
+    : Decoder(infile, type) {}
+
+::arrow::Status RLEDecoder::Init() {
+  switch (type_->id()) {
+    case ::arrow::Type::STRING:
+      values_decoder_ = std::make_unique<VarBinaryDecoder<::arrow::StringType>>(infile_, type_);
+      break;
+    case ::arrow::Type::BINARY:
+      values_decoder_ = std::make_unique<VarBinaryDecoder<::arrow::BinaryType>>(infile_, type_);
+      break;
+    default:
+      values_decoder_ = std::make_unique<PlainDecoder>(infile_, type_);
+  }
+  return values_decoder_->Init();
+}
+
+void RLEDecoder::Reset(int64_t position, int32_t length) {
+  Decoder::Reset(position, length);
+  run_ends_.reset();
+}
+
+::arrow::Status RLEDecoder::LoadRuns() const {
+  if (run_ends_) {
+    return ::arrow::Status::OK();
+  }
+  ARROW_ASSIGN_OR_RAISE(auto header, infile_->ReadAt(position_, kRunHeaderSize));
+  if (header->size() < kRunHeaderSize) {
+    return ::arrow::Status::IOError(
+        fmt::format("RLEDecoder: failed to read run header at {}", position_));
+  }
+  auto num_runs = lance::io::ReadInt<int32_t>(header->data());
+  auto values_position = lance::io::ReadInt<int64_t>(header->data() + sizeof(int32_t));
+  ARROW_ASSIGN_OR_RAISE(auto run_ends_buf,
+                        infile_->ReadAt(position_ + kRunHeaderSize, num_runs * sizeof(int32_t)));
+  run_ends_ = std::make_shared<::arrow::Int32Array>(num_runs, run_ends_buf);
+  values_decoder_->Reset(values_position, num_runs);
+  return ::arrow::Status::OK();
+}
+
+int32_t RLEDecoder::FindRun(int32_t idx) const {
+  auto begin = run_ends_->raw_values();
+  auto end = begin + run_ends_->length();
+  return std::distance(begin, std::upper_bound(begin, end, idx));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> RLEDecoder::RepeatRun(int32_t run,
+                                                                       int64_t length) const {
+  ARROW_ASSIGN_OR_RAISE(auto value, values_decoder_->GetScalar(run));
+  return ::arrow::MakeArrayFromScalar(*value, length);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> RLEDecoder::Expand(
+    int32_t first_run,
+    int32_t num_runs,
+    const std::shared_ptr<::arrow::Int32Array>& run_indices) const {
+  ARROW_ASSIGN_OR_RAISE(auto values, values_decoder_->ToArray(first_run, num_runs));
+  ARROW_ASSIGN_OR_RAISE(auto datum, ::arrow::compute::Take(values, run_indices));
+  return datum.make_array();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> RLEDecoder::GetScalar(int64_t idx) const {
+  if (idx < 0 || idx >= length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("RLEDecoder::GetScalar: out of range: idx={} page_length={}", idx, length_));
+  }
+  ARROW_RETURN_NOT_OK(LoadRuns());
+  return values_decoder_->GetScalar(FindRun(idx));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> RLEDecoder::ToArray(
+    int32_t start, std::optional<int32_t> length) const {
+  if (!length.has_value()) {
+    length = length_ - start;
+  }
+  if (start < 0 || start + *length > length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("RLEDecoder::ToArray: out of range: start={}, length={}, page_length={}",
+                    start,
+                    *length,
+                    length_));
+  }
+  if (*length == 0) {
+    return ::arrow::MakeEmptyArray(type_);
+  }
+  ARROW_RETURN_NOT_OK(LoadRuns());
+  auto end = start + *length;
+  auto first_run = FindRun(start);
+  auto last_run = FindRun(end - 1);
+  if (first_run == last_run) {
+    return RepeatRun(first_run, *length);
+  }
+
+  ARROW_ASSIGN_OR_RAISE(std::shared_ptr<::arrow::Buffer> buf,
+                        ::arrow::AllocateBuffer(*length * sizeof(int32_t)));
+  auto run_indices = reinterpret_cast<int32_t*>(buf->mutable_data());
+  auto row = start;
+  for (auto run = first_run; run <= last_run; run++) {
+    auto run_end = std::min(run_ends_->Value(run), end);
+    std::fill(run_indices + row - start, run_indices + run_end - start, run - first_run);
+    row = run_end;
+  }
+  return Expand(
+      first_run, last_run - first_run + 1, std::make_shared<::arrow::Int32Array>(*length, buf));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> RLEDecoder::Take(
+    std::shared_ptr<::arrow::Int32Array> indices) const {
+  if (indices->length() == 0) {
+    return ::arrow::MakeEmptyArray(type_);
+  }
+  auto first_index = indices->Value(0);
+  auto last_index = indices->Value(indices->length() - 1);
+  if (first_index < 0 || last_index >= length_) {
+    return ::arrow::Status::IndexError(
+        fmt::format("RLEDecoder::Take: indices out of range: [{}, {}], page_length={}",
+                    first_index,
+                    last_index,
+                    length_));
+  }
+  ARROW_RETURN_NOT_OK(LoadRuns());
+  auto first_run = FindRun(first_index);
+  auto last_run = FindRun(last_index);
+  if (first_run == last_run) {
+    return RepeatRun(first_run, indices->length());
+  }
+
+  ARROW_ASSIGN_OR_RAISE(std::shared_ptr<::arrow::Buffer> buf,
+                        ::arrow::AllocateBuffer(indices->length() * sizeof(int32_t)));
+  auto run_indices = reinterpret_cast<int32_t*>(buf->mutable_data());
+  // Indices are sorted, so each binary search starts from the run of the previous index.
+  auto begin = run_ends_->raw_values();
+  auto end = begin + run_ends_->length();
+  auto it = begin + first_run;
+  for (int64_t i = 0; i < indices->length(); i++) {
+    it = std::upper_bound(it, end, indices->Value(i));
+    run_indices[i] = std::distance(begin, it) - first_run;
+  }
+  return Expand(first_run,
+                last_run - first_run + 1,
+                std::make_shared<::arrow::Int32Array>(indices->length(), buf));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> RLEDecoder::Filter(
+    const std::string& function, const ::arrow::Datum& literal) const {
+  ARROW_RETURN_NOT_OK(LoadRuns());
+  auto num_runs = run_ends_->length();
+  if (num_runs == 0) {
+    return lance::arrow::ToArray<int32_t>({});
+  }
+  ARROW_ASSIGN_OR_RAISE(auto values, values_decoder_->ToArray(0, num_runs));
+  ARROW_ASSIGN_OR_RAISE(auto mask_datum,
+                        ::arrow::compute::CallFunction(function, {values, literal}));
+  auto mask = std::static_pointer_cast<::arrow::BooleanArray>(mask_datum.make_array());
+
+  auto run_start = [&](int64_t run) { return run == 0 ? 0 : run_ends_->Value(run - 1); };
+  int64_t num_rows = 0;
+  for (int64_t run = 0; run < num_runs; run++) {
+    if (mask->IsValid(run) && mask->Value(run)) {
+      num_rows += run_ends_->Value(run) - run_start(run);
+    }
+  }
+  ARROW_ASSIGN_OR_RAISE(std::shared_ptr<::arrow::Buffer> buf,
+                        ::arrow::AllocateBuffer(num_rows * sizeof(int32_t)));
+  auto indices = reinterpret_cast<int32_t*>(buf->mutable_data());
+  for (int64_t run = 0; run < num_runs; run++) {
+    if (mask->IsValid(run) && mask->Value(run)) {
+      auto start = run_start(run);
+      auto run_length = run_ends_->Value(run) - start;
+      std::iota(indices, indices + run_length, start);
+      indices += run_length;
+    }
+  }
+  return std::make_shared<::arrow::Int32Array>(num_rows, buf);
+}
+
+}  // namespace lance::encodings
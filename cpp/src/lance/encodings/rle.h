@@ -0,0 +1,108 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/datum.h>
+#include <arrow/io/api.h>
+
+#include <memory>
+#include <string>
+
+#include "lance/encodings/encoder.h"
+
+namespace lance::encodings {
+
+/// Run-length Encoder.
+///
+/// Layout:
+///
+/// |value1|value2|...|valueN|
+/// |num_runs:int32|values_position:int64|run_end1:int32|...|run_endN:int32|
+///
+/// The run values are written with plain encoding (primitive types) or var-binary encoding
+/// (string / binary types). The runs of temporal values are found by their physical integer
+/// values. `run_end` is the exclusive end row of each run within the page.
+/// It returns the position of the run header.
+class RLEEncoder : public Encoder {
+ public:
+  explicit RLEEncoder(std::shared_ptr<::arrow::io::OutputStream> out);
+
+  virtual ~RLEEncoder() = default;
+
+  /// Whether the run-length encoding supports the data type.
+  static bool Supports(const std::shared_ptr<::arrow::DataType>& type);
+
+  ::arrow::Result<int64_t> Write(std::shared_ptr<::arrow::Array> arr) override;
+
+  std::string ToString() const override { return "Encoder(type=RLE)"; }
+};
+
+/// Run-length Decoder.
+///
+/// Rows are located via binary search on the run ends, so that random access and filters
+/// run in proportion to the number of runs instead of the number of rows.
+class RLEDecoder : public Decoder {
+ public:
+  RLEDecoder(std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+             std::shared_ptr<::arrow::DataType> type);
+
+  ~RLEDecoder() override = default;
+
+  ::arrow::Status Init() override;
+
+  void Reset(int64_t position, int32_t length) override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetScalar(int64_t idx) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> ToArray(
+      int32_t start = 0, std::optional<int32_t> length = std::nullopt) const override;
+
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Take(
+      std::shared_ptr<::arrow::Int32Array> indices) const override;
+
+  /// Evaluate a comparison predicate over the runs, without expanding them into rows.
+  /// The predicate is evaluated once per run, and only the matched runs are expanded into
+  /// row indices.
+  ///
+  /// \param function the name of an arrow compute comparison function, i.e., "equal", "less".
+  /// \param literal the right hand side of the comparison.
+  /// \return the sorted indices of the rows that satisfy the predicate.
+  ::arrow::Result<std::shared_ptr<::arrow::Int32Array>> Filter(
+      const std::string& function, const ::arrow::Datum& literal) const override;
+
+ private:
+  /// Read the run header and the run ends of the page, if they have not been loaded yet.
+  ::arrow::Status LoadRuns() const;
+
+  /// Find the run that contains the row.
+  int32_t FindRun(int32_t idx) const;
+
+  /// Build an array by repeating the value of one run.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> RepeatRun(int32_t run, int64_t length) const;
+
+  /// Expand the runs `[first_run, first_run + num_runs)` into rows.
+  ///
+  /// \param run_indices the run of each output row, relative to `first_run`.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> Expand(
+      int32_t first_run,
+      int32_t num_runs,
+      const std::shared_ptr<::arrow::Int32Array>& run_indices) const;
+
+  std::unique_ptr<Decoder> values_decoder_;
+  mutable std::shared_ptr<::arrow::Int32Array> run_ends_;
+};
+
+}  // namespace lance::encodings
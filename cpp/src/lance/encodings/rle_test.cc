@@ -0,0 +1,186 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+
+#include "lance/encodings/rle.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/api.h>
+#include <arrow/scalar.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+
+using lance::encodings::RLEDecoder;
+using lance::encodings::RLEEncoder;
+
+namespace {
+
+std::unique_ptr<RLEDecoder> WriteRLE(const std::shared_ptr<::arrow::Array>& arr) {
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  RLEEncoder encoder(sink);
+  auto offset = encoder.Write(arr).ValueOrDie();
+
+  auto infile = std::make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto decoder = std::make_unique<RLEDecoder>(infile, arr->type());
+  CHECK(decoder->Init().ok());
+  decoder->Reset(offset, arr->length());
+  return decoder;
+}
+
+/// The "equal" function, which counts the values that it compares.
+class CountingEqual : public ::arrow::compute::MetaFunction {
+ public:
+  CountingEqual()
+      : ::arrow::compute::MetaFunction("rle_test_counting_equal",
+                                       ::arrow::compute::Arity::Binary(),
+                                       ::arrow::compute::FunctionDoc::Empty()) {}
+
+  mutable int64_t num_values = 0;
+
+ protected:
+  ::arrow::Result<::arrow::Datum> ExecuteImpl(const std::vector<::arrow::Datum>& args,
+                                              const ::arrow::compute::FunctionOptions* options,
+                                              ::arrow::compute::ExecContext* ctx) const override {
+    num_values += args[0].length();
+    return ::arrow::compute::CallFunction("equal", args, options, ctx);
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Write and read RLE int32 array") {
+  auto arr = lance::arrow::ToArray({1, 1, 1, 2, 2, 3, 5, 5, 5, 5}).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  auto actual = decoder->ToArray().ValueOrDie();
+  INFO("Expected: " << arr->ToString() << " Actual: " << actual->ToString());
+  CHECK(arr->Equals(actual));
+
+  for (int i = 0; i < arr->length(); i++) {
+    CHECK(arr->GetScalar(i).ValueOrDie()->Equals(decoder->GetScalar(i).ValueOrDie()));
+  }
+
+  for (int start = 0; start < arr->length(); start++) {
+    for (int length = 1; start + length <= arr->length(); length++) {
+      auto slice = decoder->ToArray(start, length).ValueOrDie();
+      INFO("Start " << start << " length " << length << " actual " << slice->ToString());
+      CHECK(arr->Slice(start, length)->Equals(slice));
+    }
+  }
+}
+
+TEST_CASE("Write and read RLE string array") {
+  auto arr = lance::arrow::ToArray({"car", "car", "cat", "cat", "cat", "dog"}).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  CHECK(arr->Equals(decoder->ToArray().ValueOrDie()));
+  CHECK(arr->Slice(1, 3)->Equals(decoder->ToArray(1, 3).ValueOrDie()));
+  CHECK(decoder->GetScalar(5).ValueOrDie()->Equals(::arrow::StringScalar("dog")));
+
+  auto indices = lance::arrow::ToArray({0, 2, 5}).ValueOrDie();
+  auto expected = lance::arrow::ToArray({"car", "cat", "dog"}).ValueOrDie();
+  CHECK(expected->Equals(decoder->Take(indices).ValueOrDie()));
+}
+
+TEST_CASE("RLE single run") {
+  auto arr = lance::arrow::ToArray(std::vector<int32_t>(100, 7)).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+  CHECK(arr->Equals(decoder->ToArray().ValueOrDie()));
+  CHECK(arr->Slice(10, 20)->Equals(decoder->ToArray(10, 20).ValueOrDie()));
+}
+
+TEST_CASE("Take RLE values") {
+  std::vector<int32_t> values;
+  for (int i = 0; i < 100; i++) {
+    values.emplace_back(i / 10);
+  }
+  auto arr = lance::arrow::ToArray(values).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  auto indices = lance::arrow::ToArray({0, 8, 9, 10, 45, 46, 99}).ValueOrDie();
+  auto actual = decoder->Take(indices).ValueOrDie();
+  auto expected = lance::arrow::ToArray({0, 0, 0, 1, 4, 4, 9}).ValueOrDie();
+  INFO("Actual " << actual->ToString());
+  CHECK(expected->Equals(actual));
+}
+
+TEST_CASE("Filter on RLE runs") {
+  auto arr = lance::arrow::ToArray({1, 1, 1, 2, 2, 3, 5, 5, 5, 5}).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  auto indices = decoder->Filter("equal", ::arrow::Datum(2)).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({3, 4}).ValueOrDie()));
+
+  indices = decoder->Filter("greater_equal", ::arrow::Datum(3)).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({5, 6, 7, 8, 9}).ValueOrDie()));
+
+  indices = decoder->Filter("not_equal", ::arrow::Datum(5)).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 1, 2, 3, 4, 5}).ValueOrDie()));
+
+  indices = decoder->Filter("less", ::arrow::Datum(0)).ValueOrDie();
+  CHECK(indices->length() == 0);
+}
+
+TEST_CASE("Filter evaluates the predicate once per run") {
+  std::vector<int32_t> values(100000, 7);
+  std::fill(values.begin() + 1000, values.begin() + 1010, 8);
+  auto decoder = WriteRLE(lance::arrow::ToArray(values).ValueOrDie());
+
+  auto equal = std::make_shared<CountingEqual>();
+  CHECK(::arrow::compute::GetFunctionRegistry()->AddFunction(equal).ok());
+  auto indices = decoder->Filter(equal->name(), ::arrow::Datum(8)).ValueOrDie();
+  CHECK(equal->num_values == 3);
+  CHECK(indices->length() == 10);
+  CHECK(indices->Value(0) == 1000);
+  CHECK(indices->Value(9) == 1009);
+}
+
+TEST_CASE("Write and read RLE boolean array") {
+  arrow::BooleanBuilder builder;
+  CHECK(builder.AppendValues(std::vector<bool>(50, false)).ok());
+  CHECK(builder.AppendValues(std::vector<bool>(30, true)).ok());
+  CHECK(builder.AppendValues(std::vector<bool>(20, false)).ok());
+  auto arr = builder.Finish().ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  CHECK(arr->Equals(decoder->ToArray().ValueOrDie()));
+  CHECK(arr->Slice(45, 10)->Equals(decoder->ToArray(45, 10).ValueOrDie()));
+  auto indices = decoder->Filter("equal", ::arrow::Datum(true)).ValueOrDie();
+  CHECK(indices->length() == 30);
+  CHECK(indices->Value(0) == 50);
+}
+
+TEST_CASE("Write and read RLE double array with signed zeros") {
+  auto arr = lance::arrow::ToArray({0.0, 0.0, -0.0, -0.0, 0.0, 1.5}).ValueOrDie();
+  auto decoder = WriteRLE(arr);
+
+  auto actual =
+      std::static_pointer_cast<::arrow::DoubleArray>(decoder->ToArray().ValueOrDie());
+  INFO("Expected: " << arr->ToString() << " Actual: " << actual->ToString());
+  CHECK(arr->Equals(actual));
+  // -0.0 equals 0.0, so compare the signs as well.
+  for (int64_t i = 0; i < arr->length(); i++) {
+    INFO("Index " << i);
+    CHECK(std::signbit(actual->Value(i)) == std::signbit(arr->Value(i)));
+  }
+}
@@ -0,0 +1,259 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/bitmap_index.h"
+
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
+#include <arrow/util/bit_util.h>
+#include <fmt/format.h>
+
+#include <cstring>
+#include <string>
+
+#include "lance/encodings/binary.h"
+#include "lance/encodings/encoder.h"
+#include "lance/encodings/plain.h"
+#include "lance/format/schema.h"
+#include "lance/io/pb.h"
+
+namespace lance::format {
+
+namespace {
+
+/// The encoding of the distinct values.
+pb::Encoding ValueEncoding(const ::arrow::DataType& type) {
+  return ::arrow::is_binary_like(type.id()) ? pb::Encoding::VAR_BINARY : pb::Encoding::PLAIN;
+}
+
+/// The decoder of the distinct values of the value type.
+::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> GetValueDecoder(
+    const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+    const std::shared_ptr<::arrow::DataType>& type) {
+  std::shared_ptr<lance::encodings::Decoder> decoder;
+  if (type->id() == ::arrow::Type::STRING) {
+    decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::StringType>>(in, type);
+  } else if (type->id() == ::arrow::Type::BINARY) {
+    decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::BinaryType>>(in, type);
+  } else {
+    decoder = std::make_shared<lance::encodings::PlainDecoder>(in, type);
+  }
+  ARROW_RETURN_NOT_OK(decoder->Init());
+  return decoder;
+}
+
+/// Encode the rows of a value in a batch, as row indices or as a bitmap, whichever is smaller.
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> EncodeContainer(const std::vector<int32_t>& rows,
+                                                                  int32_t length) {
+  auto bitmap_size = ::arrow::bit_util::BytesForBits(length);
+  if (static_cast<int64_t>(rows.size() * sizeof(int32_t)) < bitmap_size) {
+    ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(rows.size() * sizeof(int32_t)));
+    std::memcpy(buf->mutable_data(), rows.data(), buf->size());
+    return std::shared_ptr<::arrow::Buffer>(std::move(buf));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto bitmap, ::arrow::AllocateEmptyBitmap(length));
+  for (auto row : rows) {
+    ::arrow::bit_util::SetBit(bitmap->mutable_data(), row);
+  }
+  return std::shared_ptr<::arrow::Buffer>(std::move(bitmap));
+}
+
+}  // namespace
+
+BitmapIndex::BitmapIndex(std::shared_ptr<::arrow::io::RandomAccessFile> in,
+                         std::shared_ptr<Field> field,
+                         pb::BitmapIndex pb,
+                         std::shared_ptr<::arrow::Array> values)
+    : in_(std::move(in)),
+      field_(std::move(field)),
+      pb_(std::move(pb)),
+      values_(std::move(values)) {}
+
+bool BitmapIndex::Supports(const ::arrow::DataType& type) {
+  if (::arrow::is_dictionary(type.id())) {
+    return Supports(*static_cast<const ::arrow::DictionaryType&>(type).value_type());
+  }
+  return ::arrow::is_integer(type.id()) || type.id() == ::arrow::Type::STRING ||
+         type.id() == ::arrow::Type::BINARY;
+}
+
+std::shared_ptr<::arrow::DataType> BitmapIndex::ValueType(
+    const std::shared_ptr<::arrow::DataType>& type) {
+  if (::arrow::is_dictionary(type->id())) {
+    return std::static_pointer_cast<::arrow::DictionaryType>(type)->value_type();
+  }
+  return type;
+}
+
+::arrow::Result<std::optional<int64_t>> BitmapIndex::Write(
+    const std::shared_ptr<::arrow::io::OutputStream>& out,
+    const std::shared_ptr<Field>& field,
+    const ::arrow::ArrayVector& batches) {
+  if (!Supports(*field->type())) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Bitmap index does not support type: {}", field->type()->ToString()));
+  }
+  if (batches.empty()) {
+    return std::nullopt;
+  }
+  // Dictionary columns are indexed by their values, which are comparable across the batches.
+  auto value_type = ValueType(field->type());
+  ::arrow::ArrayVector decoded_batches;
+  for (auto& batch : batches) {
+    ARROW_ASSIGN_OR_RAISE(auto decoded, ::arrow::compute::Cast(*batch, value_type));
+    decoded_batches.emplace_back(decoded);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto all_values, ::arrow::Concatenate(decoded_batches));
+  ARROW_ASSIGN_OR_RAISE(auto unique, ::arrow::compute::Unique(all_values));
+  ARROW_ASSIGN_OR_RAISE(auto non_null, ::arrow::compute::DropNull(*unique));
+  if (non_null->length() > kMaxNumValues) {
+    return std::nullopt;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto order, ::arrow::compute::SortIndices(*non_null));
+  ARROW_ASSIGN_OR_RAISE(auto values_datum, ::arrow::compute::Take(non_null, order));
+  auto values = values_datum.make_array();
+  auto num_values = static_cast<int32_t>(values->length());
+  auto num_batches = static_cast<int32_t>(decoded_batches.size());
+
+  // Containers in the order of (value, batch).
+  std::vector<std::shared_ptr<::arrow::Buffer>> containers(num_values * num_batches);
+  for (int32_t batch_id = 0; batch_id < num_batches; batch_id++) {
+    auto& batch = decoded_batches[batch_id];
+    ARROW_ASSIGN_OR_RAISE(auto codes_datum, ::arrow::compute::IndexIn(batch, values));
+    auto codes = std::static_pointer_cast<::arrow::Int32Array>(codes_datum.make_array());
+    std::vector<std::vector<int32_t>> rows(num_values);
+    for (int32_t i = 0; i < codes->length(); i++) {
+      if (codes->IsValid(i)) {
+        rows[codes->Value(i)].emplace_back(i);
+      }
+    }
+    for (int32_t value_id = 0; value_id < num_values; value_id++) {
+      ARROW_ASSIGN_OR_RAISE(
+          containers[value_id * num_batches + batch_id],
+          EncodeContainer(rows[value_id], static_cast<int32_t>(batch->length())));
+    }
+  }
+
+  pb::BitmapIndex pb;
+  pb.set_field_id(field->id());
+  pb.set_num_values(num_values);
+  pb.set_num_batches(num_batches);
+  ARROW_ASSIGN_OR_RAISE(auto values_pos,
+                        field->GetEncoder(out, ValueEncoding(*value_type))->Write(values));
+  pb.set_values_position(values_pos);
+  ARROW_ASSIGN_OR_RAISE(auto containers_pos, out->Tell());
+  pb.set_containers_position(containers_pos);
+  std::vector<int64_t> offsets{0};
+  offsets.reserve(containers.size() + 1);
+  for (auto& container : containers) {
+    ARROW_RETURN_NOT_OK(out->Write(container));
+    offsets.emplace_back(offsets.back() + container->size());
+  }
+  // A plain page of offsets, so that a lookup only reads the offsets of its containers.
+  ARROW_ASSIGN_OR_RAISE(auto offsets_pos, out->Tell());
+  pb.set_container_offsets_position(offsets_pos);
+  ARROW_RETURN_NOT_OK(out->Write(offsets.data(), offsets.size() * sizeof(int64_t)));
+  return io::WriteProto(out, pb);
+}
+
+::arrow::Result<std::shared_ptr<BitmapIndex>> BitmapIndex::Read(
+    const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+    int64_t position,
+    const Schema& schema) {
+  ARROW_ASSIGN_OR_RAISE(auto pb, io::ParseProto<pb::BitmapIndex>(in, position));
+  auto field = schema.GetField(pb.field_id());
+  if (!field || !Supports(*field->type())) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Bitmap index of an invalid field: {}", pb.field_id()));
+  }
+  if (pb.num_values() < 0 || pb.num_batches() < 0 ||
+      pb.container_offsets_position() < pb.containers_position()) {
+    return ::arrow::Status::Invalid("Corrupted bitmap index");
+  }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetValueDecoder(in, ValueType(field->type())));
+  decoder->Reset(pb.values_position(), pb.num_values());
+  ARROW_ASSIGN_OR_RAISE(auto values, decoder->ToArray());
+  return std::shared_ptr<BitmapIndex>(
+      new BitmapIndex(in, field, std::move(pb), std::move(values)));
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> BitmapIndex::GetBitmap(
+    const ::arrow::Array& values, int32_t batch_id, int32_t length) const {
+  auto value_type = ValueType(field_->type());
+  std::shared_ptr<::arrow::Array> decoded;
+  if (::arrow::is_dictionary(values.type_id()) && values.type()->Equals(field_->type())) {
+    ARROW_ASSIGN_OR_RAISE(decoded, ::arrow::compute::Cast(values, value_type));
+  }
+  const auto& lookup_values = decoded ? *decoded : values;
+  if (!lookup_values.type()->Equals(value_type)) {
+    return ::arrow::Status::Invalid(fmt::format("Bitmap index type mismatch: expected {}, got {}",
+                                                value_type->ToString(),
+                                                lookup_values.type()->ToString()));
+  }
+  if (batch_id < 0 || batch_id >= pb_.num_batches()) {
+    return ::arrow::Status::IndexError(
+        fmt::format("Batch index out of range: {} of {}", batch_id, pb_.num_batches()));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto bitmap, ::arrow::AllocateEmptyBitmap(length));
+  auto bitmap_size = ::arrow::bit_util::BytesForBits(length);
+  ARROW_ASSIGN_OR_RAISE(auto codes_datum, ::arrow::compute::IndexIn(lookup_values, values_));
+  auto codes = std::static_pointer_cast<::arrow::Int32Array>(codes_datum.make_array());
+  for (int64_t i = 0; i < codes->length(); i++) {
+    if (codes->IsNull(i)) {
+      continue;
+    }
+    auto container_id = static_cast<int64_t>(codes->Value(i)) * pb_.num_batches() + batch_id;
+    // Only read the offsets of this container.
+    constexpr int64_t kOffsetsSize = 2 * sizeof(int64_t);
+    ARROW_ASSIGN_OR_RAISE(
+        auto offsets,
+        in_->ReadAt(pb_.container_offsets_position() + container_id * sizeof(int64_t),
+                    kOffsetsSize));
+    if (offsets->size() != kOffsetsSize) {
+      return ::arrow::Status::Invalid("Corrupted bitmap index");
+    }
+    int64_t start, end;
+    std::memcpy(&start, offsets->data(), sizeof(int64_t));
+    std::memcpy(&end, offsets->data() + sizeof(int64_t), sizeof(int64_t));
+    auto size = end - start;
+    if (start < 0 || size < 0 || size > bitmap_size) {
+      return ::arrow::Status::Invalid("Corrupted bitmap index");
+    }
+    if (size == 0) {
+      continue;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto container, in_->ReadAt(pb_.containers_position() + start, size));
+    if (size == bitmap_size) {
+      for (int64_t j = 0; j < size; j++) {
+        bitmap->mutable_data()[j] |= container->data()[j];
+      }
+    } else {
+      for (int64_t j = 0; j < size / static_cast<int64_t>(sizeof(int32_t)); j++) {
+        int32_t row;
+        std::memcpy(&row, container->data() + j * sizeof(int32_t), sizeof(int32_t));
+        if (row < 0 || row >= length) {
+          return ::arrow::Status::Invalid("Corrupted bitmap index");
+        }
+        ::arrow::bit_util::SetBit(bitmap->mutable_data(), row);
+      }
+    }
+  }
+  return std::shared_ptr<::arrow::Buffer>(std::move(bitmap));
+}
+
+const std::shared_ptr<Field>& BitmapIndex::field() const { return field_; }
+
+const std::shared_ptr<::arrow::Array>& BitmapIndex::values() const { return values_; }
+
+}  // namespace lance::format
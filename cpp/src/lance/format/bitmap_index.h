@@ -0,0 +1,103 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/io/api.h>
+#include <arrow/result.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "lance/format/format.pb.h"
+
+namespace lance::format {
+
+class Field;
+class Schema;
+
+/// Bitmap index of a low-cardinality column, i.e., `split`, `source` or `label`.
+///
+/// Each distinct value is mapped to its rows in every batch. The rows of a value in a batch
+/// are stored as the sorted row indices if the value is sparse in the batch, or as a bitmap
+/// otherwise, so that a lookup only reads the containers of the values and the batch.
+class BitmapIndex {
+ public:
+  /// Maximum number of distinct values of an indexed column.
+  static constexpr int32_t kMaxNumValues = 4096;
+
+  /// Returns true if the values of the type can be indexed, i.e., integer, string and binary
+  /// values. Dictionary columns are indexed by their values.
+  static bool Supports(const ::arrow::DataType& type);
+
+  /// The type of the indexed values of a column type, i.e., the value type of a dictionary.
+  static std::shared_ptr<::arrow::DataType> ValueType(
+      const std::shared_ptr<::arrow::DataType>& type);
+
+  /// Write the bitmap index of a column.
+  ///
+  /// \param out the output stream.
+  /// \param field the indexed field.
+  /// \param batches the values of the column, one array per batch.
+  /// \return the file position of the index, or `std::nullopt` if the column has more than
+  ///         `kMaxNumValues` distinct values.
+  static ::arrow::Result<std::optional<int64_t>> Write(
+      const std::shared_ptr<::arrow::io::OutputStream>& out,
+      const std::shared_ptr<Field>& field,
+      const ::arrow::ArrayVector& batches);
+
+  /// Open the index, and load the distinct values.
+  ///
+  /// \param in the input file.
+  /// \param position the file position of the index.
+  /// \param schema the schema of the file.
+  static ::arrow::Result<std::shared_ptr<BitmapIndex>> Read(
+      const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+      int64_t position,
+      const Schema& schema);
+
+  /// Get the rows of a batch that have any of the values.
+  ///
+  /// \param values the values to look up, of the type of the indexed column or the value type.
+  ///               Null values match no row.
+  /// \param batch_id the index of the batch in the file.
+  /// \param length the number of rows of the batch.
+  /// \return a bitmap with one bit per row of the batch.
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>> GetBitmap(const ::arrow::Array& values,
+                                                              int32_t batch_id,
+                                                              int32_t length) const;
+
+  /// The indexed field.
+  const std::shared_ptr<Field>& field() const;
+
+  /// The sorted distinct values of the column, of the value type.
+  const std::shared_ptr<::arrow::Array>& values() const;
+
+ private:
+  BitmapIndex(std::shared_ptr<::arrow::io::RandomAccessFile> in,
+              std::shared_ptr<Field> field,
+              pb::BitmapIndex pb,
+              std::shared_ptr<::arrow::Array> values);
+
+  std::shared_ptr<::arrow::io::RandomAccessFile> in_;
+  std::shared_ptr<Field> field_;
+  pb::BitmapIndex pb_;
+  std::shared_ptr<::arrow::Array> values_;
+};
+
+}  // namespace lance::format
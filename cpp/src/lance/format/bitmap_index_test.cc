@@ -0,0 +1,153 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/bitmap_index.h"
+
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <arrow/type.h>
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+#include "lance/format/schema.h"
+
+using lance::format::BitmapIndex;
+
+namespace {
+
+/// Write the index of the batches, and open it.
+std::shared_ptr<BitmapIndex> WriteAndRead(const ::arrow::ArrayVector& batches) {
+  auto schema =
+      lance::format::Schema(::arrow::schema({::arrow::field("label", batches[0]->type())}));
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto pos = BitmapIndex::Write(sink, schema.GetField("label"), batches).ValueOrDie();
+  REQUIRE(pos.has_value());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  return BitmapIndex::Read(infile, *pos, schema).ValueOrDie();
+}
+
+/// The positions of the set bits.
+std::vector<int32_t> ToRows(const std::shared_ptr<::arrow::Buffer>& bitmap, int32_t length) {
+  std::vector<int32_t> rows;
+  for (int32_t i = 0; i < length; i++) {
+    if (::arrow::bit_util::GetBit(bitmap->data(), i)) {
+      rows.emplace_back(i);
+    }
+  }
+  return rows;
+}
+
+}  // namespace
+
+TEST_CASE("Bitmap index supported types") {
+  CHECK(BitmapIndex::Supports(*::arrow::int8()));
+  CHECK(BitmapIndex::Supports(*::arrow::uint32()));
+  CHECK(BitmapIndex::Supports(*::arrow::utf8()));
+  CHECK(BitmapIndex::Supports(*::arrow::binary()));
+  CHECK(BitmapIndex::Supports(*::arrow::dictionary(::arrow::int8(), ::arrow::utf8())));
+  CHECK(!BitmapIndex::Supports(*::arrow::float64()));
+  CHECK(!BitmapIndex::Supports(*::arrow::dictionary(::arrow::int8(), ::arrow::float64())));
+  CHECK(!BitmapIndex::Supports(*::arrow::list(::arrow::utf8())));
+}
+
+TEST_CASE("Look up string values in bitmap index") {
+  // "train" is dense, and stored as bitmaps. "test" and "val" are sparse, and stored as rows.
+  ::arrow::ArrayVector batches;
+  std::vector<std::vector<int32_t>> test_rows;
+  for (int batch_id = 0; batch_id < 3; batch_id++) {
+    ::arrow::StringBuilder builder;
+    test_rows.emplace_back();
+    for (int i = 0; i < 200; i++) {
+      if (i % 50 == batch_id) {
+        CHECK(builder.Append("test").ok());
+        test_rows.back().emplace_back(i);
+      } else if (i == 199 && batch_id == 1) {
+        CHECK(builder.Append("val").ok());
+      } else if (i % 17 == 0) {
+        CHECK(builder.AppendNull().ok());
+      } else {
+        CHECK(builder.Append("train").ok());
+      }
+    }
+    batches.emplace_back(builder.Finish().ValueOrDie());
+  }
+  auto index = WriteAndRead(batches);
+  CHECK(index->values()->Equals(lance::arrow::ToArray({"test", "train", "val"}).ValueOrDie()));
+
+  for (int batch_id = 0; batch_id < 3; batch_id++) {
+    auto test = lance::arrow::ToArray({"test"}).ValueOrDie();
+    CHECK(ToRows(index->GetBitmap(*test, batch_id, 200).ValueOrDie(), 200) ==
+          test_rows[batch_id]);
+
+    auto train = lance::arrow::ToArray({"train"}).ValueOrDie();
+    auto train_rows = ToRows(index->GetBitmap(*train, batch_id, 200).ValueOrDie(), 200);
+    auto val = lance::arrow::ToArray({"val"}).ValueOrDie();
+    auto val_rows = ToRows(index->GetBitmap(*val, batch_id, 200).ValueOrDie(), 200);
+    auto all = lance::arrow::ToArray({"val", "train", "test", "missing"}).ValueOrDie();
+    auto all_rows = ToRows(index->GetBitmap(*all, batch_id, 200).ValueOrDie(), 200);
+    auto batch = std::static_pointer_cast<::arrow::StringArray>(batches[batch_id]);
+    for (int32_t i = 0; i < 200; i++) {
+      INFO("Batch " << batch_id << " row " << i);
+      auto is_train = batch->IsValid(i) && batch->GetView(i) == "train";
+      CHECK(std::count(train_rows.begin(), train_rows.end(), i) == is_train);
+      CHECK(std::count(all_rows.begin(), all_rows.end(), i) == batch->IsValid(i));
+    }
+    CHECK(val_rows == (batch_id == 1 ? std::vector<int32_t>{199} : std::vector<int32_t>{}));
+  }
+
+  // The type of the values must match.
+  CHECK(!index->GetBitmap(*lance::arrow::ToArray({1}).ValueOrDie(), 0, 200).ok());
+  CHECK(!index->GetBitmap(*lance::arrow::ToArray({"test"}).ValueOrDie(), 3, 200).ok());
+}
+
+TEST_CASE("Look up dictionary values in bitmap index") {
+  // The batches have different dictionaries.
+  auto type = ::arrow::dictionary(::arrow::int8(), ::arrow::utf8());
+  ::arrow::ArrayVector batches{
+      ::arrow::DictionaryArray::FromArrays(type,
+                                           lance::arrow::ToArray<int8_t>({0, 1, 0}).ValueOrDie(),
+                                           lance::arrow::ToArray({"cat", "dog"}).ValueOrDie())
+          .ValueOrDie(),
+      ::arrow::DictionaryArray::FromArrays(type,
+                                           lance::arrow::ToArray<int8_t>({1, 0}).ValueOrDie(),
+                                           lance::arrow::ToArray({"cat", "fox"}).ValueOrDie())
+          .ValueOrDie()};
+  auto index = WriteAndRead(batches);
+  CHECK(index->values()->Equals(lance::arrow::ToArray({"cat", "dog", "fox"}).ValueOrDie()));
+
+  auto cat = lance::arrow::ToArray({"cat"}).ValueOrDie();
+  CHECK(ToRows(index->GetBitmap(*cat, 0, 3).ValueOrDie(), 3) == std::vector<int32_t>{0, 2});
+  CHECK(ToRows(index->GetBitmap(*cat, 1, 2).ValueOrDie(), 2) == std::vector<int32_t>{1});
+  // The values can also be of the dictionary type.
+  CHECK(ToRows(index->GetBitmap(*batches[1], 1, 2).ValueOrDie(), 2) ==
+        std::vector<int32_t>{0, 1});
+}
+
+TEST_CASE("Do not index high-cardinality columns") {
+  std::vector<int32_t> values(BitmapIndex::kMaxNumValues + 1);
+  std::iota(values.begin(), values.end(), 0);
+  auto schema = lance::format::Schema(::arrow::schema({::arrow::field("id", ::arrow::int32())}));
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto pos = BitmapIndex::Write(
+                 sink, schema.GetField("id"), {lance::arrow::ToArray(values).ValueOrDie()})
+                 .ValueOrDie();
+  CHECK(!pos.has_value());
+}
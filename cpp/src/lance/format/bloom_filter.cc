@@ -0,0 +1,183 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/bloom_filter.h"
+
+#include <arrow/type_traits.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "lance/arrow/utils.h"
+#include "lance/encodings/kernels.h"
+
+namespace lance::format {
+
+namespace {
+
+template <typename ArrayType>
+void HashBinaryValues(const ::arrow::Array& arr, std::vector<uint64_t>* hashes) {
+  auto& binary = static_cast<const ArrayType&>(arr);
+  for (int64_t i = 0; i < binary.length(); i++) {
+    if (binary.IsValid(i)) {
+      auto value = binary.GetView(i);
+      hashes->emplace_back(
+          BloomFilter::Hash(reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+    }
+  }
+}
+
+/// Hash a fixed-width value. Floating-point values are hashed by their canonical bits, so -0.0
+/// hashes as 0.0 and every NaN hashes the same.
+uint64_t HashFixedWidth(const uint8_t* data, int byte_width, ::arrow::Type::type type_id) {
+  if (type_id == ::arrow::Type::FLOAT) {
+    float value;
+    std::memcpy(&value, data, sizeof(value));
+    if (std::isnan(value)) {
+      value = std::numeric_limits<float>::quiet_NaN();
+    } else if (value == 0) {
+      value = 0.0f;
+    }
+    return BloomFilter::Hash(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+  } else if (type_id == ::arrow::Type::DOUBLE) {
+    double value;
+    std::memcpy(&value, data, sizeof(value));
+    if (std::isnan(value)) {
+      value = std::numeric_limits<double>::quiet_NaN();
+    } else if (value == 0) {
+      value = 0.0;
+    }
+    return BloomFilter::Hash(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+  } else if (type_id == ::arrow::Type::HALF_FLOAT) {
+    uint16_t bits;
+    std::memcpy(&bits, data, sizeof(bits));
+    if ((bits & 0x7fff) == 0) {
+      bits = 0;
+    } else if ((bits & 0x7c00) == 0x7c00 && (bits & 0x03ff) != 0) {
+      bits = 0x7e00;
+    }
+    return BloomFilter::Hash(reinterpret_cast<const uint8_t*>(&bits), sizeof(bits));
+  }
+  return BloomFilter::Hash(data, byte_width);
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(std::shared_ptr<::arrow::Buffer> blocks) : blocks_(std::move(blocks)) {}
+
+::arrow::Result<std::shared_ptr<BloomFilter>> BloomFilter::Make(int64_t num_values,
+                                                                double fpp,
+                                                                ::arrow::MemoryPool* pool) {
+  if (!(fpp > 0 && fpp < 1)) {
+    return ::arrow::Status::Invalid(
+        fmt::format("BloomFilter: false positive rate must be in (0, 1), got {}", fpp));
+  }
+  // The number of bits for the false positive rate, with 8 bits set per value.
+  auto num_bits = -8.0 * static_cast<double>(num_values) / std::log(1 - std::pow(fpp, 1.0 / 8));
+  auto num_blocks = std::max<int64_t>(1, std::ceil(num_bits / (kBlockSize * 8)));
+  ARROW_ASSIGN_OR_RAISE(auto blocks, ::arrow::AllocateBuffer(num_blocks * kBlockSize, pool));
+  std::memset(blocks->mutable_data(), 0, blocks->size());
+  return std::shared_ptr<BloomFilter>(new BloomFilter(std::move(blocks)));
+}
+
+::arrow::Result<std::shared_ptr<BloomFilter>> BloomFilter::Make(
+    std::shared_ptr<::arrow::Buffer> blocks, ::arrow::MemoryPool* pool) {
+  if (blocks->size() == 0 || blocks->size() % kBlockSize != 0) {
+    return ::arrow::Status::Invalid(
+        fmt::format("BloomFilter: invalid size of blocks: {}", blocks->size()));
+  }
+  if (reinterpret_cast<uintptr_t>(blocks->data()) % alignof(uint32_t) != 0) {
+    // The blocks are read as uint32 words.
+    ARROW_ASSIGN_OR_RAISE(blocks, blocks->CopySlice(0, blocks->size(), pool));
+  }
+  return std::shared_ptr<BloomFilter>(new BloomFilter(std::move(blocks)));
+}
+
+bool BloomFilter::Supports(const ::arrow::DataType& type) {
+  return ::arrow::is_base_binary_like(type.id()) || lance::arrow::ByteWidth(type).has_value();
+}
+
+uint64_t BloomFilter::Hash(const uint8_t* data, int64_t length) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int64_t i = 0; i < length; i++) {
+    hash = (hash ^ data[i]) * 0x100000001b3ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+::arrow::Status BloomFilter::Insert(const ::arrow::Array& arr) {
+  if (!blocks_->is_mutable()) {
+    return ::arrow::Status::Invalid("BloomFilter: can not insert into a loaded filter");
+  }
+  std::vector<uint64_t> hashes;
+  hashes.reserve(arr.length() - arr.null_count());
+  auto type_id = arr.type_id();
+  if (type_id == ::arrow::Type::STRING || type_id == ::arrow::Type::BINARY) {
+    HashBinaryValues<::arrow::BinaryArray>(arr, &hashes);
+  } else if (type_id == ::arrow::Type::LARGE_STRING || type_id == ::arrow::Type::LARGE_BINARY) {
+    HashBinaryValues<::arrow::LargeBinaryArray>(arr, &hashes);
+  } else if (auto byte_width = lance::arrow::ByteWidth(*arr.type()); byte_width.has_value()) {
+    auto values = arr.data()->buffers[1]->data() + arr.offset() * *byte_width;
+    for (int64_t i = 0; i < arr.length(); i++) {
+      if (arr.IsValid(i)) {
+        hashes.emplace_back(HashFixedWidth(values + i * *byte_width, *byte_width, type_id));
+      }
+    }
+  } else {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("BloomFilter: unsupported type {}", arr.type()->ToString()));
+  }
+  lance::encodings::kernels::BloomFilterInsert(
+      reinterpret_cast<uint32_t*>(blocks_->mutable_data()),
+      num_blocks(),
+      hashes.data(),
+      static_cast<int64_t>(hashes.size()));
+  return ::arrow::Status::OK();
+}
+
+::arrow::Result<bool> BloomFilter::MayContainAny(
+    const std::vector<std::shared_ptr<::arrow::Scalar>>& values) const {
+  std::vector<uint64_t> hashes;
+  for (auto& value : values) {
+    ARROW_ASSIGN_OR_RAISE(auto bytes, lance::arrow::ScalarToBytes(*value));
+    auto data = reinterpret_cast<const uint8_t*>(bytes.data());
+    if (lance::arrow::ByteWidth(*value->type).has_value()) {
+      hashes.emplace_back(HashFixedWidth(data, bytes.size(), value->type->id()));
+    } else {
+      hashes.emplace_back(Hash(data, bytes.size()));
+    }
+  }
+  std::vector<uint8_t> found(hashes.size());
+  lance::encodings::kernels::BloomFilterCheck(reinterpret_cast<const uint32_t*>(blocks_->data()),
+                                              num_blocks(),
+                                              hashes.data(),
+                                              static_cast<int64_t>(hashes.size()),
+                                              found.data());
+  return std::any_of(found.begin(), found.end(), [](auto f) { return f != 0; });
+}
+
+int64_t BloomFilter::num_blocks() const { return blocks_->size() / kBlockSize; }
+
+const std::shared_ptr<::arrow::Buffer>& BloomFilter::blocks() const { return blocks_; }
+
+}  // namespace lance::format
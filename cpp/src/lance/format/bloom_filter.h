@@ -0,0 +1,81 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/result.h>
+#include <arrow/scalar.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lance::format {
+
+/// Split block Bloom filter of the values of one page.
+///
+/// The filter is an array of 32-byte blocks of 8 uint32 words. A value is hashed from its plain
+/// encoding (see `lance::arrow::ScalarToBytes()`), so a literal matches the values of the
+/// column once it is casted to the type of the column. Floating-point values are hashed by their
+/// canonical bits: -0.0 matches 0.0, and a NaN matches any NaN.
+class BloomFilter {
+ public:
+  /// Bytes of a block.
+  static constexpr int64_t kBlockSize = 32;
+
+  /// Create an empty filter.
+  ///
+  /// \param num_values the number of distinct values to insert.
+  /// \param fpp the target false positive rate, in (0, 1).
+  /// \param pool memory pool.
+  /// \return a filter sized for the false positive rate.
+  static ::arrow::Result<std::shared_ptr<BloomFilter>> Make(
+      int64_t num_values, double fpp, ::arrow::MemoryPool* pool = ::arrow::default_memory_pool());
+
+  /// Load a filter from its blocks.
+  static ::arrow::Result<std::shared_ptr<BloomFilter>> Make(
+      std::shared_ptr<::arrow::Buffer> blocks,
+      ::arrow::MemoryPool* pool = ::arrow::default_memory_pool());
+
+  /// Returns true if the values of the type can be inserted, i.e., byte-aligned fixed-width
+  /// values, or string / binary values.
+  static bool Supports(const ::arrow::DataType& type);
+
+  /// Hash the plain encoding of a value: 64-bit FNV-1a, followed by the MurmurHash3 fmix64
+  /// finalizer.
+  static uint64_t Hash(const uint8_t* data, int64_t length);
+
+  /// Insert the non-null values of an array.
+  ::arrow::Status Insert(const ::arrow::Array& arr);
+
+  /// Returns false if none of the values was inserted, or true if any of them may have been.
+  /// The values must be valid scalars of the type of the inserted arrays.
+  ::arrow::Result<bool> MayContainAny(
+      const std::vector<std::shared_ptr<::arrow::Scalar>>& values) const;
+
+  /// Number of 32-byte blocks.
+  int64_t num_blocks() const;
+
+  /// The blocks of the filter, to write to a file.
+  const std::shared_ptr<::arrow::Buffer>& blocks() const;
+
+ private:
+  explicit BloomFilter(std::shared_ptr<::arrow::Buffer> blocks);
+
+  std::shared_ptr<::arrow::Buffer> blocks_;
+};
+
+}  // namespace lance::format
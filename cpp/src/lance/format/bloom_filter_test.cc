@@ -0,0 +1,131 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/bloom_filter.h"
+
+#include <arrow/builder.h>
+#include <arrow/scalar.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+
+using lance::format::BloomFilter;
+
+TEST_CASE("Bloom filter sizing") {
+  auto small = BloomFilter::Make(10, 0.01).ValueOrDie();
+  CHECK(small->num_blocks() >= 1);
+  CHECK(small->blocks()->size() == small->num_blocks() * BloomFilter::kBlockSize);
+
+  auto large = BloomFilter::Make(10000, 0.01).ValueOrDie();
+  // About 10 bits per value for 1% false positive rate.
+  CHECK(large->num_blocks() * BloomFilter::kBlockSize * 8 >= 10000 * 9);
+  CHECK(large->num_blocks() * BloomFilter::kBlockSize * 8 <= 10000 * 16);
+  CHECK(BloomFilter::Make(10000, 0.001).ValueOrDie()->num_blocks() > large->num_blocks());
+
+  CHECK(!BloomFilter::Make(10, 0).ok());
+  CHECK(!BloomFilter::Make(10, 1).ok());
+  CHECK(!BloomFilter::Make(10, -0.5).ok());
+}
+
+TEST_CASE("Bloom filter supported types") {
+  CHECK(BloomFilter::Supports(*::arrow::int32()));
+  CHECK(BloomFilter::Supports(*::arrow::float64()));
+  CHECK(BloomFilter::Supports(*::arrow::utf8()));
+  CHECK(BloomFilter::Supports(*::arrow::large_binary()));
+  CHECK(BloomFilter::Supports(*::arrow::fixed_size_binary(16)));
+  CHECK(BloomFilter::Supports(*::arrow::timestamp(::arrow::TimeUnit::MICRO)));
+  CHECK(!BloomFilter::Supports(*::arrow::boolean()));
+  CHECK(!BloomFilter::Supports(*::arrow::list(::arrow::int32())));
+}
+
+TEST_CASE("Bloom filter over int values") {
+  const int num_values = 10000;
+  ::arrow::Int64Builder builder;
+  for (int64_t i = 0; i < num_values; i++) {
+    CHECK(builder.Append(i * 3).ok());
+  }
+  CHECK(builder.AppendNull().ok());
+  auto arr = builder.Finish().ValueOrDie();
+
+  auto bloom_filter = BloomFilter::Make(num_values, 0.01).ValueOrDie();
+  CHECK(bloom_filter->Insert(*arr).ok());
+  for (int64_t i = 0; i < num_values; i++) {
+    INFO("Value: " << i * 3);
+    CHECK(bloom_filter->MayContainAny({std::make_shared<::arrow::Int64Scalar>(i * 3)})
+              .ValueOrDie());
+  }
+
+  int false_positives = 0;
+  for (int64_t i = 0; i < num_values; i++) {
+    false_positives += bloom_filter
+                           ->MayContainAny({std::make_shared<::arrow::Int64Scalar>(i * 3 + 1)})
+                           .ValueOrDie();
+  }
+  INFO("False positives: " << false_positives);
+  CHECK(false_positives < num_values * 0.02);
+
+  // Loaded from the blocks.
+  auto loaded = BloomFilter::Make(bloom_filter->blocks()).ValueOrDie();
+  CHECK(loaded->num_blocks() == bloom_filter->num_blocks());
+  CHECK(loaded->MayContainAny({std::make_shared<::arrow::Int64Scalar>(300)}).ValueOrDie());
+  CHECK(!BloomFilter::Make(::arrow::Buffer::FromString("abc")).ok());
+}
+
+TEST_CASE("Bloom filter over string values") {
+  auto arr = lance::arrow::ToArray({"apple", "banana", "cherry"}).ValueOrDie();
+  auto bloom_filter = BloomFilter::Make(arr->length(), 0.01).ValueOrDie();
+  CHECK(bloom_filter->Insert(*arr).ok());
+
+  auto scalar = [](const std::string& value) -> std::shared_ptr<::arrow::Scalar> {
+    return std::make_shared<::arrow::StringScalar>(value);
+  };
+  CHECK(bloom_filter->MayContainAny({scalar("banana")}).ValueOrDie());
+  CHECK(bloom_filter->MayContainAny({scalar("durian"), scalar("cherry")}).ValueOrDie());
+  CHECK(!bloom_filter->MayContainAny({}).ValueOrDie());
+
+  int false_positives = 0;
+  for (int i = 0; i < 1000; i++) {
+    false_positives += bloom_filter->MayContainAny({scalar(std::to_string(i))}).ValueOrDie();
+  }
+  CHECK(false_positives < 50);
+}
+
+TEST_CASE("Bloom filter over floating-point values") {
+  ::arrow::DoubleBuilder builder;
+  CHECK(builder.AppendValues({-0.0, 1.5, std::nan("1")}).ok());
+  auto arr = builder.Finish().ValueOrDie();
+  auto bloom_filter = BloomFilter::Make(arr->length(), 0.01).ValueOrDie();
+  CHECK(bloom_filter->Insert(*arr).ok());
+
+  auto scalar = [](double value) -> std::shared_ptr<::arrow::Scalar> {
+    return std::make_shared<::arrow::DoubleScalar>(value);
+  };
+  CHECK(bloom_filter->MayContainAny({scalar(0.0)}).ValueOrDie());
+  CHECK(bloom_filter->MayContainAny({scalar(-0.0)}).ValueOrDie());
+  CHECK(bloom_filter->MayContainAny({scalar(1.5)}).ValueOrDie());
+  // A NaN with another payload.
+  CHECK(bloom_filter->MayContainAny({scalar(-std::nan("2"))}).ValueOrDie());
+
+  ::arrow::FloatBuilder float_builder;
+  CHECK(float_builder.Append(0.0f).ok());
+  auto floats = float_builder.Finish().ValueOrDie();
+  auto float_filter = BloomFilter::Make(floats->length(), 0.01).ValueOrDie();
+  CHECK(float_filter->Insert(*floats).ok());
+  CHECK(float_filter->MayContainAny({std::make_shared<::arrow::FloatScalar>(-0.0f)}).ValueOrDie());
+}
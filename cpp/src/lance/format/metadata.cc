@@ -66,6 +66,11 @@ int32_t Metadata::GetBatchLength(int32_t batch_id) const {
   return pb_.batch_offsets(batch_id + 1) - pb_.batch_offsets(batch_id);
 }
 
+int64_t Metadata::GetBatchOffset(int32_t batch_id) const {
+  assert(batch_id < pb_.batch_offsets_size());
+  return pb_.batch_offsets(batch_id);
+}
+
 ::arrow::Result<std::tuple<int32_t, int32_t>> Metadata::LocateBatch(int32_t row_index) const {
   int64_t len = length();
   if (row_index < 0 || row_index >= len) {
@@ -98,4 +103,42 @@ int64_t Metadata::page_table_position() const { return pb_.page_table_position()
 
 void Metadata::SetPageTablePosition(int64_t position) { pb_.set_page_table_position(position); }
 
+int64_t Metadata::validity_table_position() const { return pb_.validity_table_position(); }
+
+void Metadata::SetValidityTablePosition(int64_t position) {
+  pb_.set_validity_table_position(position);
+}
+
+int64_t Metadata::encoding_table_position() const { return pb_.encoding_table_position(); }
+
+void Metadata::SetEncodingTablePosition(int64_t position) {
+  pb_.set_encoding_table_position(position);
+}
+
+int64_t Metadata::statistics_position() const { return pb_.statistics_position(); }
+
+void Metadata::SetStatisticsPosition(int64_t position) { pb_.set_statistics_position(position); }
+
+int64_t Metadata::bloom_filters_position() const { return pb_.bloom_filters_position(); }
+
+void Metadata::SetBloomFiltersPosition(int64_t position) {
+  pb_.set_bloom_filters_position(position);
+}
+
+int64_t Metadata::primary_key_index_position() const {
+  return pb_.primary_key_index_position();
+}
+
+void Metadata::SetPrimaryKeyIndexPosition(int64_t position) {
+  pb_.set_primary_key_index_position(position);
+}
+
+std::vector<int64_t> Metadata::bitmap_index_positions() const {
+  return {pb_.bitmap_index_positions().begin(), pb_.bitmap_index_positions().end()};
+}
+
+void Metadata::AddBitmapIndexPosition(int64_t position) {
+  pb_.add_bitmap_index_positions(position);
+}
+
 }  // namespace lance::format
\ No newline at end of file
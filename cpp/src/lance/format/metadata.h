@@ -55,6 +55,9 @@ class Metadata final {
   /// Get the logical length of a batch.
   int32_t GetBatchLength(int32_t batch_id) const;
 
+  /// Get the index of the first row of a batch, within the file.
+  int64_t GetBatchOffset(int32_t batch_id) const;
+
   /// Locate the batch where the row belongs.
   ///
   /// \param idx the row index, within the file.
@@ -70,6 +73,43 @@ class Metadata final {
   /// Set the position of the page table.
   void SetPageTablePosition(int64_t position);
 
+  /// Get the file position to the validity table. Returns 0 if no page has nulls.
+  int64_t validity_table_position() const;
+
+  /// Set the position of the validity table.
+  void SetValidityTablePosition(int64_t position);
+
+  /// Get the file position to the encoding table. Returns 0 if all pages use the encoding of
+  /// their column.
+  int64_t encoding_table_position() const;
+
+  /// Set the position of the encoding table.
+  void SetEncodingTablePosition(int64_t position);
+
+  /// Get the file position to the page statistics. Returns 0 if no statistics were collected.
+  int64_t statistics_position() const;
+
+  /// Set the position of the page statistics.
+  void SetStatisticsPosition(int64_t position);
+
+  /// Get the file position to the Bloom filters. Returns 0 if no page has a Bloom filter.
+  int64_t bloom_filters_position() const;
+
+  /// Set the position of the Bloom filters.
+  void SetBloomFiltersPosition(int64_t position);
+
+  /// Get the file position to the primary key index. Returns 0 if the file does not have one.
+  int64_t primary_key_index_position() const;
+
+  /// Set the position of the primary key index.
+  void SetPrimaryKeyIndexPosition(int64_t position);
+
+  /// Get the file positions to the bitmap indices of the indexed columns.
+  std::vector<int64_t> bitmap_index_positions() const;
+
+  /// Add the position of the bitmap index of a column.
+  void AddBitmapIndexPosition(int64_t position);
+
   void SetManifestPosition(int64_t position);
 
   ::arrow::Result<std::shared_ptr<Manifest>> GetManifest(
@@ -19,6 +19,8 @@
 #include <memory>
 #include <vector>
 
+#include "lance/io/pb.h"
+
 namespace lance::format {
 
 void PageTable::SetPageInfo(int32_t column_id,
@@ -42,14 +44,258 @@ std::optional<PageTable::PageInfo> PageTable::GetPageInfo(int32_t column_id,
   return page_it->second;
 }
 
-::arrow::Result<int64_t> PageTable::Write(const std::shared_ptr<::arrow::io::OutputStream>& out) {
-  ::arrow::Int64Builder builder;
+void PageTable::SetValidity(int32_t column_id, int32_t batch_id, int64_t validity) noexcept {
+  if (validity == kNoNulls) {
+    auto column_it = validity_map_.find(column_id);
+    if (column_it != validity_map_.end()) {
+      column_it->second.erase(batch_id);
+    }
+    return;
+  }
+  validity_map_[column_id][batch_id] = validity;
+}
+
+int64_t PageTable::GetValidity(int32_t column_id, int32_t batch_id) const noexcept {
+  auto column_it = validity_map_.find(column_id);
+  if (column_it == validity_map_.end()) {
+    return kNoNulls;
+  }
+  auto page_it = column_it->second.find(batch_id);
+  if (page_it == column_it->second.end()) {
+    return kNoNulls;
+  }
+  return page_it->second;
+}
+
+bool PageTable::HasNulls() const noexcept {
+  for (auto& [column_id, pages] : validity_map_) {
+    if (!pages.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  auto num_columns = page_info_map_.rbegin()->first + 1;
+std::tuple<int32_t, int32_t> PageTable::Shape() const noexcept {
+  int32_t num_columns = 0;
   int32_t num_batches = 0;
   for (auto& [k, m] : page_info_map_) {
+    num_columns = std::max(num_columns, k + 1);
     num_batches = std::max(num_batches, m.rbegin()->first + 1);
   }
+  return std::make_tuple(num_columns, num_batches);
+}
+
+::arrow::Result<int64_t> PageTable::WriteValidity(
+    const std::shared_ptr<::arrow::io::OutputStream>& out) {
+  ::arrow::Int64Builder builder;
+
+  auto [num_columns, num_batches] = Shape();
+  ARROW_RETURN_NOT_OK(builder.Reserve(num_columns * num_batches));
+  for (int32_t column_id = 0; column_id < num_columns; ++column_id) {
+    for (int32_t batch_id = 0; batch_id < num_batches; ++batch_id) {
+      ARROW_RETURN_NOT_OK(builder.Append(GetValidity(column_id, batch_id)));
+    }
+  }
+  ARROW_ASSIGN_OR_RAISE(auto validity_table, builder.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto pos, out->Tell());
+  ARROW_RETURN_NOT_OK(
+      out->Write(std::static_pointer_cast<::arrow::Int64Array>(validity_table)->values()));
+  return pos;
+}
+
+::arrow::Status PageTable::ReadValidity(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                        int64_t validity_table_position,
+                                        int32_t num_columns,
+                                        int32_t num_batches) {
+  ARROW_ASSIGN_OR_RAISE(
+      auto buf, in->ReadAt(validity_table_position, num_columns * num_batches * sizeof(int64_t)));
+  auto arr = ::arrow::Int64Array(num_columns * num_batches, buf);
+  for (int32_t col = 0; col < num_columns; col++) {
+    for (int32_t batch = 0; batch < num_batches; batch++) {
+      SetValidity(col, batch, arr.Value(col * num_batches + batch));
+    }
+  }
+  return ::arrow::Status::OK();
+}
+
+void PageTable::SetEncoding(int32_t column_id,
+                            int32_t batch_id,
+                            pb::Encoding encoding) noexcept {
+  if (encoding == pb::Encoding::NONE) {
+    auto column_it = encoding_map_.find(column_id);
+    if (column_it != encoding_map_.end()) {
+      column_it->second.erase(batch_id);
+    }
+    return;
+  }
+  encoding_map_[column_id][batch_id] = encoding;
+}
+
+std::optional<pb::Encoding> PageTable::GetEncoding(int32_t column_id,
+                                                   int32_t batch_id) const noexcept {
+  auto column_it = encoding_map_.find(column_id);
+  if (column_it == encoding_map_.end()) {
+    return std::nullopt;
+  }
+  auto page_it = column_it->second.find(batch_id);
+  if (page_it == column_it->second.end()) {
+    return std::nullopt;
+  }
+  return page_it->second;
+}
+
+bool PageTable::HasPageEncodings() const noexcept {
+  for (auto& [column_id, pages] : encoding_map_) {
+    if (!pages.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+::arrow::Result<int64_t> PageTable::WriteEncodings(
+    const std::shared_ptr<::arrow::io::OutputStream>& out) {
+  ::arrow::Int32Builder builder;
+
+  auto [num_columns, num_batches] = Shape();
+  ARROW_RETURN_NOT_OK(builder.Reserve(num_columns * num_batches));
+  for (int32_t column_id = 0; column_id < num_columns; ++column_id) {
+    for (int32_t batch_id = 0; batch_id < num_batches; ++batch_id) {
+      ARROW_RETURN_NOT_OK(
+          builder.Append(GetEncoding(column_id, batch_id).value_or(pb::Encoding::NONE)));
+    }
+  }
+  ARROW_ASSIGN_OR_RAISE(auto encoding_table, builder.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto pos, out->Tell());
+  ARROW_RETURN_NOT_OK(
+      out->Write(std::static_pointer_cast<::arrow::Int32Array>(encoding_table)->values()));
+  return pos;
+}
+
+::arrow::Status PageTable::ReadEncodings(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                         int64_t encoding_table_position,
+                                         int32_t num_columns,
+                                         int32_t num_batches) {
+  ARROW_ASSIGN_OR_RAISE(
+      auto buf, in->ReadAt(encoding_table_position, num_columns * num_batches * sizeof(int32_t)));
+  auto arr = ::arrow::Int32Array(num_columns * num_batches, buf);
+  for (int32_t col = 0; col < num_columns; col++) {
+    for (int32_t batch = 0; batch < num_batches; batch++) {
+      auto encoding = arr.Value(col * num_batches + batch);
+      if (!pb::Encoding_IsValid(encoding)) {
+        return ::arrow::Status::Invalid("Invalid page encoding: ", encoding);
+      }
+      SetEncoding(col, batch, static_cast<pb::Encoding>(encoding));
+    }
+  }
+  return ::arrow::Status::OK();
+}
+
+void PageTable::SetStatistics(int32_t column_id,
+                              int32_t batch_id,
+                              pb::PageStatistics statistics) noexcept {
+  statistics.set_field_id(column_id);
+  statistics.set_batch_id(batch_id);
+  statistics_map_[column_id][batch_id] = std::move(statistics);
+}
+
+std::optional<pb::PageStatistics> PageTable::GetStatistics(int32_t column_id,
+                                                           int32_t batch_id) const noexcept {
+  auto column_it = statistics_map_.find(column_id);
+  if (column_it == statistics_map_.end()) {
+    return std::nullopt;
+  }
+  auto page_it = column_it->second.find(batch_id);
+  if (page_it == column_it->second.end()) {
+    return std::nullopt;
+  }
+  return page_it->second;
+}
+
+bool PageTable::HasStatistics() const noexcept {
+  for (auto& [column_id, pages] : statistics_map_) {
+    if (!pages.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+::arrow::Result<int64_t> PageTable::WriteStatistics(
+    const std::shared_ptr<::arrow::io::OutputStream>& out) {
+  pb::Statistics pb;
+  for (auto& [column_id, pages] : statistics_map_) {
+    for (auto& [batch_id, statistics] : pages) {
+      *pb.add_pages() = statistics;
+    }
+  }
+  return io::WriteProto(out, pb);
+}
+
+::arrow::Status PageTable::ReadStatistics(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                          int64_t statistics_position) {
+  ARROW_ASSIGN_OR_RAISE(auto pb, io::ParseProto<pb::Statistics>(in, statistics_position));
+  for (auto& statistics : pb.pages()) {
+    SetStatistics(statistics.field_id(), statistics.batch_id(), statistics);
+  }
+  return ::arrow::Status::OK();
+}
+
+void PageTable::SetBloomFilter(int32_t column_id,
+                               int32_t batch_id,
+                               pb::PageBloomFilter bloom_filter) noexcept {
+  bloom_filter.set_field_id(column_id);
+  bloom_filter.set_batch_id(batch_id);
+  bloom_filter_map_[column_id][batch_id] = std::move(bloom_filter);
+}
+
+std::optional<pb::PageBloomFilter> PageTable::GetBloomFilter(int32_t column_id,
+                                                             int32_t batch_id) const noexcept {
+  auto column_it = bloom_filter_map_.find(column_id);
+  if (column_it == bloom_filter_map_.end()) {
+    return std::nullopt;
+  }
+  auto page_it = column_it->second.find(batch_id);
+  if (page_it == column_it->second.end()) {
+    return std::nullopt;
+  }
+  return page_it->second;
+}
+
+bool PageTable::HasBloomFilters() const noexcept {
+  for (auto& [column_id, pages] : bloom_filter_map_) {
+    if (!pages.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+::arrow::Result<int64_t> PageTable::WriteBloomFilters(
+    const std::shared_ptr<::arrow::io::OutputStream>& out) {
+  pb::BloomFilters pb;
+  for (auto& [column_id, pages] : bloom_filter_map_) {
+    for (auto& [batch_id, bloom_filter] : pages) {
+      *pb.add_pages() = bloom_filter;
+    }
+  }
+  return io::WriteProto(out, pb);
+}
+
+::arrow::Status PageTable::ReadBloomFilters(
+    const std::shared_ptr<::arrow::io::RandomAccessFile>& in, int64_t bloom_filters_position) {
+  ARROW_ASSIGN_OR_RAISE(auto pb, io::ParseProto<pb::BloomFilters>(in, bloom_filters_position));
+  for (auto& bloom_filter : pb.pages()) {
+    SetBloomFilter(bloom_filter.field_id(), bloom_filter.batch_id(), bloom_filter);
+  }
+  return ::arrow::Status::OK();
+}
+
+::arrow::Result<int64_t> PageTable::Write(const std::shared_ptr<::arrow::io::OutputStream>& out) {
+  ::arrow::Int64Builder builder;
+
+  auto [num_columns, num_batches] = Shape();
 
   ARROW_RETURN_NOT_OK(builder.Reserve(num_columns * num_batches * 2));
   for (int32_t column_id = 0; column_id < num_columns; ++column_id) {
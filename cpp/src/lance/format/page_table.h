@@ -23,6 +23,8 @@
 #include <tuple>
 #include <vector>
 
+#include "lance/format/format.pb.h"
+
 namespace lance::format {
 
 /// PageTable lookup table for pages.
@@ -57,6 +59,124 @@ class PageTable {
   //          the page is virtual (i.e., parent field)
   std::optional<PageInfo> GetPageInfo(int32_t column_id, int32_t batch_id) const noexcept;
 
+  /// Validity of a page that has no nulls.
+  static constexpr int64_t kNoNulls = -1;
+
+  /// Validity of a page where all the values are null.
+  static constexpr int64_t kAllNull = -2;
+
+  /// Set the validity of a page.
+  ///
+  /// \param column_id the column / field ID.
+  /// \param batch_id the ID of the batch
+  /// \param validity `kNoNulls`, `kAllNull` or the file position of the validity bitmap.
+  void SetValidity(int32_t column_id, int32_t batch_id, int64_t validity) noexcept;
+
+  /// Get the validity of a page. Returns `kNoNulls` if it was not set.
+  int64_t GetValidity(int32_t column_id, int32_t batch_id) const noexcept;
+
+  /// Returns true if any of the pages has nulls.
+  bool HasNulls() const noexcept;
+
+  /// Write the validity table to a file.
+  ///
+  /// \param out the output stream to write validity table to.
+  /// \return file position if success.
+  ::arrow::Result<int64_t> WriteValidity(const std::shared_ptr<::arrow::io::OutputStream>& out);
+
+  /// Read the validity table from an opened file.
+  ///
+  /// \param in The input file to read
+  /// \param validity_table_position The file position to the validity table.
+  /// \param num_columns the total number of columns, including the nested columns.
+  /// \param num_batches the total number of batches in the file.
+  ::arrow::Status ReadValidity(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                               int64_t validity_table_position,
+                               int32_t num_columns,
+                               int32_t num_batches);
+
+  /// Set the encoding of a page, if it is different from the encoding of the column.
+  void SetEncoding(int32_t column_id, int32_t batch_id, pb::Encoding encoding) noexcept;
+
+  /// Get the encoding of a page.
+  ///
+  /// \return `std::nullopt` if the page uses the encoding of the column.
+  std::optional<pb::Encoding> GetEncoding(int32_t column_id, int32_t batch_id) const noexcept;
+
+  /// Returns true if any of the pages has its own encoding.
+  bool HasPageEncodings() const noexcept;
+
+  /// Write the encoding table to a file.
+  ///
+  /// \param out the output stream to write encoding table to.
+  /// \return file position if success.
+  ::arrow::Result<int64_t> WriteEncodings(const std::shared_ptr<::arrow::io::OutputStream>& out);
+
+  /// Read the encoding table from an opened file.
+  ///
+  /// \param in The input file to read
+  /// \param encoding_table_position The file position to the encoding table.
+  /// \param num_columns the total number of columns, including the nested columns.
+  /// \param num_batches the total number of batches in the file.
+  ::arrow::Status ReadEncodings(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                int64_t encoding_table_position,
+                                int32_t num_columns,
+                                int32_t num_batches);
+
+  /// Set the statistics of a page.
+  void SetStatistics(int32_t column_id, int32_t batch_id, pb::PageStatistics statistics) noexcept;
+
+  /// Get the statistics of a page.
+  ///
+  /// \return `std::nullopt` if the statistics of the page were not collected.
+  std::optional<pb::PageStatistics> GetStatistics(int32_t column_id,
+                                                  int32_t batch_id) const noexcept;
+
+  /// Returns true if any of the pages has statistics.
+  bool HasStatistics() const noexcept;
+
+  /// Write the page statistics to a file.
+  ///
+  /// \param out the output stream to write the statistics to.
+  /// \return file position if success.
+  ::arrow::Result<int64_t> WriteStatistics(const std::shared_ptr<::arrow::io::OutputStream>& out);
+
+  /// Read the page statistics from an opened file.
+  ///
+  /// \param in The input file to read
+  /// \param statistics_position The file position to the statistics.
+  ::arrow::Status ReadStatistics(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                 int64_t statistics_position);
+
+  /// Set the Bloom filter of a page.
+  void SetBloomFilter(int32_t column_id,
+                      int32_t batch_id,
+                      pb::PageBloomFilter bloom_filter) noexcept;
+
+  /// Get the Bloom filter of a page, i.e., the file position and the size of its blocks.
+  ///
+  /// \return `std::nullopt` if the page has no Bloom filter.
+  std::optional<pb::PageBloomFilter> GetBloomFilter(int32_t column_id,
+                                                    int32_t batch_id) const noexcept;
+
+  /// Returns true if any of the pages has a Bloom filter.
+  bool HasBloomFilters() const noexcept;
+
+  /// Write the Bloom filters of the pages to a file. The blocks of the filters are not written,
+  /// which are already in the file.
+  ///
+  /// \param out the output stream to write the Bloom filters to.
+  /// \return file position if success.
+  ::arrow::Result<int64_t> WriteBloomFilters(
+      const std::shared_ptr<::arrow::io::OutputStream>& out);
+
+  /// Read the Bloom filters of the pages from an opened file.
+  ///
+  /// \param in The input file to read
+  /// \param bloom_filters_position The file position to the Bloom filters.
+  ::arrow::Status ReadBloomFilters(const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+                                   int64_t bloom_filters_position);
+
   /// Write PageTable to a file.
   ///
   /// \param out the output stream to write page table to.
@@ -66,6 +186,21 @@ class PageTable {
  private:
   /// Map<column, Map<page, {position, length}>>
   std::map<int32_t, std::map<int32_t, PageInfo>> page_info_map_;
+
+  /// Map<column, Map<page, validity>>, only for the pages that have nulls.
+  std::map<int32_t, std::map<int32_t, int64_t>> validity_map_;
+
+  /// Map<column, Map<page, encoding>>, only for the pages that have their own encoding.
+  std::map<int32_t, std::map<int32_t, pb::Encoding>> encoding_map_;
+
+  /// Map<column, Map<page, statistics>>, only for the pages that have statistics.
+  std::map<int32_t, std::map<int32_t, pb::PageStatistics>> statistics_map_;
+
+  /// Map<column, Map<page, Bloom filter>>, only for the pages that have Bloom filters.
+  std::map<int32_t, std::map<int32_t, pb::PageBloomFilter>> bloom_filter_map_;
+
+  /// Number of columns and batches of the page table.
+  std::tuple<int32_t, int32_t> Shape() const noexcept;
 };
 
 }  // namespace lance::format
@@ -42,4 +42,86 @@ TEST_CASE("Serialize page length") {
       CHECK(actual->GetPageInfo(col, batch) == std::make_tuple(col * 10 + batch, col * 10 + batch));
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Serialize page validity") {
+  lance::format::PageTable lt;
+  for (int col = 0; col < 2; col++) {
+    for (int batch = 0; batch < 3; batch++) {
+      lt.SetPageInfo(col, batch, col * 10 + batch, 10);
+    }
+  }
+  CHECK(!lt.HasNulls());
+  lt.SetValidity(0, 1, PageTable::kAllNull);
+  lt.SetValidity(1, 2, 1024);
+  CHECK(lt.HasNulls());
+
+  auto out_buf = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto pos = lt.WriteValidity(out_buf).ValueOrDie();
+
+  auto in_buf = std::make_shared<arrow::io::BufferReader>(out_buf->Finish().ValueOrDie());
+  PageTable actual;
+  CHECK(actual.ReadValidity(in_buf, pos, 2, 3).ok());
+  CHECK(actual.GetValidity(0, 0) == PageTable::kNoNulls);
+  CHECK(actual.GetValidity(0, 1) == PageTable::kAllNull);
+  CHECK(actual.GetValidity(1, 2) == 1024);
+  CHECK(actual.GetValidity(1, 1) == PageTable::kNoNulls);
+}
+
+TEST_CASE("Serialize page encodings") {
+  lance::format::PageTable lt;
+  for (int col = 0; col < 2; col++) {
+    for (int batch = 0; batch < 3; batch++) {
+      lt.SetPageInfo(col, batch, col * 10 + batch, 10);
+    }
+  }
+  CHECK(!lt.HasPageEncodings());
+  lt.SetEncoding(0, 2, lance::format::pb::Encoding::RLE);
+  lt.SetEncoding(1, 0, lance::format::pb::Encoding::FSST);
+  CHECK(lt.HasPageEncodings());
+
+  auto out_buf = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto pos = lt.WriteEncodings(out_buf).ValueOrDie();
+
+  auto in_buf = std::make_shared<arrow::io::BufferReader>(out_buf->Finish().ValueOrDie());
+  PageTable actual;
+  CHECK(actual.ReadEncodings(in_buf, pos, 2, 3).ok());
+  CHECK(!actual.GetEncoding(0, 0).has_value());
+  CHECK(actual.GetEncoding(0, 2) == lance::format::pb::Encoding::RLE);
+  CHECK(actual.GetEncoding(1, 0) == lance::format::pb::Encoding::FSST);
+  CHECK(!actual.GetEncoding(1, 2).has_value());
+}
+
+TEST_CASE("Serialize page statistics") {
+  lance::format::PageTable lt;
+  CHECK(!lt.HasStatistics());
+  lance::format::pb::PageStatistics statistics;
+  statistics.set_min("apple");
+  statistics.set_max("pear");
+  statistics.set_null_count(3);
+  statistics.set_row_count(100);
+  lt.SetStatistics(2, 1, statistics);
+  statistics.clear_min();
+  statistics.clear_max();
+  statistics.set_null_count(100);
+  lt.SetStatistics(0, 4, statistics);
+  CHECK(lt.HasStatistics());
+
+  auto out_buf = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  auto pos = lt.WriteStatistics(out_buf).ValueOrDie();
+
+  auto in_buf = std::make_shared<arrow::io::BufferReader>(out_buf->Finish().ValueOrDie());
+  PageTable actual;
+  CHECK(actual.ReadStatistics(in_buf, pos).ok());
+  auto page = actual.GetStatistics(2, 1).value();
+  CHECK(page.field_id() == 2);
+  CHECK(page.batch_id() == 1);
+  CHECK(page.min() == "apple");
+  CHECK(page.max() == "pear");
+  CHECK(page.null_count() == 3);
+  CHECK(page.row_count() == 100);
+  CHECK(actual.GetStatistics(0, 4)->null_count() == 100);
+  CHECK(actual.GetStatistics(0, 4)->min().empty());
+  CHECK(!actual.GetStatistics(0, 1).has_value());
+  CHECK(!actual.GetStatistics(2, 4).has_value());
+}
@@ -0,0 +1,272 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/primary_key_index.h"
+
+#include <arrow/builder.h>
+#include <arrow/compute/api.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "lance/encodings/binary.h"
+#include "lance/encodings/plain.h"
+#include "lance/format/schema.h"
+#include "lance/io/pb.h"
+
+namespace lance::format {
+
+namespace {
+
+/// The encoding of the keys.
+pb::Encoding KeyEncoding(const ::arrow::DataType& type) {
+  return ::arrow::is_binary_like(type.id()) ? pb::Encoding::VAR_BINARY : pb::Encoding::PLAIN;
+}
+
+/// The decoder of the keys of the key type.
+::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> GetKeyDecoder(
+    const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+    const std::shared_ptr<::arrow::DataType>& type) {
+  std::shared_ptr<lance::encodings::Decoder> decoder;
+  if (type->id() == ::arrow::Type::STRING) {
+    decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::StringType>>(in, type);
+  } else if (type->id() == ::arrow::Type::BINARY) {
+    decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::BinaryType>>(in, type);
+  } else {
+    decoder = std::make_shared<lance::encodings::PlainDecoder>(in, type);
+  }
+  ARROW_RETURN_NOT_OK(decoder->Init());
+  return decoder;
+}
+
+/// The first index in [0, length) where `pred` is false, where `pred` is true for a prefix.
+template <typename Pred>
+int64_t PartitionPoint(int64_t length, Pred&& pred) {
+  int64_t low = 0;
+  while (length > 0) {
+    auto half = length / 2;
+    if (pred(low + half)) {
+      low += half + 1;
+      length -= half + 1;
+    } else {
+      length = half;
+    }
+  }
+  return low;
+}
+
+template <typename ArrayType>
+std::tuple<int64_t, int64_t> EqualRangeImpl(const ::arrow::Array& sorted,
+                                            const ::arrow::Array& keys,
+                                            int64_t index) {
+  auto& values = static_cast<const ArrayType&>(sorted);
+  auto key = static_cast<const ArrayType&>(keys).GetView(index);
+  auto lower = PartitionPoint(values.length(), [&](auto i) { return values.GetView(i) < key; });
+  auto upper = PartitionPoint(values.length(), [&](auto i) { return !(key < values.GetView(i)); });
+  return {lower, upper};
+}
+
+/// The range of the values of a sorted array that are equal to `keys[index]`.
+::arrow::Result<std::tuple<int64_t, int64_t>> EqualRange(const ::arrow::Array& sorted,
+                                                         const ::arrow::Array& keys,
+                                                         int64_t index) {
+  switch (sorted.type_id()) {
+    case ::arrow::Type::INT8:
+      return EqualRangeImpl<::arrow::Int8Array>(sorted, keys, index);
+    case ::arrow::Type::UINT8:
+      return EqualRangeImpl<::arrow::UInt8Array>(sorted, keys, index);
+    case ::arrow::Type::INT16:
+      return EqualRangeImpl<::arrow::Int16Array>(sorted, keys, index);
+    case ::arrow::Type::UINT16:
+      return EqualRangeImpl<::arrow::UInt16Array>(sorted, keys, index);
+    case ::arrow::Type::INT32:
+      return EqualRangeImpl<::arrow::Int32Array>(sorted, keys, index);
+    case ::arrow::Type::UINT32:
+      return EqualRangeImpl<::arrow::UInt32Array>(sorted, keys, index);
+    case ::arrow::Type::INT64:
+      return EqualRangeImpl<::arrow::Int64Array>(sorted, keys, index);
+    case ::arrow::Type::UINT64:
+      return EqualRangeImpl<::arrow::UInt64Array>(sorted, keys, index);
+    case ::arrow::Type::STRING:
+      return EqualRangeImpl<::arrow::StringArray>(sorted, keys, index);
+    case ::arrow::Type::BINARY:
+      return EqualRangeImpl<::arrow::BinaryArray>(sorted, keys, index);
+    case ::arrow::Type::FIXED_SIZE_BINARY:
+      return EqualRangeImpl<::arrow::FixedSizeBinaryArray>(sorted, keys, index);
+    default:
+      return ::arrow::Status::NotImplemented(
+          fmt::format("Primary key index does not support type: {}", sorted.type()->ToString()));
+  }
+}
+
+}  // namespace
+
+PrimaryKeyIndex::PrimaryKeyIndex(std::shared_ptr<::arrow::io::RandomAccessFile> in,
+                                 std::shared_ptr<Field> field,
+                                 pb::PrimaryKeyIndex pb,
+                                 std::shared_ptr<::arrow::Array> fences)
+    : in_(std::move(in)), field_(std::move(field)), pb_(std::move(pb)), fences_(std::move(fences)) {}
+
+bool PrimaryKeyIndex::Supports(const ::arrow::DataType& type) {
+  if (::arrow::is_dictionary(type.id())) {
+    return Supports(*static_cast<const ::arrow::DictionaryType&>(type).value_type());
+  }
+  return ::arrow::is_integer(type.id()) || type.id() == ::arrow::Type::STRING ||
+         type.id() == ::arrow::Type::BINARY || type.id() == ::arrow::Type::FIXED_SIZE_BINARY;
+}
+
+std::shared_ptr<::arrow::DataType> PrimaryKeyIndex::KeyType(
+    const std::shared_ptr<::arrow::DataType>& type) {
+  if (::arrow::is_dictionary(type->id())) {
+    return std::static_pointer_cast<::arrow::DictionaryType>(type)->value_type();
+  }
+  return type;
+}
+
+::arrow::Result<int64_t> PrimaryKeyIndex::Write(
+    const std::shared_ptr<::arrow::io::OutputStream>& out,
+    const std::shared_ptr<Field>& field,
+    const std::shared_ptr<::arrow::Array>& keys,
+    int32_t block_size) {
+  if (!Supports(*keys->type()) || !keys->type()->Equals(KeyType(field->type()))) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Primary key index does not support type: {}", keys->type()->ToString()));
+  }
+  if (block_size <= 0) {
+    return ::arrow::Status::Invalid(fmt::format("Invalid block size: {}", block_size));
+  }
+  // Nulls are sorted at the end.
+  ARROW_ASSIGN_OR_RAISE(auto order, ::arrow::compute::SortIndices(*keys));
+  auto num_rows = keys->length() - keys->null_count();
+  ARROW_ASSIGN_OR_RAISE(auto row_ids_datum,
+                        ::arrow::compute::Cast(order->Slice(0, num_rows), ::arrow::int64()));
+  auto row_ids = row_ids_datum.make_array();
+  ARROW_ASSIGN_OR_RAISE(auto sorted_datum, ::arrow::compute::Take(keys, row_ids));
+  auto sorted = sorted_datum.make_array();
+
+  pb::PrimaryKeyIndex pb;
+  pb.set_field_id(field->id());
+  pb.set_block_size(block_size);
+  pb.set_num_rows(num_rows);
+  auto encoding = KeyEncoding(*keys->type());
+  ::arrow::Int64Builder fence_indices;
+  for (int64_t start = 0; start < num_rows; start += block_size) {
+    auto length = std::min<int64_t>(block_size, num_rows - start);
+    ARROW_RETURN_NOT_OK(fence_indices.Append(start));
+    ARROW_ASSIGN_OR_RAISE(auto keys_pos,
+                          field->GetEncoder(out, encoding)->Write(sorted->Slice(start, length)));
+    ARROW_ASSIGN_OR_RAISE(
+        auto row_ids_pos,
+        lance::encodings::PlainEncoder(out).Write(row_ids->Slice(start, length)));
+    pb.add_keys_positions(keys_pos);
+    pb.add_row_ids_positions(row_ids_pos);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto fence_indices_arr, fence_indices.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto fences, ::arrow::compute::Take(sorted, fence_indices_arr));
+  ARROW_ASSIGN_OR_RAISE(auto fences_pos,
+                        field->GetEncoder(out, encoding)->Write(fences.make_array()));
+  pb.set_fences_position(fences_pos);
+  return io::WriteProto(out, pb);
+}
+
+::arrow::Result<std::shared_ptr<PrimaryKeyIndex>> PrimaryKeyIndex::Read(
+    const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+    int64_t position,
+    const Schema& schema) {
+  ARROW_ASSIGN_OR_RAISE(auto pb, io::ParseProto<pb::PrimaryKeyIndex>(in, position));
+  auto field = schema.GetField(pb.field_id());
+  if (!field || !Supports(*field->type())) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Primary key index of an invalid field: {}", pb.field_id()));
+  }
+  if (pb.keys_positions_size() != pb.row_ids_positions_size() ||
+      pb.block_size() <= 0 ||
+      pb.keys_positions_size() != (pb.num_rows() + pb.block_size() - 1) / pb.block_size()) {
+    return ::arrow::Status::Invalid("Corrupted primary key index");
+  }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetKeyDecoder(in, KeyType(field->type())));
+  decoder->Reset(pb.fences_position(), pb.keys_positions_size());
+  ARROW_ASSIGN_OR_RAISE(auto fences, decoder->ToArray());
+  return std::shared_ptr<PrimaryKeyIndex>(
+      new PrimaryKeyIndex(in, field, std::move(pb), std::move(fences)));
+}
+
+::arrow::Result<
+    std::tuple<std::shared_ptr<::arrow::Array>, std::shared_ptr<::arrow::Int64Array>>>
+PrimaryKeyIndex::ReadBlock(int64_t block) const {
+  auto length = std::min<int64_t>(pb_.block_size(), pb_.num_rows() - block * pb_.block_size());
+  ARROW_ASSIGN_OR_RAISE(auto keys_decoder, GetKeyDecoder(in_, KeyType(field_->type())));
+  keys_decoder->Reset(pb_.keys_positions(block), length);
+  ARROW_ASSIGN_OR_RAISE(auto keys, keys_decoder->ToArray());
+  auto row_ids_decoder = lance::encodings::PlainDecoder(in_, ::arrow::int64());
+  ARROW_RETURN_NOT_OK(row_ids_decoder.Init());
+  row_ids_decoder.Reset(pb_.row_ids_positions(block), length);
+  ARROW_ASSIGN_OR_RAISE(auto row_ids, row_ids_decoder.ToArray());
+  return std::make_tuple(keys, std::static_pointer_cast<::arrow::Int64Array>(row_ids));
+}
+
+::arrow::Result<std::vector<int64_t>> PrimaryKeyIndex::Lookup(const ::arrow::Array& keys) const {
+  auto key_type = KeyType(field_->type());
+  std::shared_ptr<::arrow::Array> decoded;
+  if (::arrow::is_dictionary(keys.type_id()) && keys.type()->Equals(field_->type())) {
+    // Dictionary keys are indexed by their values.
+    ARROW_ASSIGN_OR_RAISE(decoded, ::arrow::compute::Cast(keys, key_type));
+  }
+  const auto& key_values = decoded ? *decoded : keys;
+  if (!key_values.type()->Equals(key_type)) {
+    return ::arrow::Status::Invalid(fmt::format("Primary key type mismatch: expected {}, got {}",
+                                                key_type->ToString(),
+                                                key_values.type()->ToString()));
+  }
+  // Blocks read by this lookup.
+  std::map<int64_t,
+           std::tuple<std::shared_ptr<::arrow::Array>, std::shared_ptr<::arrow::Int64Array>>>
+      blocks;
+  std::vector<int64_t> row_ids;
+  for (int64_t i = 0; i < key_values.length(); i++) {
+    if (key_values.IsNull(i)) {
+      continue;
+    }
+    // Blocks [lower, upper) start with the key, and the block before them may end with it.
+    ARROW_ASSIGN_OR_RAISE(auto fence_range, EqualRange(*fences_, key_values, i));
+    auto [lower, upper] = fence_range;
+    if (upper == 0) {
+      // Less than all the keys.
+      continue;
+    }
+    for (auto block = std::max<int64_t>(lower - 1, 0); block < upper; block++) {
+      auto it = blocks.find(block);
+      if (it == blocks.end()) {
+        ARROW_ASSIGN_OR_RAISE(auto keys_and_row_ids, ReadBlock(block));
+        it = blocks.emplace(block, std::move(keys_and_row_ids)).first;
+      }
+      auto& [block_keys, block_row_ids] = it->second;
+      ARROW_ASSIGN_OR_RAISE(auto range, EqualRange(*block_keys, key_values, i));
+      for (auto j = std::get<0>(range); j < std::get<1>(range); j++) {
+        row_ids.emplace_back(block_row_ids->Value(j));
+      }
+    }
+  }
+  std::sort(row_ids.begin(), row_ids.end());
+  row_ids.erase(std::unique(row_ids.begin(), row_ids.end()), row_ids.end());
+  return row_ids;
+}
+
+const std::shared_ptr<Field>& PrimaryKeyIndex::field() const { return field_; }
+
+int64_t PrimaryKeyIndex::num_blocks() const { return pb_.keys_positions_size(); }
+
+}  // namespace lance::format
@@ -0,0 +1,103 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/io/api.h>
+#include <arrow/result.h>
+
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "lance/format/format.pb.h"
+
+namespace lance::format {
+
+class Field;
+class Schema;
+
+/// Sorted index of the primary key of a file, to look up the rows by key.
+///
+/// The (key, row id) pairs are sorted by key, and split into blocks. The first key of each
+/// block (the fence pointers) is loaded when the index is opened, so a lookup binary-searches
+/// the fences in memory, and reads the one block that can contain the key.
+class PrimaryKeyIndex {
+ public:
+  /// Default number of (key, row id) pairs in a block.
+  static constexpr int32_t kBlockSize = 1024;
+
+  /// Returns true if the keys of the type can be indexed, i.e., integer, string, binary and
+  /// fixed size binary keys. Dictionary keys are indexed by their values.
+  static bool Supports(const ::arrow::DataType& type);
+
+  /// The type of the indexed keys of a primary key type, i.e., the value type of a dictionary.
+  static std::shared_ptr<::arrow::DataType> KeyType(
+      const std::shared_ptr<::arrow::DataType>& type);
+
+  /// Write the index of the primary key of a file.
+  ///
+  /// \param out the output stream.
+  /// \param field the primary key field.
+  /// \param keys the keys of all the rows of the file, in row order, of the key type. Null keys
+  ///             are not indexed.
+  /// \param block_size the number of (key, row id) pairs in a block.
+  /// \return the file position of the index.
+  static ::arrow::Result<int64_t> Write(const std::shared_ptr<::arrow::io::OutputStream>& out,
+                                        const std::shared_ptr<Field>& field,
+                                        const std::shared_ptr<::arrow::Array>& keys,
+                                        int32_t block_size = kBlockSize);
+
+  /// Open the index, and load the fence pointers.
+  ///
+  /// \param in the input file.
+  /// \param position the file position of the index.
+  /// \param schema the schema of the file.
+  static ::arrow::Result<std::shared_ptr<PrimaryKeyIndex>> Read(
+      const std::shared_ptr<::arrow::io::RandomAccessFile>& in,
+      int64_t position,
+      const Schema& schema);
+
+  /// Look up the rows of the keys.
+  ///
+  /// \param keys the keys to look up, of the type of the primary key or the key type. Null keys
+  ///             match no row.
+  /// \return the sorted row ids, within the file, of the rows that have any of the keys.
+  ::arrow::Result<std::vector<int64_t>> Lookup(const ::arrow::Array& keys) const;
+
+  /// The primary key field.
+  const std::shared_ptr<Field>& field() const;
+
+  /// Number of blocks.
+  int64_t num_blocks() const;
+
+ private:
+  PrimaryKeyIndex(std::shared_ptr<::arrow::io::RandomAccessFile> in,
+                  std::shared_ptr<Field> field,
+                  pb::PrimaryKeyIndex pb,
+                  std::shared_ptr<::arrow::Array> fences);
+
+  /// Read the keys and the row ids of a block.
+  ::arrow::Result<std::tuple<std::shared_ptr<::arrow::Array>, std::shared_ptr<::arrow::Int64Array>>>
+  ReadBlock(int64_t block) const;
+
+  std::shared_ptr<::arrow::io::RandomAccessFile> in_;
+  std::shared_ptr<Field> field_;
+  pb::PrimaryKeyIndex pb_;
+  std::shared_ptr<::arrow::Array> fences_;
+};
+
+}  // namespace lance::format
@@ -0,0 +1,133 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/format/primary_key_index.h"
+
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <arrow/type.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/stl.h"
+#include "lance/format/schema.h"
+
+using lance::format::PrimaryKeyIndex;
+
+namespace {
+
+/// Write the index of the keys, and open it.
+std::shared_ptr<PrimaryKeyIndex> WriteAndRead(const std::shared_ptr<::arrow::Array>& keys,
+                                              int32_t block_size) {
+  auto schema = lance::format::Schema(::arrow::schema({::arrow::field("pk", keys->type())}));
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  // Do not start the index at the beginning of the file.
+  CHECK(sink->Write("lance", 5).ok());
+  auto pos = PrimaryKeyIndex::Write(sink, schema.GetField("pk"), keys, block_size).ValueOrDie();
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  return PrimaryKeyIndex::Read(infile, pos, schema).ValueOrDie();
+}
+
+}  // namespace
+
+TEST_CASE("Primary key index supported types") {
+  CHECK(PrimaryKeyIndex::Supports(*::arrow::int32()));
+  CHECK(PrimaryKeyIndex::Supports(*::arrow::uint64()));
+  CHECK(PrimaryKeyIndex::Supports(*::arrow::utf8()));
+  CHECK(PrimaryKeyIndex::Supports(*::arrow::binary()));
+  CHECK(PrimaryKeyIndex::Supports(*::arrow::fixed_size_binary(16)));
+  CHECK(!PrimaryKeyIndex::Supports(*::arrow::float32()));
+  CHECK(!PrimaryKeyIndex::Supports(*::arrow::boolean()));
+  CHECK(!PrimaryKeyIndex::Supports(*::arrow::list(::arrow::int32())));
+}
+
+TEST_CASE("Look up int primary keys") {
+  const int num_rows = 1000;
+  std::vector<int64_t> keys(num_rows);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (auto& key : keys) {
+    key *= 2;
+  }
+  auto index = WriteAndRead(lance::arrow::ToArray(keys).ValueOrDie(), 64);
+  CHECK(index->num_blocks() == 16);
+
+  for (auto row_id : {0, 1, 63, 64, 500, 999}) {
+    auto lookup = lance::arrow::ToArray<int64_t>({keys[row_id]}).ValueOrDie();
+    CHECK(index->Lookup(*lookup).ValueOrDie() == std::vector<int64_t>({row_id}));
+  }
+  // Keys that are not in the index: before, between and after the keys.
+  auto missing = lance::arrow::ToArray<int64_t>({-10, 1, 63, 2001}).ValueOrDie();
+  CHECK(index->Lookup(*missing).ValueOrDie().empty());
+
+  auto lookup = lance::arrow::ToArray<int64_t>({keys[7], 1, keys[3], keys[7]}).ValueOrDie();
+  CHECK(index->Lookup(*lookup).ValueOrDie() == std::vector<int64_t>({3, 7}));
+
+  // The type of the keys must match.
+  CHECK(!index->Lookup(*lance::arrow::ToArray<int32_t>({0}).ValueOrDie()).ok());
+}
+
+TEST_CASE("Look up duplicated primary keys across blocks") {
+  // Key 5 spans several blocks, and the other keys are unique.
+  ::arrow::Int32Builder builder;
+  std::vector<int64_t> expected;
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 == 0) {
+      CHECK(builder.Append(5).ok());
+      expected.emplace_back(i);
+    } else {
+      CHECK(builder.Append(i + 100).ok());
+    }
+  }
+  CHECK(builder.AppendNull().ok());
+  auto index = WriteAndRead(builder.Finish().ValueOrDie(), 4);
+
+  auto lookup = lance::arrow::ToArray<int32_t>({5}).ValueOrDie();
+  CHECK(index->Lookup(*lookup).ValueOrDie() == expected);
+  lookup = lance::arrow::ToArray<int32_t>({101, 5, 198}).ValueOrDie();
+  auto row_ids = index->Lookup(*lookup).ValueOrDie();
+  CHECK(row_ids.size() == expected.size() + 2);
+  CHECK(std::is_sorted(row_ids.begin(), row_ids.end()));
+  CHECK(row_ids.back() == 99);
+
+  // Null keys are not indexed.
+  ::arrow::Int32Builder null_builder;
+  CHECK(null_builder.AppendNull().ok());
+  CHECK(index->Lookup(*null_builder.Finish().ValueOrDie()).ValueOrDie().empty());
+}
+
+TEST_CASE("Look up string primary keys") {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 300; i++) {
+    keys.emplace_back(fmt::format("key-{}", (i * 7) % 300));
+  }
+  auto index = WriteAndRead(lance::arrow::ToArray(keys).ValueOrDie(), 32);
+
+  auto lookup = lance::arrow::ToArray({"key-7", "key-299", "key-", "key-3000"}).ValueOrDie();
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < static_cast<int64_t>(keys.size()); i++) {
+    if (keys[i] == "key-7" || keys[i] == "key-299") {
+      expected.emplace_back(i);
+    }
+  }
+  CHECK(expected.size() == 2);
+  CHECK(index->Lookup(*lookup).ValueOrDie() == expected);
+}
@@ -14,6 +14,7 @@
 
 #include "lance/format/schema.h"
 
+#include <arrow/array/util.h>
 #include <arrow/status.h>
 #include <arrow/type.h>
 #include <arrow/util/string.h>
@@ -27,8 +28,13 @@
 
 #include "lance/arrow/type.h"
 #include "lance/encodings/binary.h"
+#include "lance/encodings/blob.h"
+#include "lance/encodings/byte_stream_split.h"
 #include "lance/encodings/dictionary.h"
+#include "lance/encodings/fsst.h"
+#include "lance/encodings/packed_struct.h"
 #include "lance/encodings/plain.h"
+#include "lance/encodings/rle.h"
 
 using std::make_shared;
 using std::string;
@@ -49,19 +55,31 @@ Field::Field(const std::shared_ptr<::arrow::Field>& field)
     for (auto& arrow_field : struct_type->fields()) {
       children_.push_back(std::shared_ptr<Field>(new Field(arrow_field)));
     }
+  } else if (::lance::arrow::is_map(field->type())) {
+    // Offsets page, with the keys and values as two child columns.
+    auto map_type = std::static_pointer_cast<::arrow::MapType>(field->type());
+    children_.emplace_back(std::shared_ptr<Field>(new Field(map_type->key_field())));
+    children_.emplace_back(std::shared_ptr<Field>(new Field(map_type->item_field())));
+    encoding_ = pb::PLAIN;
   } else if (::lance::arrow::is_list(field->type())) {
-    auto list_type = std::static_pointer_cast<::arrow::ListType>(field->type());
+    auto list_type = std::static_pointer_cast<::arrow::BaseListType>(field->type());
     children_.emplace_back(
         std::shared_ptr<Field>(new Field(::arrow::field("item", list_type->value_type()))));
     encoding_ = pb::PLAIN;
   }
 
   if (::arrow::is_binary_like(field->type()->id())) {
+    encoding_ = pb::VAR_BINARY32;
+  } else if (::arrow::is_large_binary_like(field->type()->id())) {
+    // Pages of large strings may exceed 2GB, so keep the int64 positions.
     encoding_ = pb::VAR_BINARY;
   } else if (::arrow::is_primitive(field->type()->id())) {
     encoding_ = pb::PLAIN;
   } else if (::arrow::is_dictionary(field->type()->id())) {
     encoding_ = pb::DICTIONARY;
+  } else if (::lance::arrow::is_fixed_size_list(field->type()) ||
+             ::arrow::is_fixed_size_binary(field->type()->id())) {
+    encoding_ = pb::PLAIN;
   }
 }
 
@@ -119,7 +137,7 @@ std::shared_ptr<Field> Field::Get(const std::vector<std::string>& field_path,
 }
 
 std::shared_ptr<Field> Field::Get(const std::string_view& name) const {
-  if (logical_type_ == "list.struct") {
+  if (logical_type_ == "list.struct" || logical_type_ == "large_list.struct") {
     if (children_.empty()) {
       return nullptr;
     }
@@ -166,13 +184,29 @@ const std::shared_ptr<::arrow::Array>& Field::dictionary() const { return dictio
 ::arrow::Status Field::LoadDictionary(std::shared_ptr<::arrow::io::RandomAccessFile> infile) {
   assert(::arrow::is_dictionary(type()->id()));
   auto dict_type = std::dynamic_pointer_cast<::arrow::DictionaryType>(type());
-  ///
-  assert(dict_type->value_type()->Equals(::arrow::utf8()));
-
-  auto decoder = lance::encodings::VarBinaryDecoder<::arrow::StringType>(infile, ::arrow::utf8());
-  decoder.Reset(dictionary_offset_, dictionary_page_length_);
+  auto value_type = dict_type->value_type();
+  if (dictionary_page_length_ == 0) {
+    ARROW_ASSIGN_OR_RAISE(auto empty, ::arrow::MakeEmptyArray(value_type));
+    return set_dictionary(empty);
+  }
+
+  std::unique_ptr<lance::encodings::Decoder> decoder;
+  if (::arrow::is_primitive(value_type->id())) {
+    decoder = std::make_unique<lance::encodings::PlainDecoder>(infile, value_type);
+  } else if (value_type->id() == ::arrow::Type::STRING) {
+    decoder = std::make_unique<lance::encodings::VarBinaryDecoder<::arrow::StringType>>(
+        infile, value_type);
+  } else if (value_type->id() == ::arrow::Type::BINARY) {
+    decoder = std::make_unique<lance::encodings::VarBinaryDecoder<::arrow::BinaryType>>(
+        infile, value_type);
+  } else {
+    return ::arrow::Status::NotImplemented(
+        fmt::format("Dictionary with value type {} is not supported", value_type->ToString()));
+  }
+  ARROW_RETURN_NOT_OK(decoder->Init());
+  decoder->Reset(dictionary_offset_, dictionary_page_length_);
 
-  ARROW_ASSIGN_OR_RAISE(auto dict_arr, decoder.ToArray());
+  ARROW_ASSIGN_OR_RAISE(auto dict_arr, decoder->ToArray());
   return set_dictionary(dict_arr);
 }
 
@@ -184,38 +218,72 @@ int32_t Field::GetFieldsCount() const {
 }
 
 std::shared_ptr<lance::encodings::Encoder> Field::GetEncoder(
-    std::shared_ptr<::arrow::io::OutputStream> sink) {
-  switch (encoding_) {
+    std::shared_ptr<::arrow::io::OutputStream> sink, std::optional<pb::Encoding> page_encoding) {
+  auto encoding = page_encoding.value_or(encoding_);
+  switch (encoding) {
     case pb::Encoding::PLAIN:
       return std::make_shared<lance::encodings::PlainEncoder>(sink);
     case pb::Encoding::VAR_BINARY:
       return std::make_shared<lance::encodings::VarBinaryEncoder>(sink);
+    case pb::Encoding::VAR_BINARY32:
+      return std::make_shared<lance::encodings::VarBinary32Encoder>(sink);
+    case pb::Encoding::BLOB:
+      return std::make_shared<lance::encodings::BlobEncoder>(sink);
     case pb::Encoding::DICTIONARY:
       return std::make_shared<lance::encodings::DictionaryEncoder>(sink);
+    case pb::Encoding::RLE:
+      return std::make_shared<lance::encodings::RLEEncoder>(sink);
+    case pb::Encoding::FSST:
+      return std::make_shared<lance::encodings::FSSTEncoder>(sink);
+    case pb::Encoding::BYTE_STREAM_SPLIT:
+      return std::make_shared<lance::encodings::ByteStreamSplitEncoder>(sink);
+    case pb::Encoding::PACKED_STRUCT:
+      return std::make_shared<lance::encodings::PackedStructEncoder>(sink);
     default:
-      fmt::print(stderr, "Encoding {} is not supported\n", encoding_);
+      fmt::print(stderr, "Encoding {} is not supported\n", encoding);
       assert(false);
   }
 }
 
 ::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> Field::GetDecoder(
-    std::shared_ptr<::arrow::io::RandomAccessFile> infile) {
+    std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+    std::optional<pb::Encoding> page_encoding) {
+  auto encoding = page_encoding.value_or(encoding_);
   std::shared_ptr<lance::encodings::Decoder> decoder;
-  if (encoding() == pb::Encoding::PLAIN) {
-    if (logical_type_ == "list" || logical_type_ == "list.struct") {
+  if (encoding == pb::Encoding::PLAIN) {
+    if (logical_type_ == "list" || logical_type_ == "list.struct" || logical_type_ == "map" ||
+        logical_type_ == "map:sorted") {
       decoder = std::make_shared<lance::encodings::PlainDecoder>(infile, ::arrow::int32());
+    } else if (logical_type_ == "large_list" || logical_type_ == "large_list.struct") {
+      decoder = std::make_shared<lance::encodings::PlainDecoder>(infile, ::arrow::int64());
     } else {
       decoder = std::make_shared<lance::encodings::PlainDecoder>(infile, type());
     }
-  } else if (encoding_ == pb::Encoding::VAR_BINARY) {
+  } else if (encoding == pb::Encoding::VAR_BINARY) {
     if (logical_type_ == "string") {
       decoder =
           std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::StringType>>(infile, type());
     } else if (logical_type_ == "binary") {
       decoder =
           std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::BinaryType>>(infile, type());
+    } else if (logical_type_ == "large_string") {
+      decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::LargeStringType>>(
+          infile, type());
+    } else if (logical_type_ == "large_binary") {
+      decoder = std::make_shared<lance::encodings::VarBinaryDecoder<::arrow::LargeBinaryType>>(
+          infile, type());
     }
-  } else if (encoding_ == pb::Encoding::DICTIONARY) {
+  } else if (encoding == pb::Encoding::VAR_BINARY32) {
+    if (logical_type_ == "string") {
+      decoder = std::make_shared<lance::encodings::VarBinary32Decoder<::arrow::StringType>>(
+          infile, type());
+    } else if (logical_type_ == "binary") {
+      decoder = std::make_shared<lance::encodings::VarBinary32Decoder<::arrow::BinaryType>>(
+          infile, type());
+    }
+  } else if (encoding == pb::Encoding::BLOB) {
+    decoder = std::make_shared<lance::encodings::BlobDecoder>(infile, type());
+  } else if (encoding == pb::Encoding::DICTIONARY) {
     auto dict_type = std::static_pointer_cast<::arrow::DictionaryType>(type());
     if (!dictionary()) {
       /// Fetch dictionary on demand?
@@ -223,6 +291,14 @@ std::shared_ptr<lance::encodings::Encoder> Field::GetEncoder(
     }
     decoder =
         std::make_shared<lance::encodings::DictionaryDecoder>(infile, dict_type, dictionary());
+  } else if (encoding == pb::Encoding::RLE) {
+    decoder = std::make_shared<lance::encodings::RLEDecoder>(infile, type());
+  } else if (encoding == pb::Encoding::FSST) {
+    decoder = std::make_shared<lance::encodings::FSSTDecoder>(infile, type());
+  } else if (encoding == pb::Encoding::BYTE_STREAM_SPLIT) {
+    decoder = std::make_shared<lance::encodings::ByteStreamSplitDecoder>(infile, type());
+  } else if (encoding == pb::Encoding::PACKED_STRUCT) {
+    decoder = std::make_shared<lance::encodings::PackedStructDecoder>(infile, type());
   }
 
   if (decoder) {
@@ -234,7 +310,7 @@ std::shared_ptr<lance::encodings::Encoder> Field::GetEncoder(
   } else {
     return ::arrow::Status::NotImplemented(
         fmt::format("Field::GetDecoder(): encoding={} logic_type={} is not supported.",
-                    encoding(),
+                    encoding,
                     logical_type_));
   }
 }
@@ -270,6 +346,13 @@ std::shared_ptr<::arrow::DataType> Field::type() const {
   } else if (logical_type_ == "list.struct") {
     assert(children_.size() == 1);
     return ::arrow::list(children_[0]->type());
+  } else if (logical_type_ == "large_list" || logical_type_ == "large_list.struct") {
+    assert(children_.size() == 1);
+    return ::arrow::large_list(children_[0]->type());
+  } else if (logical_type_ == "map" || logical_type_ == "map:sorted") {
+    assert(children_.size() == 2);
+    return ::arrow::map(
+        children_[0]->type(), children_[1]->ToArrow(), logical_type_ == "map:sorted");
   } else if (logical_type_ == "struct") {
     std::vector<std::shared_ptr<::arrow::Field>> sub_types;
     for (auto& child : children_) {
@@ -321,8 +404,12 @@ std::shared_ptr<Field> Field::Project(const std::shared_ptr<::arrow::Field>& arr
       new_field->AddChild(subfield->Project(arrow_subfield));
     }
   } else if (arrow::is_list(arrow_field->type())) {
-    auto list_type = std::dynamic_pointer_cast<::arrow::ListType>(arrow_field->type());
+    auto list_type = std::dynamic_pointer_cast<::arrow::BaseListType>(arrow_field->type());
     new_field->AddChild(children_[0]->Project(list_type->value_field()));
+  } else if (arrow::is_map(arrow_field->type())) {
+    auto map_type = std::dynamic_pointer_cast<::arrow::MapType>(arrow_field->type());
+    new_field->AddChild(children_[0]->Project(map_type->key_field()));
+    new_field->AddChild(children_[1]->Project(map_type->item_field()));
   }
   return new_field;
 }
@@ -386,7 +473,7 @@ Schema::Schema(std::shared_ptr<::arrow::Schema> schema) {
   }
 
   /// If this is a list<struct> node, we push the copy field into the child / struct node.
-  if (field->logical_type() == "list.struct") {
+  if (field->logical_type() == "list.struct" || field->logical_type() == "large_list.struct") {
     assert(field->children_.size() == 1);
     if (new_field->children_.empty()) {
       new_field->children_.emplace_back(field->children_[0]->Copy(false));
@@ -599,7 +686,9 @@ std::shared_ptr<::arrow::Schema> Schema::ToArrow() const {
 pb::Field::Type Field::GetNodeType() const {
   if (logical_type_ == "struct") {
     return pb::Field::PARENT;
-  } else if (logical_type_ == "list.struct" || logical_type_ == "list") {
+  } else if (logical_type_ == "list.struct" || logical_type_ == "list" ||
+             logical_type_ == "large_list.struct" || logical_type_ == "large_list" ||
+             logical_type_ == "map" || logical_type_ == "map:sorted") {
     return pb::Field::REPEATED;
   } else {
     return pb::Field::LEAF;
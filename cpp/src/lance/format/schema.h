@@ -18,6 +18,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -146,11 +147,23 @@ class Field final {
 
   lance::format::pb::Encoding encoding() const { return encoding_; };
 
+  /// Get the decoder of a page.
+  ///
+  /// \param infile the input file.
+  /// \param page_encoding the encoding of the page, if it is different from the encoding of
+  ///                      the field.
   ::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> GetDecoder(
-      std::shared_ptr<::arrow::io::RandomAccessFile> infile);
+      std::shared_ptr<::arrow::io::RandomAccessFile> infile,
+      std::optional<pb::Encoding> page_encoding = std::nullopt);
 
+  /// Get the encoder of a page.
+  ///
+  /// \param sink the output stream.
+  /// \param page_encoding the encoding of the page, if it is different from the encoding of
+  ///                      the field.
   std::shared_ptr<lance::encodings::Encoder> GetEncoder(
-      std::shared_ptr<::arrow::io::OutputStream> sink);
+      std::shared_ptr<::arrow::io::OutputStream> sink,
+      std::optional<pb::Encoding> page_encoding = std::nullopt);
 
   /// Debug String
   std::string ToString() const;
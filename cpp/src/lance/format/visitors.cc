@@ -51,8 +51,8 @@ WriteDictionaryVisitor::WriteDictionaryVisitor(std::shared_ptr<::arrow::io::Outp
     : out_(out) {}
 
 ::arrow::Status WriteDictionaryVisitor::Visit(std::shared_ptr<Field> root) {
-  if (::arrow::is_dictionary(root->type()->id())) {
-    assert(root->dictionary());
+  // Columns without any non-null value do not have a dictionary.
+  if (::arrow::is_dictionary(root->type()->id()) && root->dictionary()) {
     auto decoder =
         std::dynamic_pointer_cast<lance::encodings::DictionaryEncoder>(root->GetEncoder(out_));
     ARROW_ASSIGN_OR_RAISE(auto offset, decoder->WriteValueArray(root->dictionary()));
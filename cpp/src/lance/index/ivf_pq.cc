@@ -0,0 +1,403 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/index/ivf_pq.h"
+
+#include <arrow/array/concatenate.h>
+#include <arrow/builder.h>
+#include <arrow/io/api.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <random>
+
+#include "lance/arrow/stl.h"
+#include "lance/arrow/writer.h"
+#include "lance/encodings/kernels.h"
+#include "lance/format/schema.h"
+#include "lance/index/kmeans.h"
+#include "lance/io/reader.h"
+
+namespace lance::index {
+
+namespace {
+
+constexpr char kIvfFile[] = "ivf.lance";
+constexpr char kPqFile[] = "pq.lance";
+constexpr char kCodesFile[] = "codes.lance";
+
+/// Pick a random sample of at most `sample_size` vectors.
+std::vector<float> Sample(const float* vectors,
+                          int64_t num_vectors,
+                          int32_t dimension,
+                          int64_t sample_size,
+                          uint32_t seed) {
+  if (num_vectors <= sample_size) {
+    return {vectors, vectors + num_vectors * dimension};
+  }
+  std::vector<int64_t> ids(num_vectors);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(seed));
+  ids.resize(sample_size);
+  std::sort(ids.begin(), ids.end());
+  std::vector<float> sample;
+  sample.reserve(sample_size * dimension);
+  for (auto id : ids) {
+    sample.insert(sample.end(), vectors + id * dimension, vectors + (id + 1) * dimension);
+  }
+  return sample;
+}
+
+/// Make a `fixed_size_list<float>` array of the vectors.
+::arrow::Result<std::shared_ptr<::arrow::Array>> ToFixedSizeList(const std::vector<float>& vectors,
+                                                                 int32_t dimension) {
+  ARROW_ASSIGN_OR_RAISE(auto values, lance::arrow::ToArray(vectors));
+  return ::arrow::FixedSizeListArray::FromArrays(values, dimension);
+}
+
+/// Read the values of a `fixed_size_list<float>` column.
+::arrow::Result<std::vector<float>> ToVector(const std::shared_ptr<::arrow::ChunkedArray>& column) {
+  ARROW_ASSIGN_OR_RAISE(auto arr, ::arrow::Concatenate(column->chunks()));
+  ARROW_ASSIGN_OR_RAISE(auto values,
+                        std::static_pointer_cast<::arrow::FixedSizeListArray>(arr)->Flatten());
+  auto floats = std::static_pointer_cast<::arrow::FloatArray>(values);
+  return std::vector<float>(floats->raw_values(), floats->raw_values() + floats->length());
+}
+
+/// Read a lance file.
+::arrow::Result<std::shared_ptr<lance::io::FileReader>> OpenFile(
+    const std::shared_ptr<::arrow::fs::FileSystem>& fs, const std::string& path) {
+  ARROW_ASSIGN_OR_RAISE(auto infile, fs->OpenInputFile(path));
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  ARROW_RETURN_NOT_OK(reader->Open());
+  return reader;
+}
+
+::arrow::Status WriteFile(const std::shared_ptr<::arrow::fs::FileSystem>& fs,
+                          const std::string& path,
+                          const ::arrow::Table& table) {
+  ARROW_ASSIGN_OR_RAISE(auto sink, fs->OpenOutputStream(path));
+  ARROW_RETURN_NOT_OK(lance::arrow::WriteTable(table, sink, ""));
+  return sink->Close();
+}
+
+}  // namespace
+
+IvfPqIndex::IvfPqIndex(int32_t dimension,
+                       int32_t num_sub_vectors,
+                       int32_t num_codes,
+                       std::vector<float> centroids,
+                       std::vector<float> codebooks,
+                       std::vector<int64_t> partition_offsets,
+                       std::vector<int64_t> partition_lengths)
+    : dimension_(dimension),
+      num_sub_vectors_(num_sub_vectors),
+      num_codes_(num_codes),
+      centroids_(std::move(centroids)),
+      codebooks_(std::move(codebooks)),
+      partition_offsets_(std::move(partition_offsets)),
+      partition_lengths_(std::move(partition_lengths)) {}
+
+::arrow::Result<std::shared_ptr<IvfPqIndex>> IvfPqIndex::Build(
+    const float* vectors,
+    const int64_t* row_ids,
+    int64_t num_vectors,
+    int32_t dimension,
+    const lance::arrow::IvfPqIndexOptions& options) {
+  auto num_partitions = options.num_partitions;
+  auto num_sub_vectors = options.num_sub_vectors;
+  if (dimension <= 0 || num_partitions <= 0 || num_sub_vectors <= 0 ||
+      dimension % num_sub_vectors != 0 || options.sample_rate <= 0) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Invalid IVF-PQ parameters: dimension={}, num_partitions={}, "
+                    "num_sub_vectors={}, sample_rate={}",
+                    dimension,
+                    num_partitions,
+                    num_sub_vectors,
+                    options.sample_rate));
+  }
+  if (num_vectors < num_partitions) {
+    return ::arrow::Status::Invalid(fmt::format(
+        "Can not build {} partitions over {} vectors", num_partitions, num_vectors));
+  }
+
+  // IVF.
+  auto sample = Sample(vectors,
+                       num_vectors,
+                       dimension,
+                       static_cast<int64_t>(num_partitions) * options.sample_rate,
+                       options.seed);
+  ARROW_ASSIGN_OR_RAISE(auto centroids,
+                        KMeans(sample.data(),
+                               sample.size() / dimension,
+                               dimension,
+                               num_partitions,
+                               options.max_iterations,
+                               options.seed));
+  std::vector<int32_t> partitions(num_vectors);
+  std::vector<float> residuals(num_vectors * dimension);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto vector = vectors + i * dimension;
+    partitions[i] = NearestCentroid(vector, centroids.data(), num_partitions, dimension);
+    auto centroid = centroids.data() + static_cast<int64_t>(partitions[i]) * dimension;
+    for (int32_t j = 0; j < dimension; j++) {
+      residuals[i * dimension + j] = vector[j] - centroid[j];
+    }
+  }
+
+  // PQ over the residuals.
+  auto sub_dimension = dimension / num_sub_vectors;
+  auto num_codes = static_cast<int32_t>(std::min<int64_t>(kMaxNumCodes, num_vectors));
+  auto residual_sample = Sample(residuals.data(),
+                                num_vectors,
+                                dimension,
+                                static_cast<int64_t>(num_codes) * options.sample_rate,
+                                options.seed);
+  auto sample_size = static_cast<int64_t>(residual_sample.size()) / dimension;
+  std::vector<float> codebooks;
+  codebooks.reserve(static_cast<int64_t>(num_sub_vectors) * num_codes * sub_dimension);
+  std::vector<float> sub_vectors(sample_size * sub_dimension);
+  for (int32_t s = 0; s < num_sub_vectors; s++) {
+    for (int64_t i = 0; i < sample_size; i++) {
+      std::copy_n(residual_sample.begin() + i * dimension + s * sub_dimension,
+                  sub_dimension,
+                  sub_vectors.begin() + i * sub_dimension);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto codebook,
+                          KMeans(sub_vectors.data(),
+                                 sample_size,
+                                 sub_dimension,
+                                 num_codes,
+                                 options.max_iterations,
+                                 options.seed + s + 1));
+    codebooks.insert(codebooks.end(), codebook.begin(), codebook.end());
+  }
+
+  // Sort the vectors by partition, and encode them.
+  std::vector<int64_t> order(num_vectors);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+    return partitions[lhs] < partitions[rhs];
+  });
+  std::vector<int64_t> partition_offsets(num_partitions, 0);
+  std::vector<int64_t> partition_lengths(num_partitions, 0);
+  for (auto partition : partitions) {
+    partition_lengths[partition]++;
+  }
+  std::partial_sum(partition_lengths.begin(),
+                   partition_lengths.end() - 1,
+                   partition_offsets.begin() + 1);
+  ::arrow::Int64Builder row_id_builder;
+  ::arrow::FixedSizeBinaryBuilder code_builder(::arrow::fixed_size_binary(num_sub_vectors));
+  ARROW_RETURN_NOT_OK(row_id_builder.Reserve(num_vectors));
+  ARROW_RETURN_NOT_OK(code_builder.Reserve(num_vectors));
+  std::vector<uint8_t> code(num_sub_vectors);
+  for (auto i : order) {
+    for (int32_t s = 0; s < num_sub_vectors; s++) {
+      code[s] = static_cast<uint8_t>(
+          NearestCentroid(residuals.data() + i * dimension + s * sub_dimension,
+                          codebooks.data() + static_cast<int64_t>(s) * num_codes * sub_dimension,
+                          num_codes,
+                          sub_dimension));
+    }
+    row_id_builder.UnsafeAppend(row_ids[i]);
+    code_builder.UnsafeAppend(code.data());
+  }
+  ARROW_ASSIGN_OR_RAISE(auto row_id_arr, row_id_builder.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto code_arr, code_builder.Finish());
+
+  auto index = std::shared_ptr<IvfPqIndex>(new IvfPqIndex(dimension,
+                                                          num_sub_vectors,
+                                                          num_codes,
+                                                          std::move(centroids),
+                                                          std::move(codebooks),
+                                                          std::move(partition_offsets),
+                                                          std::move(partition_lengths)));
+  index->codes_ = ::arrow::Table::Make(::arrow::schema({::arrow::field("row_id", ::arrow::int64()),
+                                                        ::arrow::field("code", code_arr->type())}),
+                                       {row_id_arr, code_arr});
+  return index;
+}
+
+::arrow::Status IvfPqIndex::Write(const std::shared_ptr<::arrow::fs::FileSystem>& fs,
+                                  const std::string& dir) const {
+  if (!codes_) {
+    return ::arrow::Status::Invalid("Only a built index can be written");
+  }
+  ARROW_RETURN_NOT_OK(fs->CreateDir(dir));
+
+  ARROW_ASSIGN_OR_RAISE(auto centroids, ToFixedSizeList(centroids_, dimension_));
+  ARROW_ASSIGN_OR_RAISE(auto offsets, lance::arrow::ToArray(partition_offsets_));
+  ARROW_ASSIGN_OR_RAISE(auto lengths, lance::arrow::ToArray(partition_lengths_));
+  auto ivf = ::arrow::Table::Make(::arrow::schema({::arrow::field("centroid", centroids->type()),
+                                                   ::arrow::field("offset", ::arrow::int64()),
+                                                   ::arrow::field("length", ::arrow::int64())}),
+                                  {centroids, offsets, lengths});
+  ARROW_RETURN_NOT_OK(WriteFile(fs, dir + "/" + kIvfFile, *ivf));
+
+  ARROW_ASSIGN_OR_RAISE(auto codebooks,
+                        ToFixedSizeList(codebooks_, dimension_ / num_sub_vectors_));
+  auto pq = ::arrow::Table::Make(::arrow::schema({::arrow::field("centroid", codebooks->type())}),
+                                 {codebooks});
+  ARROW_RETURN_NOT_OK(WriteFile(fs, dir + "/" + kPqFile, *pq));
+
+  return WriteFile(fs, dir + "/" + kCodesFile, *codes_);
+}
+
+::arrow::Result<std::shared_ptr<IvfPqIndex>> IvfPqIndex::Open(
+    const std::shared_ptr<::arrow::fs::FileSystem>& fs, const std::string& dir) {
+  ARROW_ASSIGN_OR_RAISE(auto ivf_reader, OpenFile(fs, dir + "/" + kIvfFile));
+  ARROW_ASSIGN_OR_RAISE(auto ivf, ivf_reader->ReadTable());
+  ARROW_ASSIGN_OR_RAISE(auto pq_reader, OpenFile(fs, dir + "/" + kPqFile));
+  ARROW_ASSIGN_OR_RAISE(auto pq, pq_reader->ReadTable());
+  ARROW_ASSIGN_OR_RAISE(auto codes_reader, OpenFile(fs, dir + "/" + kCodesFile));
+
+  auto centroid_type = ivf->schema()->GetFieldByName("centroid")->type();
+  auto codebook_type = pq->schema()->GetFieldByName("centroid")->type();
+  auto code_type = codes_reader->schema().GetField("code")->type();
+  if (centroid_type->id() != ::arrow::Type::FIXED_SIZE_LIST ||
+      codebook_type->id() != ::arrow::Type::FIXED_SIZE_LIST ||
+      code_type->id() != ::arrow::Type::FIXED_SIZE_BINARY) {
+    return ::arrow::Status::Invalid(fmt::format("Invalid IVF-PQ index: {}", dir));
+  }
+  auto dimension = std::static_pointer_cast<::arrow::FixedSizeListType>(centroid_type)->list_size();
+  auto sub_dimension =
+      std::static_pointer_cast<::arrow::FixedSizeListType>(codebook_type)->list_size();
+  auto num_sub_vectors =
+      std::static_pointer_cast<::arrow::FixedSizeBinaryType>(code_type)->byte_width();
+  if (sub_dimension * num_sub_vectors != dimension || pq->num_rows() % num_sub_vectors != 0) {
+    return ::arrow::Status::Invalid(fmt::format("Invalid IVF-PQ index: {}", dir));
+  }
+  auto num_codes = static_cast<int32_t>(pq->num_rows() / num_sub_vectors);
+
+  ARROW_ASSIGN_OR_RAISE(auto centroids, ToVector(ivf->GetColumnByName("centroid")));
+  ARROW_ASSIGN_OR_RAISE(auto codebooks, ToVector(pq->GetColumnByName("centroid")));
+  std::vector<int64_t> partition_offsets;
+  std::vector<int64_t> partition_lengths;
+  for (auto& [name, out] : {std::make_tuple("offset", &partition_offsets),
+                            std::make_tuple("length", &partition_lengths)}) {
+    for (auto& chunk : ivf->GetColumnByName(name)->chunks()) {
+      auto arr = std::static_pointer_cast<::arrow::Int64Array>(chunk);
+      out->insert(out->end(), arr->raw_values(), arr->raw_values() + arr->length());
+    }
+  }
+  auto index = std::shared_ptr<IvfPqIndex>(new IvfPqIndex(dimension,
+                                                          num_sub_vectors,
+                                                          num_codes,
+                                                          std::move(centroids),
+                                                          std::move(codebooks),
+                                                          std::move(partition_offsets),
+                                                          std::move(partition_lengths)));
+  index->codes_reader_ = codes_reader;
+  return index;
+}
+
+::arrow::Result<std::tuple<std::shared_ptr<::arrow::Int64Array>,
+                           std::shared_ptr<::arrow::FixedSizeBinaryArray>>>
+IvfPqIndex::ReadPartition(int32_t partition) const {
+  auto offset = partition_offsets_[partition];
+  auto length = partition_lengths_[partition];
+  std::shared_ptr<::arrow::Array> row_ids;
+  std::shared_ptr<::arrow::Array> codes;
+  if (codes_) {
+    auto slice = codes_->Slice(offset, length);
+    ARROW_ASSIGN_OR_RAISE(row_ids, ::arrow::Concatenate(slice->column(0)->chunks()));
+    ARROW_ASSIGN_OR_RAISE(codes, ::arrow::Concatenate(slice->column(1)->chunks()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(
+        auto batch,
+        codes_reader_->ReadAt(codes_reader_->schema(), offset, static_cast<int32_t>(length)));
+    row_ids = batch->GetColumnByName("row_id");
+    codes = batch->GetColumnByName("code");
+  }
+  return std::make_tuple(std::static_pointer_cast<::arrow::Int64Array>(row_ids),
+                         std::static_pointer_cast<::arrow::FixedSizeBinaryArray>(codes));
+}
+
+::arrow::Result<std::vector<Neighbor>> IvfPqIndex::Search(const float* query,
+                                                          int32_t k,
+                                                          int32_t nprobe) const {
+  if (k <= 0 || nprobe <= 0) {
+    return ::arrow::Status::Invalid(fmt::format("Invalid k={} or nprobe={}", k, nprobe));
+  }
+  // The nearest partitions.
+  std::vector<float> centroid_distances(num_partitions());
+  lance::encodings::kernels::L2Distances(
+      query, centroids_.data(), dimension_, num_partitions(), centroid_distances.data());
+  std::vector<std::tuple<float, int32_t>> partitions;
+  for (int32_t i = 0; i < num_partitions(); i++) {
+    partitions.emplace_back(centroid_distances[i], i);
+  }
+  nprobe = std::min(nprobe, num_partitions());
+  std::partial_sort(partitions.begin(), partitions.begin() + nprobe, partitions.end());
+
+  auto sub_dimension = dimension_ / num_sub_vectors_;
+  std::vector<float> residual(dimension_);
+  // The distances of each sub-vector of the residual to the codes.
+  std::vector<float> distance_table(static_cast<int64_t>(num_sub_vectors_) * num_codes_);
+  // Max heap of the k nearest candidates.
+  std::priority_queue<std::tuple<float, int64_t>> heap;
+  for (int32_t p = 0; p < nprobe; p++) {
+    auto partition = std::get<1>(partitions[p]);
+    if (partition_lengths_[partition] == 0) {
+      continue;
+    }
+    auto centroid = centroids_.data() + static_cast<int64_t>(partition) * dimension_;
+    for (int32_t j = 0; j < dimension_; j++) {
+      residual[j] = query[j] - centroid[j];
+    }
+    for (int32_t s = 0; s < num_sub_vectors_; s++) {
+      lance::encodings::kernels::L2Distances(
+          residual.data() + s * sub_dimension,
+          codebooks_.data() + static_cast<int64_t>(s) * num_codes_ * sub_dimension,
+          sub_dimension,
+          num_codes_,
+          distance_table.data() + s * num_codes_);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto partition_data, ReadPartition(partition));
+    auto [row_ids, codes] = partition_data;
+    for (int64_t i = 0; i < row_ids->length(); i++) {
+      auto code = codes->GetValue(i);
+      float distance = 0;
+      for (int32_t s = 0; s < num_sub_vectors_; s++) {
+        distance += distance_table[s * num_codes_ + code[s]];
+      }
+      if (static_cast<int32_t>(heap.size()) < k) {
+        heap.emplace(distance, row_ids->Value(i));
+      } else if (distance < std::get<0>(heap.top())) {
+        heap.pop();
+        heap.emplace(distance, row_ids->Value(i));
+      }
+    }
+  }
+  std::vector<Neighbor> neighbors(heap.size());
+  for (auto it = neighbors.rbegin(); it != neighbors.rend(); it++) {
+    auto [distance, row_id] = heap.top();
+    *it = Neighbor{row_id, distance};
+    heap.pop();
+  }
+  return neighbors;
+}
+
+int32_t IvfPqIndex::dimension() const { return dimension_; }
+
+int32_t IvfPqIndex::num_partitions() const {
+  return static_cast<int32_t>(partition_offsets_.size());
+}
+
+int32_t IvfPqIndex::num_sub_vectors() const { return num_sub_vectors_; }
+
+}  // namespace lance::index
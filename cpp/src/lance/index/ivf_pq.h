@@ -0,0 +1,127 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/filesystem/api.h>
+#include <arrow/result.h>
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "lance/arrow/index.h"
+
+namespace lance::io {
+class FileReader;
+}
+
+namespace lance::index {
+
+/// A row and its distance to the query vector.
+struct Neighbor {
+  int64_t row_id;
+  /// Squared L2 distance.
+  float distance;
+};
+
+/// IVF-PQ index for approximate nearest neighbor search by L2 distance.
+///
+/// The vectors are clustered into partitions by k-means (IVF). The residual of each vector to
+/// its partition centroid is split into sub-vectors, and each sub-vector is encoded by the
+/// index of its nearest code in a per sub-vector codebook (PQ). A search only scans the
+/// partitions of the `nprobe` nearest centroids, and estimates the distances from the codes.
+///
+/// The index is stored as three lance files in a directory:
+///  - `ivf.lance`: the centroid, and the offset / length in `codes.lance` of each partition;
+///  - `pq.lance`: the codebooks, with the code `c` of the sub-vector `s` at row
+///    `s * num_codes + c`;
+///  - `codes.lance`: the row ids and the PQ codes of the vectors, sorted by partition.
+class IvfPqIndex {
+ public:
+  /// Maximum number of codes per sub-vector, so that a code fits in one byte.
+  static constexpr int32_t kMaxNumCodes = 256;
+
+  /// Build an index in memory.
+  ///
+  /// \param vectors `num_vectors` vectors, stored row by row.
+  /// \param row_ids the row id of each vector.
+  /// \param num_vectors the number of vectors.
+  /// \param dimension the dimension of the vectors.
+  /// \param options the parameters of the index.
+  static ::arrow::Result<std::shared_ptr<IvfPqIndex>> Build(
+      const float* vectors,
+      const int64_t* row_ids,
+      int64_t num_vectors,
+      int32_t dimension,
+      const lance::arrow::IvfPqIndexOptions& options);
+
+  /// Open an index, and load its centroids and codebooks. The codes are read by the search.
+  static ::arrow::Result<std::shared_ptr<IvfPqIndex>> Open(
+      const std::shared_ptr<::arrow::fs::FileSystem>& fs, const std::string& dir);
+
+  /// Write a built index to a directory.
+  ::arrow::Status Write(const std::shared_ptr<::arrow::fs::FileSystem>& fs,
+                        const std::string& dir) const;
+
+  /// Search the approximate nearest neighbors of a query vector.
+  ///
+  /// \param query the query vector, of `dimension()` floats.
+  /// \param k the number of neighbors.
+  /// \param nprobe the number of partitions to scan.
+  /// \return at most `k` neighbors, ordered by their estimated distances.
+  ::arrow::Result<std::vector<Neighbor>> Search(const float* query,
+                                                int32_t k,
+                                                int32_t nprobe) const;
+
+  int32_t dimension() const;
+
+  int32_t num_partitions() const;
+
+  int32_t num_sub_vectors() const;
+
+ private:
+  IvfPqIndex(int32_t dimension,
+             int32_t num_sub_vectors,
+             int32_t num_codes,
+             std::vector<float> centroids,
+             std::vector<float> codebooks,
+             std::vector<int64_t> partition_offsets,
+             std::vector<int64_t> partition_lengths);
+
+  /// Read the row ids and the codes of a partition.
+  ::arrow::Result<std::tuple<std::shared_ptr<::arrow::Int64Array>,
+                             std::shared_ptr<::arrow::FixedSizeBinaryArray>>>
+  ReadPartition(int32_t partition) const;
+
+  int32_t dimension_;
+  int32_t num_sub_vectors_;
+  int32_t num_codes_;
+  /// The centroids of the partitions, stored row by row.
+  std::vector<float> centroids_;
+  /// The codes of each sub-vector, stored row by row.
+  std::vector<float> codebooks_;
+  std::vector<int64_t> partition_offsets_;
+  std::vector<int64_t> partition_lengths_;
+  /// The row ids and the codes, sorted by partition, of a built index.
+  std::shared_ptr<::arrow::Table> codes_;
+  /// The reader of `codes.lance`, of an opened index.
+  std::shared_ptr<lance::io::FileReader> codes_reader_;
+};
+
+}  // namespace lance::index
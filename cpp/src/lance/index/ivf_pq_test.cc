@@ -0,0 +1,167 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/index/ivf_pq.h"
+
+#include <arrow/filesystem/localfs.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lance/index/kmeans.h"
+
+using lance::index::IvfPqIndex;
+
+namespace {
+
+/// Generate `num_vectors` vectors around `num_clusters` random centers.
+std::vector<float> MakeClusters(int64_t num_vectors, int32_t dimension, int32_t num_clusters) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> center_dist(-10, 10);
+  std::normal_distribution<float> noise(0, 1);
+  std::vector<float> centers(num_clusters * dimension);
+  std::generate(centers.begin(), centers.end(), [&] { return center_dist(gen); });
+  std::vector<float> vectors(num_vectors * dimension);
+  for (int64_t i = 0; i < num_vectors; i++) {
+    auto center = centers.data() + (i % num_clusters) * dimension;
+    for (int32_t j = 0; j < dimension; j++) {
+      vectors[i * dimension + j] = center[j] + noise(gen);
+    }
+  }
+  return vectors;
+}
+
+/// The row ids of the exact `k` nearest neighbors.
+std::vector<int64_t> BruteForce(const std::vector<float>& vectors,
+                                int32_t dimension,
+                                const float* query,
+                                int32_t k) {
+  std::vector<int64_t> ids(vectors.size() / dimension);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](auto lhs, auto rhs) {
+    return lance::index::L2Distance(query, vectors.data() + lhs * dimension, dimension) <
+           lance::index::L2Distance(query, vectors.data() + rhs * dimension, dimension);
+  });
+  ids.resize(k);
+  return ids;
+}
+
+}  // namespace
+
+TEST_CASE("KMeans finds the clusters") {
+  std::vector<float> centers{0, 0, 10, 10, -10, 10, 10, -10};
+  std::vector<float> vectors;
+  std::mt19937 gen(42);
+  std::normal_distribution<float> noise(0, 0.5);
+  for (int i = 0; i < 400; i++) {
+    vectors.emplace_back(centers[(i % 4) * 2] + noise(gen));
+    vectors.emplace_back(centers[(i % 4) * 2 + 1] + noise(gen));
+  }
+  auto centroids = lance::index::KMeans(vectors.data(), 400, 2, 4, 50, 42).ValueOrDie();
+  CHECK(centroids.size() == 8);
+  for (int i = 0; i < 4; i++) {
+    auto nearest = lance::index::NearestCentroid(centers.data() + i * 2, centroids.data(), 4, 2);
+    INFO("Center " << i << " nearest centroid " << nearest);
+    CHECK(lance::index::L2Distance(centers.data() + i * 2, centroids.data() + nearest * 2, 2) <
+          0.1);
+  }
+
+  CHECK(!lance::index::KMeans(vectors.data(), 400, 2, 401, 50, 42).ok());
+  CHECK(!lance::index::KMeans(vectors.data(), 400, 2, 0, 50, 42).ok());
+}
+
+TEST_CASE("Build, write and search IVF-PQ index") {
+  const int64_t kNumVectors = 2000;
+  const int32_t kDimension = 16;
+  const int32_t kTopK = 10;
+  auto vectors = MakeClusters(kNumVectors, kDimension, 20);
+  std::vector<int64_t> row_ids(kNumVectors);
+  std::iota(row_ids.begin(), row_ids.end(), 0);
+
+  lance::arrow::IvfPqIndexOptions options;
+  options.num_partitions = 20;
+  options.num_sub_vectors = 8;
+  auto index =
+      IvfPqIndex::Build(vectors.data(), row_ids.data(), kNumVectors, kDimension, options)
+          .ValueOrDie();
+  CHECK(index->dimension() == kDimension);
+  CHECK(index->num_partitions() == 20);
+  CHECK(index->num_sub_vectors() == 8);
+
+  auto dir = std::filesystem::temp_directory_path() / "ivf_pq_test";
+  std::filesystem::remove_all(dir);
+  auto fs = std::make_shared<::arrow::fs::LocalFileSystem>();
+  CHECK(index->Write(fs, dir.string()).ok());
+  auto opened = IvfPqIndex::Open(fs, dir.string()).ValueOrDie();
+  CHECK(opened->dimension() == kDimension);
+  CHECK(opened->num_partitions() == 20);
+  CHECK(opened->num_sub_vectors() == 8);
+
+  int32_t num_found = 0;
+  for (int64_t q = 0; q < 50; q++) {
+    auto query = vectors.data() + q * 37 * kDimension;
+    auto expected = BruteForce(vectors, kDimension, query, kTopK);
+    auto neighbors = index->Search(query, kTopK, 2).ValueOrDie();
+    REQUIRE(neighbors.size() == kTopK);
+    CHECK(std::is_sorted(neighbors.begin(), neighbors.end(), [](auto& lhs, auto& rhs) {
+      return lhs.distance < rhs.distance;
+    }));
+
+    // The opened index gives the same results as the built one.
+    auto opened_neighbors = opened->Search(query, kTopK, 2).ValueOrDie();
+    REQUIRE(opened_neighbors.size() == kTopK);
+    for (int32_t i = 0; i < kTopK; i++) {
+      CHECK(neighbors[i].row_id == opened_neighbors[i].row_id);
+      CHECK(neighbors[i].distance == opened_neighbors[i].distance);
+      num_found += std::count(expected.begin(), expected.end(), neighbors[i].row_id);
+    }
+  }
+  auto recall = static_cast<double>(num_found) / (50 * kTopK);
+  INFO("Recall@10: " << recall);
+  CHECK(recall > 0.5);
+
+  // Probe all the partitions, and ask for more neighbors than the vectors.
+  auto neighbors = index->Search(vectors.data(), kNumVectors + 1, 100).ValueOrDie();
+  CHECK(neighbors.size() == kNumVectors);
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Invalid IVF-PQ parameters") {
+  auto vectors = MakeClusters(100, 8, 4);
+  std::vector<int64_t> row_ids(100);
+  std::iota(row_ids.begin(), row_ids.end(), 0);
+
+  lance::arrow::IvfPqIndexOptions options;
+  options.num_partitions = 4;
+  options.num_sub_vectors = 3;
+  CHECK(!IvfPqIndex::Build(vectors.data(), row_ids.data(), 100, 8, options).ok());
+
+  options.num_sub_vectors = 2;
+  options.num_partitions = 101;
+  CHECK(!IvfPqIndex::Build(vectors.data(), row_ids.data(), 100, 8, options).ok());
+
+  options.num_partitions = 4;
+  auto index = IvfPqIndex::Build(vectors.data(), row_ids.data(), 100, 8, options).ValueOrDie();
+  CHECK(!index->Search(vectors.data(), 0, 1).ok());
+  CHECK(!index->Search(vectors.data(), 10, 0).ok());
+
+  auto fs = std::make_shared<::arrow::fs::LocalFileSystem>();
+  auto dir = std::filesystem::temp_directory_path() / "ivf_pq_test_not_exist";
+  CHECK(!IvfPqIndex::Open(fs, dir.string()).ok());
+}
@@ -0,0 +1,116 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/index/kmeans.h"
+
+#include <arrow/status.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "lance/encodings/kernels.h"
+
+namespace lance::index {
+
+float L2Distance(const float* lhs, const float* rhs, int32_t dimension) {
+  float distance;
+  lance::encodings::kernels::L2Distances(lhs, rhs, dimension, 1, &distance);
+  return distance;
+}
+
+int32_t NearestCentroid(const float* vector,
+                        const float* centroids,
+                        int32_t num_centroids,
+                        int32_t dimension) {
+  // Compute the distances to a chunk of centroids at a time.
+  constexpr int32_t kChunkSize = 64;
+  float distances[kChunkSize];
+  int32_t nearest = 0;
+  auto min_distance = std::numeric_limits<float>::max();
+  for (int32_t start = 0; start < num_centroids; start += kChunkSize) {
+    auto length = std::min(kChunkSize, num_centroids - start);
+    lance::encodings::kernels::L2Distances(
+        vector, centroids + static_cast<int64_t>(start) * dimension, dimension, length, distances);
+    for (int32_t i = 0; i < length; i++) {
+      if (distances[i] < min_distance) {
+        min_distance = distances[i];
+        nearest = start + i;
+      }
+    }
+  }
+  return nearest;
+}
+
+::arrow::Result<std::vector<float>> KMeans(const float* vectors,
+                                           int64_t num_vectors,
+                                           int32_t dimension,
+                                           int32_t k,
+                                           int32_t max_iterations,
+                                           uint32_t seed) {
+  if (k <= 0 || dimension <= 0) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Invalid k-means parameters: k={}, dimension={}", k, dimension));
+  }
+  if (num_vectors < k) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Can not cluster {} vectors into {} clusters", num_vectors, k));
+  }
+  // Start from k distinct random vectors.
+  std::mt19937 gen(seed);
+  std::vector<int64_t> ids(num_vectors);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::vector<float> centroids(static_cast<int64_t>(k) * dimension);
+  for (int32_t i = 0; i < k; i++) {
+    auto j = std::uniform_int_distribution<int64_t>(i, num_vectors - 1)(gen);
+    std::swap(ids[i], ids[j]);
+    std::copy_n(vectors + ids[i] * dimension, dimension, centroids.begin() + i * dimension);
+  }
+
+  std::vector<int32_t> assignments(num_vectors, -1);
+  std::vector<double> sums(centroids.size());
+  std::vector<int64_t> counts(k);
+  for (int32_t iteration = 0; iteration < max_iterations; iteration++) {
+    bool changed = false;
+    std::fill(sums.begin(), sums.end(), 0);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int64_t i = 0; i < num_vectors; i++) {
+      auto vector = vectors + i * dimension;
+      auto nearest = NearestCentroid(vector, centroids.data(), k, dimension);
+      changed = changed || nearest != assignments[i];
+      assignments[i] = nearest;
+      counts[nearest]++;
+      for (int32_t j = 0; j < dimension; j++) {
+        sums[static_cast<int64_t>(nearest) * dimension + j] += vector[j];
+      }
+    }
+    if (!changed) {
+      break;
+    }
+    for (int32_t c = 0; c < k; c++) {
+      // An empty cluster keeps its centroid.
+      if (counts[c] > 0) {
+        for (int32_t j = 0; j < dimension; j++) {
+          auto pos = static_cast<int64_t>(c) * dimension + j;
+          centroids[pos] = static_cast<float>(sums[pos] / counts[c]);
+        }
+      }
+    }
+  }
+  return centroids;
+}
+
+}  // namespace lance::index
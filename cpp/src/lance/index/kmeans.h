@@ -0,0 +1,53 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/result.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace lance::index {
+
+/// Squared L2 distance between two vectors.
+float L2Distance(const float* lhs, const float* rhs, int32_t dimension);
+
+/// Find the nearest centroid of a vector.
+///
+/// \param vector the vector, of `dimension` floats.
+/// \param centroids `num_centroids` centroids, stored row by row.
+/// \return the index of the nearest centroid.
+int32_t NearestCentroid(const float* vector,
+                        const float* centroids,
+                        int32_t num_centroids,
+                        int32_t dimension);
+
+/// Cluster vectors with k-means (Lloyd's algorithm) by L2 distance.
+///
+/// \param vectors `num_vectors` vectors, stored row by row.
+/// \param num_vectors the number of vectors, which must be at least `k`.
+/// \param dimension the dimension of the vectors.
+/// \param k the number of clusters.
+/// \param max_iterations the maximum number of iterations.
+/// \param seed the seed to pick the initial centroids.
+/// \return `k` centroids, stored row by row.
+::arrow::Result<std::vector<float>> KMeans(const float* vectors,
+                                           int64_t num_vectors,
+                                           int32_t dimension,
+                                           int32_t k,
+                                           int32_t max_iterations,
+                                           uint32_t seed);
+
+}  // namespace lance::index
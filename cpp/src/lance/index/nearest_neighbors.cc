@@ -0,0 +1,368 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "lance/index/nearest_neighbors.h"
+
+#include <arrow/compute/api.h>
+#include <arrow/dataset/dataset.h>
+#include <arrow/dataset/file_base.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include <tuple>
+
+#include "lance/arrow/file_lance.h"
+#include "lance/arrow/stl.h"
+#include "lance/encodings/kernels.h"
+#include "lance/format/metadata.h"
+#include "lance/format/schema.h"
+#include "lance/index/kmeans.h"
+#include "lance/io/reader.h"
+
+namespace lance::index {
+
+namespace {
+
+using Readers = std::vector<std::shared_ptr<lance::io::FileReader>>;
+
+/// Project the vector column of a fragment.
+::arrow::Result<std::shared_ptr<lance::format::Schema>> ProjectVectorColumn(
+    const lance::io::FileReader& reader, const std::string& column) {
+  ARROW_ASSIGN_OR_RAISE(auto schema, reader.schema().Project({column}));
+  auto type = schema->GetField(column)->type();
+  if ((type->id() != ::arrow::Type::FIXED_SIZE_LIST && type->id() != ::arrow::Type::LIST) ||
+      type->field(0)->type()->id() != ::arrow::Type::FLOAT) {
+    return ::arrow::Status::Invalid(
+        fmt::format("Column {} is not a vector column: {}", column, type->ToString()));
+  }
+  return schema;
+}
+
+/// The first value and the dimension of the `i`-th vector of a vector array.
+std::tuple<const float*, int32_t> GetVector(const ::arrow::Array& arr, int64_t i) {
+  if (arr.type_id() == ::arrow::Type::FIXED_SIZE_LIST) {
+    auto& list_arr = static_cast<const ::arrow::FixedSizeListArray&>(arr);
+    auto values = std::static_pointer_cast<::arrow::FloatArray>(list_arr.values());
+    return {values->raw_values() + list_arr.value_offset(i), list_arr.value_length(i)};
+  }
+  auto& list_arr = static_cast<const ::arrow::ListArray&>(arr);
+  auto values = std::static_pointer_cast<::arrow::FloatArray>(list_arr.values());
+  return {values->raw_values() + list_arr.value_offset(i), list_arr.value_length(i)};
+}
+
+/// Visit the non-null vectors of a column, with their row ids and dimensions.
+::arrow::Status ForEachVector(
+    const Readers& readers,
+    const std::string& column,
+    const std::function<::arrow::Status(int64_t, const float*, int32_t)>& visit) {
+  for (std::size_t fragment = 0; fragment < readers.size(); fragment++) {
+    auto& reader = readers[fragment];
+    ARROW_ASSIGN_OR_RAISE(auto schema, ProjectVectorColumn(*reader, column));
+    int32_t row = 0;
+    for (int32_t batch_id = 0; batch_id < reader->metadata().num_batches(); batch_id++) {
+      ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(*schema, batch_id));
+      auto arr = batch->GetColumnByName(column);
+      for (int64_t i = 0; i < arr->length(); i++, row++) {
+        if (arr->IsNull(i)) {
+          continue;
+        }
+        auto [vector, dimension] = GetVector(*arr, i);
+        auto row_id = MakeRowId(static_cast<int32_t>(fragment), row);
+        ARROW_RETURN_NOT_OK(visit(row_id, vector, dimension));
+      }
+    }
+  }
+  return ::arrow::Status::OK();
+}
+
+::arrow::Status CheckDimension(const std::string& column, int32_t expected, int32_t actual) {
+  if (expected != actual) {
+    return ::arrow::Status::Invalid(fmt::format(
+        "Vector of column {} has dimension {}, expected {}", column, actual, expected));
+  }
+  return ::arrow::Status::OK();
+}
+
+/// Keep the nearest `k` neighbors.
+class TopK {
+ public:
+  explicit TopK(int32_t k) : k_(k) {}
+
+  void Push(int64_t row_id, float distance) {
+    if (static_cast<int32_t>(heap_.size()) < k_) {
+      heap_.emplace(distance, row_id);
+    } else if (distance < std::get<0>(heap_.top())) {
+      heap_.pop();
+      heap_.emplace(distance, row_id);
+    }
+  }
+
+  /// The neighbors, ordered by their distances.
+  std::vector<Neighbor> Finish() {
+    std::vector<Neighbor> neighbors(heap_.size());
+    for (auto it = neighbors.rbegin(); it != neighbors.rend(); it++) {
+      auto [distance, row_id] = heap_.top();
+      *it = Neighbor{row_id, distance};
+      heap_.pop();
+    }
+    return neighbors;
+  }
+
+ private:
+  int32_t k_;
+  /// Max heap of the distances.
+  std::priority_queue<std::tuple<float, int64_t>> heap_;
+};
+
+}  // namespace
+
+int64_t MakeRowId(int32_t fragment, int32_t row) {
+  return (static_cast<int64_t>(fragment) << 32) | static_cast<uint32_t>(row);
+}
+
+::arrow::Result<Readers> OpenFragments(const std::shared_ptr<::arrow::dataset::Dataset>& dataset) {
+  ARROW_ASSIGN_OR_RAISE(auto fragments, dataset->GetFragments());
+  Readers readers;
+  for (auto fragment_result : fragments) {
+    ARROW_ASSIGN_OR_RAISE(auto fragment, fragment_result);
+    auto file_fragment = std::dynamic_pointer_cast<::arrow::dataset::FileFragment>(fragment);
+    if (!file_fragment ||
+        file_fragment->format()->type_name() != lance::arrow::LanceFileFormat().type_name()) {
+      return ::arrow::Status::NotImplemented(
+          "Nearest neighbor search only supports datasets of lance files");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto infile, file_fragment->source().Open());
+    auto reader = std::make_shared<lance::io::FileReader>(infile);
+    ARROW_RETURN_NOT_OK(reader->Open());
+    readers.emplace_back(reader);
+  }
+  return readers;
+}
+
+::arrow::Result<Vectors> ReadVectors(const Readers& readers, const std::string& column) {
+  Vectors vectors{0, {}, {}};
+  ARROW_RETURN_NOT_OK(ForEachVector(
+      readers, column, [&](int64_t row_id, const float* vector, int32_t dimension) {
+        if (vectors.row_ids.empty()) {
+          vectors.dimension = dimension;
+        }
+        ARROW_RETURN_NOT_OK(CheckDimension(column, vectors.dimension, dimension));
+        vectors.values.insert(vectors.values.end(), vector, vector + dimension);
+        vectors.row_ids.emplace_back(row_id);
+        return ::arrow::Status::OK();
+      }));
+  return vectors;
+}
+
+::arrow::Result<std::vector<std::vector<Neighbor>>> SearchExact(
+    const Readers& readers,
+    const std::string& column,
+    const std::vector<std::vector<float>>& queries,
+    int32_t k,
+    lance::arrow::DistanceMetric metric) {
+  if (k <= 0) {
+    return ::arrow::Status::Invalid(fmt::format("Invalid k={}", k));
+  }
+  if (queries.empty()) {
+    return std::vector<std::vector<Neighbor>>{};
+  }
+  auto dimension = static_cast<int32_t>(queries[0].size());
+  std::vector<float> query_norms;
+  for (auto& query : queries) {
+    ARROW_RETURN_NOT_OK(CheckDimension(column, dimension, static_cast<int32_t>(query.size())));
+    float norm;
+    lance::encodings::kernels::SquaredNorms(query.data(), dimension, 1, &norm);
+    query_norms.emplace_back(std::sqrt(norm));
+  }
+
+  // One task per batch.
+  std::vector<std::shared_ptr<lance::format::Schema>> schemas;
+  std::vector<std::tuple<int32_t, int32_t>> tasks;
+  for (std::size_t fragment = 0; fragment < readers.size(); fragment++) {
+    ARROW_ASSIGN_OR_RAISE(auto schema, ProjectVectorColumn(*readers[fragment], column));
+    schemas.emplace_back(schema);
+    for (int32_t batch_id = 0; batch_id < readers[fragment]->metadata().num_batches();
+         batch_id++) {
+      tasks.emplace_back(static_cast<int32_t>(fragment), batch_id);
+    }
+  }
+
+  // Each worker scans every `num_workers`-th batch into its own heaps.
+  auto search = [&](std::size_t worker,
+                    std::size_t num_workers) -> ::arrow::Result<std::vector<TopK>> {
+    std::vector<TopK> heaps(queries.size(), TopK(k));
+    std::vector<float> norms;
+    std::vector<float> distances;
+    for (auto t = worker; t < tasks.size(); t += num_workers) {
+      auto [fragment, batch_id] = tasks[t];
+      auto& reader = readers[fragment];
+      ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(*schemas[fragment], batch_id));
+      auto arr = batch->GetColumnByName(column);
+      auto first_row = static_cast<int32_t>(reader->metadata().GetBatchOffset(batch_id));
+      auto length = arr->length();
+
+      // The vectors of a fixed_size_list array are contiguous, so that they are compared in
+      // one kernel call. Vectors of a list array are compared one by one.
+      std::vector<std::tuple<int64_t, const float*, int64_t>> runs;
+      if (arr->type_id() == ::arrow::Type::FIXED_SIZE_LIST && length > 0) {
+        auto [vectors, vector_dimension] = GetVector(*arr, 0);
+        ARROW_RETURN_NOT_OK(CheckDimension(column, dimension, vector_dimension));
+        runs.emplace_back(0, vectors, length);
+      } else {
+        for (int64_t i = 0; i < length; i++) {
+          if (arr->IsValid(i)) {
+            auto [vector, vector_dimension] = GetVector(*arr, i);
+            ARROW_RETURN_NOT_OK(CheckDimension(column, dimension, vector_dimension));
+            runs.emplace_back(i, vector, 1);
+          }
+        }
+      }
+
+      distances.resize(length);
+      norms.resize(length);
+      for (auto [offset, vectors, num_vectors] : runs) {
+        if (metric == lance::arrow::DistanceMetric::kCosine) {
+          lance::encodings::kernels::SquaredNorms(
+              vectors, dimension, num_vectors, norms.data() + offset);
+        }
+      }
+      for (std::size_t q = 0; q < queries.size(); q++) {
+        for (auto [offset, vectors, num_vectors] : runs) {
+          auto out = distances.data() + offset;
+          if (metric == lance::arrow::DistanceMetric::kL2) {
+            lance::encodings::kernels::L2Distances(
+                queries[q].data(), vectors, dimension, num_vectors, out);
+            continue;
+          }
+          lance::encodings::kernels::DotProducts(
+              queries[q].data(), vectors, dimension, num_vectors, out);
+          for (int64_t i = 0; i < num_vectors; i++) {
+            if (metric == lance::arrow::DistanceMetric::kDot) {
+              out[i] = -out[i];
+            } else {
+              auto norm = query_norms[q] * std::sqrt(norms[offset + i]);
+              out[i] = norm > 0 ? 1 - out[i] / norm : 1;
+            }
+          }
+        }
+        for (int64_t i = 0; i < length; i++) {
+          if (arr->IsValid(i)) {
+            heaps[q].Push(MakeRowId(fragment, first_row + static_cast<int32_t>(i)), distances[i]);
+          }
+        }
+      }
+    }
+    return heaps;
+  };
+
+  auto num_workers =
+      std::min<std::size_t>(tasks.size(), std::max(1U, std::thread::hardware_concurrency()));
+  std::vector<std::future<::arrow::Result<std::vector<TopK>>>> futures;
+  for (std::size_t worker = 0; worker < num_workers; worker++) {
+    futures.emplace_back(std::async(std::launch::async, search, worker, num_workers));
+  }
+  std::vector<TopK> merged(queries.size(), TopK(k));
+  for (auto& future : futures) {
+    ARROW_ASSIGN_OR_RAISE(auto heaps, future.get());
+    for (std::size_t q = 0; q < queries.size(); q++) {
+      for (auto& neighbor : heaps[q].Finish()) {
+        merged[q].Push(neighbor.row_id, neighbor.distance);
+      }
+    }
+  }
+  std::vector<std::vector<Neighbor>> neighbors;
+  for (auto& heap : merged) {
+    neighbors.emplace_back(heap.Finish());
+  }
+  return neighbors;
+}
+
+::arrow::Result<std::vector<Neighbor>> Refine(const Readers& readers,
+                                              const std::string& column,
+                                              const std::vector<float>& query,
+                                              const std::vector<Neighbor>& candidates,
+                                              int32_t k) {
+  if (readers.empty()) {
+    return std::vector<Neighbor>{};
+  }
+  std::vector<int64_t> row_ids;
+  for (auto& candidate : candidates) {
+    row_ids.emplace_back(candidate.row_id);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto schema, readers[0]->schema().Project({column}));
+  ARROW_ASSIGN_OR_RAISE(auto table, TakeRows(readers, *schema, row_ids));
+  auto query_dimension = static_cast<int32_t>(query.size());
+  TopK top_k(k);
+  int64_t i = 0;
+  for (auto& chunk : table->GetColumnByName(column)->chunks()) {
+    for (int64_t j = 0; j < chunk->length(); j++, i++) {
+      auto [vector, dimension] = GetVector(*chunk, j);
+      ARROW_RETURN_NOT_OK(CheckDimension(column, query_dimension, dimension));
+      top_k.Push(row_ids[i], L2Distance(query.data(), vector, dimension));
+    }
+  }
+  return top_k.Finish();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Table>> TakeRows(const Readers& readers,
+                                                          const lance::format::Schema& schema,
+                                                          const std::vector<int64_t>& row_ids) {
+  // Read the rows in the order of the row ids, batch by batch.
+  std::vector<int64_t> order(row_ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+    return row_ids[lhs] < row_ids[rhs];
+  });
+  ::arrow::RecordBatchVector batches;
+  std::size_t i = 0;
+  while (i < order.size()) {
+    auto row_id = row_ids[order[i]];
+    auto fragment = row_id >> 32;
+    if (fragment < 0 || fragment >= static_cast<int64_t>(readers.size())) {
+      return ::arrow::Status::IndexError(fmt::format("Row id {} is out of range", row_id));
+    }
+    auto& reader = readers[fragment];
+    ARROW_ASSIGN_OR_RAISE(
+        auto location,
+        reader->metadata().LocateBatch(static_cast<int32_t>(row_id & 0xFFFFFFFF)));
+    auto [batch_id, batch_offset] = location;
+    auto batch_start = row_id - batch_offset;
+    auto batch_length = reader->metadata().GetBatchLength(batch_id);
+    std::vector<int32_t> indices;
+    for (; i < order.size() && row_ids[order[i]] < batch_start + batch_length; i++) {
+      indices.emplace_back(static_cast<int32_t>(row_ids[order[i]] - batch_start));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto indices_arr, lance::arrow::ToArray(indices));
+    ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(schema, batch_id, indices_arr));
+    batches.emplace_back(batch);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto table, ::arrow::Table::FromRecordBatches(schema.ToArrow(), batches));
+
+  // Restore the order of the row ids.
+  std::vector<int64_t> positions(order.size());
+  for (std::size_t j = 0; j < order.size(); j++) {
+    positions[order[j]] = j;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto positions_arr, lance::arrow::ToArray(positions));
+  ARROW_ASSIGN_OR_RAISE(auto taken, ::arrow::compute::Take(table, positions_arr));
+  return taken.table();
+}
+
+}  // namespace lance::index
@@ -0,0 +1,101 @@
+//  Copyright 2022 Lance Authors
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#pragma once
+
+#include <arrow/dataset/type_fwd.h>
+#include <arrow/result.h>
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lance/arrow/scanner.h"
+#include "lance/index/ivf_pq.h"
+
+namespace lance::format {
+class Schema;
+}
+
+namespace lance::io {
+class FileReader;
+}
+
+/// \file Nearest neighbor search over the vector columns of a dataset.
+///
+/// A row of a dataset is identified by the position of its fragment in the dataset and its
+/// position in the fragment.
+
+namespace lance::index {
+
+/// Make the row id of the `row`-th row of the `fragment`-th fragment.
+int64_t MakeRowId(int32_t fragment, int32_t row);
+
+/// Open a reader for each fragment of a dataset of lance files.
+::arrow::Result<std::vector<std::shared_ptr<lance::io::FileReader>>> OpenFragments(
+    const std::shared_ptr<::arrow::dataset::Dataset>& dataset);
+
+/// The non-null vectors of a column, stored row by row.
+struct Vectors {
+  int32_t dimension;
+  std::vector<float> values;
+  std::vector<int64_t> row_ids;
+};
+
+/// Read all the non-null vectors of a `fixed_size_list<float>` or `list<float>` column.
+///
+/// Returns Invalid if the vectors do not have the same dimension.
+::arrow::Result<Vectors> ReadVectors(
+    const std::vector<std::shared_ptr<lance::io::FileReader>>& readers, const std::string& column);
+
+/// Search the exact `k` nearest neighbors of each query, by scanning all the vectors once.
+///
+/// The batches are scanned in parallel, each task keeping its own top-k heaps, which are merged
+/// at the end. A batch is compared with all the queries once it is loaded.
+///
+/// \param readers the readers of the fragments.
+/// \param column the vector column.
+/// \param queries the query vectors, of the same dimension.
+/// \param k the number of neighbors of each query.
+/// \param metric the distance metric.
+/// \return the neighbors of each query, ordered by their distances.
+::arrow::Result<std::vector<std::vector<Neighbor>>> SearchExact(
+    const std::vector<std::shared_ptr<lance::io::FileReader>>& readers,
+    const std::string& column,
+    const std::vector<std::vector<float>>& queries,
+    int32_t k,
+    lance::arrow::DistanceMetric metric = lance::arrow::DistanceMetric::kL2);
+
+/// Re-rank the candidates of an approximate search by their exact L2 distances, and keep the
+/// nearest `k`.
+::arrow::Result<std::vector<Neighbor>> Refine(
+    const std::vector<std::shared_ptr<lance::io::FileReader>>& readers,
+    const std::string& column,
+    const std::vector<float>& query,
+    const std::vector<Neighbor>& candidates,
+    int32_t k);
+
+/// Read the rows by their row ids, in the order of `row_ids`.
+///
+/// \param readers the readers of the fragments.
+/// \param schema the columns to read.
+/// \param row_ids the row ids made by `MakeRowId()`.
+::arrow::Result<std::shared_ptr<::arrow::Table>> TakeRows(
+    const std::vector<std::shared_ptr<lance::io::FileReader>>& readers,
+    const lance::format::Schema& schema,
+    const std::vector<int64_t>& row_ids);
+
+}  // namespace lance::index
@@ -15,21 +15,421 @@
 #include "lance/io/filter.h"
 
 #include <arrow/array.h>
+#include <arrow/array/util.h>
+#include <arrow/builder.h>
 #include <arrow/compute/api.h>
 #include <arrow/record_batch.h>
 #include <arrow/result.h>
+#include <arrow/util/bitmap_ops.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include "lance/arrow/type.h"
+#include "lance/arrow/utils.h"
+#include "lance/encodings/dictionary.h"
+#include "lance/encodings/encoder.h"
+#include "lance/encodings/kernels.h"
+#include "lance/format/bitmap_index.h"
+#include "lance/format/bloom_filter.h"
+#include "lance/format/metadata.h"
+#include "lance/format/page_table.h"
+#include "lance/format/primary_key_index.h"
 #include "lance/io/reader.h"
 
 namespace lance::io {
 
+namespace {
+
+/// Comparison functions, mapped to the equivalent function with swapped operands.
+const std::map<std::string, std::string> kComparisonFunctions = {
+    {"equal", "equal"},
+    {"not_equal", "not_equal"},
+    {"less", "greater"},
+    {"less_equal", "greater_equal"},
+    {"greater", "less"},
+    {"greater_equal", "less_equal"},
+};
+
+/// Returns true if the encoding can evaluate the function over the encoded values.
+bool SupportsEncodedFilter(lance::format::pb::Encoding encoding,
+                           const ::arrow::DataType& type,
+                           const std::string& function) {
+  switch (encoding) {
+    case lance::format::pb::Encoding::PLAIN:
+      // Key lookups over hashes / UUIDs.
+      return type.id() == ::arrow::Type::FIXED_SIZE_BINARY &&
+             (function == "equal" || function == "not_equal");
+    case lance::format::pb::Encoding::RLE:
+      return kComparisonFunctions.contains(function);
+    case lance::format::pb::Encoding::FSST:
+      return function == "equal" || function == "not_equal" || function == "starts_with";
+    case lance::format::pb::Encoding::DICTIONARY:
+      return function == "equal" || function == "not_equal" || function == "is_in";
+    default:
+      return false;
+  }
+}
+
+/// Collect the indices of the rows selected by a boolean mask. Null is not selected.
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> MaskToIndices(const ::arrow::Datum& mask,
+                                                                     int64_t length) {
+  std::shared_ptr<::arrow::Array> arr;
+  if (mask.is_scalar()) {
+    ARROW_ASSIGN_OR_RAISE(arr, ::arrow::MakeArrayFromScalar(*mask.scalar(), length));
+  } else {
+    arr = mask.make_array();
+  }
+  auto bools = std::static_pointer_cast<::arrow::BooleanArray>(arr);
+  auto bitmap = bools->values();
+  auto offset = bools->offset();
+  if (bools->null_count() > 0) {
+    ARROW_ASSIGN_OR_RAISE(bitmap,
+                          ::arrow::internal::BitmapAnd(::arrow::default_memory_pool(),
+                                                       bitmap->data(),
+                                                       offset,
+                                                       bools->null_bitmap_data(),
+                                                       offset,
+                                                       bools->length(),
+                                                       0));
+    offset = 0;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto indices, ::arrow::AllocateBuffer(bools->length() * sizeof(int32_t)));
+  auto count = lance::encodings::kernels::BitmapToIndices(
+      bitmap->data(), offset, bools->length(), reinterpret_cast<int32_t*>(indices->mutable_data()));
+  return std::make_shared<::arrow::Int32Array>(count, std::move(indices));
+}
+
+/// The indices of all the rows of a batch.
+::arrow::Result<std::shared_ptr<::arrow::Int32Array>> AllIndices(int64_t length) {
+  ARROW_ASSIGN_OR_RAISE(auto indices, ::arrow::AllocateBuffer(length * sizeof(int32_t)));
+  auto values = reinterpret_cast<int32_t*>(indices->mutable_data());
+  std::iota(values, values + length, 0);
+  return std::make_shared<::arrow::Int32Array>(length, std::move(indices));
+}
+
+/// Flatten the members of a conjunction.
+std::vector<::arrow::compute::Expression> FlattenConjunction(
+    const ::arrow::compute::Expression& filter) {
+  std::vector<::arrow::compute::Expression> members;
+  std::vector<::arrow::compute::Expression> pending{filter};
+  while (!pending.empty()) {
+    auto expr = pending.back();
+    pending.pop_back();
+    auto call = expr.call();
+    if (call != nullptr && (call->function_name == "and" || call->function_name == "and_kleene")) {
+      // Keep the written order of the members.
+      pending.insert(pending.end(), call->arguments.rbegin(), call->arguments.rend());
+    } else {
+      members.emplace_back(expr);
+    }
+  }
+  return members;
+}
+
+/// Match a `column == literal` or `is_in(column, values)` predicate.
+///
+/// \return the column, and the values casted to the type of the column (the value type of a
+///         dictionary column), or `std::nullopt` if the predicate does not match, or if it may
+///         match null rows.
+::arrow::Result<std::optional<
+    std::tuple<std::shared_ptr<lance::format::Field>, std::shared_ptr<::arrow::Array>>>>
+MatchValueSet(const lance::format::Schema& schema, const ::arrow::compute::Expression& expr) {
+  auto call = expr.call();
+  if (call == nullptr) {
+    return std::nullopt;
+  }
+  const ::arrow::FieldRef* ref = nullptr;
+  std::shared_ptr<::arrow::Array> values;
+  if (call->function_name == "equal" && call->arguments.size() == 2) {
+    ref = call->arguments[0].field_ref();
+    auto value = call->arguments[1].literal();
+    if (ref == nullptr) {
+      ref = call->arguments[1].field_ref();
+      value = call->arguments[0].literal();
+    }
+    if (value == nullptr || !value->is_scalar()) {
+      return std::nullopt;
+    }
+    ARROW_ASSIGN_OR_RAISE(values, ::arrow::MakeArrayFromScalar(*value->scalar(), 1));
+  } else if (call->function_name == "is_in" && call->arguments.size() == 1) {
+    ref = call->arguments[0].field_ref();
+    auto options = std::dynamic_pointer_cast<::arrow::compute::SetLookupOptions>(call->options);
+    if (!options || !options->value_set.is_array()) {
+      return std::nullopt;
+    }
+    values = options->value_set.make_array();
+  }
+  if (ref == nullptr || ref->name() == nullptr || values == nullptr) {
+    return std::nullopt;
+  }
+  auto field = schema.GetField(*ref->name());
+  if (!field) {
+    return std::nullopt;
+  }
+  // Dictionary columns are matched by their values, which the indices are built of.
+  auto value_type = field->type();
+  if (::arrow::is_dictionary(value_type->id())) {
+    value_type = std::static_pointer_cast<::arrow::DictionaryType>(value_type)->value_type();
+  }
+  if (!values->type()->Equals(value_type)) {
+    auto casted = ::arrow::compute::Cast(*values, value_type);
+    if (!casted.ok()) {
+      return std::nullopt;
+    }
+    values = *casted;
+  }
+  if (values->null_count() > 0) {
+    // `is_in` may match the null rows, which are not in the Bloom filters nor in the indices.
+    return std::nullopt;
+  }
+  return std::make_tuple(field, values);
+}
+
+/// Estimated bytes to read per value of a type.
+double EstimateReadCost(const ::arrow::DataType& type) {
+  if (::arrow::is_dictionary(type.id())) {
+    return EstimateReadCost(*static_cast<const ::arrow::DictionaryType&>(type).index_type());
+  }
+  if (auto fixed_width = dynamic_cast<const ::arrow::FixedWidthType*>(&type)) {
+    return fixed_width->bit_width() / 8.0;
+  }
+  if (::arrow::is_binary_like(type.id()) || ::arrow::is_large_binary_like(type.id())) {
+    // Offsets, and the average length of short strings.
+    return 32;
+  }
+  double cost = 4;
+  for (auto& child : type.fields()) {
+    cost += EstimateReadCost(*child->type());
+  }
+  return cost;
+}
+
+}  // namespace
+
 Filter::Filter(std::shared_ptr<lance::format::Schema> schema,
-               const ::arrow::compute::Expression& filter)
-    : schema_(schema), filter_(filter) {}
+               std::shared_ptr<lance::format::Schema> output_schema,
+               const ::arrow::compute::Expression& filter,
+               ::arrow::compute::Expression bound_filter,
+               std::optional<EncodedFilter> encoded_filter,
+               std::vector<EqualityProbe> equality_probes,
+               std::vector<Stage> stages,
+               std::optional<IndexPredicate> index_predicate)
+    : schema_(schema),
+      output_schema_(output_schema),
+      filter_(filter),
+      bound_filter_(std::move(bound_filter)),
+      encoded_filter_(std::move(encoded_filter)),
+      equality_probes_(std::move(equality_probes)),
+      stages_(std::move(stages)),
+      index_predicate_(std::move(index_predicate)) {}
+
+std::optional<Filter::EncodedFilter> Filter::MakeEncodedFilter(
+    const lance::format::Schema& schema, const ::arrow::compute::Expression& filter) {
+  auto call = filter.call();
+  if (call == nullptr) {
+    return std::nullopt;
+  }
+  auto function = call->function_name;
+  const ::arrow::FieldRef* ref = nullptr;
+  ::arrow::Datum literal;
+  if (function == "starts_with" && call->arguments.size() == 1) {
+    auto options =
+        std::dynamic_pointer_cast<::arrow::compute::MatchSubstringOptions>(call->options);
+    if (!options || options->ignore_case) {
+      return std::nullopt;
+    }
+    ref = call->arguments[0].field_ref();
+    literal = ::arrow::Datum(options->pattern);
+  } else if (function == "is_in" && call->arguments.size() == 1) {
+    auto options = std::dynamic_pointer_cast<::arrow::compute::SetLookupOptions>(call->options);
+    if (!options || !options->value_set.is_array()) {
+      return std::nullopt;
+    }
+    ref = call->arguments[0].field_ref();
+    literal = options->value_set;
+  } else if (call->arguments.size() == 2) {
+    auto it = kComparisonFunctions.find(function);
+    if (it == kComparisonFunctions.end()) {
+      return std::nullopt;
+    }
+    ref = call->arguments[0].field_ref();
+    auto value = call->arguments[1].literal();
+    if (ref == nullptr) {
+      // literal <op> column
+      ref = call->arguments[1].field_ref();
+      value = call->arguments[0].literal();
+      function = it->second;
+    }
+    if (value == nullptr) {
+      return std::nullopt;
+    }
+    literal = *value;
+  }
+  if (ref == nullptr || ref->name() == nullptr) {
+    return std::nullopt;
+  }
+  auto field = schema.GetField(*ref->name());
+  if (!field) {
+    return std::nullopt;
+  }
+  if (::arrow::is_dictionary(field->type()->id())) {
+    // Dictionary columns compare the literal with the dictionary values.
+    auto value_type =
+        std::static_pointer_cast<::arrow::DictionaryType>(field->type())->value_type();
+    auto casted = ::arrow::compute::Cast(literal, value_type);
+    if (!casted.ok() || casted->null_count() > 0 || !field->dictionary()) {
+      // Comparisons with null never match, while `is_in` may match the null rows.
+      return std::nullopt;
+    }
+    // Resolve the codes once, the dictionary is shared by the pages of the file.
+    auto codes = lance::encodings::DictionaryDecoder::ResolveCodes(
+        *std::static_pointer_cast<::arrow::DictionaryType>(field->type()),
+        field->dictionary(),
+        *casted);
+    if (!codes.ok()) {
+      return std::nullopt;
+    }
+    return EncodedFilter{field, function, *casted, *codes};
+  }
+  if (!literal.is_scalar()) {
+    return std::nullopt;
+  }
+  auto scalar = literal.scalar();
+  if (!scalar->is_valid) {
+    // Leave the comparisons with null to the generic evaluation.
+    return std::nullopt;
+  }
+  if (!scalar->type->Equals(field->type())) {
+    // A safe cast, so that a lossy literal (i.e., `int_col < 2.5`) is left to the generic
+    // evaluation instead of being truncated.
+    auto casted = ::arrow::compute::Cast(
+        ::arrow::Datum(scalar), field->type(), ::arrow::compute::CastOptions::Safe());
+    if (!casted.ok() || !casted->is_scalar() || !casted->scalar()->is_valid) {
+      return std::nullopt;
+    }
+    scalar = casted->scalar();
+  }
+  return EncodedFilter{field, function, ::arrow::Datum(scalar), nullptr};
+}
+
+::arrow::Result<std::vector<Filter::EqualityProbe>> Filter::MakeEqualityProbes(
+    const lance::format::Schema& schema, const ::arrow::compute::Expression& filter) {
+  std::vector<EqualityProbe> probes;
+  for (auto& member : FlattenConjunction(filter)) {
+    ARROW_ASSIGN_OR_RAISE(auto value_set, MatchValueSet(schema, member));
+    if (!value_set.has_value()) {
+      continue;
+    }
+    auto& [field, values] = *value_set;
+    if (!(lance::format::BloomFilter::Supports(*field->type()) ||
+          lance::format::PrimaryKeyIndex::Supports(*field->type()))) {
+      continue;
+    }
+    EqualityProbe probe{field, values, {}};
+    for (int64_t i = 0; i < values->length(); i++) {
+      ARROW_ASSIGN_OR_RAISE(auto value, values->GetScalar(i));
+      probe.values.emplace_back(value);
+    }
+    probes.emplace_back(std::move(probe));
+  }
+  return probes;
+}
+
+::arrow::Result<std::optional<Filter::IndexPredicate>> Filter::MakeIndexPredicate(
+    const lance::format::Schema& schema, const ::arrow::compute::Expression& filter) {
+  auto call = filter.call();
+  if (call == nullptr) {
+    return std::nullopt;
+  }
+  auto& function = call->function_name;
+  if (function == "and" || function == "and_kleene" || function == "or" ||
+      function == "or_kleene") {
+    auto is_and = function == "and" || function == "and_kleene";
+    IndexPredicate predicate{is_and ? IndexPredicate::Kind::kAnd : IndexPredicate::Kind::kOr};
+    for (auto& argument : call->arguments) {
+      ARROW_ASSIGN_OR_RAISE(auto child, MakeIndexPredicate(schema, argument));
+      if (!child.has_value()) {
+        if (!is_and) {
+          return std::nullopt;
+        }
+        // The other members are evaluated over the selected rows.
+        predicate.exact = false;
+        continue;
+      }
+      predicate.exact = predicate.exact && child->exact;
+      predicate.children.emplace_back(std::move(*child));
+    }
+    if (predicate.children.empty()) {
+      return std::nullopt;
+    }
+    return predicate;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto value_set, MatchValueSet(schema, filter));
+  if (!value_set.has_value() ||
+      !lance::format::BitmapIndex::Supports(*std::get<0>(*value_set)->type())) {
+    return std::nullopt;
+  }
+  auto& [field, values] = *value_set;
+  return IndexPredicate{IndexPredicate::Kind::kValues, field, values};
+}
+
+::arrow::Result<std::vector<Filter::Stage>> Filter::MakeStages(
+    const lance::format::Schema& schema, const ::arrow::compute::Expression& filter) {
+  std::vector<std::vector<std::string>> stage_columns;
+  std::vector<std::vector<::arrow::compute::Expression>> stage_members;
+  for (auto& member : FlattenConjunction(filter)) {
+    std::vector<std::string> columns;
+    for (auto& ref : ::arrow::compute::FieldsInExpression(member)) {
+      if (ref.name() == nullptr) {
+        return std::vector<Stage>{};
+      }
+      columns.emplace_back(*ref.name());
+    }
+    if (columns.empty()) {
+      return std::vector<Stage>{};
+    }
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    auto it = std::find(stage_columns.begin(), stage_columns.end(), columns);
+    if (it == stage_columns.end()) {
+      stage_columns.emplace_back(columns);
+      stage_members.emplace_back(std::vector<::arrow::compute::Expression>{member});
+    } else {
+      stage_members[std::distance(stage_columns.begin(), it)].emplace_back(member);
+    }
+  }
+  if (stage_columns.size() < 2) {
+    return std::vector<Stage>{};
+  }
 
-::arrow::Result<std::unique_ptr<Filter>> Filter::Make(const lance::format::Schema& schema,
-                                                      const ::arrow::compute::Expression& filter) {
+  std::vector<Stage> stages;
+  for (std::size_t i = 0; i < stage_columns.size(); i++) {
+    ARROW_ASSIGN_OR_RAISE(auto stage_schema, schema.Project(stage_columns[i]));
+    auto& members = stage_members[i];
+    auto expr = members.size() == 1 ? members[0] : ::arrow::compute::and_(members);
+    auto bound = expr.Bind(*stage_schema->ToArrow());
+    if (!bound.ok()) {
+      // Report the error by evaluating the whole filter.
+      return std::vector<Stage>{};
+    }
+    double cost = 0;
+    for (auto& field : stage_schema->fields()) {
+      cost += EstimateReadCost(*field->type());
+    }
+    stages.emplace_back(Stage{*bound, stage_schema, cost});
+  }
+  return stages;
+}
+
+::arrow::Result<std::unique_ptr<Filter>> Filter::Make(
+    const lance::format::Schema& schema,
+    const ::arrow::compute::Expression& filter,
+    std::shared_ptr<lance::format::Schema> projection) {
   if (!::arrow::compute::ExpressionHasFieldRefs(filter)) {
     /// All scalar?
     return nullptr;
@@ -40,35 +440,455 @@ Filter::Filter(std::shared_ptr<lance::format::Schema> schema,
     columns.emplace_back(std::string(*ref.name()));
   }
   ARROW_ASSIGN_OR_RAISE(auto filter_schema, schema.Project(columns));
-  return std::unique_ptr<Filter>(new Filter(filter_schema, filter));
+  std::vector<std::string> output_columns;
+  for (auto& field : filter_schema->fields()) {
+    if (!projection || projection->GetField(field->name())) {
+      output_columns.emplace_back(field->name());
+    }
+  }
+  ARROW_ASSIGN_OR_RAISE(auto output_schema, filter_schema->Project(output_columns));
+  // Binding errors, i.e., of mismatched literal types, are reported by the execution.
+  auto bound_filter = filter.Bind(*filter_schema->ToArrow()).ValueOr(filter);
+  ARROW_ASSIGN_OR_RAISE(auto equality_probes, MakeEqualityProbes(schema, filter));
+  ARROW_ASSIGN_OR_RAISE(auto stages, MakeStages(schema, filter));
+  ARROW_ASSIGN_OR_RAISE(auto index_predicate, MakeIndexPredicate(schema, filter));
+  return std::unique_ptr<Filter>(new Filter(filter_schema,
+                                            output_schema,
+                                            filter,
+                                            bound_filter,
+                                            MakeEncodedFilter(schema, filter),
+                                            std::move(equality_probes),
+                                            std::move(stages),
+                                            std::move(index_predicate)));
 }
 
 ::arrow::Result<
     std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
 Filter::Execute(std::shared_ptr<::arrow::RecordBatch> batch) const {
-  ARROW_ASSIGN_OR_RAISE(auto filter_expr, filter_.Bind(*(batch->schema())));
+  auto filter_expr = bound_filter_;
+  if (!filter_expr.IsBound() || !batch->schema()->Equals(*schema_->ToArrow())) {
+    ARROW_ASSIGN_OR_RAISE(filter_expr, filter_.Bind(*(batch->schema())));
+  }
   ARROW_ASSIGN_OR_RAISE(auto mask,
                         ::arrow::compute::ExecuteScalarExpression(
                             filter_expr, *(batch->schema()), ::arrow::Datum(batch)));
-  ARROW_ASSIGN_OR_RAISE(auto data, batch->ToStructArray());
-  ARROW_ASSIGN_OR_RAISE(auto indices_datum,
-                        ::arrow::compute::CallFunction("indices_nonzero", {mask}));
-  ARROW_ASSIGN_OR_RAISE(indices_datum, ::arrow::compute::Cast(indices_datum, ::arrow::int32()));
-  ARROW_ASSIGN_OR_RAISE(auto values, ::arrow::compute::CallFunction("filter", {data, mask}));
+  ARROW_ASSIGN_OR_RAISE(auto indices, MaskToIndices(mask, batch->num_rows()));
+  ARROW_ASSIGN_OR_RAISE(auto values, SelectOutput(batch));
+  if (indices->length() == batch->num_rows()) {
+    return std::make_tuple(indices, values);
+  }
+  // Only copy the matched rows of the output columns.
+  ::arrow::ArrayVector columns;
+  for (auto& column : values->columns()) {
+    ARROW_ASSIGN_OR_RAISE(auto taken, ::arrow::compute::Take(*column, *indices));
+    columns.emplace_back(taken);
+  }
+  return std::make_tuple(
+      indices, ::arrow::RecordBatch::Make(values->schema(), indices->length(), columns));
+}
 
-  auto indices = std::static_pointer_cast<::arrow::Int32Array>(indices_datum.make_array());
-  auto values_arr = values.make_array();
-  ARROW_ASSIGN_OR_RAISE(auto result_batch, ::arrow::RecordBatch::FromStructArray(values_arr));
-  return std::make_tuple(indices, result_batch);
+::arrow::Result<std::shared_ptr<::arrow::RecordBatch>> Filter::SelectOutput(
+    const std::shared_ptr<::arrow::RecordBatch>& batch) const {
+  ::arrow::FieldVector fields;
+  ::arrow::ArrayVector columns;
+  for (auto& field : output_schema_->fields()) {
+    auto index = batch->schema()->GetFieldIndex(field->name());
+    if (index < 0) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Filter column {} is not in the batch", field->name()));
+    }
+    fields.emplace_back(batch->schema()->field(index));
+    columns.emplace_back(batch->column(index));
+  }
+  return ::arrow::RecordBatch::Make(::arrow::schema(fields), batch->num_rows(), columns);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::RecordBatch>> Filter::ReadOutput(
+    const std::shared_ptr<FileReader>& reader,
+    int32_t batch_id,
+    const std::shared_ptr<::arrow::Int32Array>& indices) const {
+  if (output_schema_->fields().empty()) {
+    return ::arrow::RecordBatch::Make(
+        ::arrow::schema(::arrow::FieldVector{}), indices->length(), ::arrow::ArrayVector{});
+  }
+  if (indices->length() == 0) {
+    return ::arrow::RecordBatch::MakeEmpty(output_schema_->ToArrow());
+  }
+  if (indices->length() == reader->metadata().GetBatchLength(batch_id)) {
+    return reader->ReadBatch(*output_schema_, batch_id);
+  }
+  return reader->ReadBatch(*output_schema_, batch_id, indices);
+}
+
+::arrow::Result<
+    std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+Filter::ExecuteEncoded(const std::shared_ptr<FileReader>& reader, int32_t batch_id) const {
+  // Evaluate the predicate over the encoded values, and only read the matched rows.
+  auto& field = encoded_filter_->field;
+  auto validity = reader->page_table().GetValidity(field->id(), batch_id);
+  std::shared_ptr<::arrow::Int32Array> indices;
+  if (validity == lance::format::PageTable::kAllNull) {
+    // Comparing with null never matches.
+    ARROW_ASSIGN_OR_RAISE(auto empty, ::arrow::MakeEmptyArray(::arrow::int32()));
+    indices = std::static_pointer_cast<::arrow::Int32Array>(empty);
+  } else {
+    ARROW_ASSIGN_OR_RAISE(auto decoder, reader->GetDecoder(field, batch_id));
+    auto dict_decoder = std::dynamic_pointer_cast<lance::encodings::DictionaryDecoder>(decoder);
+    if (dict_decoder) {
+      ARROW_ASSIGN_OR_RAISE(
+          indices, dict_decoder->FilterCodes(encoded_filter_->function, encoded_filter_->codes));
+    } else {
+      ARROW_ASSIGN_OR_RAISE(
+          indices, decoder->Filter(encoded_filter_->function, encoded_filter_->literal));
+    }
+  }
+  if (indices->length() == 0 || validity == lance::format::PageTable::kNoNulls) {
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+  // Encodings do not track nulls, so drop the matched null rows.
+  ARROW_ASSIGN_OR_RAISE(auto values, reader->ReadBatch(*schema_, batch_id, indices));
+  ARROW_ASSIGN_OR_RAISE(auto mask,
+                        ::arrow::compute::IsValid(values->GetColumnByName(field->name())));
+  ARROW_ASSIGN_OR_RAISE(auto valid_indices, ::arrow::compute::Filter(indices, mask));
+  ARROW_ASSIGN_OR_RAISE(auto valid_values, ::arrow::compute::Filter(values, mask));
+  indices = std::static_pointer_cast<::arrow::Int32Array>(valid_indices.make_array());
+  ARROW_ASSIGN_OR_RAISE(values, SelectOutput(valid_values.record_batch()));
+  return std::make_tuple(indices, values);
+}
+
+::arrow::Result<::arrow::compute::Expression> Filter::Simplify(const FileReader& reader,
+                                                              int32_t batch_id) const {
+  auto schema = schema_->ToArrow();
+  auto filter = bound_filter_;
+  if (!filter.IsBound()) {
+    ARROW_ASSIGN_OR_RAISE(filter, filter_.Bind(*schema));
+  }
+  // Only the pages without nulls, or with only nulls, bound their values: a comparison over a
+  // null value is never true, while `is_null()` is.
+  std::vector<::arrow::compute::Expression> guarantees;
+  for (auto& ref : ::arrow::compute::FieldsInExpression(filter_)) {
+    auto field = schema_->GetField(*ref.name());
+    if (!field) {
+      continue;
+    }
+    auto statistics = reader.page_table().GetStatistics(field->id(), batch_id);
+    if (!statistics.has_value()) {
+      continue;
+    }
+    if (statistics->null_count() == statistics->row_count()) {
+      guarantees.emplace_back(
+          ::arrow::compute::call("is_null", {::arrow::compute::field_ref(ref)}));
+    } else if (statistics->null_count() == 0) {
+      ARROW_ASSIGN_OR_RAISE(auto min,
+                            lance::arrow::ScalarFromBytes(field->type(), statistics->min()));
+      ARROW_ASSIGN_OR_RAISE(auto max,
+                            lance::arrow::ScalarFromBytes(field->type(), statistics->max()));
+      guarantees.emplace_back(::arrow::compute::greater_equal(
+          ::arrow::compute::field_ref(ref), ::arrow::compute::literal(min)));
+      guarantees.emplace_back(::arrow::compute::less_equal(::arrow::compute::field_ref(ref),
+                                                           ::arrow::compute::literal(max)));
+    }
+  }
+  if (guarantees.empty()) {
+    return filter;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto guarantee, ::arrow::compute::and_(guarantees).Bind(*schema));
+  return ::arrow::compute::SimplifyWithGuarantee(filter, guarantee);
+}
+
+::arrow::Result<bool> Filter::MayMatch(const FileReader& reader, int32_t batch_id) const {
+  for (auto& probe : equality_probes_) {
+    ARROW_ASSIGN_OR_RAISE(auto bloom_filter, reader.GetBloomFilter(probe.field, batch_id));
+    if (bloom_filter) {
+      ARROW_ASSIGN_OR_RAISE(auto may_contain, bloom_filter->MayContainAny(probe.values));
+      if (!may_contain) {
+        return false;
+      }
+    }
+  }
+  return true;
 }
 
 ::arrow::Result<
     std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
 Filter::Execute(std::shared_ptr<FileReader> reader, int32_t batch_id) const {
+  ARROW_ASSIGN_OR_RAISE(auto simplified, Simplify(*reader, batch_id));
+  bool no_match = false;
+  if (simplified.literal() != nullptr && simplified.literal()->is_scalar()) {
+    auto& matched = simplified.literal()->scalar();
+    no_match = !matched->is_valid || !static_cast<const ::arrow::BooleanScalar&>(*matched).value;
+  }
+  if (!no_match) {
+    ARROW_ASSIGN_OR_RAISE(auto may_match, MayMatch(*reader, batch_id));
+    no_match = !may_match;
+  }
+  if (no_match) {
+    // No row can match, skip the batch without reading it.
+    ARROW_ASSIGN_OR_RAISE(auto empty, ::arrow::MakeEmptyArray(::arrow::int32()));
+    auto indices = std::static_pointer_cast<::arrow::Int32Array>(empty);
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+  if (simplified.literal() != nullptr && simplified.literal()->is_scalar()) {
+    // All the rows match, skip evaluating the predicate.
+    ARROW_ASSIGN_OR_RAISE(auto indices,
+                          AllIndices(reader->metadata().GetBatchLength(batch_id)));
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto primary_key_indices, LookupPrimaryKey(*reader, batch_id));
+  if (primary_key_indices.has_value()) {
+    return ExecuteAt(reader, batch_id, *primary_key_indices);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto bitmap_index_indices, LookupBitmapIndex(*reader, batch_id));
+  if (bitmap_index_indices.has_value()) {
+    auto [indices, exact] = *bitmap_index_indices;
+    if (!exact) {
+      return ExecuteAt(reader, batch_id, indices);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+  if (encoded_filter_.has_value()) {
+    // The encoding may be chosen per page.
+    auto& field = encoded_filter_->field;
+    auto encoding =
+        reader->page_table().GetEncoding(field->id(), batch_id).value_or(field->encoding());
+    if (SupportsEncodedFilter(encoding, *field->type(), encoded_filter_->function)) {
+      return ExecuteEncoded(reader, batch_id);
+    }
+  }
+  if (!stages_.empty()) {
+    return ExecuteStages(reader, batch_id);
+  }
   ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(*schema_, batch_id));
   return Execute(batch);
 }
 
+::arrow::Result<std::optional<std::shared_ptr<::arrow::Int32Array>>> Filter::LookupPrimaryKey(
+    const FileReader& reader, int32_t batch_id) const {
+  auto& index = reader.primary_key_index();
+  if (!index) {
+    return std::nullopt;
+  }
+  auto probe = std::find_if(equality_probes_.begin(), equality_probes_.end(), [&](auto& probe) {
+    return probe.field->id() == index->field()->id();
+  });
+  if (probe == equality_probes_.end()) {
+    return std::nullopt;
+  }
+  const std::vector<int64_t>* row_ids = nullptr;
+  {
+    std::lock_guard guard(primary_key_rows_mutex_);
+    if (!primary_key_rows_) {
+      // Look up the keys once, the filter is made per file.
+      ARROW_ASSIGN_OR_RAISE(primary_key_rows_, index->Lookup(*probe->value_set));
+    }
+    row_ids = &*primary_key_rows_;
+  }
+  auto offset = reader.metadata().GetBatchOffset(batch_id);
+  auto begin = std::lower_bound(row_ids->begin(), row_ids->end(), offset);
+  auto end = std::lower_bound(
+      begin, row_ids->end(), offset + reader.metadata().GetBatchLength(batch_id));
+  ::arrow::Int32Builder builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(end - begin));
+  for (auto it = begin; it != end; it++) {
+    builder.UnsafeAppend(static_cast<int32_t>(*it - offset));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto indices, builder.Finish());
+  return std::static_pointer_cast<::arrow::Int32Array>(indices);
+}
+
+::arrow::Result<
+    std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+Filter::ExecuteAt(const std::shared_ptr<FileReader>& reader,
+                  int32_t batch_id,
+                  const std::shared_ptr<::arrow::Int32Array>& indices) const {
+  if (indices->length() == 0) {
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+  // Only read the candidate rows, and evaluate the filter over them.
+  ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(*schema_, batch_id, indices));
+  ARROW_ASSIGN_OR_RAISE(auto result, Execute(batch));
+  auto [matched, values] = result;
+  ARROW_ASSIGN_OR_RAISE(auto matched_indices, ::arrow::compute::Take(*indices, *matched));
+  return std::make_tuple(std::static_pointer_cast<::arrow::Int32Array>(matched_indices), values);
+}
+
+::arrow::Result<std::optional<std::tuple<std::shared_ptr<::arrow::Buffer>, bool>>>
+Filter::EvaluateIndexPredicate(const IndexPredicate& predicate,
+                               const FileReader& reader,
+                               int32_t batch_id) const {
+  auto length = reader.metadata().GetBatchLength(batch_id);
+  if (predicate.kind == IndexPredicate::Kind::kValues) {
+    auto index = reader.GetBitmapIndex(predicate.field);
+    if (!index) {
+      return std::nullopt;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto bitmap, index->GetBitmap(*predicate.values, batch_id, length));
+    return std::make_tuple(bitmap, true);
+  }
+  auto is_and = predicate.kind == IndexPredicate::Kind::kAnd;
+  std::shared_ptr<::arrow::Buffer> bitmap;
+  auto exact = predicate.exact;
+  for (auto& child : predicate.children) {
+    ARROW_ASSIGN_OR_RAISE(auto child_result, EvaluateIndexPredicate(child, reader, batch_id));
+    if (!child_result.has_value()) {
+      if (!is_and) {
+        return std::nullopt;
+      }
+      exact = false;
+      continue;
+    }
+    auto [child_bitmap, child_exact] = *child_result;
+    exact = exact && child_exact;
+    if (!bitmap) {
+      bitmap = child_bitmap;
+    } else if (is_and) {
+      ARROW_ASSIGN_OR_RAISE(bitmap,
+                            ::arrow::internal::BitmapAnd(::arrow::default_memory_pool(),
+                                                         bitmap->data(),
+                                                         0,
+                                                         child_bitmap->data(),
+                                                         0,
+                                                         length,
+                                                         0));
+    } else {
+      ARROW_ASSIGN_OR_RAISE(bitmap,
+                            ::arrow::internal::BitmapOr(::arrow::default_memory_pool(),
+                                                        bitmap->data(),
+                                                        0,
+                                                        child_bitmap->data(),
+                                                        0,
+                                                        length,
+                                                        0));
+    }
+  }
+  if (!bitmap) {
+    return std::nullopt;
+  }
+  return std::make_tuple(bitmap, exact);
+}
+
+::arrow::Result<std::optional<std::tuple<std::shared_ptr<::arrow::Int32Array>, bool>>>
+Filter::LookupBitmapIndex(const FileReader& reader, int32_t batch_id) const {
+  if (!index_predicate_.has_value()) {
+    return std::nullopt;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto result, EvaluateIndexPredicate(*index_predicate_, reader, batch_id));
+  if (!result.has_value()) {
+    return std::nullopt;
+  }
+  auto [bitmap, exact] = *result;
+  auto length = reader.metadata().GetBatchLength(batch_id);
+  ARROW_ASSIGN_OR_RAISE(auto indices, ::arrow::AllocateBuffer(length * sizeof(int32_t)));
+  auto count = lance::encodings::kernels::BitmapToIndices(
+      bitmap->data(), 0, length, reinterpret_cast<int32_t*>(indices->mutable_data()));
+  return std::make_tuple(std::make_shared<::arrow::Int32Array>(count, std::move(indices)), exact);
+}
+
+std::vector<const Filter::Stage*> Filter::OrderStages() const {
+  std::vector<std::tuple<double, const Stage*>> ranks;
+  {
+    std::lock_guard guard(stages_mutex_);
+    for (auto& stage : stages_) {
+      // The pass rate starts from 1/2, and converges to the observed rate of the file.
+      auto pass_rate = (stage.num_matched + 1.0) / (stage.num_rows + 2.0);
+      ranks.emplace_back(stage.cost / (1 - pass_rate), &stage);
+    }
+  }
+  std::stable_sort(ranks.begin(), ranks.end(), [](auto& lhs, auto& rhs) {
+    return std::get<0>(lhs) < std::get<0>(rhs);
+  });
+  std::vector<const Stage*> stages;
+  for (auto& [rank, stage] : ranks) {
+    stages.emplace_back(stage);
+  }
+  return stages;
+}
+
+std::vector<::arrow::compute::Expression> Filter::GetStages() const {
+  std::vector<::arrow::compute::Expression> stages;
+  for (auto stage : OrderStages()) {
+    stages.emplace_back(stage->filter);
+  }
+  return stages;
+}
+
+::arrow::Result<
+    std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+Filter::ExecuteStages(const std::shared_ptr<FileReader>& reader, int32_t batch_id) const {
+  // The selected rows of the batch, or nullptr before the first stage.
+  std::shared_ptr<::arrow::Int32Array> indices;
+  // The batches read by the stages, with the positions of the selected rows in them.
+  std::vector<std::tuple<std::shared_ptr<::arrow::RecordBatch>,
+                         std::shared_ptr<::arrow::Int32Array>>>
+      batches;
+  for (auto stage : OrderStages()) {
+    std::shared_ptr<::arrow::RecordBatch> batch;
+    if (indices) {
+      ARROW_ASSIGN_OR_RAISE(batch, reader->ReadBatch(*stage->schema, batch_id, indices));
+    } else {
+      ARROW_ASSIGN_OR_RAISE(batch, reader->ReadBatch(*stage->schema, batch_id));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto mask,
+                          ::arrow::compute::ExecuteScalarExpression(
+                              stage->filter, *batch->schema(), ::arrow::Datum(batch)));
+    ARROW_ASSIGN_OR_RAISE(auto selected, MaskToIndices(mask, batch->num_rows()));
+    {
+      std::lock_guard guard(stages_mutex_);
+      stage->num_rows += batch->num_rows();
+      stage->num_matched += selected->length();
+    }
+
+    if (indices) {
+      ARROW_ASSIGN_OR_RAISE(auto taken, ::arrow::compute::Take(*indices, *selected));
+      indices = std::static_pointer_cast<::arrow::Int32Array>(taken);
+    } else {
+      indices = selected;
+    }
+    if (indices->length() == 0) {
+      break;
+    }
+    for (auto& [_, positions] : batches) {
+      ARROW_ASSIGN_OR_RAISE(auto taken, ::arrow::compute::Take(*positions, *selected));
+      positions = std::static_pointer_cast<::arrow::Int32Array>(taken);
+    }
+    batches.emplace_back(batch, selected);
+  }
+  if (indices->length() == 0) {
+    ARROW_ASSIGN_OR_RAISE(auto values, ReadOutput(reader, batch_id, indices));
+    return std::make_tuple(indices, values);
+  }
+
+  // Gather the output columns at the final selection.
+  ::arrow::FieldVector fields;
+  ::arrow::ArrayVector columns;
+  for (auto& field : output_schema_->fields()) {
+    for (auto& [batch, positions] : batches) {
+      auto index = batch->schema()->GetFieldIndex(field->name());
+      if (index < 0) {
+        continue;
+      }
+      auto column = batch->column(index);
+      if (positions->length() < column->length()) {
+        ARROW_ASSIGN_OR_RAISE(column, ::arrow::compute::Take(*column, *positions));
+      }
+      fields.emplace_back(batch->schema()->field(index));
+      columns.emplace_back(column);
+      break;
+    }
+  }
+  auto values = ::arrow::RecordBatch::Make(::arrow::schema(fields), indices->length(), columns);
+  return std::make_tuple(indices, values);
+}
+
+const std::shared_ptr<lance::format::Schema>& Filter::output_schema() const {
+  return output_schema_;
+}
+
 const std::shared_ptr<lance::format::Schema>& Filter::schema() const { return schema_; }
 
 std::string Filter::ToString() const { return filter_.ToString(); }
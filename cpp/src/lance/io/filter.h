@@ -18,7 +18,11 @@
 #include <arrow/result.h>
 
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include "lance/format/schema.h"
 
@@ -32,12 +36,22 @@ class Filter {
   Filter() = delete;
 
   /// Build a filter from arrow's filter expression and dataset schema.
-  static ::arrow::Result<std::unique_ptr<Filter>> Make(const lance::format::Schema& schema,
-                                                       const ::arrow::compute::Expression& filter);
+  ///
+  /// The expression is bound to the filter columns once, and reused for every batch.
+  ///
+  /// \param schema dataset schema.
+  /// \param filter the filter expression.
+  /// \param projection the columns to output. The filter only outputs the filter columns that
+  ///        are in the projection, and the other filter columns are only read to evaluate the
+  ///        filter. All the filter columns are output if it is nullptr.
+  static ::arrow::Result<std::unique_ptr<Filter>> Make(
+      const lance::format::Schema& schema,
+      const ::arrow::compute::Expression& filter,
+      std::shared_ptr<lance::format::Schema> projection = nullptr);
 
   /// Execute the filter on an arrow RecordBatch.
   ///
-  /// \return a tuple of [indices, filtered_array].
+  /// \return a tuple of [indices, filtered_array], where filtered_array has the output columns.
   ///
   /// For example, with a record batch of {"bar": [0, 2, 32, 5, 32]}, and filter "bar = 32",
   /// this function returns:
@@ -51,15 +65,186 @@ class Filter {
       std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
   Execute(std::shared_ptr<FileReader> reader, int32_t batch_id) const;
 
+  /// Simplify the filter with the statistics of the pages of a batch.
+  ///
+  /// \param reader the file reader.
+  /// \param batch_id the index of the batch in the file.
+  /// \return the filter bound to the filter schema. It is a `false` or `null` literal if no
+  ///         row of the batch can match, or a `true` literal if all the rows match.
+  ::arrow::Result<::arrow::compute::Expression> Simplify(const FileReader& reader,
+                                                         int32_t batch_id) const;
+
+  /// Check the filter with the Bloom filters of the pages of a batch.
+  ///
+  /// \param reader the file reader.
+  /// \param batch_id the index of the batch in the file.
+  /// \return false if the Bloom filters prove that no row of the batch matches an equality or
+  ///         `is_in` predicate of the filter, or true otherwise.
+  ::arrow::Result<bool> MayMatch(const FileReader& reader, int32_t batch_id) const;
+
+  /// The stages of a conjunctive filter, in the order to evaluate them over the next batch.
+  ///
+  /// Each stage is the conjunction of the predicates over the same columns. The stages are
+  /// ordered by the estimated cost of reading their columns, and by their pass rates observed
+  /// over the previous batches of the file. It is empty if the filter is evaluated at once.
+  std::vector<::arrow::compute::Expression> GetStages() const;
+
+  /// The columns to evaluate the filter.
   const std::shared_ptr<lance::format::Schema>& schema() const;
 
+  /// The filter columns in the output of `Execute()`.
+  const std::shared_ptr<lance::format::Schema>& output_schema() const;
+
   std::string ToString() const;
 
  private:
-  Filter(std::shared_ptr<lance::format::Schema> schema, const ::arrow::compute::Expression& filter);
+  /// A `column <op> literal` predicate that the encoding of the column can evaluate without
+  /// decoding the column, i.e., over the runs of RLE, the compressed values of FSST, or the
+  /// codes of a dictionary.
+  struct EncodedFilter {
+    std::shared_ptr<lance::format::Field> field;
+    /// Arrow compute function name, with the column on the left hand side.
+    std::string function;
+    /// A scalar, or the value set of `is_in`. It is of the value type for dictionary columns.
+    ::arrow::Datum literal;
+    /// The codes of the literal in the dictionary of a dictionary column.
+    std::shared_ptr<::arrow::Array> codes;
+  };
+
+  /// A `column == literal` or `is_in(column, values)` predicate, which a row must satisfy to
+  /// match the filter, and can be checked with the Bloom filters of the column, or looked up
+  /// in the primary key index.
+  struct EqualityProbe {
+    std::shared_ptr<lance::format::Field> field;
+    /// The values to look up, casted to the type of the column.
+    std::shared_ptr<::arrow::Array> value_set;
+    std::vector<std::shared_ptr<::arrow::Scalar>> values;
+  };
+
+  /// An `==`, `is_in`, `and` or `or` predicate that might be evaluated by the bitmap indices
+  /// of the columns.
+  struct IndexPredicate {
+    enum class Kind { kValues, kAnd, kOr };
+    Kind kind;
+    /// The column and the values of `==` and `is_in`.
+    std::shared_ptr<lance::format::Field> field;
+    std::shared_ptr<::arrow::Array> values;
+    std::vector<IndexPredicate> children;
+    /// False if the predicate selects a superset of the matched rows, i.e., an `and` with
+    /// members that the indices can not evaluate.
+    bool exact = true;
+  };
+
+  /// The predicates of a conjunction over the same columns.
+  struct Stage {
+    ::arrow::compute::Expression filter;
+    /// The columns of the stage.
+    std::shared_ptr<lance::format::Schema> schema;
+    /// Estimated bytes to read per row.
+    double cost;
+    /// The rows evaluated by this stage, and the rows that passed, guarded by `stages_mutex_`.
+    mutable int64_t num_rows = 0;
+    mutable int64_t num_matched = 0;
+  };
+
+  Filter(std::shared_ptr<lance::format::Schema> schema,
+         std::shared_ptr<lance::format::Schema> output_schema,
+         const ::arrow::compute::Expression& filter,
+         ::arrow::compute::Expression bound_filter,
+         std::optional<EncodedFilter> encoded_filter = std::nullopt,
+         std::vector<EqualityProbe> equality_probes = {},
+         std::vector<Stage> stages = {},
+         std::optional<IndexPredicate> index_predicate = std::nullopt);
+
+  /// Match a `column <op> literal` predicate, which might be evaluated by the encoding of the
+  /// pages of the column.
+  static std::optional<EncodedFilter> MakeEncodedFilter(
+      const lance::format::Schema& schema, const ::arrow::compute::Expression& filter);
+
+  /// Collect the equality and `is_in` predicates in the conjunction of the filter, over the
+  /// columns that might have Bloom filters or a primary key index.
+  static ::arrow::Result<std::vector<EqualityProbe>> MakeEqualityProbes(
+      const lance::format::Schema& schema, const ::arrow::compute::Expression& filter);
+
+  /// Match the `==`, `is_in`, `and` and `or` predicates of the filter, over the columns that
+  /// might have bitmap indices.
+  static ::arrow::Result<std::optional<IndexPredicate>> MakeIndexPredicate(
+      const lance::format::Schema& schema, const ::arrow::compute::Expression& filter);
+
+  /// Split a conjunctive filter into stages of predicates over the same columns.
+  ///
+  /// \return the stages, or an empty vector if the filter has less than two stages.
+  static ::arrow::Result<std::vector<Stage>> MakeStages(const lance::format::Schema& schema,
+                                                        const ::arrow::compute::Expression& filter);
+
+  /// Order the stages by their cost per filtered row.
+  std::vector<const Stage*> OrderStages() const;
+
+  /// Evaluate the stages in order, each reading its columns at the rows that passed the
+  /// previous stages.
+  ::arrow::Result<
+      std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+  ExecuteStages(const std::shared_ptr<FileReader>& reader, int32_t batch_id) const;
+
+  /// Look up the rows of a batch by the primary key index of the file.
+  ///
+  /// \return the (sorted) indices of the rows of the batch that have the primary keys of an
+  ///         equality probe, or `std::nullopt` if the index can not be used.
+  ::arrow::Result<std::optional<std::shared_ptr<::arrow::Int32Array>>> LookupPrimaryKey(
+      const FileReader& reader, int32_t batch_id) const;
+
+  /// Evaluate an index predicate over the bitmap indices of a batch.
+  ///
+  /// \return a tuple of [bitmap, exact] with one bit per row of the batch, or `std::nullopt` if
+  ///         the columns are not indexed in the file.
+  ::arrow::Result<std::optional<std::tuple<std::shared_ptr<::arrow::Buffer>, bool>>>
+  EvaluateIndexPredicate(const IndexPredicate& predicate,
+                         const FileReader& reader,
+                         int32_t batch_id) const;
+
+  /// Select the rows of a batch by the bitmap indices of the file.
+  ///
+  /// \return a tuple of [indices, exact], where the indices are a superset of the matched rows
+  ///         unless exact, or `std::nullopt` if the indices can not be used.
+  ::arrow::Result<std::optional<std::tuple<std::shared_ptr<::arrow::Int32Array>, bool>>>
+  LookupBitmapIndex(const FileReader& reader, int32_t batch_id) const;
+
+  /// Evaluate the filter over the candidate rows of a batch, selected by an index.
+  ::arrow::Result<
+      std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+  ExecuteAt(const std::shared_ptr<FileReader>& reader,
+            int32_t batch_id,
+            const std::shared_ptr<::arrow::Int32Array>& indices) const;
+
+  /// Keep the output columns of a batch, without copying them.
+  ::arrow::Result<std::shared_ptr<::arrow::RecordBatch>> SelectOutput(
+      const std::shared_ptr<::arrow::RecordBatch>& batch) const;
+
+  /// Read the output columns of the matched rows of a batch.
+  ::arrow::Result<std::shared_ptr<::arrow::RecordBatch>> ReadOutput(
+      const std::shared_ptr<FileReader>& reader,
+      int32_t batch_id,
+      const std::shared_ptr<::arrow::Int32Array>& indices) const;
+
+  /// Execute the encoded filter on one page.
+  ::arrow::Result<
+      std::tuple<std::shared_ptr<::arrow::Int32Array>, std::shared_ptr<::arrow::RecordBatch>>>
+  ExecuteEncoded(const std::shared_ptr<FileReader>& reader, int32_t batch_id) const;
 
   std::shared_ptr<lance::format::Schema> schema_;
+  std::shared_ptr<lance::format::Schema> output_schema_;
   ::arrow::compute::Expression filter_;
+  /// The filter bound to `schema_`, if it can be bound.
+  ::arrow::compute::Expression bound_filter_;
+  std::optional<EncodedFilter> encoded_filter_;
+  std::vector<EqualityProbe> equality_probes_;
+  std::vector<Stage> stages_;
+  mutable std::mutex stages_mutex_;
+  std::optional<IndexPredicate> index_predicate_;
+
+  /// Sorted row ids of the primary keys of the probe, looked up on the first batch of the file.
+  mutable std::mutex primary_key_rows_mutex_;
+  mutable std::optional<std::vector<int64_t>> primary_key_rows_;
 };
 
 }  // namespace lance::io
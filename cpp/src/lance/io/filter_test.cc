@@ -15,15 +15,26 @@
 #include "lance/io/filter.h"
 
 #include <arrow/array.h>
+#include <arrow/compute/api.h>
 #include <arrow/compute/exec/expression.h>
+#include <arrow/io/api.h>
 #include <arrow/record_batch.h>
+#include <arrow/table.h>
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
+#include "lance/arrow/writer.h"
+#include "lance/format/metadata.h"
+#include "lance/format/page_table.h"
 #include "lance/format/schema.h"
+#include "lance/io/reader.h"
 
 using ::arrow::compute::equal;
 using ::arrow::compute::field_ref;
@@ -87,4 +98,757 @@ TEST_CASE("label = cat or label = dog") {
       ::arrow::StructArray::Make({labels}, {::arrow::field("label", ::arrow::utf8())}).ValueOrDie();
   auto expected = ::arrow::RecordBatch::FromStructArray(struct_arr).ValueOrDie();
   CHECK(output->Equals(*expected));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Output only the projected filter columns") {
+  auto expr = ::arrow::compute::and_(::arrow::compute::greater(field_ref("value"), literal(10)),
+                                     ::arrow::compute::not_equal(field_ref("label"), literal("x")));
+  auto projection = kSchema.Project({"pk", "label"}).ValueOrDie();
+  auto filter = lance::io::Filter::Make(kSchema, expr, projection).ValueOrDie();
+  CHECK(filter->schema()->GetFieldsCount() == 2);
+  CHECK(filter->output_schema()->ToArrow()->Equals(
+      ::arrow::schema({::arrow::field("label", ::arrow::utf8())})));
+
+  auto schema = filter->schema()->ToArrow();
+  // The filter is bound once, and evaluated over each batch.
+  for (int i = 0; i < 3; i++) {
+    auto batch = ::arrow::RecordBatch::Make(
+        schema,
+        4,
+        {lance::arrow::ToArray({1, 20 + i, 30, 40}).ValueOrDie(),
+         lance::arrow::ToArray({"a", "b", "x", "c"}).ValueOrDie()});
+    auto [indices, output] = filter->Execute(batch).ValueOrDie();
+    CHECK(indices->Equals(lance::arrow::ToArray({1, 3}).ValueOrDie()));
+    CHECK(output->num_columns() == 1);
+    CHECK(output->GetColumnByName("label")->Equals(lance::arrow::ToArray({"b", "c"}).ValueOrDie()));
+  }
+
+  // Filter columns that are not projected.
+  filter = lance::io::Filter::Make(kSchema, expr, kSchema.Project({"pk"}).ValueOrDie())
+               .ValueOrDie();
+  auto batch = ::arrow::RecordBatch::Make(schema,
+                                          2,
+                                          {lance::arrow::ToArray({11, 12}).ValueOrDie(),
+                                           lance::arrow::ToArray({"x", "y"}).ValueOrDie()});
+  auto [indices, output] = filter->Execute(batch).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({1}).ValueOrDie()));
+  CHECK(output->num_columns() == 0);
+  CHECK(output->num_rows() == 1);
+}
+
+TEST_CASE("Filter over run-length encoded column") {
+  auto categories = lance::arrow::ToArray({"cat", "cat", "cat", "dog", "dog", "fox"}).ValueOrDie();
+  auto values = lance::arrow::ToArray({1, 2, 3, 4, 5, 6}).ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("category", ::arrow::utf8()), ::arrow::field("value", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(schema, {categories, values});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.rle_columns = {"category"};
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("category")->encoding() ==
+        lance::format::pb::Encoding::RLE);
+
+  auto filter =
+      lance::io::Filter::Make(reader->schema(), equal(literal("dog"), field_ref("category")))
+          .ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({3, 4}).ValueOrDie()));
+  auto expected = lance::arrow::ToArray({"dog", "dog"}).ValueOrDie();
+  CHECK(output->GetColumnByName("category")->Equals(expected));
+
+  filter = lance::io::Filter::Make(reader->schema(), equal(field_ref("category"), literal("bird")))
+               .ValueOrDie();
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->length() == 0);
+  CHECK(output->num_rows() == 0);
+}
+
+TEST_CASE("Filter over run-length encoded column with nulls") {
+  ::arrow::StringBuilder builder;
+  CHECK(builder.AppendValues({"cat", "cat"}).ok());
+  CHECK(builder.AppendNulls(3).ok());
+  CHECK(builder.AppendValues({"dog", "fox"}).ok());
+  auto categories = builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("category", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(schema, {categories});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.rle_columns = {"category"};
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+
+  auto filter = lance::io::Filter::Make(
+                    reader->schema(), ::arrow::compute::not_equal(field_ref("category"), literal("cat")))
+                    .ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  INFO("Indices: " << indices->ToString());
+  CHECK(indices->Equals(lance::arrow::ToArray({5, 6}).ValueOrDie()));
+  CHECK(output->GetColumnByName("category")
+            ->Equals(lance::arrow::ToArray({"dog", "fox"}).ValueOrDie()));
+}
+
+TEST_CASE("Filter run-length encoded column with a non-integral literal") {
+  auto values = lance::arrow::ToArray({1, 1, 2, 2, 3, 3}).ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("value", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(schema, {values});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.rle_columns = {"value"};
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("value")->encoding() == lance::format::pb::Encoding::RLE);
+
+  // 2.5 can not be casted to int32 without truncation, so it must not be compared as 2.
+  auto filter =
+      lance::io::Filter::Make(reader->schema(), equal(field_ref("value"), literal(2.5)))
+          .ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->length() == 0);
+
+  filter = lance::io::Filter::Make(reader->schema(),
+                                   ::arrow::compute::less(field_ref("value"), literal(2.5)))
+               .ValueOrDie();
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 1, 2, 3}).ValueOrDie()));
+}
+
+TEST_CASE("Prefix filter over FSST compressed column") {
+  auto paths =
+      lance::arrow::ToArray({"images/train/1.jpg", "images/val/2.jpg", "images/train/3.jpg"})
+          .ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("path", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(schema, {paths});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.fsst_columns = {"path"};
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("path")->encoding() == lance::format::pb::Encoding::FSST);
+
+  auto expr = ::arrow::compute::call("starts_with",
+                                     {field_ref("path")},
+                                     ::arrow::compute::MatchSubstringOptions("images/train"));
+  auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 2}).ValueOrDie()));
+  CHECK(output->GetColumnByName("path")->Equals(
+      lance::arrow::ToArray({"images/train/1.jpg", "images/train/3.jpg"}).ValueOrDie()));
+
+  // Comparisons with a null literal never match.
+  filter = lance::io::Filter::Make(
+               reader->schema(),
+               equal(field_ref("path"), literal(::arrow::MakeNullScalar(::arrow::utf8()))))
+               .ValueOrDie();
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->length() == 0);
+
+  auto read_table = reader->ReadTable().ValueOrDie();
+  CHECK(read_table->Equals(*table));
+}
+
+TEST_CASE("Filter pages with different encodings") {
+  ::arrow::Int32Builder builder;
+  for (int i = 0; i < 200; i++) {
+    // The first page has long runs, the second page does not.
+    CHECK(builder.Append(i < 100 ? i / 50 : i % 3).ok());
+  }
+  auto values = builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("value", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(schema, {values});
+  table = ::arrow::ConcatenateTables({table->Slice(0, 100), table->Slice(100)}).ValueOrDie();
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.encoding_policy = lance::arrow::EncodingPolicy::kBalanced;
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->page_table().GetEncoding(0, 0) == lance::format::pb::Encoding::RLE);
+  CHECK(!reader->page_table().GetEncoding(0, 1).has_value());
+
+  auto expr = ::arrow::compute::equal(field_ref("value"), ::arrow::compute::literal(1));
+  auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->length() == 50);
+  CHECK(indices->Value(0) == 50);
+  std::tie(indices, output) = filter->Execute(reader, 1).ValueOrDie();
+  CHECK(indices->length() == 34);
+  CHECK(indices->Value(0) == 0);
+}
+
+TEST_CASE("Key lookup over fixed size binary column") {
+  auto type = ::arrow::fixed_size_binary(32);
+  ::arrow::FixedSizeBinaryBuilder builder(type);
+  for (int i = 0; i < 50; i++) {
+    if (i % 7 == 3) {
+      CHECK(builder.AppendNull().ok());
+    } else {
+      CHECK(builder.Append(fmt::format("{:032d}", i % 10)).ok());
+    }
+  }
+  auto hashes = builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("hash", type)});
+  auto table = ::arrow::Table::Make(schema, {hashes});
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("hash")->encoding() == lance::format::pb::Encoding::PLAIN);
+
+  auto key = std::make_shared<::arrow::FixedSizeBinaryScalar>(
+      ::arrow::Buffer::FromString(fmt::format("{:032d}", 5)), type);
+  auto filter =
+      lance::io::Filter::Make(reader->schema(), equal(field_ref("hash"), literal(key)))
+          .ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  // Row 45 is null.
+  INFO("Indices: " << indices->ToString());
+  CHECK(indices->Equals(lance::arrow::ToArray({5, 15, 25, 35}).ValueOrDie()));
+  CHECK(output->num_rows() == 4);
+
+  // Comparisons with a null literal never match, including the null rows.
+  filter = lance::io::Filter::Make(reader->schema(),
+                                   equal(field_ref("hash"), literal(::arrow::MakeNullScalar(type))))
+               .ValueOrDie();
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->length() == 0);
+
+  auto read_table = reader->ReadTable().ValueOrDie();
+  CHECK(read_table->Equals(*table));
+}
+
+TEST_CASE("Time range filter over timestamp column") {
+  auto type = ::arrow::timestamp(::arrow::TimeUnit::MILLI, "UTC");
+  std::vector<int64_t> millis;
+  for (int i = 0; i < 20; i++) {
+    millis.emplace_back(1'660'000'000'000 + i * 60'000);
+  }
+  auto ts = lance::arrow::ToArray(millis).ValueOrDie()->View(type).ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("ts", type)});
+  auto table = ::arrow::Table::Make(schema, {ts});
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("ts")->type()->Equals(type));
+
+  // Between the 5th and the 8th minutes.
+  auto start = std::make_shared<::arrow::TimestampScalar>(1'660'000'000'000 + 5 * 60'000, type);
+  auto end = std::make_shared<::arrow::TimestampScalar>(1'660'000'000'000 + 8 * 60'000, type);
+  auto expr = ::arrow::compute::and_(
+      ::arrow::compute::greater_equal(field_ref("ts"), literal(start)),
+      ::arrow::compute::less(field_ref("ts"), literal(end)));
+  auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({5, 6, 7}).ValueOrDie()));
+  CHECK(output->GetColumnByName("ts")->Equals(ts->Slice(5, 3)));
+
+  auto read_table = reader->ReadTable().ValueOrDie();
+  CHECK(read_table->Equals(*table));
+}
+
+TEST_CASE("Skip batches by page statistics") {
+  // 4 batches of time-clustered rows. The "score" column is all null in the last batch.
+  ::arrow::Int64Builder ts_builder;
+  ::arrow::DoubleBuilder score_builder;
+  for (int i = 0; i < 100; i++) {
+    CHECK(ts_builder.Append(1000 + i).ok());
+    if (i >= 75 || i == 10) {
+      CHECK(score_builder.AppendNull().ok());
+    } else {
+      CHECK(score_builder.Append(i * 0.5).ok());
+    }
+  }
+  auto schema = ::arrow::schema(
+      {::arrow::field("ts", ::arrow::int64()), ::arrow::field("score", ::arrow::float64())});
+  auto table = ::arrow::Table::Make(
+      schema, {ts_builder.Finish().ValueOrDie(), score_builder.Finish().ValueOrDie()});
+  table = ::arrow::ConcatenateTables(
+              {table->Slice(0, 25), table->Slice(25, 25), table->Slice(50, 25), table->Slice(75)})
+              .ValueOrDie();
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->metadata().statistics_position() > 0);
+  auto statistics = reader->page_table().GetStatistics(0, 1).value();
+  CHECK(statistics.null_count() == 0);
+  CHECK(statistics.row_count() == 25);
+
+  auto is_literal = [](const ::arrow::compute::Expression& expr, bool value) {
+    return expr.literal() != nullptr && expr.literal()->scalar()->is_valid &&
+           expr.literal()->scalar_as<::arrow::BooleanScalar>().value == value;
+  };
+
+  auto filter = lance::io::Filter::Make(reader->schema(),
+                                        ::arrow::compute::greater(field_ref("ts"), literal(1060)))
+                    .ValueOrDie();
+  CHECK(is_literal(filter->Simplify(*reader, 0).ValueOrDie(), false));
+  CHECK(is_literal(filter->Simplify(*reader, 1).ValueOrDie(), false));
+  CHECK(filter->Simplify(*reader, 2).ValueOrDie().call() != nullptr);
+  CHECK(is_literal(filter->Simplify(*reader, 3).ValueOrDie(), true));
+  std::vector<int64_t> num_rows;
+  for (int batch_id = 0; batch_id < 4; batch_id++) {
+    auto [indices, output] = filter->Execute(reader, batch_id).ValueOrDie();
+    CHECK(indices->length() == output->num_rows());
+    num_rows.emplace_back(output->num_rows());
+  }
+  CHECK(num_rows == std::vector<int64_t>({0, 0, 14, 25}));
+  auto [indices, output] = filter->Execute(reader, 3).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                               13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24})
+                            .ValueOrDie()));
+
+  // The score column has nulls in the first batch, and only nulls in the last batch.
+  filter = lance::io::Filter::Make(reader->schema(),
+                                   ::arrow::compute::less(field_ref("score"), literal(2.0)))
+               .ValueOrDie();
+  CHECK(filter->Simplify(*reader, 0).ValueOrDie().call() != nullptr);
+  CHECK(is_literal(filter->Simplify(*reader, 1).ValueOrDie(), false));
+  CHECK(!is_literal(filter->Simplify(*reader, 3).ValueOrDie(), true));
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({0, 1, 2, 3}).ValueOrDie()));
+  std::tie(indices, output) = filter->Execute(reader, 3).ValueOrDie();
+  CHECK(indices->length() == 0);
+
+  filter = lance::io::Filter::Make(reader->schema(),
+                                   ::arrow::compute::call("is_null", {field_ref("score")}))
+               .ValueOrDie();
+  CHECK(is_literal(filter->Simplify(*reader, 3).ValueOrDie(), true));
+  std::tie(indices, output) = filter->Execute(reader, 0).ValueOrDie();
+  CHECK(indices->Equals(lance::arrow::ToArray({10}).ValueOrDie()));
+}
+
+TEST_CASE("Skip batches by page Bloom filters") {
+  // 10 batches of 100 unordered ids, so that the min / max of every page cover most of the ids.
+  const int num_batches = 10;
+  const int batch_size = 100;
+  std::vector<int> ids(num_batches * batch_size);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+  auto schema = ::arrow::schema(
+      {::arrow::field("id", ::arrow::utf8()), ::arrow::field("value", ::arrow::int32())});
+  std::vector<std::shared_ptr<::arrow::Table>> tables;
+  for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+    ::arrow::StringBuilder id_builder;
+    ::arrow::Int32Builder value_builder;
+    for (int i = batch_id * batch_size; i < (batch_id + 1) * batch_size; i++) {
+      CHECK(id_builder.Append(fmt::format("id-{:04}", ids[i])).ok());
+      CHECK(value_builder.Append(ids[i]).ok());
+    }
+    tables.emplace_back(::arrow::Table::Make(
+        schema, {id_builder.Finish().ValueOrDie(), value_builder.Finish().ValueOrDie()}));
+  }
+  auto table = ::arrow::ConcatenateTables(tables).ValueOrDie();
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.bloom_filter_columns = {{"id", 0.01}, {"missing", 0.01}};
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).IsInvalid());
+
+  options.bloom_filter_columns = {{"id", 0.01}};
+  sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->metadata().bloom_filters_position() > 0);
+  CHECK(reader->GetBloomFilter(reader->schema().GetField("id"), 0).ValueOrDie() != nullptr);
+  CHECK(reader->GetBloomFilter(reader->schema().GetField("value"), 0).ValueOrDie() == nullptr);
+
+  // Returns the number of batches that may match, and the values of the matched rows.
+  auto execute = [&](const ::arrow::compute::Expression& expr) {
+    auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+    int num_may_match = 0;
+    std::vector<int32_t> values;
+    for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+      num_may_match += filter->MayMatch(*reader, batch_id).ValueOrDie();
+      auto [indices, output] = filter->Execute(reader, batch_id).ValueOrDie();
+      CHECK(indices->length() == output->num_rows());
+      for (int64_t i = 0; i < indices->length(); i++) {
+        values.emplace_back(ids[batch_id * batch_size + indices->Value(i)]);
+      }
+    }
+    std::sort(values.begin(), values.end());
+    return std::make_tuple(num_may_match, values);
+  };
+
+  auto [num_may_match, values] = execute(equal(field_ref("id"), literal("id-0123")));
+  CHECK(num_may_match >= 1);
+  CHECK(num_may_match <= 2);
+  CHECK(values == std::vector<int32_t>({123}));
+
+  std::tie(num_may_match, values) = execute(equal(field_ref("id"), literal("id-9999")));
+  CHECK(num_may_match <= 1);
+  CHECK(values.empty());
+
+  auto value_set = lance::arrow::ToArray({"id-0007", "id-0500", "id-5000"}).ValueOrDie();
+  std::tie(num_may_match, values) = execute(::arrow::compute::call(
+      "is_in", {field_ref("id")}, ::arrow::compute::SetLookupOptions(value_set)));
+  CHECK(num_may_match >= 1);
+  CHECK(num_may_match <= 4);
+  CHECK(values == std::vector<int32_t>({7, 500}));
+
+  // Bloom filters are only checked on the conjunctions.
+  std::tie(num_may_match, values) =
+      execute(::arrow::compute::and_(equal(field_ref("id"), literal("id-0042")),
+                                     ::arrow::compute::greater(field_ref("value"), literal(10))));
+  CHECK(num_may_match <= 2);
+  CHECK(values == std::vector<int32_t>({42}));
+  std::tie(num_may_match, values) = execute(
+      or_(equal(field_ref("id"), literal("id-0042")), equal(field_ref("value"), literal(10))));
+  CHECK(num_may_match == num_batches);
+  CHECK(values == std::vector<int32_t>({10, 42}));
+}
+
+TEST_CASE("Filter over dictionary codes") {
+  auto type = ::arrow::dictionary(::arrow::int8(), ::arrow::utf8());
+  auto dict = lance::arrow::ToArray({"cat", "dog", "fox"}).ValueOrDie();
+  ::arrow::Int8Builder codes_builder;
+  for (auto code : {0, 1, -1, 2, 1, 0, 1, -1}) {
+    CHECK((code < 0 ? codes_builder.AppendNull() : codes_builder.Append(code)).ok());
+  }
+  auto labels = ::arrow::DictionaryArray::FromArrays(
+                    type, codes_builder.Finish().ValueOrDie(), dict)
+                    .ValueOrDie();
+  auto values = lance::arrow::ToArray({0, 1, 2, 3, 4, 5, 6, 7}).ValueOrDie();
+  auto schema =
+      ::arrow::schema({::arrow::field("label", type), ::arrow::field("value", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(schema, {labels, values});
+  table = ::arrow::ConcatenateTables({table->Slice(0, 4), table->Slice(4)}).ValueOrDie();
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("label")->encoding() == lance::format::pb::Encoding::DICTIONARY);
+
+  // Returns the matched indices of each batch.
+  auto execute = [&](const ::arrow::compute::Expression& expr) {
+    auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+    std::vector<std::vector<int32_t>> matched;
+    for (int batch_id = 0; batch_id < 2; batch_id++) {
+      auto [indices, output] = filter->Execute(reader, batch_id).ValueOrDie();
+      CHECK(indices->length() == output->num_rows());
+      matched.emplace_back(indices->raw_values(), indices->raw_values() + indices->length());
+    }
+    return matched;
+  };
+  using Matched = std::vector<std::vector<int32_t>>;
+
+  CHECK(execute(equal(field_ref("label"), literal("dog"))) == Matched({{1}, {0, 2}}));
+  CHECK(execute(equal(literal("cat"), field_ref("label"))) == Matched({{0}, {1}}));
+  CHECK(execute(::arrow::compute::not_equal(field_ref("label"), literal("dog"))) ==
+        Matched({{0, 3}, {1}}));
+  auto value_set = lance::arrow::ToArray({"fox", "cat", "bird"}).ValueOrDie();
+  CHECK(execute(::arrow::compute::call("is_in",
+                                       {field_ref("label")},
+                                       ::arrow::compute::SetLookupOptions(value_set))) ==
+        Matched({{0, 3}, {1}}));
+
+  // Literals that are not in the dictionary.
+  CHECK(execute(equal(field_ref("label"), literal("bird"))) == Matched({{}, {}}));
+  CHECK(execute(::arrow::compute::not_equal(field_ref("label"), literal("bird"))) ==
+        Matched({{0, 1, 3}, {0, 1, 2}}));
+
+  // The matched values are decoded.
+  auto filter =
+      lance::io::Filter::Make(reader->schema(), equal(field_ref("label"), literal("fox")))
+          .ValueOrDie();
+  auto [indices, output] = filter->Execute(reader, 0).ValueOrDie();
+  auto actual = ::arrow::compute::Cast(output->GetColumnByName("label"), ::arrow::utf8())
+                    .ValueOrDie()
+                    .make_array();
+  CHECK(actual->Equals(lance::arrow::ToArray({"fox"}).ValueOrDie()));
+}
+
+TEST_CASE("Evaluate conjunctions in stages") {
+  const int num_batches = 8;
+  const int batch_size = 50;
+  ::arrow::Int32Builder score_builder;
+  ::arrow::StringBuilder caption_builder;
+  for (int i = 0; i < num_batches * batch_size; i++) {
+    CHECK(score_builder.Append(i % 100).ok());
+    CHECK(caption_builder.Append(i % 7 == 0 ? fmt::format("a dog {}", i) : "a cat").ok());
+  }
+  auto schema = ::arrow::schema(
+      {::arrow::field("score", ::arrow::int32()), ::arrow::field("caption", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(
+      schema, {score_builder.Finish().ValueOrDie(), caption_builder.Finish().ValueOrDie()});
+  std::vector<std::shared_ptr<::arrow::Table>> slices;
+  for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+    slices.emplace_back(table->Slice(batch_id * batch_size, batch_size));
+  }
+  table = ::arrow::ConcatenateTables(slices).ValueOrDie();
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+
+  auto contains_dog = ::arrow::compute::call(
+      "match_substring", {field_ref("caption")}, ::arrow::compute::MatchSubstringOptions("dog"));
+  auto check_results = [&](const lance::io::Filter& filter, auto&& predicate) {
+    for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+      auto [indices, output] = filter.Execute(reader, batch_id).ValueOrDie();
+      std::vector<int32_t> expected;
+      for (int i = 0; i < batch_size; i++) {
+        if (predicate(batch_id * batch_size + i)) {
+          expected.emplace_back(i);
+        }
+      }
+      INFO("Batch: " << batch_id);
+      auto actual =
+          std::vector<int32_t>(indices->raw_values(), indices->raw_values() + indices->length());
+      CHECK(actual == expected);
+      CHECK(output->num_rows() == indices->length());
+      CHECK(output->num_columns() == 2);
+      auto scores =
+          std::static_pointer_cast<::arrow::Int32Array>(output->GetColumnByName("score"));
+      for (int64_t i = 0; i < indices->length(); i++) {
+        CHECK(scores->Value(i) == (batch_id * batch_size + indices->Value(i)) % 100);
+      }
+    }
+  };
+
+  // The column of the first stage.
+  auto first_stage = [](const lance::io::Filter& filter) {
+    return *::arrow::compute::FieldsInExpression(filter.GetStages()[0])[0].name();
+  };
+
+  // The integer predicate is cheaper to read, so it runs first.
+  auto filter =
+      lance::io::Filter::Make(
+          reader->schema(),
+          ::arrow::compute::and_(contains_dog,
+                                 ::arrow::compute::greater(field_ref("score"), literal(90))))
+          .ValueOrDie();
+  CHECK(filter->GetStages().size() == 2);
+  CHECK(first_stage(*filter) == "score");
+  check_results(*filter, [](int i) { return i % 7 == 0 && i % 100 > 90; });
+  CHECK(first_stage(*filter) == "score");
+
+  // The integer predicate passes all the rows, so the selective string predicate runs first
+  // once the pass rates are observed.
+  filter = lance::io::Filter::Make(
+               reader->schema(),
+               ::arrow::compute::and_(::arrow::compute::greater_equal(field_ref("score"),
+                                                                      literal(0)),
+                                      contains_dog))
+               .ValueOrDie();
+  CHECK(first_stage(*filter) == "score");
+  check_results(*filter, [](int i) { return i % 7 == 0; });
+  CHECK(first_stage(*filter) == "caption");
+  check_results(*filter, [](int i) { return i % 7 == 0; });
+
+  // Predicates over one column are evaluated at once.
+  filter = lance::io::Filter::Make(
+               reader->schema(),
+               ::arrow::compute::and_(::arrow::compute::greater(field_ref("score"), literal(10)),
+                                      ::arrow::compute::less(field_ref("score"), literal(20))))
+               .ValueOrDie();
+  CHECK(filter->GetStages().empty());
+}
+
+TEST_CASE("Look up primary keys with the index") {
+  const int num_batches = 4;
+  const int batch_size = 50;
+  std::vector<int64_t> ids(num_batches * batch_size);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+  std::vector<int32_t> values;
+  for (auto id : ids) {
+    values.emplace_back(id % 10);
+  }
+  auto schema = ::arrow::schema(
+      {::arrow::field("id", ::arrow::int64()), ::arrow::field("value", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(
+      schema,
+      {lance::arrow::ToArray(ids).ValueOrDie(), lance::arrow::ToArray(values).ValueOrDie()});
+  std::vector<std::shared_ptr<::arrow::Table>> tables;
+  for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+    tables.emplace_back(table->Slice(batch_id * batch_size, batch_size));
+  }
+  table = ::arrow::ConcatenateTables(tables).ValueOrDie();
+
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "id").ok());
+  auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->primary_key_index() != nullptr);
+
+  // Returns the ids of the matched rows, and checks the output values.
+  auto execute = [&](const ::arrow::compute::Expression& expr) {
+    auto filter = lance::io::Filter::Make(reader->schema(), expr).ValueOrDie();
+    std::vector<int64_t> matched;
+    for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+      auto [indices, output] = filter->Execute(reader, batch_id).ValueOrDie();
+      CHECK(indices->length() == output->num_rows());
+      for (int64_t i = 0; i < indices->length(); i++) {
+        auto id = ids[batch_id * batch_size + indices->Value(i)];
+        auto id_column = output->GetColumnByName("id");
+        if (id_column) {
+          CHECK(std::static_pointer_cast<::arrow::Int64Array>(id_column)->Value(i) == id);
+        }
+        matched.emplace_back(id);
+      }
+    }
+    std::sort(matched.begin(), matched.end());
+    return matched;
+  };
+
+  CHECK(execute(equal(field_ref("id"), literal(int64_t{123}))) == std::vector<int64_t>({123}));
+  // The literal is casted to the type of the primary key.
+  CHECK(execute(equal(field_ref("id"), literal(77))) == std::vector<int64_t>({77}));
+  CHECK(execute(equal(field_ref("id"), literal(int64_t{1000}))).empty());
+
+  auto value_set = lance::arrow::ToArray<int64_t>({3, 42, 199, 5000}).ValueOrDie();
+  auto is_in = ::arrow::compute::call(
+      "is_in", {field_ref("id")}, ::arrow::compute::SetLookupOptions(value_set));
+  CHECK(execute(is_in) == std::vector<int64_t>({3, 42, 199}));
+  // The rest of the conjunction is evaluated over the rows of the keys.
+  CHECK(execute(::arrow::compute::and_(is_in, equal(field_ref("value"), literal(2)))) ==
+        std::vector<int64_t>({42}));
+}
+
+TEST_CASE("Filter with bitmap indices") {
+  const int num_batches = 3;
+  const int batch_size = 100;
+  ::arrow::StringBuilder split_builder;
+  ::arrow::Int32Builder label_builder;
+  ::arrow::Int32Builder value_builder;
+  ::arrow::Int8Builder source_builder;
+  ::arrow::DoubleBuilder score_builder;
+  std::mt19937 gen(42);
+  for (int i = 0; i < num_batches * batch_size; i++) {
+    auto split = gen() % 10;
+    CHECK(split_builder.Append(split < 8 ? "train" : (split == 8 ? "val" : "test")).ok());
+    if (i % 23 == 0) {
+      CHECK(label_builder.AppendNull().ok());
+    } else {
+      CHECK(label_builder.Append(gen() % 5).ok());
+    }
+    CHECK(value_builder.Append(i).ok());
+    CHECK(source_builder.Append(gen() % 3).ok());
+    CHECK(score_builder.Append(i * 0.5).ok());
+  }
+  auto source_type = ::arrow::dictionary(::arrow::int8(), ::arrow::utf8());
+  auto sources = ::arrow::DictionaryArray::FromArrays(
+                     source_type,
+                     source_builder.Finish().ValueOrDie(),
+                     lance::arrow::ToArray({"web", "book", "news"}).ValueOrDie())
+                     .ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("split", ::arrow::utf8()),
+                                 ::arrow::field("label", ::arrow::int32()),
+                                 ::arrow::field("value", ::arrow::int32()),
+                                 ::arrow::field("source", source_type),
+                                 ::arrow::field("score", ::arrow::float64())});
+  auto table = ::arrow::Table::Make(schema,
+                                    {split_builder.Finish().ValueOrDie(),
+                                     label_builder.Finish().ValueOrDie(),
+                                     value_builder.Finish().ValueOrDie(),
+                                     sources,
+                                     score_builder.Finish().ValueOrDie()});
+  std::vector<std::shared_ptr<::arrow::Table>> tables;
+  for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+    tables.emplace_back(table->Slice(batch_id * batch_size, batch_size));
+  }
+  table = ::arrow::ConcatenateTables(tables).ValueOrDie();
+
+  auto write = [&](const std::vector<std::string>& indexed_columns,
+                   const std::shared_ptr<::arrow::io::OutputStream>& sink) {
+    auto options = lance::arrow::FileWriteOptions();
+    options.bitmap_index_columns = indexed_columns;
+    return lance::arrow::WriteTable(*table, sink, "", options);
+  };
+  auto open = [&](const std::vector<std::string>& indexed_columns) {
+    auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+    CHECK(write(indexed_columns, sink).ok());
+    auto infile = std::make_shared<::arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+    auto reader = std::make_shared<lance::io::FileReader>(infile);
+    CHECK(reader->Open().ok());
+    return reader;
+  };
+  // The indexed columns must exist and be supported.
+  auto sink = ::arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(write({"split", "missing"}, sink).IsInvalid());
+  CHECK(write({"split", "score"}, sink).IsInvalid());
+
+  auto reader = open({"split", "label", "source"});
+  auto baseline = open({});
+  CHECK(reader->GetBitmapIndex(reader->schema().GetField("split")) != nullptr);
+  CHECK(reader->GetBitmapIndex(reader->schema().GetField("label")) != nullptr);
+  CHECK(reader->GetBitmapIndex(reader->schema().GetField("source")) != nullptr);
+  CHECK(reader->GetBitmapIndex(reader->schema().GetField("value")) == nullptr);
+  CHECK(baseline->GetBitmapIndex(baseline->schema().GetField("split")) == nullptr);
+
+  // Returns the values of the matched rows.
+  auto execute = [&](const std::shared_ptr<lance::io::FileReader>& file,
+                     const ::arrow::compute::Expression& expr) {
+    auto projection = file->schema().Project({"value"}).ValueOrDie();
+    auto filter = lance::io::Filter::Make(file->schema(), expr, projection).ValueOrDie();
+    std::vector<int32_t> values;
+    for (int batch_id = 0; batch_id < num_batches; batch_id++) {
+      auto [indices, output] = filter->Execute(file, batch_id).ValueOrDie();
+      CHECK(indices->length() == output->num_rows());
+      for (int64_t i = 0; i < indices->length(); i++) {
+        values.emplace_back(batch_id * batch_size + indices->Value(i));
+      }
+    }
+    return values;
+  };
+
+  auto value_set = lance::arrow::ToArray({1, 3}).ValueOrDie();
+  auto label_in = ::arrow::compute::call(
+      "is_in", {field_ref("label")}, ::arrow::compute::SetLookupOptions(value_set));
+  for (auto& expr : std::vector<::arrow::compute::Expression>{
+           equal(field_ref("split"), literal("val")),
+           equal(field_ref("split"), literal("none")),
+           equal(field_ref("source"), literal("news")),
+           label_in,
+           ::arrow::compute::and_(equal(field_ref("source"), literal("book")), label_in),
+           ::arrow::compute::and_(equal(field_ref("split"), literal("test")), label_in),
+           or_(equal(field_ref("split"), literal("test")), equal(field_ref("label"), literal(2))),
+           // Only the indexed members of a conjunction are evaluated by the indices.
+           ::arrow::compute::and_(equal(field_ref("split"), literal("train")),
+                                  ::arrow::compute::less(field_ref("value"), literal(150))),
+           // A disjunction with members that are not indexed.
+           or_(equal(field_ref("split"), literal("val")),
+               ::arrow::compute::less(field_ref("value"), literal(10))),
+       }) {
+    INFO("Filter: " << expr.ToString());
+    auto expected = execute(baseline, expr);
+    CHECK(execute(reader, expr) == expected);
+  }
+  CHECK(execute(reader, equal(field_ref("split"), literal("none"))).empty());
+  CHECK(!execute(reader, equal(field_ref("split"), literal("val"))).empty());
+}
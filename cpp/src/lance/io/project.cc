@@ -43,6 +43,8 @@ Project::Project(std::shared_ptr<format::Schema> dataset_schema,
     std::shared_ptr<::arrow::dataset::ScanOptions> scan_options,
     std::optional<int32_t> limit,
     int32_t offset) {
+  // Output all the filter columns, because the scan node of Arrow evaluates the filter again
+  // over the batches of the fragments.
   ARROW_ASSIGN_OR_RAISE(auto filter, Filter::Make(*schema, scan_options->filter));
   auto projected_arrow_schema = scan_options->projected_schema;
   if (projected_arrow_schema->num_fields() == 0) {
@@ -82,7 +84,12 @@ bool Project::CanParallelScan() const { return limit_.operator bool(); }
           std::static_pointer_cast<decltype(indices)::element_type>(indices->Slice(offset, len));
       values = values->Slice(offset, len);
     }
-    ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadBatch(*scan_schema_, batch_id, indices));
+    std::shared_ptr<::arrow::RecordBatch> batch;
+    if (indices->length() == 0) {
+      ARROW_ASSIGN_OR_RAISE(batch, ::arrow::RecordBatch::MakeEmpty(scan_schema_->ToArrow()));
+    } else {
+      ARROW_ASSIGN_OR_RAISE(batch, reader->ReadBatch(*scan_schema_, batch_id, indices));
+    }
     assert(values->num_rows() == batch->num_rows());
     ARROW_ASSIGN_OR_RAISE(auto merged, lance::arrow::MergeRecordBatches(values, batch));
     return merged;
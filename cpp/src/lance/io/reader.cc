@@ -15,24 +15,37 @@
 #include "lance/io/reader.h"
 
 #include <arrow/array/concatenate.h>
+#include <arrow/builder.h>
+#include <arrow/compute/api.h>
 #include <arrow/result.h>
 #include <arrow/status.h>
 #include <arrow/table.h>
 #include <arrow/type.h>
+#include <arrow/type_traits.h>
+#include <arrow/visit_type_inline.h>
+#include <arrow/util/bit_util.h>
+#include <arrow/util/bitmap_ops.h>
 #include <fmt/format.h>
 
 #include <algorithm>
 #include <cstdint>
 #include <future>
+#include <limits>
 #include <memory>
 
+#include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
 #include "lance/encodings/binary.h"
+#include "lance/encodings/blob.h"
+#include "lance/encodings/kernels.h"
 #include "lance/encodings/plain.h"
+#include "lance/format/bitmap_index.h"
+#include "lance/format/bloom_filter.h"
 #include "lance/format/format.h"
 #include "lance/format/manifest.h"
 #include "lance/format/metadata.h"
 #include "lance/format/page_table.h"
+#include "lance/format/primary_key_index.h"
 #include "lance/format/schema.h"
 #include "lance/io/endian.h"
 
@@ -47,6 +60,88 @@ typedef ::arrow::Result<std::shared_ptr<::arrow::Scalar>> ScalarResult;
 
 namespace lance::io {
 
+namespace {
+
+/// Find one key in the entries of each map, i.e., `attrs['camera_model']`.
+///
+/// The keys of a map are searched with binary search if they are sorted within each map
+/// (`MapType::keys_sorted()`), or scanned otherwise.
+class MapKeyFinder {
+ public:
+  /// \param keys the keys of all the entries.
+  /// \param key the key to find, of the same type as `keys`.
+  /// \param keys_sorted whether the keys are sorted within each map.
+  /// \param entries the `[begin, end)` range in `keys` of each map.
+  MapKeyFinder(const ::arrow::Array& keys,
+               const ::arrow::Scalar& key,
+               bool keys_sorted,
+               const std::vector<std::pair<int64_t, int64_t>>& entries)
+      : keys_(keys), key_(key), keys_sorted_(keys_sorted), entries_(entries) {}
+
+  template <typename T>
+  ::arrow::Status Visit(const T& type) {
+    if constexpr (::arrow::is_number_type<T>::value || ::arrow::is_base_binary_type<T>::value) {
+      using ArrayType = typename ::arrow::TypeTraits<T>::ArrayType;
+      using ScalarType = typename ::arrow::TypeTraits<T>::ScalarType;
+      const auto& keys = static_cast<const ArrayType&>(keys_);
+      const auto& scalar = static_cast<const ScalarType&>(key_);
+      if constexpr (::arrow::is_base_binary_type<T>::value) {
+        return Find(keys, scalar.view());
+      } else {
+        return Find(keys, scalar.value);
+      }
+    }
+    return ::arrow::Status::NotImplemented(
+        fmt::format("Lookup by key of type {} is not supported", type.ToString()));
+  }
+
+  /// The position of the key in `keys` for each map, or `std::nullopt` if it is not found.
+  const std::vector<std::optional<int64_t>>& positions() const { return positions_; }
+
+ private:
+  template <typename ArrayType, typename ValueType>
+  ::arrow::Status Find(const ArrayType& keys, const ValueType& value) {
+    positions_.clear();
+    positions_.reserve(entries_.size());
+    for (auto [begin, end] : entries_) {
+      std::optional<int64_t> pos;
+      if (keys_sorted_) {
+        // Lower bound of the key.
+        auto lo = begin;
+        auto hi = end;
+        while (lo < hi) {
+          auto mid = lo + (hi - lo) / 2;
+          if (keys.GetView(mid) < value) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        if (lo < end && keys.GetView(lo) == value) {
+          pos = lo;
+        }
+      } else {
+        for (auto i = begin; i < end; i++) {
+          if (keys.GetView(i) == value) {
+            pos = i;
+            break;
+          }
+        }
+      }
+      positions_.emplace_back(pos);
+    }
+    return ::arrow::Status::OK();
+  }
+
+  const ::arrow::Array& keys_;
+  const ::arrow::Scalar& key_;
+  bool keys_sorted_;
+  const std::vector<std::pair<int64_t, int64_t>>& entries_;
+  std::vector<std::optional<int64_t>> positions_;
+};
+
+}  // namespace
+
 ::arrow::Result<int64_t> ReadFooter(const std::shared_ptr<::arrow::Buffer>& buf) {
   assert(buf->size() >= 16);
   if (auto magic_buf = ::arrow::SliceBuffer(buf, buf->size() - 4);
@@ -91,6 +186,32 @@ Status FileReader::Open() {
   ARROW_ASSIGN_OR_RAISE(
       page_table_,
       format::PageTable::Make(file_, metadata_->page_table_position(), num_columns, num_batches));
+  if (metadata_->validity_table_position() > 0) {
+    ARROW_RETURN_NOT_OK(page_table_->ReadValidity(
+        file_, metadata_->validity_table_position(), num_columns, num_batches));
+  }
+  if (metadata_->encoding_table_position() > 0) {
+    ARROW_RETURN_NOT_OK(page_table_->ReadEncodings(
+        file_, metadata_->encoding_table_position(), num_columns, num_batches));
+  }
+  if (metadata_->statistics_position() > 0) {
+    ARROW_RETURN_NOT_OK(page_table_->ReadStatistics(file_, metadata_->statistics_position()));
+  }
+  if (metadata_->bloom_filters_position() > 0) {
+    ARROW_RETURN_NOT_OK(
+        page_table_->ReadBloomFilters(file_, metadata_->bloom_filters_position()));
+  }
+  if (metadata_->primary_key_index_position() > 0) {
+    ARROW_ASSIGN_OR_RAISE(primary_key_index_,
+                          format::PrimaryKeyIndex::Read(file_,
+                                                        metadata_->primary_key_index_position(),
+                                                        manifest_->schema()));
+  }
+  for (auto position : metadata_->bitmap_index_positions()) {
+    ARROW_ASSIGN_OR_RAISE(auto index,
+                          format::BitmapIndex::Read(file_, position, manifest_->schema()));
+    bitmap_indices_[index->field()->id()] = index;
+  }
   return Status::OK();
 }
 
@@ -100,30 +221,281 @@ const lance::format::Manifest& FileReader::manifest() const { return *manifest_;
 
 const lance::format::Metadata& FileReader::metadata() const { return *metadata_; }
 
+const lance::format::PageTable& FileReader::page_table() const { return *page_table_; }
+
+const std::shared_ptr<lance::format::PrimaryKeyIndex>& FileReader::primary_key_index() const {
+  return primary_key_index_;
+}
+
+namespace {
+
+/// Set the validity bitmap of an array.
+///
+/// \param arr the array decoded from the page.
+/// \param bitmap validity bitmap, starting at the first element of the array. Can be nullptr.
+/// \param pool memory pool.
+::arrow::Result<std::shared_ptr<::arrow::Array>> WithValidity(
+    const std::shared_ptr<::arrow::Array>& arr,
+    std::shared_ptr<::arrow::Buffer> bitmap,
+    ::arrow::MemoryPool* pool) {
+  if (!bitmap) {
+    return arr;
+  }
+  auto data = arr->data()->Copy();
+  if (data->offset != 0) {
+    ARROW_ASSIGN_OR_RAISE(auto shifted,
+                          ::arrow::AllocateEmptyBitmap(data->offset + data->length, pool));
+    ::arrow::internal::CopyBitmap(
+        bitmap->data(), 0, data->length, shifted->mutable_data(), data->offset);
+    bitmap = std::move(shifted);
+  }
+  data->buffers[0] = std::move(bitmap);
+  data->null_count = ::arrow::kUnknownNullCount;
+  return ::arrow::MakeArray(data);
+}
+
+}  // namespace
+
+int32_t FileReader::GetReadLength(int32_t batch_id, const ArrayReadParams& params) const {
+  if (params.indices.has_value()) {
+    return static_cast<int32_t>(params.indices.value()->length());
+  }
+  return params.length.value_or(metadata_->GetBatchLength(batch_id) - params.offset.value());
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> FileReader::GetValidityBitmap(
+    const std::shared_ptr<lance::format::Field>& field,
+    int32_t batch_id,
+    const ArrayReadParams& params) const {
+  auto validity = page_table_->GetValidity(field->id(), batch_id);
+  if (validity == format::PageTable::kNoNulls) {
+    return nullptr;
+  }
+  auto length = GetReadLength(batch_id, params);
+  if (validity == format::PageTable::kAllNull) {
+    return ::arrow::AllocateEmptyBitmap(length, pool_);
+  }
+  if (params.indices.has_value()) {
+    auto& indices = params.indices.value();
+    ARROW_ASSIGN_OR_RAISE(auto bitmap, ::arrow::AllocateEmptyBitmap(length, pool_));
+    if (length == 0) {
+      return bitmap;
+    }
+    int32_t first_byte = indices->Value(0) / 8;
+    int32_t last_byte = indices->Value(indices->length() - 1) / 8;
+    ARROW_ASSIGN_OR_RAISE(auto buf,
+                          file_->ReadAt(validity + first_byte, last_byte - first_byte + 1));
+    lance::encodings::kernels::GatherBits(buf->data(),
+                                          buf->size(),
+                                          indices->raw_values(),
+                                          length,
+                                          first_byte * 8,
+                                          bitmap->mutable_data());
+    return bitmap;
+  }
+  auto start = params.offset.value();
+  auto first_byte = start / 8;
+  auto num_bytes = ::arrow::bit_util::BytesForBits(start + length) - first_byte;
+  ARROW_ASSIGN_OR_RAISE(auto buf, file_->ReadAt(validity + first_byte, num_bytes));
+  if (start % 8 == 0) {
+    return buf;
+  }
+  return ::arrow::internal::CopyBitmap(pool_, buf->data(), start % 8, length);
+}
+
+::arrow::Result<bool> FileReader::IsNull(const std::shared_ptr<lance::format::Field>& field,
+                                         int32_t batch_id,
+                                         int32_t idx) const {
+  auto validity = page_table_->GetValidity(field->id(), batch_id);
+  if (validity == format::PageTable::kNoNulls) {
+    return false;
+  } else if (validity == format::PageTable::kAllNull) {
+    return true;
+  }
+  uint8_t byte;
+  ARROW_RETURN_NOT_OK(file_->ReadAt(validity + idx / 8, 1, &byte));
+  return !::arrow::bit_util::GetBit(&byte, idx % 8);
+}
+
 ::arrow::Result<::std::shared_ptr<::arrow::Scalar>> FileReader::GetScalar(
     const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const {
   if (field->logical_type() == "struct") {
     return GetStructScalar(field, batch_id, idx);
-  } else if (field->logical_type() == "list" || field->logical_type() == "list.struct") {
+  } else if (is_list(field->type())) {
     return GetListScalar(field, batch_id, idx);
+  } else if (lance::arrow::is_map(field->type())) {
+    ARROW_ASSIGN_OR_RAISE(auto arr, GetMapArray(field, batch_id, ArrayReadParams(idx, 1)));
+    return arr->GetScalar(0);
   } else {
     return GetPrimitiveScalar(field, batch_id, idx);
   }
 }
 
-::arrow::Result<::std::shared_ptr<::arrow::Scalar>> FileReader::GetPrimitiveScalar(
-    const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const {
-  auto field_id = field->id();
-  ARROW_ASSIGN_OR_RAISE(auto decoder, field->GetDecoder(file_));
-  ARROW_ASSIGN_OR_RAISE(auto page, GetPageInfo(field_id, batch_id));
+::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> FileReader::GetDecoder(
+    const std::shared_ptr<lance::format::Field>& field, int32_t batch_id) const {
+  ARROW_ASSIGN_OR_RAISE(auto page, GetPageInfo(field->id(), batch_id));
   auto [pos, length] = page;
+  ARROW_ASSIGN_OR_RAISE(auto decoder,
+                        field->GetDecoder(file_, page_table_->GetEncoding(field->id(), batch_id)));
   decoder->Reset(pos, length);
+  return decoder;
+}
+
+::arrow::Result<std::shared_ptr<lance::format::BloomFilter>> FileReader::GetBloomFilter(
+    const std::shared_ptr<lance::format::Field>& field, int32_t batch_id) const {
+  auto page = page_table_->GetBloomFilter(field->id(), batch_id);
+  if (!page.has_value()) {
+    return nullptr;
+  }
+  auto size = page->num_blocks() * lance::format::BloomFilter::kBlockSize;
+  ARROW_ASSIGN_OR_RAISE(auto blocks, file_->ReadAt(page->position(), size));
+  return lance::format::BloomFilter::Make(blocks, pool_);
+}
+
+::arrow::Result<std::vector<std::optional<lance::encodings::BlobHandle>>> FileReader::GetBlobs(
+    const std::string& column,
+    int32_t batch_id,
+    std::optional<std::shared_ptr<::arrow::Int32Array>> indices) const {
+  auto field = schema().GetField(column);
+  if (!field || field->encoding() != lance::format::pb::Encoding::BLOB) {
+    return Status::Invalid(fmt::format("Column {} is not a blob column", column));
+  }
+  auto params = indices.has_value() ? ArrayReadParams(indices.value()) : ArrayReadParams(0);
+  auto length = GetReadLength(batch_id, params);
+  std::vector<std::optional<lance::encodings::BlobHandle>> blobs(length);
+  if (length == 0 ||
+      page_table_->GetValidity(field->id(), batch_id) == format::PageTable::kAllNull) {
+    return blobs;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetDecoder(field, batch_id));
+  auto blob_decoder = std::dynamic_pointer_cast<lance::encodings::BlobDecoder>(decoder);
+  std::vector<lance::encodings::BlobHandle> handles;
+  if (indices.has_value()) {
+    ARROW_ASSIGN_OR_RAISE(handles, blob_decoder->GetBlobs(indices.value()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(handles, blob_decoder->GetBlobs(0, length));
+  }
+  ARROW_ASSIGN_OR_RAISE(auto validity, GetValidityBitmap(field, batch_id, params));
+  for (int32_t i = 0; i < length; i++) {
+    if (!validity || ::arrow::bit_util::GetBit(validity->data(), i)) {
+      blobs[i] = handles[i];
+    }
+  }
+  return blobs;
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetMapValues(
+    const std::string& column,
+    int32_t batch_id,
+    const ::arrow::Scalar& key,
+    std::optional<std::shared_ptr<::arrow::Int32Array>> indices) const {
+  auto field = schema().GetField(column);
+  if (!field || !lance::arrow::is_map(field->type())) {
+    return Status::Invalid(fmt::format("Column {} is not a map column", column));
+  }
+  auto map_type = std::static_pointer_cast<::arrow::MapType>(field->type());
+  auto params = indices.has_value() ? ArrayReadParams(indices.value()) : ArrayReadParams(0);
+  auto length = GetReadLength(batch_id, params);
+  if (length == 0 || !key.is_valid ||
+      page_table_->GetValidity(field->id(), batch_id) == format::PageTable::kAllNull) {
+    return ::arrow::MakeArrayOfNull(map_type->item_type(), length, pool_);
+  }
+  std::shared_ptr<::arrow::Scalar> casted_key;
+  if (!key.type->Equals(map_type->key_type())) {
+    ARROW_ASSIGN_OR_RAISE(casted_key, key.CastTo(map_type->key_type()));
+  }
+  const auto& lookup_key = casted_key ? *casted_key : key;
+
+  // Read the offsets and the keys of the rows covering all the requested rows.
+  int32_t start = indices.has_value() ? indices.value()->Value(0) : 0;
+  int32_t num_rows = indices.has_value() ? indices.value()->Value(length - 1) - start + 1 : length;
+  ARROW_ASSIGN_OR_RAISE(auto offsets_arr, GetOffsets(field, batch_id, start, num_rows));
+  auto offsets = std::static_pointer_cast<::arrow::Int32Array>(offsets_arr);
+  auto start_pos = offsets->Value(0);
+  ARROW_ASSIGN_OR_RAISE(
+      auto keys,
+      GetArray(field->field(0),
+               batch_id,
+               ArrayReadParams(start_pos, offsets->Value(num_rows) - start_pos)));
+  ARROW_ASSIGN_OR_RAISE(auto validity,
+                        GetValidityBitmap(field, batch_id, ArrayReadParams(start, num_rows)));
+  std::vector<std::pair<int64_t, int64_t>> entries(length);
+  for (int32_t i = 0; i < length; i++) {
+    auto row = (indices.has_value() ? indices.value()->Value(i) : i) - start;
+    if (!validity || ::arrow::bit_util::GetBit(validity->data(), row)) {
+      entries[i] = {offsets->Value(row) - start_pos, offsets->Value(row + 1) - start_pos};
+    }
+  }
+  MapKeyFinder finder(*keys, lookup_key, map_type->keys_sorted(), entries);
+  ARROW_RETURN_NOT_OK(::arrow::VisitTypeInline(*keys->type(), &finder));
+
+  // Only read the values of the matched entries.
+  ::arrow::Int32Builder value_indices;
+  ::arrow::Int32Builder take_indices;
+  for (auto pos : finder.positions()) {
+    if (pos.has_value()) {
+      ARROW_RETURN_NOT_OK(take_indices.Append(static_cast<int32_t>(value_indices.length())));
+      ARROW_RETURN_NOT_OK(value_indices.Append(static_cast<int32_t>(start_pos + pos.value())));
+    } else {
+      ARROW_RETURN_NOT_OK(take_indices.AppendNull());
+    }
+  }
+  if (value_indices.length() == 0) {
+    return ::arrow::MakeArrayOfNull(map_type->item_type(), length, pool_);
+  }
+  std::shared_ptr<::arrow::Int32Array> value_indices_arr;
+  ARROW_RETURN_NOT_OK(value_indices.Finish(&value_indices_arr));
+  ARROW_ASSIGN_OR_RAISE(auto values,
+                        GetArray(field->field(1), batch_id, ArrayReadParams(value_indices_arr)));
+  ARROW_ASSIGN_OR_RAISE(auto take_indices_arr, take_indices.Finish());
+  ARROW_ASSIGN_OR_RAISE(auto datum, ::arrow::compute::Take(values, take_indices_arr));
+  return datum.make_array();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Scalar>> FileReader::GetMapValue(
+    int32_t idx, const std::string& column, const ::arrow::Scalar& key) const {
+  ARROW_ASSIGN_OR_RAISE(auto batch, metadata_->LocateBatch(idx));
+  auto [batch_id, idx_in_batch] = batch;
+  ARROW_ASSIGN_OR_RAISE(auto indices, lance::arrow::ToArray({idx_in_batch}));
+  ARROW_ASSIGN_OR_RAISE(auto values, GetMapValues(column, batch_id, key, indices));
+  return values->GetScalar(0);
+}
+
+::arrow::Result<::std::shared_ptr<::arrow::Scalar>> FileReader::GetPrimitiveScalar(
+    const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const {
+  ARROW_ASSIGN_OR_RAISE(auto is_null, IsNull(field, batch_id, idx));
+  if (is_null) {
+    return ::arrow::MakeNullScalar(field->type());
+  }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetDecoder(field, batch_id));
   return decoder->GetScalar(idx);
 }
 
 ::arrow::Result<::std::shared_ptr<::arrow::Scalar>> FileReader::GetStructScalar(
     const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const {
+  ARROW_ASSIGN_OR_RAISE(auto is_null, IsNull(field, batch_id, idx));
+  if (is_null) {
+    return ::arrow::MakeNullScalar(field->type());
+  }
   ::arrow::StructScalar::ValueType values;
+  if (field->encoding() == lance::format::pb::Encoding::PACKED_STRUCT) {
+    // One read for all the children. The page is decoded with the full struct type, because
+    // the projection may only keep some of the children.
+    ARROW_ASSIGN_OR_RAISE(auto decoder,
+                          GetDecoder(manifest_->schema().GetField(field->id()), batch_id));
+    ARROW_ASSIGN_OR_RAISE(auto row, decoder->GetScalar(idx));
+    auto& packed = static_cast<const ::arrow::StructScalar&>(*row);
+    for (auto& child : field->fields()) {
+      ARROW_ASSIGN_OR_RAISE(auto child_is_null, IsNull(child, batch_id, idx));
+      if (child_is_null) {
+        values.emplace_back(::arrow::MakeNullScalar(child->type()));
+      } else {
+        ARROW_ASSIGN_OR_RAISE(auto value, packed.field(child->name()));
+        values.emplace_back(value);
+      }
+    }
+    return std::make_shared<::arrow::StructScalar>(values, field->type());
+  }
   std::vector<std::future<ScalarResult>> futures;
   for (auto& child : field->fields()) {
     futures.emplace_back(std::async(&FileReader::GetScalar, this, child, batch_id, idx));
@@ -135,30 +507,73 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
   return std::make_shared<::arrow::StructScalar>(values, field->type());
 }
 
-::arrow::Result<std::shared_ptr<::arrow::Int32Array>> ResetOffsets(
-    const std::shared_ptr<::arrow::Int32Array>& offsets) {
-  int32_t start_pos = offsets->Value(0);
-  ARROW_ASSIGN_OR_RAISE(auto datum, ::arrow::compute::Subtract(offsets, ::arrow::Datum(start_pos)));
-  return std::static_pointer_cast<::arrow::Int32Array>(datum.make_array());
+/// Read the i-th offset of an int32 (list) or int64 (large_list) offsets array.
+int64_t GetOffset(const ::arrow::Array& offsets, int64_t i) {
+  if (offsets.type_id() == ::arrow::Type::INT64) {
+    return static_cast<const ::arrow::Int64Array&>(offsets).Value(i);
+  }
+  return static_cast<const ::arrow::Int32Array&>(offsets).Value(i);
+}
+
+/// Check that the values of `[start_pos, end_pos)` in the child page of a list can be read with
+/// int32 positions.
+::arrow::Status CheckListValueRange(const lance::format::Field& field,
+                                   int64_t start_pos,
+                                   int64_t end_pos) {
+  if (start_pos < 0 || end_pos < start_pos || end_pos > std::numeric_limits<int32_t>::max()) {
+    return ::arrow::Status::CapacityError(
+        fmt::format("Column {}: list values [{}, {}) exceed the page capacity",
+                    field.name(),
+                    start_pos,
+                    end_pos));
+  }
+  return ::arrow::Status::OK();
+}
+
+/// Realign the offsets to start from zero. The buffer is used as is if they already do.
+::arrow::Result<std::shared_ptr<::arrow::Buffer>> ResetOffsets(
+    const std::shared_ptr<::arrow::Array>& offsets) {
+  auto start_pos = GetOffset(*offsets, 0);
+  if (start_pos == 0) {
+    return offsets->data()->buffers[1];
+  }
+  ARROW_ASSIGN_OR_RAISE(auto buf, ::arrow::AllocateBuffer(offsets->data()->buffers[1]->size()));
+  if (offsets->type_id() == ::arrow::Type::INT64) {
+    lance::encodings::kernels::RebaseOffsets(
+        std::static_pointer_cast<::arrow::Int64Array>(offsets)->raw_values(),
+        offsets->length(),
+        start_pos,
+        reinterpret_cast<int64_t*>(buf->mutable_data()));
+  } else {
+    lance::encodings::kernels::RebaseOffsets(
+        std::static_pointer_cast<::arrow::Int32Array>(offsets)->raw_values(),
+        offsets->length(),
+        static_cast<int32_t>(start_pos),
+        reinterpret_cast<int32_t*>(buf->mutable_data()));
+  }
+  return std::shared_ptr<::arrow::Buffer>(std::move(buf));
 }
 
 ::arrow::Result<::std::shared_ptr<::arrow::Scalar>> FileReader::GetListScalar(
     const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const {
-  auto field_id = field->id();
-  ARROW_ASSIGN_OR_RAISE(auto decoder, field->GetDecoder(file_));
-  ARROW_ASSIGN_OR_RAISE(auto page, GetPageInfo(field_id, batch_id));
-  auto [pos, length] = page;
-  decoder->Reset(pos, length);
-  ARROW_ASSIGN_OR_RAISE(auto offsets_arr, decoder->ToArray(idx, 2));
-  auto offsets = std::static_pointer_cast<::arrow::Int32Array>(offsets_arr);
-  if (offsets->Value(0) == offsets->Value(1)) {
-    return std::make_shared<::arrow::NullScalar>();
+  ARROW_ASSIGN_OR_RAISE(auto is_null, IsNull(field, batch_id, idx));
+  if (is_null) {
+    return ::arrow::MakeNullScalar(field->type());
   }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetDecoder(field, batch_id));
+  ARROW_ASSIGN_OR_RAISE(auto offsets, decoder->ToArray(idx, 2));
+  auto start_pos = GetOffset(*offsets, 0);
+  auto end_pos = GetOffset(*offsets, 1);
+  ARROW_RETURN_NOT_OK(CheckListValueRange(*field, start_pos, end_pos));
   ARROW_ASSIGN_OR_RAISE(
       auto values,
       GetArray(field->fields()[0],
                batch_id,
-               ArrayReadParams(offsets->Value(0), offsets->Value(1) - offsets->Value(0))));
+               ArrayReadParams(static_cast<int32_t>(start_pos),
+                               static_cast<int32_t>(end_pos - start_pos))));
+  if (field->type()->id() == ::arrow::Type::LARGE_LIST) {
+    return std::make_shared<::arrow::LargeListScalar>(values);
+  }
   return std::make_shared<::arrow::ListScalar>(values);
 }
 
@@ -191,6 +606,46 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
   return Get(idx, manifest_->schema());
 }
 
+std::shared_ptr<lance::format::BitmapIndex> FileReader::GetBitmapIndex(
+    const std::shared_ptr<lance::format::Field>& field) const {
+  auto it = bitmap_indices_.find(field->id());
+  return it == bitmap_indices_.end() ? nullptr : it->second;
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Table>> FileReader::GetByKey(
+    const std::shared_ptr<::arrow::Array>& keys, const std::vector<std::string>& columns) const {
+  if (!primary_key_index_) {
+    return Status::Invalid("The file does not have a primary key index");
+  }
+  auto projection = std::make_shared<format::Schema>(manifest_->schema());
+  if (!columns.empty()) {
+    ARROW_ASSIGN_OR_RAISE(projection, manifest_->schema().Project(columns));
+  }
+  ARROW_ASSIGN_OR_RAISE(
+      auto casted,
+      ::arrow::compute::Cast(
+          keys, format::PrimaryKeyIndex::KeyType(primary_key_index_->field()->type())));
+  ARROW_ASSIGN_OR_RAISE(auto row_ids, primary_key_index_->Lookup(*casted.make_array()));
+
+  std::vector<std::shared_ptr<::arrow::RecordBatch>> batches;
+  for (std::size_t i = 0; i < row_ids.size();) {
+    ARROW_ASSIGN_OR_RAISE(auto location, metadata_->LocateBatch(row_ids[i]));
+    auto [batch_id, offset] = location;
+    auto batch_start = row_ids[i] - offset;
+    auto batch_end = batch_start + metadata_->GetBatchLength(batch_id);
+    ::arrow::Int32Builder builder;
+    for (; i < row_ids.size() && row_ids[i] < batch_end; i++) {
+      ARROW_RETURN_NOT_OK(builder.Append(static_cast<int32_t>(row_ids[i] - batch_start)));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto indices, builder.Finish());
+    ARROW_ASSIGN_OR_RAISE(
+        auto batch,
+        ReadBatch(*projection, batch_id, std::static_pointer_cast<::arrow::Int32Array>(indices)));
+    batches.emplace_back(batch);
+  }
+  return ::arrow::Table::FromRecordBatches(projection->ToArrow(), batches);
+}
+
 ::arrow::Result<std::shared_ptr<::arrow::Table>> FileReader::ReadTable() {
   std::vector<std::shared_ptr<::arrow::ChunkedArray>> columns;
   return ReadTable(manifest_->schema());
@@ -292,6 +747,8 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
     return GetStructArray(field, batch_id, params);
   } else if (is_list(dtype)) {
     return GetListArray(field, batch_id, params);
+  } else if (lance::arrow::is_map(dtype)) {
+    return GetMapArray(field, batch_id, params);
   } else if (::arrow::is_dictionary(dtype->id())) {
     return GetDictionaryArray(field, batch_id, params);
   } else {
@@ -303,6 +760,9 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
     const std::shared_ptr<lance::format::Field>& field,
     int32_t batch_id,
     const ArrayReadParams& params) const {
+  if (field->encoding() == lance::format::pb::Encoding::PACKED_STRUCT) {
+    return GetPackedStructArray(field, batch_id, params);
+  }
   ::arrow::ArrayVector children;
   std::vector<std::string> field_names;
   for (auto child : field->fields()) {
@@ -310,7 +770,73 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
     children.emplace_back(arr);
     field_names.emplace_back(child->name());
   }
-  return ::arrow::StructArray::Make(children, field_names);
+  ARROW_ASSIGN_OR_RAISE(auto null_bitmap, GetValidityBitmap(field, batch_id, params));
+  return ::arrow::StructArray::Make(children, field_names, null_bitmap);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetPackedStructArray(
+    const std::shared_ptr<lance::format::Field>& field,
+    int32_t batch_id,
+    const ArrayReadParams& params) const {
+  if (page_table_->GetValidity(field->id(), batch_id) == format::PageTable::kAllNull) {
+    return ::arrow::MakeArrayOfNull(field->type(), GetReadLength(batch_id, params), pool_);
+  }
+  // The page is decoded with the full struct type, because the projection may only keep some
+  // of the children.
+  ARROW_ASSIGN_OR_RAISE(auto decoder,
+                        GetDecoder(manifest_->schema().GetField(field->id()), batch_id));
+  std::shared_ptr<::arrow::Array> arr;
+  if (params.indices) {
+    ARROW_ASSIGN_OR_RAISE(arr, decoder->Take(params.indices.value()));
+  } else {
+    ARROW_ASSIGN_OR_RAISE(arr, decoder->ToArray(params.offset.value(), params.length));
+  }
+  auto packed = std::static_pointer_cast<::arrow::StructArray>(arr);
+  ::arrow::ArrayVector children;
+  std::vector<std::string> field_names;
+  for (auto child : field->fields()) {
+    ARROW_ASSIGN_OR_RAISE(auto child_bitmap, GetValidityBitmap(child, batch_id, params));
+    ARROW_ASSIGN_OR_RAISE(
+        auto child_arr, WithValidity(packed->GetFieldByName(child->name()), child_bitmap, pool_));
+    children.emplace_back(child_arr);
+    field_names.emplace_back(child->name());
+  }
+  ARROW_ASSIGN_OR_RAISE(auto null_bitmap, GetValidityBitmap(field, batch_id, params));
+  return ::arrow::StructArray::Make(children, field_names, null_bitmap);
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::TakeNested(
+    const std::shared_ptr<lance::format::Field>& field,
+    int batch_id,
+    const std::shared_ptr<::arrow::Int32Array>& indices) const {
+  // TODO: GH-39. We should improve the read behavior to use indices to save some I/Os.
+  if (indices->length() == 0) {
+    return ::arrow::Status::IndexError(fmt::format(
+        "FileReader::TakeNested: indices is empty: field={}({})", field->name(), field->id()));
+  }
+  auto start = static_cast<int32_t>(indices->Value(0));
+  auto length = static_cast<int32_t>(indices->Value(indices->length() - 1) - start + 1);
+  ARROW_ASSIGN_OR_RAISE(auto unfiltered_arr,
+                        GetArray(field, batch_id, ArrayReadParams(start, length)));
+  ARROW_ASSIGN_OR_RAISE(auto shifted_indices,
+                        ::arrow::compute::Subtract(indices, ::arrow::Datum(start)));
+  ARROW_ASSIGN_OR_RAISE(auto datum,
+                        ::arrow::compute::CallFunction("take", {unfiltered_arr, shifted_indices}));
+  return datum.make_array();
+}
+
+::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetOffsets(
+    const std::shared_ptr<lance::format::Field>& field,
+    int batch_id,
+    int32_t start,
+    std::optional<int32_t> length) const {
+  // The offsets page is read with the decoder directly, because the validity of the page
+  // applies to the list elements, not to the offsets.
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetDecoder(field, batch_id));
+  if (length.has_value()) {
+    return decoder->ToArray(start, length.value() + 1);
+  }
+  return decoder->ToArray(start);
 }
 
 ::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetListArray(
@@ -318,51 +844,55 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
     int batch_id,
     const ArrayReadParams& params) const {
   if (params.indices.has_value()) {
-    // TODO: GH-39. We should improve the read behavior to use indices to save some I/Os.
-    auto& indices = params.indices.value();
-    if (indices->length() == 0) {
-      return ::arrow::Status::IndexError(fmt::format(
-          "FileReader::GetListArray: indices is empty: field={}({})", field->name(), field->id()));
-    }
-    auto start = static_cast<int32_t>(indices->Value(0));
-    auto length = static_cast<int32_t>(indices->Value(indices->length() - 1) - start);
-    ARROW_ASSIGN_OR_RAISE(auto unfiltered_arr,
-                          GetListArray(field, batch_id, ArrayReadParams(start, length)));
-    ARROW_ASSIGN_OR_RAISE(auto datum,
-                          ::arrow::compute::CallFunction("take", {unfiltered_arr, indices}));
-    return datum.make_array();
+    return TakeNested(field, batch_id, params.indices.value());
   }
 
-  auto length = params.length;
   auto start = params.offset.value();
+  ARROW_ASSIGN_OR_RAISE(auto offsets_arr, GetOffsets(field, batch_id, start, params.length));
+  // The positions of the values in the child page are int32 even for large lists, which the
+  // writer checks for.
+  auto num_rows = static_cast<int32_t>(offsets_arr->length() - 1);
+  auto start_pos = GetOffset(*offsets_arr, 0);
+  auto end_pos = GetOffset(*offsets_arr, num_rows);
+  ARROW_RETURN_NOT_OK(CheckListValueRange(*field, start_pos, end_pos));
+  auto array_length = end_pos - start_pos;
+  ARROW_ASSIGN_OR_RAISE(auto values,
+                        GetArray(field->fields()[0],
+                                 batch_id,
+                                 ArrayReadParams(static_cast<int32_t>(start_pos),
+                                                 static_cast<int32_t>(array_length))));
+  // Realigned offsets to be zero-started
+  ARROW_ASSIGN_OR_RAISE(auto shifted_offsets, ResetOffsets(offsets_arr));
+  ARROW_ASSIGN_OR_RAISE(auto null_bitmap,
+                        GetValidityBitmap(field, batch_id, ArrayReadParams(start, num_rows)));
+  if (field->type()->id() == ::arrow::Type::LARGE_LIST) {
+    return std::make_shared<::arrow::LargeListArray>(
+        field->type(), num_rows, shifted_offsets, values, null_bitmap);
+  }
+  return std::make_shared<::arrow::ListArray>(
+      field->type(), num_rows, shifted_offsets, values, null_bitmap);
+}
 
-  std::shared_ptr<::arrow::Array> offsets_arr;
-  if (length.has_value()) {
-    ARROW_ASSIGN_OR_RAISE(
-        offsets_arr,
-        GetPrimitiveArray(field, batch_id, ArrayReadParams(start, length.value() + 1)));
-  } else {
-    ARROW_ASSIGN_OR_RAISE(offsets_arr, GetPrimitiveArray(field, batch_id, ArrayReadParams(start)));
+::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetMapArray(
+    const std::shared_ptr<lance::format::Field>& field,
+    int batch_id,
+    const ArrayReadParams& params) const {
+  if (params.indices.has_value()) {
+    return TakeNested(field, batch_id, params.indices.value());
   }
+
+  auto start = params.offset.value();
+  ARROW_ASSIGN_OR_RAISE(auto offsets_arr, GetOffsets(field, batch_id, start, params.length));
   auto offsets = std::static_pointer_cast<::arrow::Int32Array>(offsets_arr);
-  int32_t start_pos = offsets->Value(0);
-  int32_t array_length = offsets->Value(offsets_arr->length() - 1) - start_pos;
-  ARROW_ASSIGN_OR_RAISE(
-      auto values,
-      GetArray(field->fields()[0], batch_id, ArrayReadParams(start_pos, array_length)));
-  // Realigned offsets to be zero-started
+  auto num_rows = static_cast<int32_t>(offsets->length() - 1);
+  auto entries = ArrayReadParams(offsets->Value(0), offsets->Value(num_rows) - offsets->Value(0));
+  ARROW_ASSIGN_OR_RAISE(auto keys, GetArray(field->field(0), batch_id, entries));
+  ARROW_ASSIGN_OR_RAISE(auto items, GetArray(field->field(1), batch_id, entries));
   ARROW_ASSIGN_OR_RAISE(auto shifted_offsets, ResetOffsets(offsets));
-  // Setup null bitmap
-  ARROW_ASSIGN_OR_RAISE(auto null_bitmap, ::arrow::AllocateBitmap(shifted_offsets->length() - 1, pool_));
-  for (int i = 0; i < shifted_offsets->length() - 1; i++) {
-    ::arrow::bit_util::SetBitTo(null_bitmap->mutable_data(), i,
-                                offsets->Value(i + 1) - offsets->Value(i) > 0);
-  }
-  return std::make_shared<::arrow::ListArray>(field->type(),
-                                              shifted_offsets->length() - 1,
-                                              shifted_offsets->data()->buffers[1],
-                                              values,
-                                              null_bitmap);
+  ARROW_ASSIGN_OR_RAISE(auto null_bitmap,
+                        GetValidityBitmap(field, batch_id, ArrayReadParams(start, num_rows)));
+  return std::make_shared<::arrow::MapArray>(
+      field->type(), num_rows, shifted_offsets, keys, items, null_bitmap);
 }
 
 ::arrow::Result<std::shared_ptr<::arrow::Array>> FileReader::GetDictionaryArray(
@@ -377,18 +907,23 @@ const lance::format::Metadata& FileReader::metadata() const { return *metadata_;
     const std::shared_ptr<lance::format::Field>& field,
     int batch_id,
     const ArrayReadParams& params) const {
-  auto field_id = field->id();
-  ARROW_ASSIGN_OR_RAISE(auto page_info, GetPageInfo(field_id, batch_id));
-  auto [position, length] = page_info;
-  ARROW_ASSIGN_OR_RAISE(auto decoder, field->GetDecoder(file_));
-  decoder->Reset(position, length);
-  decltype(decoder->ToArray()) result;
+  auto validity = page_table_->GetValidity(field->id(), batch_id);
+  if (validity == format::PageTable::kAllNull) {
+    // Values of an all-null page are not stored.
+    return ::arrow::MakeArrayOfNull(field->type(), GetReadLength(batch_id, params), pool_);
+  }
+  ARROW_ASSIGN_OR_RAISE(auto decoder, GetDecoder(field, batch_id));
+  std::shared_ptr<::arrow::Array> arr;
   if (params.indices) {
-    result = decoder->Take(params.indices.value());
+    ARROW_ASSIGN_OR_RAISE(arr, decoder->Take(params.indices.value()));
   } else {
-    result = decoder->ToArray(params.offset.value(), params.length);
+    ARROW_ASSIGN_OR_RAISE(arr, decoder->ToArray(params.offset.value(), params.length));
+  }
+  if (validity == format::PageTable::kNoNulls) {
+    return arr;
   }
-  return result;
+  ARROW_ASSIGN_OR_RAISE(auto null_bitmap, GetValidityBitmap(field, batch_id, params));
+  return WithValidity(arr, null_bitmap, pool_);
 }
 
 FileReader::ArrayReadParams::ArrayReadParams(int32_t off, std::optional<int32_t> len)
@@ -18,15 +18,26 @@
 #include <arrow/type_fwd.h>
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
+#include <vector>
+
+namespace lance::encodings {
+class BlobHandle;
+class Decoder;
+}  // namespace lance::encodings
 
 namespace lance::format {
+class BitmapIndex;
+class BloomFilter;
 class Field;
 class Manifest;
 class Metadata;
 class PageTable;
+class PrimaryKeyIndex;
 class Schema;
 }  // namespace lance::format
 
@@ -76,6 +87,29 @@ class FileReader {
   /// Get file manifest.
   const lance::format::Manifest& manifest() const;
 
+  /// Get the page table, including the validity of each page.
+  const lance::format::PageTable& page_table() const;
+
+  /// Get the index of the primary key, or `nullptr` if the file does not have one.
+  const std::shared_ptr<lance::format::PrimaryKeyIndex>& primary_key_index() const;
+
+  /// Read the rows by their primary keys, using the primary key index.
+  ///
+  /// \param keys the keys to look up. They are casted to the type of the primary key if
+  ///             necessary.
+  /// \param columns the columns to read. All the columns if empty.
+  /// \return the rows that have any of the keys, in row order.
+  ::arrow::Result<std::shared_ptr<::arrow::Table>> GetByKey(
+      const std::shared_ptr<::arrow::Array>& keys,
+      const std::vector<std::string>& columns = {}) const;
+
+  /// Get the bitmap index of a column.
+  ///
+  /// \param field the field (column) to look up.
+  /// \return the bitmap index, or `nullptr` if the column is not indexed.
+  std::shared_ptr<lance::format::BitmapIndex> GetBitmapIndex(
+      const std::shared_ptr<lance::format::Field>& field) const;
+
   /// Read one single row at the index.
   ::arrow::Result<std::vector<::std::shared_ptr<::arrow::Scalar>>> Get(int32_t idx);
 
@@ -83,6 +117,57 @@ class FileReader {
   ::arrow::Result<std::vector<::std::shared_ptr<::arrow::Scalar>>> Get(
       int32_t idx, const std::vector<std::string>& columns);
 
+  /// Get the decoder of a page, which is already reset to the page position.
+  ///
+  /// \param field the field (column) of the page.
+  /// \param batch_id the index of the batch in the file.
+  /// \return a decoder if success.
+  ::arrow::Result<std::shared_ptr<lance::encodings::Decoder>> GetDecoder(
+      const std::shared_ptr<lance::format::Field>& field, int32_t batch_id) const;
+
+  /// Read the Bloom filter of a page.
+  ///
+  /// \param field the field (column) of the page.
+  /// \param batch_id the index of the batch in the file.
+  /// \return the Bloom filter, or `nullptr` if the page does not have one.
+  ::arrow::Result<std::shared_ptr<lance::format::BloomFilter>> GetBloomFilter(
+      const std::shared_ptr<lance::format::Field>& field, int32_t batch_id) const;
+
+  /// Get the lazy handles of the values of a blob column, without reading the values.
+  ///
+  /// Use `lance::encodings::ReadBlobs()` to fetch the bytes of the selected handles.
+  ///
+  /// \param column the name of a column written with blob encoding.
+  /// \param batch_id the index of the batch in the file.
+  /// \param indices the (sorted) rows of the batch. All the rows if not specified.
+  /// \return one handle per row, or `std::nullopt` for a null value.
+  ::arrow::Result<std::vector<std::optional<lance::encodings::BlobHandle>>> GetBlobs(
+      const std::string& column,
+      int32_t batch_id,
+      std::optional<std::shared_ptr<::arrow::Int32Array>> indices = std::nullopt) const;
+
+  /// Read the value of one key of a map column, for each row, i.e., `attrs['camera_model']`.
+  ///
+  /// Only the keys and the values of the matched entries are read, not the whole maps.
+  ///
+  /// \param column the name of a map column.
+  /// \param batch_id the index of the batch in the file.
+  /// \param key the key to look up. It is casted to the key type of the map if necessary.
+  /// \param indices the (sorted) rows of the batch. All the rows if not specified.
+  /// \return the values of the key, or null if the map is null or does not have the key.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> GetMapValues(
+      const std::string& column,
+      int32_t batch_id,
+      const ::arrow::Scalar& key,
+      std::optional<std::shared_ptr<::arrow::Int32Array>> indices = std::nullopt) const;
+
+  /// Read the value of one key of a map column at the row index.
+  ///
+  /// \see GetMapValues
+  ::arrow::Result<std::shared_ptr<::arrow::Scalar>> GetMapValue(int32_t idx,
+                                                                const std::string& column,
+                                                                const ::arrow::Scalar& key) const;
+
  private:
   FileReader() = delete;
 
@@ -134,11 +219,37 @@ class FileReader {
       int32_t batch_id,
       const ArrayReadParams& params) const;
 
+  /// Read a struct column stored with the packed struct encoding, where all the children are
+  /// in one page of the struct field.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> GetPackedStructArray(
+      const std::shared_ptr<lance::format::Field>& field,
+      int32_t batch_id,
+      const ArrayReadParams& params) const;
+
   ::arrow::Result<std::shared_ptr<::arrow::Array>> GetListArray(
       const std::shared_ptr<lance::format::Field>& field,
       int32_t batch_id,
       const ArrayReadParams& params) const;
 
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> GetMapArray(
+      const std::shared_ptr<lance::format::Field>& field,
+      int32_t batch_id,
+      const ArrayReadParams& params) const;
+
+  /// Take the rows of a list or map column, from the range covering all the indices.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> TakeNested(
+      const std::shared_ptr<lance::format::Field>& field,
+      int32_t batch_id,
+      const std::shared_ptr<::arrow::Int32Array>& indices) const;
+
+  /// Read `length + 1` offsets of a list or map page, from the row `start`, or all the offsets
+  /// after `start` if the length is not specified.
+  ::arrow::Result<std::shared_ptr<::arrow::Array>> GetOffsets(
+      const std::shared_ptr<lance::format::Field>& field,
+      int32_t batch_id,
+      int32_t start,
+      std::optional<int32_t> length) const;
+
   ::arrow::Result<std::shared_ptr<::arrow::Array>> GetDictionaryArray(
       const std::shared_ptr<lance::format::Field>& field,
       int32_t batch_id,
@@ -155,6 +266,23 @@ class FileReader {
   ::arrow::Result<::std::shared_ptr<::arrow::Scalar>> GetStructScalar(
       const std::shared_ptr<lance::format::Field>& field, int32_t batch_id, int32_t idx) const;
 
+  /// Read the validity bitmap of a page, for the rows specified by the read params.
+  ///
+  /// \return the validity bitmap, starting at the first row to read. Or `nullptr` if all
+  ///         the rows in the page are valid.
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>> GetValidityBitmap(
+      const std::shared_ptr<lance::format::Field>& field,
+      int32_t batch_id,
+      const ArrayReadParams& params) const;
+
+  /// Returns true if the value at the index of a page is null.
+  ::arrow::Result<bool> IsNull(const std::shared_ptr<lance::format::Field>& field,
+                               int32_t batch_id,
+                               int32_t idx) const;
+
+  /// Get the number of rows to read from a batch.
+  int32_t GetReadLength(int32_t batch_id, const ArrayReadParams& params) const;
+
   /// Get the file position and page length for a page.
   ///
   /// \param field_id the field / column Id
@@ -169,6 +297,9 @@ class FileReader {
   std::shared_ptr<lance::format::Metadata> metadata_;
   std::shared_ptr<lance::format::Manifest> manifest_;
   std::shared_ptr<lance::format::PageTable> page_table_;
+  std::shared_ptr<lance::format::PrimaryKeyIndex> primary_key_index_;
+  /// Bitmap indices, keyed by field id.
+  std::map<int32_t, std::shared_ptr<lance::format::BitmapIndex>> bitmap_indices_;
 
   std::shared_ptr<::arrow::Buffer> cached_last_page_;
 };
@@ -15,16 +15,25 @@
 #include "lance/arrow/reader.h"
 
 #include <arrow/builder.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <arrow/table.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <random>
 
 #include "lance/arrow/stl.h"
 #include "lance/arrow/type.h"
 #include "lance/arrow/writer.h"
+#include "lance/encodings/blob.h"
+#include "lance/format/metadata.h"
+#include "lance/format/page_table.h"
+#include "lance/format/schema.h"
+#include "lance/io/reader.h"
 
 TEST_CASE("Test List Array With Nulls") {
   auto int_builder = std::make_shared<::arrow::Int32Builder>();
@@ -61,6 +70,589 @@ TEST_CASE("Test List Array With Nulls") {
 
   for (int i = 2; i < 5; i++) {
     scalar = reader->Get(i).ValueOrDie()[0];
-    CHECK(scalar->Equals(::arrow::NullScalar()));
+    CHECK(scalar->Equals(*::arrow::MakeNullScalar(::arrow::list(::arrow::int32()))));
   }
 }
+
+TEST_CASE("Read primitive and string arrays with nulls") {
+  ::arrow::Int32Builder int_builder;
+  ::arrow::StringBuilder str_builder;
+  for (int i = 0; i < 20; i++) {
+    if (i % 3 == 0) {
+      CHECK(int_builder.AppendNull().ok());
+      CHECK(str_builder.AppendNull().ok());
+    } else {
+      CHECK(int_builder.Append(i).ok());
+      CHECK(str_builder.Append(fmt::format("str-{}", i)).ok());
+    }
+  }
+  auto ints = int_builder.Finish().ValueOrDie();
+  auto strs = str_builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("ints", ::arrow::int32()), ::arrow::field("strs", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(schema, {ints, strs});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+
+  CHECK(!reader->Get(3).ValueOrDie()[0]->is_valid);
+  CHECK(!reader->Get(3).ValueOrDie()[1]->is_valid);
+  CHECK(reader->Get(4).ValueOrDie()[0]->Equals(::arrow::Int32Scalar(4)));
+}
+
+TEST_CASE("Read all-null page") {
+  auto nulls = ::arrow::MakeArrayOfNull(::arrow::float64(), 10).ValueOrDie();
+  auto values = lance::arrow::ToArray({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}).ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("nulls", ::arrow::float64()), ::arrow::field("values", ::arrow::int32())});
+  auto table = ::arrow::Table::Make(schema, {nulls, values});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  auto actual = reader->ReadTable().ValueOrDie();
+  CHECK(table->Equals(*actual));
+  CHECK(actual->GetColumnByName("nulls")->null_count() == 10);
+  CHECK(!reader->Get(5).ValueOrDie()[0]->is_valid);
+}
+
+TEST_CASE("Distinguish empty lists from null lists") {
+  auto int_builder = std::make_shared<::arrow::Int32Builder>();
+  auto list_builder = ::arrow::ListBuilder(::arrow::default_memory_pool(), int_builder);
+  CHECK(list_builder.Append().ok());
+  CHECK(list_builder.AppendNull().ok());
+  CHECK(list_builder.Append().ok());
+  CHECK(int_builder->AppendValues({1, 2}).ok());
+  auto lists = list_builder.Finish().ValueOrDie();
+
+  auto schema = ::arrow::schema({::arrow::field("lists", ::arrow::list(::arrow::int32()))});
+  auto table = ::arrow::Table::Make(schema, {lists});
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+  CHECK(actual->GetColumnByName("lists")->null_count() == 1);
+}
+
+TEST_CASE("Read struct array with nulls") {
+  auto ints = lance::arrow::ToArray({1, 2, 3, 4}).ValueOrDie();
+  auto null_bitmap = ::arrow::AllocateEmptyBitmap(4).ValueOrDie();
+  ::arrow::bit_util::SetBit(null_bitmap->mutable_data(), 0);
+  ::arrow::bit_util::SetBit(null_bitmap->mutable_data(), 2);
+  auto structs = ::arrow::StructArray::Make({ints}, {"i"}, null_bitmap).ValueOrDie();
+
+  auto schema = ::arrow::schema({::arrow::field("s", structs->type())});
+  auto table = ::arrow::Table::Make(schema, {structs});
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+  CHECK(!reader->Get(1).ValueOrDie()[0]->is_valid);
+}
+
+TEST_CASE("Read fixed size list array") {
+  auto float_builder = std::make_shared<::arrow::FloatBuilder>();
+  auto list_builder =
+      ::arrow::FixedSizeListBuilder(::arrow::default_memory_pool(), float_builder, 3);
+  for (int i = 0; i < 10; i++) {
+    if (i == 4) {
+      CHECK(list_builder.AppendNull().ok());
+    } else {
+      CHECK(list_builder.Append().ok());
+      CHECK(float_builder->AppendValues({1.0f * i, 2.0f * i, 3.0f * i}).ok());
+    }
+  }
+  auto embeddings = list_builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("embeddings", embeddings->type())});
+  auto table = ::arrow::Table::Make(schema, {embeddings});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  CHECK(reader->GetSchema().ValueOrDie()->Equals(*schema));
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+
+  CHECK(reader->Get(2).ValueOrDie()[0]->Equals(embeddings->GetScalar(2).ValueOrDie()));
+  CHECK(!reader->Get(4).ValueOrDie()[0]->is_valid);
+}
+
+TEST_CASE("Read byte stream split columns") {
+  ::arrow::FloatBuilder scores_builder;
+  ::arrow::DoubleBuilder xs_builder;
+  for (int i = 0; i < 100; i++) {
+    if (i % 7 == 0) {
+      CHECK(scores_builder.AppendNull().ok());
+    } else {
+      CHECK(scores_builder.Append(0.01f * i).ok());
+    }
+    CHECK(xs_builder.Append(1.5 * i).ok());
+  }
+  auto scores = scores_builder.Finish().ValueOrDie();
+  auto xs = xs_builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("score", ::arrow::float32()), ::arrow::field("x", ::arrow::float64())});
+  auto table = ::arrow::Table::Make(schema, {scores, xs});
+  table = ::arrow::ConcatenateTables({table->Slice(0, 30), table->Slice(30)}).ValueOrDie();
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.byte_stream_split_columns = {"score", "x"};
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = lance::arrow::FileReader::Make(infile).ValueOrDie();
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+
+  CHECK(!reader->Get(35).ValueOrDie()[0]->is_valid);
+  CHECK(reader->Get(36).ValueOrDie()[0]->Equals(::arrow::FloatScalar(0.01f * 36)));
+  CHECK(reader->Get(36).ValueOrDie()[1]->Equals(::arrow::DoubleScalar(1.5 * 36)));
+}
+
+TEST_CASE("Read run-length encoded temporal columns") {
+  ::arrow::TimestampBuilder ts_builder(::arrow::timestamp(::arrow::TimeUnit::MILLI),
+                                       ::arrow::default_memory_pool());
+  ::arrow::Date32Builder date_builder;
+  ::arrow::DurationBuilder duration_builder(::arrow::duration(::arrow::TimeUnit::SECOND),
+                                           ::arrow::default_memory_pool());
+  ::arrow::Decimal128Builder price_builder(::arrow::decimal128(10, 2));
+  for (int i = 0; i < 100; i++) {
+    CHECK(ts_builder.Append(1660000000000 + (i / 10) * 1000).ok());
+    if (i % 13 == 0) {
+      CHECK(date_builder.AppendNull().ok());
+    } else {
+      CHECK(date_builder.Append(19000 + i / 25).ok());
+    }
+    CHECK(duration_builder.Append(i / 50).ok());
+    CHECK(price_builder.Append(::arrow::Decimal128(i / 20)).ok());
+  }
+  auto schema = ::arrow::schema({::arrow::field("ts", ts_builder.type()),
+                                 ::arrow::field("date", ::arrow::date32()),
+                                 ::arrow::field("duration", duration_builder.type()),
+                                 ::arrow::field("price", ::arrow::decimal128(10, 2))});
+  auto table = ::arrow::Table::Make(schema,
+                                    {ts_builder.Finish().ValueOrDie(),
+                                     date_builder.Finish().ValueOrDie(),
+                                     duration_builder.Finish().ValueOrDie(),
+                                     price_builder.Finish().ValueOrDie()});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.rle_columns = {"ts", "date", "duration", "price"};
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  for (auto name : {"ts", "date", "duration"}) {
+    INFO("Column " << name);
+    CHECK(reader->schema().GetField(name)->encoding() == lance::format::pb::Encoding::RLE);
+  }
+  // Decimals are not run-length encoded.
+  CHECK(reader->schema().GetField("price")->encoding() != lance::format::pb::Encoding::RLE);
+
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+}
+
+TEST_CASE("Choose encodings per page") {
+  ::arrow::Int32Builder sorted_builder;
+  ::arrow::Int32Builder random_builder;
+  ::arrow::StringBuilder paths_builder;
+  for (int i = 0; i < 400; i++) {
+    CHECK(sorted_builder.Append(i / 100).ok());
+    CHECK(random_builder.Append((i * 7919) % 1000).ok());
+    CHECK(paths_builder.Append(fmt::format("s3://bucket/images/train/{:08d}.jpg", i)).ok());
+  }
+  auto sorted = sorted_builder.Finish().ValueOrDie();
+  auto random = random_builder.Finish().ValueOrDie();
+  auto paths = paths_builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema({::arrow::field("sorted", ::arrow::int32()),
+                                 ::arrow::field("random", ::arrow::int32()),
+                                 ::arrow::field("path", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(schema, {sorted, random, paths});
+  // Write two batches.
+  table = ::arrow::ConcatenateTables({table->Slice(0, 200), table->Slice(200)}).ValueOrDie();
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.encoding_policy = lance::arrow::EncodingPolicy::kSmallest;
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->metadata().encoding_table_position() > 0);
+  auto& page_table = reader->page_table();
+  for (int batch = 0; batch < 2; batch++) {
+    CHECK(page_table.GetEncoding(0, batch) == lance::format::pb::Encoding::RLE);
+    CHECK(!page_table.GetEncoding(1, batch).has_value());
+    CHECK(page_table.GetEncoding(2, batch) == lance::format::pb::Encoding::FSST);
+  }
+
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+  CHECK(reader->Get(250).ValueOrDie()[0]->Equals(::arrow::Int32Scalar(2)));
+  CHECK(reader->Get(250).ValueOrDie()[2]->Equals(paths->GetScalar(250).ValueOrDie()));
+
+  // The default policy keeps the encoding of the columns.
+  sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->metadata().encoding_table_position() == 0);
+}
+
+TEST_CASE("Read blob columns lazily") {
+  ::arrow::Int32Builder ids_builder;
+  ::arrow::BinaryBuilder images_builder;
+  for (int i = 0; i < 10; i++) {
+    CHECK(ids_builder.Append(i).ok());
+    if (i == 3) {
+      CHECK(images_builder.AppendNull().ok());
+    } else {
+      CHECK(images_builder.Append(std::string(10000 + i, static_cast<char>(i))).ok());
+    }
+  }
+  auto ids = ids_builder.Finish().ValueOrDie();
+  auto images = images_builder.Finish().ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("id", ::arrow::int32()), ::arrow::field("image", ::arrow::binary())});
+  auto table = ::arrow::Table::Make(schema, {ids, images});
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.blob_columns = {"image"};
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  auto actual = reader->ReadTable().ValueOrDie();
+  CHECK(table->Equals(*actual));
+  CHECK(reader->Get(3).ValueOrDie()[1]->is_valid == false);
+
+  auto indices = lance::arrow::ToArray({1, 3, 8}).ValueOrDie();
+  auto blobs = reader->GetBlobs("image", 0, indices).ValueOrDie();
+  CHECK(blobs.size() == 3);
+  CHECK(blobs[0]->length() == 10001);
+  CHECK(!blobs[1].has_value());
+  CHECK(blobs[2]->length() == 10008);
+  auto buffers = lance::encodings::ReadBlobs(blobs).ValueOrDie();
+  CHECK(buffers[0]->ToString() == std::string(10001, static_cast<char>(1)));
+  CHECK(buffers[1] == nullptr);
+  CHECK(buffers[2]->ToString() == std::string(10008, static_cast<char>(8)));
+
+  CHECK(reader->GetBlobs("image", 0).ValueOrDie().size() == 10);
+  CHECK(!reader->GetBlobs("id", 0).ok());
+}
+
+TEST_CASE("Read large list and large string arrays") {
+  auto binary_builder = std::make_shared<::arrow::LargeBinaryBuilder>();
+  ::arrow::LargeListBuilder frames_builder(::arrow::default_memory_pool(), binary_builder);
+  ::arrow::LargeStringBuilder names_builder;
+  for (int i = 0; i < 20; i++) {
+    if (i % 6 == 5) {
+      CHECK(frames_builder.AppendNull().ok());
+      CHECK(names_builder.AppendNull().ok());
+      continue;
+    }
+    CHECK(frames_builder.Append().ok());
+    for (int j = 0; j < i % 4; j++) {
+      CHECK(binary_builder->Append(fmt::format("frame-{}-{}", i, j)).ok());
+    }
+    CHECK(names_builder.Append(fmt::format("video-{}", i)).ok());
+  }
+  auto frames = frames_builder.Finish().ValueOrDie();
+  auto names = names_builder.Finish().ValueOrDie();
+  auto schema =
+      ::arrow::schema({::arrow::field("frames", ::arrow::large_list(::arrow::large_binary())),
+                       ::arrow::field("name", ::arrow::large_utf8())});
+  auto table = ::arrow::Table::Make(schema, {frames, names});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().ToArrow()->Equals(schema));
+
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(actual->Equals(*table));
+
+  // Sliced reads rebase the offsets, which are used as is when reading from the first row.
+  auto batch = reader->ReadAt(reader->schema(), 3, 10).ValueOrDie();
+  CHECK(batch->column(0)->Equals(frames->Slice(3, 10)));
+  CHECK(batch->column(1)->Equals(names->Slice(3, 10)));
+
+  auto indices = lance::arrow::ToArray({1, 5, 7, 18}).ValueOrDie();
+  batch = reader->ReadBatch(reader->schema(), 0, indices).ValueOrDie();
+  auto expected = ::arrow::compute::Take(table, indices).ValueOrDie().table();
+  CHECK(::arrow::Table::FromRecordBatches({batch}).ValueOrDie()->Equals(*expected));
+
+  auto row = reader->Get(3).ValueOrDie();
+  CHECK(row[0]->Equals(frames->GetScalar(3).ValueOrDie()));
+  CHECK(row[1]->Equals(names->GetScalar(3).ValueOrDie()));
+}
+
+TEST_CASE("Read map arrays and look up keys") {
+  // Keys are looked up with binary search if they are sorted within each map.
+  for (bool keys_sorted : {false, true}) {
+    INFO("Keys sorted: " << keys_sorted);
+    auto type = ::arrow::map(::arrow::utf8(), ::arrow::utf8(), keys_sorted);
+    auto key_builder = std::make_shared<::arrow::StringBuilder>();
+    auto item_builder = std::make_shared<::arrow::StringBuilder>();
+    ::arrow::MapBuilder builder(::arrow::default_memory_pool(), key_builder, item_builder, type);
+    std::vector<std::string> attrs = {"aperture", "camera_model", "exposure", "iso"};
+    for (int i = 0; i < 30; i++) {
+      if (i % 7 == 6) {
+        CHECK(builder.AppendNull().ok());
+        continue;
+      }
+      CHECK(builder.Append().ok());
+      for (std::size_t j = 0; j < attrs.size(); j++) {
+        // Row i does not have the (i % 5)-th attribute.
+        if (static_cast<int>(j) == i % 5) {
+          continue;
+        }
+        CHECK(key_builder->Append(attrs[j]).ok());
+        CHECK(item_builder->Append(fmt::format("{}-{}", attrs[j], i)).ok());
+      }
+    }
+    auto attrs_arr = builder.Finish().ValueOrDie();
+    auto schema = ::arrow::schema({::arrow::field("attrs", type)});
+    auto table = ::arrow::Table::Make(schema, {attrs_arr});
+
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+    auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+    auto reader = std::make_shared<lance::io::FileReader>(infile);
+    CHECK(reader->Open().ok());
+    CHECK(reader->schema().ToArrow()->Equals(schema));
+
+    auto actual = reader->ReadTable().ValueOrDie();
+    INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+    CHECK(actual->Equals(*table));
+    CHECK(reader->Get(3).ValueOrDie()[0]->Equals(attrs_arr->GetScalar(3).ValueOrDie()));
+    auto indices = lance::arrow::ToArray({2, 6, 11, 25}).ValueOrDie();
+    auto batch = reader->ReadBatch(reader->schema(), 0, indices).ValueOrDie();
+    auto expected = ::arrow::compute::Take(attrs_arr, indices).ValueOrDie().make_array();
+    CHECK(batch->column(0)->Equals(expected));
+
+    auto key = ::arrow::StringScalar("camera_model");
+    auto values = reader->GetMapValues("attrs", 0, key).ValueOrDie();
+    CHECK(values->length() == 30);
+    for (int i = 0; i < 30; i++) {
+      INFO("Row " << i << ": " << values->GetScalar(i).ValueOrDie()->ToString());
+      if (i % 7 == 6 || i % 5 == 1) {
+        CHECK(values->IsNull(i));
+      } else {
+        CHECK(values->GetScalar(i).ValueOrDie()->Equals(
+            ::arrow::StringScalar(fmt::format("camera_model-{}", i))));
+      }
+    }
+    auto taken = reader->GetMapValues("attrs", 0, key, indices).ValueOrDie();
+    CHECK(taken->Equals(::arrow::compute::Take(values, indices).ValueOrDie().make_array()));
+    CHECK(reader->GetMapValue(2, "attrs", key).ValueOrDie()->Equals(
+        ::arrow::StringScalar("camera_model-2")));
+    CHECK(!reader->GetMapValue(6, "attrs", key).ValueOrDie()->is_valid);
+
+    auto missing = reader->GetMapValues("attrs", 0, ::arrow::StringScalar("gps")).ValueOrDie();
+    CHECK(missing->null_count() == 30);
+  }
+}
+
+TEST_CASE("Read packed struct columns") {
+  ::arrow::FloatBuilder xmin_builder;
+  ::arrow::FloatBuilder ymin_builder;
+  ::arrow::Int32Builder label_builder;
+  ::arrow::DoubleBuilder score_builder;
+  ::arrow::TypedBufferBuilder<bool> validity_builder;
+  for (int i = 0; i < 100; i++) {
+    CHECK(xmin_builder.Append(0.5f * i).ok());
+    CHECK(ymin_builder.Append(0.25f * i).ok());
+    if (i % 5 == 2) {
+      CHECK(label_builder.AppendNull().ok());
+    } else {
+      CHECK(label_builder.Append(i % 10).ok());
+    }
+    CHECK(score_builder.Append(1.0 / (i + 1)).ok());
+    CHECK(validity_builder.Append(i % 9 != 4).ok());
+  }
+  auto bbox = ::arrow::StructArray::Make({xmin_builder.Finish().ValueOrDie(),
+                                          ymin_builder.Finish().ValueOrDie(),
+                                          label_builder.Finish().ValueOrDie(),
+                                          score_builder.Finish().ValueOrDie()},
+                                         std::vector<std::string>{"xmin", "ymin", "label", "score"},
+                                         validity_builder.Finish().ValueOrDie())
+                  .ValueOrDie();
+  auto ids = lance::arrow::ToArray(std::vector<int32_t>(100, 7)).ValueOrDie();
+  auto schema = ::arrow::schema(
+      {::arrow::field("id", ::arrow::int32()), ::arrow::field("bbox", bbox->type())});
+  auto table = ::arrow::Table::Make(schema, {ids, bbox});
+  table = ::arrow::ConcatenateTables({table->Slice(0, 40), table->Slice(40)}).ValueOrDie();
+
+  auto options = lance::arrow::FileWriteOptions();
+  options.packed_struct_columns = {"bbox", "id"};
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  // Only struct columns can be packed.
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).IsInvalid());
+
+  options.packed_struct_columns = {"bbox", "missing"};
+  sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).IsInvalid());
+
+  options.packed_struct_columns = {"bbox"};
+  sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "", options).ok());
+
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->schema().GetField("bbox")->encoding() ==
+        lance::format::pb::Encoding::PACKED_STRUCT);
+  CHECK(reader->schema().GetField("id")->encoding() == lance::format::pb::Encoding::PLAIN);
+
+  auto actual = reader->ReadTable().ValueOrDie();
+  INFO("Expected table: " << table->ToString() << "\n Actual table: " << actual->ToString());
+  CHECK(table->Equals(*actual));
+
+  for (int32_t idx : {0, 4, 12, 41, 57, 99}) {
+    INFO("Row: " << idx);
+    CHECK(reader->Get(idx).ValueOrDie()[1]->Equals(*bbox->GetScalar(idx).ValueOrDie()));
+  }
+
+  // Read a subset of the children.
+  auto projected = reader->schema().Project({"bbox.score", "bbox.label"}).ValueOrDie();
+  auto indices = lance::arrow::ToArray({1, 2, 12, 13, 50}).ValueOrDie();
+  auto batch = reader->ReadBatch(*projected, 1, indices).ValueOrDie();
+  auto taken = std::static_pointer_cast<::arrow::StructArray>(
+      ::arrow::compute::Take(bbox->Slice(40), indices).ValueOrDie().make_array());
+  auto expected = ::arrow::StructArray::Make(
+                      {taken->GetFieldByName("score"), taken->GetFieldByName("label")},
+                      std::vector<std::string>{"score", "label"},
+                      taken->null_bitmap())
+                      .ValueOrDie();
+  INFO("Expected: " << expected->ToString()
+                    << "\n Actual: " << batch->GetColumnByName("bbox")->ToString());
+  CHECK(expected->Equals(batch->GetColumnByName("bbox")));
+
+  // The label of row 52 is null, but the box is not.
+  auto row = reader->Get(52, {"bbox.label"}).ValueOrDie()[0];
+  CHECK(row->is_valid);
+  CHECK(!std::static_pointer_cast<::arrow::StructScalar>(row)->value[0]->is_valid);
+}
+
+TEST_CASE("Read rows by primary keys") {
+  // 3 batches of shuffled keys.
+  std::vector<int64_t> keys(300);
+  std::iota(keys.begin(), keys.end(), 1000);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  std::vector<std::string> values;
+  for (auto key : keys) {
+    values.emplace_back(fmt::format("value-{}", key));
+  }
+  auto schema = ::arrow::schema(
+      {::arrow::field("pk", ::arrow::int64()), ::arrow::field("value", ::arrow::utf8())});
+  auto table = ::arrow::Table::Make(schema,
+                                    {lance::arrow::ToArray(keys).ValueOrDie(),
+                                     lance::arrow::ToArray(values).ValueOrDie()});
+  table = ::arrow::ConcatenateTables(
+              {table->Slice(0, 100), table->Slice(100, 100), table->Slice(200)})
+              .ValueOrDie();
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "pk").ok());
+  auto infile = make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie());
+  auto reader = std::make_shared<lance::io::FileReader>(infile);
+  CHECK(reader->Open().ok());
+  CHECK(reader->primary_key_index() != nullptr);
+
+  // The keys are casted to the type of the primary key.
+  auto lookup = lance::arrow::ToArray<int32_t>({1250, 1003, 7, 1150}).ValueOrDie();
+  auto actual = reader->GetByKey(lookup, {"value"}).ValueOrDie();
+  CHECK(actual->schema()->Equals(*::arrow::schema({::arrow::field("value", ::arrow::utf8())})));
+  std::vector<std::string> expected;
+  for (auto& value : values) {
+    if (value == "value-1250" || value == "value-1003" || value == "value-1150") {
+      expected.emplace_back(value);
+    }
+  }
+  auto expected_table = ::arrow::Table::Make(actual->schema(),
+                                             {lance::arrow::ToArray(expected).ValueOrDie()});
+  INFO("Expected: " << expected_table->ToString() << "\nActual: " << actual->ToString());
+  CHECK(actual->CombineChunks().ValueOrDie()->Equals(*expected_table));
+
+  // All the columns.
+  actual = reader->GetByKey(lance::arrow::ToArray<int64_t>({1042}).ValueOrDie()).ValueOrDie();
+  CHECK(actual->num_rows() == 1);
+  CHECK(actual->num_columns() == 2);
+  CHECK(actual->GetColumnByName("value")->GetScalar(0).ValueOrDie()->ToString() == "value-1042");
+
+  // No index without a primary key.
+  sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "").ok());
+  reader = std::make_shared<lance::io::FileReader>(
+      make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie()));
+  CHECK(reader->Open().ok());
+  CHECK(reader->primary_key_index() == nullptr);
+  CHECK(!reader->GetByKey(lookup).ok());
+
+  // The primary key column does not exist.
+  sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "pkk").IsInvalid());
+}
+
+TEST_CASE("Read rows by dictionary primary keys") {
+  // The batches have different dictionaries.
+  auto type = ::arrow::dictionary(::arrow::int8(), ::arrow::utf8());
+  ::arrow::ArrayVector chunks;
+  for (auto& [indices, dict] :
+       std::vector<std::tuple<std::vector<int8_t>, std::vector<std::string>>>{
+           {{0, 1, 0}, {"cat", "dog"}}, {{1, 0}, {"cat", "fox"}}}) {
+    chunks.emplace_back(::arrow::DictionaryArray::FromArrays(
+                            type,
+                            lance::arrow::ToArray(indices).ValueOrDie(),
+                            lance::arrow::ToArray(dict).ValueOrDie())
+                            .ValueOrDie());
+  }
+  auto schema = ::arrow::schema({::arrow::field("label", type)});
+  auto table = ::arrow::Table::Make(schema, {std::make_shared<::arrow::ChunkedArray>(chunks)});
+
+  auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+  CHECK(lance::arrow::WriteTable(*table, sink, "label").ok());
+  auto reader = std::make_shared<lance::io::FileReader>(
+      make_shared<arrow::io::BufferReader>(sink->Finish().ValueOrDie()));
+  CHECK(reader->Open().ok());
+  CHECK(reader->primary_key_index() != nullptr);
+
+  // The keys are looked up by the dictionary values.
+  auto actual =
+      reader->GetByKey(lance::arrow::ToArray({"cat", "fox"}).ValueOrDie()).ValueOrDie();
+  CHECK(actual->num_rows() == 4);
+}
@@ -15,15 +15,28 @@
 #include "lance/io/writer.h"
 
 #include <arrow/array.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
 #include <arrow/dataset/file_base.h>
 #include <arrow/record_batch.h>
 #include <arrow/status.h>
+#include <arrow/util/bitmap_ops.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 #include "lance/arrow/file_lance.h"
 #include "lance/arrow/type.h"
+#include "lance/arrow/utils.h"
+#include "lance/encodings/packed_struct.h"
+#include "lance/encodings/rle.h"
+#include "lance/format/bitmap_index.h"
+#include "lance/format/bloom_filter.h"
 #include "lance/format/format.h"
 #include "lance/format/manifest.h"
 #include "lance/format/metadata.h"
+#include "lance/format/primary_key_index.h"
 #include "lance/format/schema.h"
 #include "lance/format/visitors.h"
 #include "lance/io/pb.h"
@@ -59,6 +72,48 @@ namespace internal {
 
 }  // namespace internal
 
+namespace {
+
+/// Number of rows sampled from a page to choose its encoding.
+constexpr int64_t kEncodingSampleSize = 1024;
+
+/// Number of evenly spaced slices that make up the sample.
+constexpr int64_t kEncodingSampleSlices = 4;
+
+struct EncodingCandidate {
+  lance::format::pb::Encoding encoding;
+  /// Decoding cost relative to the plain / var-binary encoding.
+  double decode_cost;
+};
+
+/// Candidate encodings of a column, starting from the encoding of the column.
+std::vector<EncodingCandidate> GetEncodingCandidates(const lance::format::Field& field) {
+  std::vector<EncodingCandidate> candidates{{field.encoding(), 1.0}};
+  // Byte-stream-split pages are not smaller than plain pages without page compression.
+  candidates.push_back({lance::format::pb::Encoding::RLE, 1.25});
+  if (::arrow::is_binary_like(field.type()->id())) {
+    candidates.push_back({lance::format::pb::Encoding::FSST, 2.5});
+  }
+  return candidates;
+}
+
+/// Sample the rows of a page from evenly spaced slices.
+::arrow::Result<std::shared_ptr<::arrow::Array>> SamplePage(
+    const std::shared_ptr<::arrow::Array>& arr) {
+  if (arr->length() <= kEncodingSampleSize) {
+    return arr;
+  }
+  auto slice_length = kEncodingSampleSize / kEncodingSampleSlices;
+  auto stride = arr->length() / kEncodingSampleSlices;
+  ::arrow::ArrayVector slices;
+  for (int64_t i = 0; i < kEncodingSampleSlices; i++) {
+    slices.emplace_back(arr->Slice(i * stride, slice_length));
+  }
+  return ::arrow::Concatenate(slices);
+}
+
+}  // namespace
+
 FileWriter::FileWriter(std::shared_ptr<::arrow::Schema> schema,
                        std::shared_ptr<::arrow::dataset::FileWriteOptions> options,
                        std::shared_ptr<::arrow::io::OutputStream> destination,
@@ -67,16 +122,111 @@ FileWriter::FileWriter(std::shared_ptr<::arrow::Schema> schema,
       lance_schema_(std::make_unique<lance::format::Schema>(schema)),
       metadata_(std::make_unique<lance::format::Metadata>()) {
   assert(schema->num_fields() > 0);
+  if (options_->type_name() == lance::arrow::LanceFileFormat::Make()->type_name()) {
+    auto opts = std::dynamic_pointer_cast<lance::arrow::FileWriteOptions>(options_);
+    encoding_policy_ = opts->encoding_policy;
+    for (auto& name : opts->rle_columns) {
+      auto field = lance_schema_->GetField(name);
+      if (!field) {
+        continue;
+      }
+      if (lance::encodings::RLEEncoder::Supports(field->type())) {
+        field->set_encoding(lance::format::pb::Encoding::RLE);
+      }
+    }
+    for (auto& name : opts->fsst_columns) {
+      auto field = lance_schema_->GetField(name);
+      if (field && ::arrow::is_binary_like(field->type()->id())) {
+        field->set_encoding(lance::format::pb::Encoding::FSST);
+      }
+    }
+    for (auto& name : opts->byte_stream_split_columns) {
+      auto field = lance_schema_->GetField(name);
+      if (field && (field->type()->id() == ::arrow::Type::FLOAT ||
+                    field->type()->id() == ::arrow::Type::DOUBLE)) {
+        field->set_encoding(lance::format::pb::Encoding::BYTE_STREAM_SPLIT);
+      }
+    }
+    for (auto& name : opts->blob_columns) {
+      auto field = lance_schema_->GetField(name);
+      if (field && (field->type()->id() == ::arrow::Type::STRING ||
+                    field->type()->id() == ::arrow::Type::BINARY)) {
+        field->set_encoding(lance::format::pb::Encoding::BLOB);
+      }
+    }
+    options_status_ = ConfigureIndicesAndLayouts(*opts);
+  }
+}
+
+::arrow::Status FileWriter::ConfigureIndicesAndLayouts(const lance::arrow::FileWriteOptions& opts) {
+  for (auto& [name, fpp] : opts.bloom_filter_columns) {
+    auto field = lance_schema_->GetField(name);
+    if (!field) {
+      return ::arrow::Status::Invalid(fmt::format("Bloom filter column {} does not exist", name));
+    }
+    if (!lance::format::BloomFilter::Supports(*field->type())) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Bloom filter does not support column {} of type {}",
+                      name,
+                      field->type()->ToString()));
+    }
+    bloom_filter_fpps_[field->id()] = fpp;
+  }
+  if (!opts.primary_key.empty()) {
+    auto field = lance_schema_->GetField(opts.primary_key);
+    if (!field || !schema_->GetFieldByName(opts.primary_key)) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Primary key column {} does not exist", opts.primary_key));
+    }
+    // A primary key of a type that can not be indexed is only recorded in the manifest.
+    if (lance::format::PrimaryKeyIndex::Supports(*field->type())) {
+      primary_key_field_ = field;
+    }
+  }
+  for (auto& name : opts.bitmap_index_columns) {
+    auto field = lance_schema_->GetField(name);
+    if (!field || !schema_->GetFieldByName(name)) {
+      return ::arrow::Status::Invalid(fmt::format("Bitmap index column {} does not exist", name));
+    }
+    if (!lance::format::BitmapIndex::Supports(*field->type())) {
+      return ::arrow::Status::Invalid(
+          fmt::format("Bitmap index does not support column {} of type {}",
+                      name,
+                      field->type()->ToString()));
+    }
+    bitmap_index_values_[field->id()] = {};
+  }
+  for (auto& name : opts.packed_struct_columns) {
+    auto field = lance_schema_->GetField(name);
+    if (!field) {
+      return ::arrow::Status::Invalid(fmt::format("Packed struct column {} does not exist", name));
+    }
+    ARROW_RETURN_NOT_OK(lance::encodings::PackedStructLayout(*field->type()).status());
+    field->set_encoding(lance::format::pb::Encoding::PACKED_STRUCT);
+  }
+  return ::arrow::Status::OK();
 }
 
 FileWriter::~FileWriter() {}
 
 ::arrow::Status FileWriter::Write(const std::shared_ptr<::arrow::RecordBatch>& batch) {
+  ARROW_RETURN_NOT_OK(options_status_);
   metadata_->AddBatchLength(batch->num_rows());
 
   for (const auto& field : lance_schema_->fields()) {
     ARROW_RETURN_NOT_OK(WriteArray(field, batch->GetColumnByName(field->name())));
   }
+  if (primary_key_field_) {
+    // Dictionary keys are indexed by their values, which are comparable across the batches.
+    ARROW_ASSIGN_OR_RAISE(
+        auto keys,
+        ::arrow::compute::Cast(*batch->GetColumnByName(primary_key_field_->name()),
+                               format::PrimaryKeyIndex::KeyType(primary_key_field_->type())));
+    primary_keys_.emplace_back(keys);
+  }
+  for (auto& [field_id, values] : bitmap_index_values_) {
+    values.emplace_back(batch->GetColumnByName(lance_schema_->GetField(field_id)->name()));
+  }
   batch_id_++;
   return ::arrow::Status::OK();
 }
@@ -84,33 +234,182 @@ FileWriter::~FileWriter() {}
 ::arrow::Status FileWriter::WriteArray(const std::shared_ptr<format::Field>& field,
                                        const std::shared_ptr<::arrow::Array>& arr) {
   assert(field->type()->id() == arr->type_id());
-  if (::arrow::is_primitive(arr->type_id()) || ::arrow::is_binary_like(arr->type_id())) {
+  ARROW_RETURN_NOT_OK(WriteValidity(field, arr));
+  if (::arrow::is_primitive(arr->type_id()) || ::arrow::is_binary_like(arr->type_id()) ||
+      ::arrow::is_large_binary_like(arr->type_id())) {
+    ARROW_RETURN_NOT_OK(CollectStatistics(field, arr));
+    ARROW_RETURN_NOT_OK(WriteBloomFilter(field, arr));
     return WritePrimitiveArray(field, arr);
   } else if (lance::arrow::is_struct(arr->type())) {
     return WriteStructArray(field, arr);
   } else if (lance::arrow::is_list(arr->type())) {
     return WriteListArray(field, arr);
+  } else if (lance::arrow::is_map(arr->type())) {
+    return WriteMapArray(field, arr);
   } else if (::arrow::is_dictionary(arr->type_id())) {
     return WriteDictionaryArray(field, arr);
+  } else if (::arrow::is_fixed_size_binary(arr->type_id())) {
+    ARROW_RETURN_NOT_OK(CollectStatistics(field, arr));
+    ARROW_RETURN_NOT_OK(WriteBloomFilter(field, arr));
+    return WritePrimitiveArray(field, arr);
+  } else if (lance::arrow::is_fixed_size_list(arr->type())) {
+    // A leaf column, with the values of all rows in one page.
+    return WritePrimitiveArray(field, arr);
   }
   return ::arrow::Status::Invalid(
       fmt::format("WriteArray: unsupported data type: {}", arr->type()->ToString()));
 }
 
+::arrow::Status FileWriter::WriteValidity(const std::shared_ptr<format::Field>& field,
+                                          const std::shared_ptr<::arrow::Array>& arr) {
+  if (arr->null_count() == 0) {
+    return ::arrow::Status::OK();
+  }
+  if (arr->null_count() == arr->length()) {
+    lookup_table_.SetValidity(field->id(), batch_id_, format::PageTable::kAllNull);
+    return ::arrow::Status::OK();
+  }
+  ARROW_ASSIGN_OR_RAISE(
+      auto bitmap,
+      ::arrow::internal::CopyBitmap(
+          ::arrow::default_memory_pool(), arr->null_bitmap_data(), arr->offset(), arr->length()));
+  ARROW_ASSIGN_OR_RAISE(auto pos, destination_->Tell());
+  ARROW_RETURN_NOT_OK(destination_->Write(bitmap));
+  lookup_table_.SetValidity(field->id(), batch_id_, pos);
+  return ::arrow::Status::OK();
+}
+
+::arrow::Status FileWriter::CollectStatistics(const std::shared_ptr<format::Field>& field,
+                                              const std::shared_ptr<::arrow::Array>& arr) {
+  format::pb::PageStatistics statistics;
+  statistics.set_null_count(arr->null_count());
+  statistics.set_row_count(arr->length());
+  if (arr->null_count() < arr->length()) {
+    if (::arrow::is_floating(arr->type_id())) {
+      // NaN is not ordered, so the range of a page with NaNs does not bound its values.
+      ARROW_ASSIGN_OR_RAISE(auto is_nan, ::arrow::compute::CallFunction("is_nan", {arr}));
+      ARROW_ASSIGN_OR_RAISE(auto has_nan, ::arrow::compute::Any(is_nan));
+      if (has_nan.scalar_as<::arrow::BooleanScalar>().value) {
+        return ::arrow::Status::OK();
+      }
+    }
+    auto min_max = ::arrow::compute::MinMax(arr);
+    if (!min_max.ok()) {
+      // The values of this type are not ordered.
+      return ::arrow::Status::OK();
+    }
+    auto& values = min_max->scalar_as<::arrow::StructScalar>().value;
+    auto min = lance::arrow::ScalarToBytes(*values[0]);
+    auto max = lance::arrow::ScalarToBytes(*values[1]);
+    if (!min.ok() || !max.ok()) {
+      return ::arrow::Status::OK();
+    }
+    statistics.set_min(std::move(min).ValueUnsafe());
+    statistics.set_max(std::move(max).ValueUnsafe());
+  }
+  lookup_table_.SetStatistics(field->id(), batch_id_, std::move(statistics));
+  return ::arrow::Status::OK();
+}
+
+::arrow::Status FileWriter::WriteBloomFilter(const std::shared_ptr<format::Field>& field,
+                                             const std::shared_ptr<::arrow::Array>& arr) {
+  auto it = bloom_filter_fpps_.find(field->id());
+  if (it == bloom_filter_fpps_.end()) {
+    return ::arrow::Status::OK();
+  }
+  ARROW_ASSIGN_OR_RAISE(auto bloom_filter,
+                        format::BloomFilter::Make(arr->length() - arr->null_count(), it->second));
+  ARROW_RETURN_NOT_OK(bloom_filter->Insert(*arr));
+  ARROW_ASSIGN_OR_RAISE(auto pos, destination_->Tell());
+  ARROW_RETURN_NOT_OK(destination_->Write(bloom_filter->blocks()));
+  format::pb::PageBloomFilter page;
+  page.set_position(pos);
+  page.set_num_blocks(bloom_filter->num_blocks());
+  lookup_table_.SetBloomFilter(field->id(), batch_id_, std::move(page));
+  return ::arrow::Status::OK();
+}
+
 ::arrow::Status FileWriter::WritePrimitiveArray(const std::shared_ptr<format::Field>& field,
                                                 const std::shared_ptr<::arrow::Array>& arr) {
   auto field_id = field->id();
-  auto encoder = field->GetEncoder(destination_);
-  ARROW_ASSIGN_OR_RAISE(auto pos, encoder->Write(arr));
+  int64_t pos;
+  if (arr->length() > 0 && arr->null_count() == arr->length()) {
+    // The values of an all-null page are never read.
+    ARROW_ASSIGN_OR_RAISE(pos, destination_->Tell());
+  } else {
+    auto encoding = field->encoding();
+    if (encoding_policy_ != lance::arrow::EncodingPolicy::kFixed) {
+      ARROW_ASSIGN_OR_RAISE(encoding, SelectEncoding(field, arr));
+    }
+    if (encoding == format::pb::Encoding::VAR_BINARY32 &&
+        std::static_pointer_cast<::arrow::BinaryArray>(arr)->total_values_length() >
+            std::numeric_limits<int32_t>::max()) {
+      // Pages larger than 2GB need int64 offsets.
+      encoding = format::pb::Encoding::VAR_BINARY;
+    }
+    auto encoder = field->GetEncoder(destination_, encoding);
+    ARROW_ASSIGN_OR_RAISE(pos, encoder->Write(arr));
+    if (encoding != field->encoding()) {
+      lookup_table_.SetEncoding(field_id, batch_id_, encoding);
+    }
+  }
   lookup_table_.SetPageInfo(field_id, batch_id_, pos, arr->length());
   return ::arrow::Status::OK();
 }
 
+::arrow::Result<format::pb::Encoding> FileWriter::SelectEncoding(
+    const std::shared_ptr<format::Field>& field, const std::shared_ptr<::arrow::Array>& arr) {
+  auto encoding = field->encoding();
+  // Only the leaf columns with the default encoding of their type, i.e., not the offsets of
+  // a list column, or the columns that have been configured explicitly.
+  if (arr->type_id() != field->type()->id() ||
+      (encoding != format::pb::Encoding::PLAIN && encoding != format::pb::Encoding::VAR_BINARY &&
+       encoding != format::pb::Encoding::VAR_BINARY32) ||
+      !(::arrow::is_primitive(arr->type_id()) || ::arrow::is_binary_like(arr->type_id()))) {
+    return encoding;
+  }
+  ARROW_ASSIGN_OR_RAISE(auto sample, SamplePage(arr));
+  double best_score = std::numeric_limits<double>::max();
+  for (auto& candidate : GetEncodingCandidates(*field)) {
+    ARROW_ASSIGN_OR_RAISE(auto sink, ::arrow::io::BufferOutputStream::Create());
+    auto encoder = field->GetEncoder(sink, candidate.encoding);
+    if (!encoder->Write(sample).ok()) {
+      continue;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto size, sink->Tell());
+    double score = static_cast<double>(size);
+    if (encoding_policy_ == lance::arrow::EncodingPolicy::kBalanced) {
+      score *= candidate.decode_cost;
+    }
+    if (score < best_score) {
+      best_score = score;
+      encoding = candidate.encoding;
+    }
+  }
+  return encoding;
+}
+
 ::arrow::Status FileWriter::WriteStructArray(const std::shared_ptr<format::Field>& field,
                                              const std::shared_ptr<::arrow::Array>& arr) {
   assert(arrow::is_struct(field->type()));
   auto struct_arr = std::static_pointer_cast<::arrow::StructArray>(arr);
   assert(field->fields().size() == static_cast<size_t>(struct_arr->num_fields()));
+  if (field->encoding() == format::pb::Encoding::PACKED_STRUCT) {
+    // All the children are written in one page of the struct field. The children keep their
+    // own validity, and share the page of their parent.
+    for (auto child : field->fields()) {
+      auto child_arr = struct_arr->GetFieldByName(child->name());
+      ARROW_RETURN_NOT_OK(WriteValidity(child, child_arr));
+      ARROW_RETURN_NOT_OK(CollectStatistics(child, child_arr));
+      ARROW_RETURN_NOT_OK(WriteBloomFilter(child, child_arr));
+    }
+    ARROW_RETURN_NOT_OK(WritePrimitiveArray(field, arr));
+    auto [pos, length] = lookup_table_.GetPageInfo(field->id(), batch_id_).value();
+    for (auto child : field->fields()) {
+      lookup_table_.SetPageInfo(child->id(), batch_id_, pos, length);
+    }
+    return ::arrow::Status::OK();
+  }
   for (auto child : field->fields()) {
     auto child_arr = struct_arr->GetFieldByName(child->name());
     ARROW_RETURN_NOT_OK(WriteArray(child, child_arr));
@@ -120,34 +419,136 @@ FileWriter::~FileWriter() {}
 
 ::arrow::Status FileWriter::WriteListArray(const std::shared_ptr<format::Field>& field,
                                            const std::shared_ptr<::arrow::Array>& arr) {
-  assert(field->logical_type() == "list" || field->logical_type() == "list.struct");
+  assert(lance::arrow::is_list(field->type()));
   assert(field->fields().size() == 1);
+  // The offsets are written with their own width, int32 for list and int64 for large_list.
+  auto child_field = field->field(0);
+  if (arr->type_id() == ::arrow::Type::LARGE_LIST) {
+    auto list_arr = std::static_pointer_cast<::arrow::LargeListArray>(arr);
+    // The child page is read with int32 positions and lengths.
+    auto num_values = list_arr->value_offset(list_arr->length()) - list_arr->value_offset(0);
+    if (num_values > std::numeric_limits<int32_t>::max()) {
+      return ::arrow::Status::CapacityError(
+          fmt::format("Column {} has {} list values in one batch, more than a page can hold",
+                      field->name(),
+                      num_values));
+    }
+    ARROW_RETURN_NOT_OK(WritePrimitiveArray(field, list_arr->offsets()));
+    return WriteArray(child_field, list_arr->values());
+  }
   auto list_arr = std::static_pointer_cast<::arrow::ListArray>(arr);
-  auto offset_arr = list_arr->offsets();
   ARROW_RETURN_NOT_OK(WritePrimitiveArray(field, list_arr->offsets()));
-  auto child_field = field->field(0);
   return WriteArray(child_field, list_arr->values());
 }
 
+::arrow::Status FileWriter::WriteMapArray(const std::shared_ptr<format::Field>& field,
+                                          const std::shared_ptr<::arrow::Array>& arr) {
+  assert(lance::arrow::is_map(field->type()));
+  assert(field->fields().size() == 2);
+  auto map_arr = std::static_pointer_cast<::arrow::MapArray>(arr);
+  ARROW_RETURN_NOT_OK(WritePrimitiveArray(field, map_arr->offsets()));
+  ARROW_RETURN_NOT_OK(WriteArray(field->field(0), map_arr->keys()));
+  return WriteArray(field->field(1), map_arr->items());
+}
+
 ::arrow::Status FileWriter::WriteDictionaryArray(const std::shared_ptr<format::Field>& field,
                                                  const std::shared_ptr<::arrow::Array>& arr) {
   assert(field->logical_type().starts_with("dict:"));
   auto encoder = field->GetEncoder(destination_);
   auto dict_arr = std::static_pointer_cast<::arrow::DictionaryArray>(arr);
-  if (!field->dictionary()) {
-    ARROW_RETURN_NOT_OK(field->set_dictionary(dict_arr->dictionary()));
-  }
   auto field_id = field->id();
-  ARROW_ASSIGN_OR_RAISE(auto pos, encoder->Write(arr));
+  int64_t pos;
+  if (arr->length() > 0 && arr->null_count() == arr->length()) {
+    ARROW_ASSIGN_OR_RAISE(pos, destination_->Tell());
+  } else {
+    ARROW_ASSIGN_OR_RAISE(auto unified, UnifyDictionary(field, dict_arr));
+    ARROW_ASSIGN_OR_RAISE(pos, encoder->Write(unified));
+  }
   lookup_table_.SetPageInfo(field_id, batch_id_, pos, arr->length());
   return ::arrow::Status::OK();
 }
 
+::arrow::Result<std::shared_ptr<::arrow::DictionaryArray>> FileWriter::UnifyDictionary(
+    const std::shared_ptr<format::Field>& field,
+    const std::shared_ptr<::arrow::DictionaryArray>& arr) {
+  auto dict_type = std::static_pointer_cast<::arrow::DictionaryType>(field->type());
+  auto& unifier = dictionary_unifiers_[field->id()];
+  if (!unifier) {
+    ARROW_ASSIGN_OR_RAISE(unifier, ::arrow::DictionaryUnifier::Make(dict_type->value_type()));
+  }
+  std::shared_ptr<::arrow::Buffer> transpose_map;
+  ARROW_RETURN_NOT_OK(unifier->Unify(*arr->dictionary(), &transpose_map));
+
+  // The values of the dictionaries seen before keep their positions, so the indices only
+  // change when this batch brings new values in a different order.
+  auto transpose = reinterpret_cast<const int32_t*>(transpose_map->data());
+  auto dict_length = arr->dictionary()->length();
+  bool is_identity = true;
+  int32_t max_index = 0;
+  for (int64_t i = 0; i < dict_length; i++) {
+    is_identity &= transpose[i] == i;
+    max_index = std::max(max_index, transpose[i]);
+  }
+  auto index_type = std::static_pointer_cast<::arrow::IntegerType>(dict_type->index_type());
+  auto bits = index_type->bit_width() - (index_type->is_signed() ? 1 : 0);
+  if (bits < 31 && max_index >= (int64_t{1} << bits)) {
+    return ::arrow::Status::CapacityError(
+        fmt::format("Dictionary of column {} has more values than index type {} can address",
+                    field->name(),
+                    index_type->ToString()));
+  }
+  if (is_identity) {
+    return arr;
+  }
+  // Only the indices are written, so the dictionary of the remapped array is irrelevant.
+  ARROW_ASSIGN_OR_RAISE(auto transposed,
+                        arr->Transpose(field->type(), arr->dictionary(), transpose));
+  return std::static_pointer_cast<::arrow::DictionaryArray>(transposed);
+}
+
 ::arrow::Status FileWriter::WriteFooter() {
+  ARROW_RETURN_NOT_OK(options_status_);
+  for (auto& [field_id, unifier] : dictionary_unifiers_) {
+    auto field = lance_schema_->GetField(field_id);
+    auto dict_type = std::static_pointer_cast<::arrow::DictionaryType>(field->type());
+    std::shared_ptr<::arrow::Array> dictionary;
+    ARROW_RETURN_NOT_OK(unifier->GetResultWithIndexType(dict_type->index_type(), &dictionary));
+    ARROW_RETURN_NOT_OK(field->set_dictionary(dictionary));
+  }
   // Write dictionary values first.
   auto visitor = format::WriteDictionaryVisitor(destination_);
   ARROW_RETURN_NOT_OK(visitor.VisitSchema(lance_schema_));
 
+  if (lookup_table_.HasNulls()) {
+    ARROW_ASSIGN_OR_RAISE(auto validity_pos, lookup_table_.WriteValidity(destination_));
+    metadata_->SetValidityTablePosition(validity_pos);
+  }
+  if (lookup_table_.HasPageEncodings()) {
+    ARROW_ASSIGN_OR_RAISE(auto encoding_pos, lookup_table_.WriteEncodings(destination_));
+    metadata_->SetEncodingTablePosition(encoding_pos);
+  }
+  if (lookup_table_.HasBloomFilters()) {
+    ARROW_ASSIGN_OR_RAISE(auto bloom_filters_pos, lookup_table_.WriteBloomFilters(destination_));
+    metadata_->SetBloomFiltersPosition(bloom_filters_pos);
+  }
+  if (lookup_table_.HasStatistics()) {
+    ARROW_ASSIGN_OR_RAISE(auto statistics_pos, lookup_table_.WriteStatistics(destination_));
+    metadata_->SetStatisticsPosition(statistics_pos);
+  }
+  if (primary_key_field_ && !primary_keys_.empty()) {
+    ARROW_ASSIGN_OR_RAISE(auto keys, ::arrow::Concatenate(primary_keys_));
+    ARROW_ASSIGN_OR_RAISE(auto index_pos,
+                          format::PrimaryKeyIndex::Write(destination_, primary_key_field_, keys));
+    metadata_->SetPrimaryKeyIndexPosition(index_pos);
+  }
+  for (auto& [field_id, values] : bitmap_index_values_) {
+    ARROW_ASSIGN_OR_RAISE(
+        auto index_pos,
+        format::BitmapIndex::Write(destination_, lance_schema_->GetField(field_id), values));
+    if (index_pos.has_value()) {
+      metadata_->AddBitmapIndexPosition(*index_pos);
+    }
+  }
   ARROW_ASSIGN_OR_RAISE(auto pos, lookup_table_.Write(destination_));
   metadata_->SetPageTablePosition(pos);
 
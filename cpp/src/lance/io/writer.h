@@ -14,14 +14,17 @@
 
 #pragma once
 
+#include <arrow/array/array_dict.h>
 #include <arrow/dataset/file_base.h>
 #include <arrow/filesystem/api.h>
 #include <arrow/io/api.h>
 #include <arrow/status.h>
 #include <arrow/util/future.h>
 
+#include <map>
 #include <memory>
 
+#include "lance/arrow/file_lance.h"
 #include "lance/format/metadata.h"
 #include "lance/format/page_table.h"
 
@@ -49,23 +52,63 @@ class FileWriter final : public ::arrow::dataset::FileWriter {
  private:
   ::arrow::Future<> FinishInternal() override;
 
+  /// Set up the indices and the layouts of the columns in the options.
+  ///
+  /// \return Status::Invalid if a column does not exist or does not support the option.
+  ::arrow::Status ConfigureIndicesAndLayouts(const lance::arrow::FileWriteOptions& opts);
+
   ::arrow::Status WriteFooter();
 
   ::arrow::Status WriteArray(const std::shared_ptr<format::Field>& field,
                              const std::shared_ptr<::arrow::Array>& arr);
+  /// Write the validity bitmap of the page, if the array has nulls.
+  ::arrow::Status WriteValidity(const std::shared_ptr<format::Field>& field,
+                                const std::shared_ptr<::arrow::Array>& arr);
+  /// Collect the min / max values and the null count of a leaf page, to prune the pages
+  /// by the filters of the readers.
+  ::arrow::Status CollectStatistics(const std::shared_ptr<format::Field>& field,
+                                    const std::shared_ptr<::arrow::Array>& arr);
+  /// Write the Bloom filter of a leaf page, if the column is configured with one.
+  ::arrow::Status WriteBloomFilter(const std::shared_ptr<format::Field>& field,
+                                   const std::shared_ptr<::arrow::Array>& arr);
   ::arrow::Status WritePrimitiveArray(const std::shared_ptr<format::Field>& field,
                                       const std::shared_ptr<::arrow::Array>& arr);
+  /// Choose the encoding of a page, by encoding a sample of the page with each candidate
+  /// encoding and comparing the sizes under `encoding_policy_`.
+  ::arrow::Result<format::pb::Encoding> SelectEncoding(const std::shared_ptr<format::Field>& field,
+                                                       const std::shared_ptr<::arrow::Array>& arr);
   ::arrow::Status WriteStructArray(const std::shared_ptr<format::Field>& field,
                                    const std::shared_ptr<::arrow::Array>& arr);
   ::arrow::Status WriteListArray(const std::shared_ptr<format::Field>& field,
                                  const std::shared_ptr<::arrow::Array>& arr);
+  /// Write the offsets of a map array, then the keys and the values as two child columns.
+  ::arrow::Status WriteMapArray(const std::shared_ptr<format::Field>& field,
+                                const std::shared_ptr<::arrow::Array>& arr);
   /// Write Arrow DictionaryArray.
   ::arrow::Status WriteDictionaryArray(const std::shared_ptr<format::Field>& field,
                                        const std::shared_ptr<::arrow::Array>& arr);
+  /// Remap the indices of a dictionary array to the file-level dictionary of the field, which
+  /// is the union of the dictionaries of all the batches written so far.
+  ::arrow::Result<std::shared_ptr<::arrow::DictionaryArray>> UnifyDictionary(
+      const std::shared_ptr<format::Field>& field,
+      const std::shared_ptr<::arrow::DictionaryArray>& arr);
 
   std::shared_ptr<lance::format::Schema> lance_schema_;
   std::unique_ptr<lance::format::Metadata> metadata_;
   format::PageTable lookup_table_;
+  lance::arrow::EncodingPolicy encoding_policy_ = lance::arrow::EncodingPolicy::kFixed;
+  /// The false positive rate of the Bloom filters, keyed by field id.
+  std::map<int32_t, double> bloom_filter_fpps_;
+  /// Unified dictionaries, keyed by field id.
+  std::map<int32_t, std::unique_ptr<::arrow::DictionaryUnifier>> dictionary_unifiers_;
+  /// The primary key field to index, if it is set and supported.
+  std::shared_ptr<format::Field> primary_key_field_;
+  /// The primary keys of the batches written so far.
+  ::arrow::ArrayVector primary_keys_;
+  /// The values of the bitmap indexed columns of the batches written so far, keyed by field id.
+  std::map<int32_t, ::arrow::ArrayVector> bitmap_index_values_;
+  /// The error of the options, which is returned by the first write.
+  ::arrow::Status options_status_;
   int32_t batch_id_ = 0;
 };
 